@@ -5,7 +5,8 @@ from pybind11.setup_helpers import Pybind11Extension, build_ext
 ext_modules = [
     Pybind11Extension(
     "_ruptura",
-    sources=glob("src/*.cpp"),
+    # the snapshot reader tool has a main of its own
+    sources=[source for source in glob("src/*.cpp") if not source.endswith("snapshot_tool.cpp")],
     extra_compile_args=["-std=c++17", "-DPYBUILD=1"]
     )
 ]
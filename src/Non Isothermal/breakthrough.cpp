@@ -1,7 +1,8 @@
 /**
  * The problem of the implementation lies in two areas, messed up function calls and incorrect use of units in some areas.
  * The files with the changed function calls to include temperature are not included because they are the issue and is too much of a mess to be usable. 
- * The files that are included are the breakthrough.h, isotherm.cpp, isotherm.h and inputreader.cpp
+ * The files that are included are the breakthrough.h, isotherm.cpp, isotherm.h, inputreader.cpp,
+ * mixture_prediction_temperature.h and mixture_prediction_temperature.cpp
  * If the units of the input and function calls are added properly, in theory it should work. Unfortunately, I did not manage to do this in time.
  * The current implementation only aimed at making the langmuir model work before moving to the rest, as such only it has been altered.
  * 
@@ -17,6 +18,9 @@
  *    Langmuir model updated with temperature dependency and extra input
  * - inputreader.cpp 
  *    Added additional input parameter to langmuir model
+ * - mixture_prediction_temperature.h, mixture_prediction_temperature.cpp
+ *    the isotherm accessor that runs the IAST, SIAST and explicit-isotherm kernels of MixturePrediction for the
+ *    temperature factors of a grid point
  * 
  * - void Breakthrough::initialize()
  *    (temporarily) declare constants for temperature computation
@@ -26,11 +30,19 @@
  *    set last grid point to grid point before it. Though a ghost node should be used instead
  * - void Breakthrough::computeFirstDerivatives(...)
  *    Apply boundary conditions for first and last grid point
- *    Compute energy balance to obtain dTdt for middle grid points
+ *    Compute energy balance to obtain dTdt for middle grid points (without the conduction, which is implicit)
+ * - void Breakthrough::computeImplicitConduction()
+ *    Backward-Euler step for the axial heat conduction, a tridiagonal system solved with the Thomas algorithm
  *    Multiply prefactor by T[i]
  * - void Breakthrough::computeEquilibriumLoadings(...)
  *    Multiply prefactor by T[i]
- *    Added a temperature argument to the mixture prediction
+ *    Added the temperature factors of the grid point as an argument to the mixture prediction
+ * - void Breakthrough::updateTemperatureFactors(...)
+ *    Cache the temperature factors (affinity and saturation capacity) of a grid point, the mixture prediction passes
+ *    those of component id and site, factors[site * Ncomp + id], to the 'adjusted' isotherm functions
+ * - void Breakthrough::run(), void Breakthrough::computePureComponentLoadings(...)
+ *    Write the pure-component loadings at the local temperatures to 'column.data', after all other columns, computed
+ *    over the whole column with the batched Isotherm::addValues for the temperature vector T
  */
 
 
@@ -51,6 +63,7 @@
 #endif
 
 #include "breakthrough.h"
+#include "mixture_prediction_temperature.h"
 
 const double R=8.31446261815324;
 
@@ -135,9 +148,33 @@ Breakthrough::Breakthrough(const InputReader &inputReader):
     Dqdt((Ngrid + 1) * Ncomp),
     Dqdtnew((Ngrid + 1) * Ncomp),
     cachedP0((Ngrid + 1) * Ncomp * maxIsothermTerms),
-    cachedPsi((Ngrid + 1) * maxIsothermTerms)
+    cachedPsi((Ngrid + 1) * maxIsothermTerms),
+    temperatureFactors((Ngrid + 1) * Ncomp * maxIsothermTerms),
+    factorTemperature(Ngrid + 1, std::numeric_limits<double>::quiet_NaN()),
+    purePressures(Ngrid + 1),
+    pureLoadings((Ngrid + 1) * Ncomp),
+    conductionScratchC(Ngrid + 1),
+    conductionScratchD(Ngrid + 1)
 {
 }
+// the gas-phase mol-fractions given through Python are normalized to unity, as the InputReader does for input files
+static std::vector<Component> normalize_molfracs(std::vector<Component> components)
+{
+  double sum = 0.0;
+  for(const Component &component : components)
+  {
+    sum += component.Yi0;
+  }
+  if(sum > 0.0)
+  {
+    for(Component &component : components)
+    {
+      component.Yi0 /= sum;
+    }
+  }
+  return components;
+}
+
 Breakthrough::Breakthrough(std::string _displayName, std::vector<Component> _components, size_t _carrierGasComponent,
                            size_t _numberOfGridPoints, size_t _printEvery, size_t _writeEvery, double _temperature,
                            double _p_total, double _columnVoidFraction, double _pressureGradient,
@@ -168,7 +205,7 @@ Breakthrough::Breakthrough(std::string _displayName, std::vector<Component> _com
       pulse(_pulse),
       tpulse(_pulseTime),
       mixture(_mixture),
-      maxIsothermTerms(mixture.maxIsothermTerms),
+      maxIsothermTerms(mixture.getMaxIsothermTerms()),
       prefactor(Ncomp),
       Yi(Ncomp),
       Xi(Ncomp),
@@ -196,7 +233,13 @@ Breakthrough::Breakthrough(std::string _displayName, std::vector<Component> _com
       Dqdt((Ngrid + 1) * Ncomp),
       Dqdtnew((Ngrid + 1) * Ncomp),
       cachedP0((Ngrid + 1) * Ncomp * maxIsothermTerms),
-      cachedPsi((Ngrid + 1) * maxIsothermTerms)
+      cachedPsi((Ngrid + 1) * maxIsothermTerms),
+      temperatureFactors((Ngrid + 1) * Ncomp * maxIsothermTerms),
+      factorTemperature(Ngrid + 1, std::numeric_limits<double>::quiet_NaN()),
+      purePressures(Ngrid + 1),
+      pureLoadings((Ngrid + 1) * Ncomp),
+      conductionScratchC(Ngrid + 1),
+      conductionScratchD(Ngrid + 1)
 {
   // normally ran in main.cpp, now run by default
   initialize();
@@ -276,7 +319,9 @@ void Breakthrough::initialize()
       Yi[j] /= sum;
     }
 
-    iastPerformance += mixture.predictMixture(Yi, pt_init[i], T[i], Xi, Ni, 
+    updateTemperatureFactors(i, T[i]);
+    iastPerformance += mixture.predictMixture(
+        TemperatureAdjustedIsotherms{&temperatureFactors[i * Ncomp * maxIsothermTerms], Ncomp}, Yi, pt_init[i], Xi, Ni,
         &cachedP0[i * Ncomp * maxIsothermTerms], &cachedPsi[i * maxIsothermTerms]);
 
     for(size_t j = 0; j < Ncomp; ++j)
@@ -327,6 +372,11 @@ void Breakthrough::run()
     movieStream << "# column " << column_nr++ << ": component " << j << " Dpdt  (derivative P with t)\n";
     movieStream << "# column " << column_nr++ << ": component " << j << " Dqdt  (derivative Q with tn\n";
   }
+  // Non isothermal: the pure-component loadings follow the other columns, so that those keep their numbers
+  for (size_t j = 0; j < Ncomp; ++j)
+  {
+    movieStream << "# column " << column_nr++ << ": component " << j << " Qpure (pure-component loading at T)\n";
+  }
 
   for (size_t step = 0; (step < Nsteps || autoSteps); ++step)
   {
@@ -347,6 +397,11 @@ void Breakthrough::run()
                    << P[Ngrid * Ncomp + j] / ((p_total + dptdx * L) * components[j].Yi0) << std::endl;
       }
 
+      for (size_t j = 0; j < Ncomp; ++j)
+      {
+        computePureComponentLoadings(j, &pureLoadings[j * (Ngrid + 1)]);
+      }
+
       for (size_t i = 0; i < Ngrid + 1; ++i)
       {
         movieStream << static_cast<double>(i) * dx << " ";
@@ -360,6 +415,10 @@ void Breakthrough::run()
                       << P[i * Ncomp + j] / (Pt[i] * components[j].Yi0) << " " << Dpdt[i * Ncomp + j] << " "
                       << Dqdt[i * Ncomp + j] << " ";
         }
+        for (size_t j = 0; j < Ncomp; ++j)
+        {
+          movieStream << pureLoadings[j * (Ngrid + 1) + i] << " ";
+        }
         movieStream << "\n";
       }
       movieStream << "\n\n";
@@ -493,6 +552,9 @@ void Breakthrough::computeStep(size_t step)
   Tnew[i] = (1.0 / 3.0) * T[i] + (2.0 / 3.0) * Tnew[i] + (2.0 / 3.0) * dt * DTdtnew[i];
   Tnew[Ngrid] = Tnew[Ngrid-1];
 
+  // Non isothermal: conduction over the full time step on top of the explicit advection and heat of adsorption
+  computeImplicitConduction();
+
 
   computeEquilibriumLoadings();
 
@@ -551,8 +613,10 @@ void Breakthrough::computeEquilibriumLoadings()
     }
   
     // use Yi and Pt[i] to compute the loadings in the adsorption mixture via mixture prediction
-    // Non isothermal: added temperature argument
-    iastPerformance += mixture.predictMixture(Yi, Pt[i], T[i], Xi, Ni, 
+    // Non isothermal: added the temperature factors as argument
+    updateTemperatureFactors(i, T[i]);
+    iastPerformance += mixture.predictMixture(
+        TemperatureAdjustedIsotherms{&temperatureFactors[i * Ncomp * maxIsothermTerms], Ncomp}, Yi, Pt[i], Xi, Ni,
         &cachedP0[i * Ncomp * maxIsothermTerms], &cachedPsi[i * maxIsothermTerms]);
 
     for(size_t j = 0; j < Ncomp; ++j)
@@ -569,6 +633,40 @@ void Breakthrough::computeEquilibriumLoadings()
 }
 
 
+// Non isothermal: recompute the temperature factors of all isotherm sites at grid point i only when its temperature
+// has changed since the last mixture prediction there (NaN initially, so the first call always computes them)
+void Breakthrough::updateTemperatureFactors(size_t i, double temperature)
+{
+  if(factorTemperature[i] == temperature) return;
+
+  TemperatureFactors *factors = &temperatureFactors[i * Ncomp * maxIsothermTerms];
+  for(size_t j = 0; j < Ncomp; ++j)
+  {
+    const MultiSiteIsotherm &isotherm = components[j].isotherm;
+    for(size_t site = 0; site < isotherm.numberOfSites; ++site)
+    {
+      factors[site * Ncomp + j] = isotherm.sites[site].temperatureFactors(temperature);
+    }
+  }
+  factorTemperature[i] = temperature;
+}
+
+// Non isothermal: the pure-component loadings of component j at the partial pressures and temperatures of all grid
+// points, evaluated site by site over the whole column with the batched Isotherm::addValues
+void Breakthrough::computePureComponentLoadings(size_t j, double *loadings)
+{
+  for(size_t i = 0; i < Ngrid + 1; ++i)
+  {
+    purePressures[i] = P[i * Ncomp + j];
+  }
+  std::fill(loadings, loadings + Ngrid + 1, 0.0);
+  const MultiSiteIsotherm &isotherm = components[j].isotherm;
+  for(size_t site = 0; site < isotherm.numberOfSites; ++site)
+  {
+    isotherm.sites[site].addValues(purePressures.data(), T.data(), loadings, Ngrid + 1);
+  }
+}
+
 // calculate the derivatives Dq/dt and Dp/dt along the column
 void Breakthrough::computeFirstDerivatives(std::vector<double> &dqdt,
                                            std::vector<double> &dpdt,
@@ -628,8 +726,8 @@ void Breakthrough::computeFirstDerivatives(std::vector<double> &dqdt,
 
     sink = epsilon * C_pg * Ct + (1.0 - epsilon) * (C_ps * rho_p);
 
-    dTdt[i] = (K_z * (Ti[i-1] - 2.0 * Ti[i] + Ti[i+1]) * idx2) / sink 
-              + (-epsilon * Ct * C_pg * v[i] * (Ti[i] - Ti[i-1]) * idx) / sink 
+    // the axial conduction is treated implicitly in 'computeImplicitConduction'
+    dTdt[i] = (-epsilon * Ct * C_pg * v[i] * (Ti[i] - Ti[i-1]) * idx) / sink 
               + -((1 - epsilon) * rho_p * has) / sink;
   }
 
@@ -647,6 +745,52 @@ void Breakthrough::computeFirstDerivatives(std::vector<double> &dqdt,
   dTdt[Ngrid] = 0.0;
 }
 
+// Non isothermal: backward-Euler step of the axial heat conduction, dT/dt = (K_z / sink) d^2T/dx^2, applied to the
+// explicit estimate Tnew in place. The inlet temperature is fixed and the last grid point follows the one before it,
+// so the unknowns are T[1..Ngrid-1] with the tridiagonal rows
+//   -r[i] T[i-1] + (1 + 2 r[i]) T[i] - r[i] T[i+1] = Tnew[i],   r[i] = dt K_z / (sink[i] dx^2)
+// of which the last one becomes -r T[Ngrid-2] + (1 + r) T[Ngrid-1] (zero gradient at the outlet).
+void Breakthrough::computeImplicitConduction()
+{
+  if(Ngrid < 2) return;
+
+  double idx2 = 1.0 / (dx * dx);
+
+  // forward sweep of the Thomas algorithm
+  double previousC = 0.0;
+  double previousD = Tnew[0];
+  for(size_t i = 1; i < Ngrid; ++i)
+  {
+    double ptot = 0.0;
+    for(size_t j = 0; j < Ncomp; ++j)
+    {
+      ptot += Pnew[i * Ncomp + j];
+    }
+    double Ct = ptot / (R * Tnew[i]);
+    double sink = epsilon * C_pg * Ct + (1.0 - epsilon) * (C_ps * rho_p);
+    double r = dt * K_z * idx2 / sink;
+
+    double lower = -r;
+    double diagonal = (i == Ngrid - 1) ? 1.0 + r : 1.0 + 2.0 * r;
+    double upper = (i == Ngrid - 1) ? 0.0 : -r;
+
+    double denominator = diagonal - lower * previousC;
+    conductionScratchC[i] = upper / denominator;
+    conductionScratchD[i] = (Tnew[i] - lower * previousD) / denominator;
+
+    previousC = conductionScratchC[i];
+    previousD = conductionScratchD[i];
+  }
+
+  // back substitution
+  Tnew[Ngrid - 1] = conductionScratchD[Ngrid - 1];
+  for(size_t i = Ngrid - 2; i >= 1; --i)
+  {
+    Tnew[i] = conductionScratchD[i] - conductionScratchC[i] * Tnew[i + 1];
+  }
+  Tnew[Ngrid] = Tnew[Ngrid - 1];
+}
+
 // calculate new velocity Vnew from Qnew, Qeqnew, Pnew, Pt
 void Breakthrough::computeVelocity()
 {
@@ -95,6 +95,14 @@ struct Breakthrough
     std::vector<double> cachedP0;  // cached hypothetical pressure
     std::vector<double> cachedPsi; // cached reduced grand potential over the column
 
+    // Non isothermal: temperature-adjusted isotherms per grid point, refreshed when the temperature there changes
+    std::vector<TemperatureFactors> temperatureFactors; // per grid point, [i * Ncomp * maxIsothermTerms + site * Ncomp + id]
+    std::vector<double> factorTemperature;              // temperature of the factors at every grid point
+
+    // Non isothermal: pure-component loadings along the column at the local temperatures, written to 'column.data'
+    std::vector<double> purePressures;  // partial pressures of one component at every grid point
+    std::vector<double> pureLoadings;   // per component, [j * (Ngrid + 1) + i]
+
     // Max: Properties and Parameters
     double K_z;                        // Thermal conductivity of gas [J/mol/K]
     double C_ps;                      // Heat capacity of adsorbent [J/kg/K]
@@ -110,6 +118,11 @@ struct Breakthrough
     std::vector<double> del_H;     // Delta Heat of components [mol/kg]
     double T_ref;
 
+    // Non isothermal: axial heat conduction by an implicit (backward Euler) step after the explicit SSP-RK step,
+    // which removes the diffusion-number limit dt < sink dx^2 / (2 K_z) on the time step
+    std::vector<double> conductionScratchC; // Thomas algorithm: modified upper diagonal
+    std::vector<double> conductionScratchD; // Thomas algorithm: modified right-hand side
+
     enum class IntegrationScheme
     {
       SSP_RK = 0,
@@ -127,8 +140,14 @@ struct Breakthrough
 
     void computeTemperature();
 
+    void computeImplicitConduction();
+
     void computeEquilibriumLoadings();
 
+    void updateTemperatureFactors(size_t i, double temperature);
+
+    void computePureComponentLoadings(size_t j, double *loadings);
+
     void computeVelocity();
 
     void createMovieScriptColumnV();
@@ -5,6 +5,7 @@
 #include <iostream>
 #include <sstream>
 #include <fstream>
+#include <algorithm>
 
 bool caseInSensStringCompare(const std::string& str1, const std::string& str2)
 {
@@ -530,8 +531,10 @@ InputReader::InputReader(const std::string fileName):
         {
           throw std::runtime_error("Error: Sips requires three parameters");
         }
-        values.resize(3);
-        Isotherm isotherm = Isotherm(Isotherm::Type::Sips, values, 3);
+        // Non isothermal: optional fourth parameter E [J/mol], van 't Hoff temperature dependence of b
+        size_t numberOfValues = std::min(values.size(), size_t{4});
+        values.resize(numberOfValues);
+        Isotherm isotherm = Isotherm(Isotherm::Type::Sips, values, numberOfValues);
         components[numberOfComponents - 1].isotherm.add(isotherm);
         continue;
       }
@@ -542,8 +545,10 @@ InputReader::InputReader(const std::string fileName):
         {
           throw std::runtime_error("Error: Langmuir-Freundlich requires three parameters");
         }
-        values.resize(3);
-        Isotherm isotherm = Isotherm(Isotherm::Type::Langmuir_Freundlich, values, 3);
+        // Non isothermal: optional fourth parameter E [J/mol], van 't Hoff temperature dependence of b
+        size_t numberOfValues = std::min(values.size(), size_t{4});
+        values.resize(numberOfValues);
+        Isotherm isotherm = Isotherm(Isotherm::Type::Langmuir_Freundlich, values, numberOfValues);
         components[numberOfComponents - 1].isotherm.add(isotherm);
         continue;
       }
@@ -566,8 +571,10 @@ InputReader::InputReader(const std::string fileName):
         {
           throw std::runtime_error("Error: Toth requires three parameters");
         }
-        values.resize(3);
-        Isotherm isotherm = Isotherm(Isotherm::Type::Toth, values, 3);
+        // Non isothermal: optional fourth parameter E [J/mol], van 't Hoff temperature dependence of b
+        size_t numberOfValues = std::min(values.size(), size_t{4});
+        values.resize(numberOfValues);
+        Isotherm isotherm = Isotherm(Isotherm::Type::Toth, values, numberOfValues);
         components[numberOfComponents - 1].isotherm.add(isotherm);
         continue;
       }
@@ -632,6 +639,49 @@ InputReader::InputReader(const std::string fileName):
         continue;
       }
 
+      // Non isothermal: temperature dependence of the saturation capacity of the last isotherm site of the component
+      if (caseInSensStringCompare(keyword, "SaturationTemperatureDependence"))
+      {
+        if(components[numberOfComponents - 1].isotherm.sites.empty())
+        {
+          throw std::runtime_error("Error: SaturationTemperatureDependence must follow an isotherm at line: " +
+                                   std::to_string(lineNumber));
+        }
+        Isotherm &site = components[numberOfComponents - 1].isotherm.sites.back();
+        if(!site.hasTemperatureDependentSaturation())
+        {
+          throw std::runtime_error("Error: SaturationTemperatureDependence at line: " + std::to_string(lineNumber) +
+                                   " only applies to Langmuir, Sips, Langmuir-Freundlich and Toth isotherms");
+        }
+
+        std::string str;
+        double chi, referenceTemperature;
+        std::istringstream ss(arguments);
+        if (ss >> str >> chi >> referenceTemperature)
+        {
+          if(referenceTemperature <= 0.0)
+          {
+            throw std::runtime_error("Error: SaturationTemperatureDependence reference temperature must be positive "
+                                     "(Use e.g.: 'SaturationTemperatureDependence Exponential 0.5 298.15')");
+          }
+          site.saturationCoefficient = chi;
+          site.referenceTemperature = referenceTemperature;
+          if (caseInSensStringCompare(str, "Linear"))
+          {
+            site.saturationDependence = Isotherm::SaturationDependence::Linear;
+            continue;
+          }
+          if (caseInSensStringCompare(str, "Exponential"))
+          {
+            site.saturationDependence = Isotherm::SaturationDependence::Exponential;
+            continue;
+          }
+        }
+        throw std::runtime_error("Error: unknown SaturationTemperatureDependence at line: " +
+                                 std::to_string(lineNumber) +
+                                 " (Use e.g.: 'SaturationTemperatureDependence Exponential 0.5 298.15')");
+      }
+
       if(!(startsWith(keyword, "//") || startsWith(keyword, "#")))
       {
         std::cout << "Error: unknown keyword (" << keyword << ") with arguments (" << arguments << ")" << std::endl;
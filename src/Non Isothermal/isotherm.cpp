@@ -141,9 +141,103 @@ std::string Isotherm::repr() const
     default:
       break;
   }
+
+  // Non isothermal: temperature dependence
+  if(affinityEnergy() != 0.0 && type != Isotherm::Type::Langmuir)
+  {
+    s += "        E:     " + std::to_string(affinityEnergy()) + " [J/mol]\n";
+  }
+  switch(saturationDependence)
+  {
+    case SaturationDependence::Linear:
+      s += "        q_sat(T) = q_sat (1 + chi (T - T_ref)), chi: " + std::to_string(saturationCoefficient) +
+           " [1/K], T_ref: " + std::to_string(referenceTemperature) + " [K]\n";
+      break;
+    case SaturationDependence::Exponential:
+      s += "        q_sat(T) = q_sat exp(chi (1 - T / T_ref)), chi: " + std::to_string(saturationCoefficient) +
+           " [-], T_ref: " + std::to_string(referenceTemperature) + " [K]\n";
+      break;
+    default:
+      break;
+  }
   return s;
 }
 
+// Non isothermal: the batched loadings with the switch on the type taken out of the loop; 'factorsAt(i)' gives the
+// temperature factors at grid point i and is only called for the temperature-dependent models
+template <typename FactorsAt>
+static void addAdjustedValues(const Isotherm &isotherm, const double *pressures, FactorsAt factorsAt, double *loadings,
+                              size_t n)
+{
+  const std::vector<double> &parameters = isotherm.parameters;
+  switch(isotherm.type)
+  {
+    case Isotherm::Type::Langmuir:
+    {
+      for(size_t i = 0; i < n; ++i)
+      {
+        TemperatureFactors factors = factorsAt(i);
+        double temp = parameters[1] * factors.affinity * pressures[i];
+        loadings[i] += parameters[0] * factors.saturation * temp / (1.0 + temp);
+      }
+      break;
+    }
+    case Isotherm::Type::Sips:
+    {
+      const double exponent = 1.0 / parameters[2];
+      for(size_t i = 0; i < n; ++i)
+      {
+        TemperatureFactors factors = factorsAt(i);
+        double temp = std::pow(parameters[1] * factors.affinity * pressures[i], exponent);
+        loadings[i] += parameters[0] * factors.saturation * temp / (1.0 + temp);
+      }
+      break;
+    }
+    case Isotherm::Type::Langmuir_Freundlich:
+    {
+      for(size_t i = 0; i < n; ++i)
+      {
+        TemperatureFactors factors = factorsAt(i);
+        double temp = parameters[1] * factors.affinity * std::pow(pressures[i], parameters[2]);
+        loadings[i] += parameters[0] * factors.saturation * temp / (1.0 + temp);
+      }
+      break;
+    }
+    case Isotherm::Type::Toth:
+    {
+      const double exponent = 1.0 / parameters[2];
+      for(size_t i = 0; i < n; ++i)
+      {
+        TemperatureFactors factors = factorsAt(i);
+        double temp = parameters[1] * factors.affinity * pressures[i];
+        loadings[i] += parameters[0] * factors.saturation * temp / std::pow(1.0 + std::pow(temp, parameters[2]), exponent);
+      }
+      break;
+    }
+    default:
+    {
+      // the other models do not depend on the temperature
+      const TemperatureFactors none{};
+      for(size_t i = 0; i < n; ++i)
+      {
+        loadings[i] += isotherm.adjustedValue(pressures[i], none);
+      }
+      break;
+    }
+  }
+}
+
+void Isotherm::addValues(const double *pressures, double *loadings, size_t n) const
+{
+  addAdjustedValues(*this, pressures, [](size_t) { return TemperatureFactors{}; }, loadings, n);
+}
+
+void Isotherm::addValues(const double *pressures, const double *temperatures, double *loadings, size_t n) const
+{
+  addAdjustedValues(*this, pressures, [this, temperatures](size_t i) { return temperatureFactors(temperatures[i]); },
+                    loadings, n);
+}
+
 bool Isotherm::isUnphysical() const
 {
   switch(type)
@@ -29,6 +29,18 @@ constexpr double Runiv = 8.31446261815324;
 // parameter 0: K
 // parameter 1: N
 // parameter 2: power
+//
+// Non isothermal: the affinity b of the Langmuir, Sips, Langmuir-Freundlich and Toth models follows van 't Hoff,
+// b(T) = b0 exp(-E / (R T)), with E the last parameter (parameter 2 for Langmuir, the optional parameter 3 for the
+// others). The saturation capacity of these models can in addition depend linearly, q_sat (1 + chi (T - T_ref)), or
+// exponentially, q_sat exp(chi (1 - T / T_ref)), on the temperature.
+
+// Non isothermal: the temperature-dependent factors of the affinity and the saturation capacity of an isotherm site
+struct TemperatureFactors
+{
+  double affinity{1.0};
+  double saturation{1.0};
+};
 
 struct Isotherm
 {
@@ -74,16 +86,122 @@ struct Isotherm
   std::vector<double> parameters;
   size_t numberOfParameters;
 
+  // Non isothermal: optional temperature dependence of the saturation capacity of this site
+  enum class SaturationDependence
+  {
+    None = 0,
+    Linear = 1,
+    Exponential = 2
+  };
+  SaturationDependence saturationDependence{ SaturationDependence::None };
+  double saturationCoefficient{ 0.0 };      // chi [1/K] (linear) or [-] (exponential)
+  double referenceTemperature{ 298.15 };    // T_ref [K]
+
   std::string repr() const;
 
+  // Non isothermal: the energy E [J/mol] of the van 't Hoff affinity, zero for models without temperature dependence
+  inline double affinityEnergy() const
+  {
+    switch(type)
+    {
+      case Isotherm::Type::Langmuir:
+        return numberOfParameters > 2 ? parameters[2] : 0.0;
+      case Isotherm::Type::Sips:
+      case Isotherm::Type::Langmuir_Freundlich:
+      case Isotherm::Type::Toth:
+        return numberOfParameters > 3 ? parameters[3] : 0.0;
+      default:
+        return 0.0;
+    }
+  }
+
+  // Non isothermal: whether the saturation capacity of the model is scaled by the temperature factors, only the
+  // Langmuir, Sips, Langmuir-Freundlich and Toth models have one
+  inline bool hasTemperatureDependentSaturation() const
+  {
+    switch(type)
+    {
+      case Isotherm::Type::Langmuir:
+      case Isotherm::Type::Sips:
+      case Isotherm::Type::Langmuir_Freundlich:
+      case Isotherm::Type::Toth:
+        return true;
+      default:
+        return false;
+    }
+  }
+
+  // Non isothermal: the temperature-dependent factors of the affinity and the saturation capacity. They only change
+  // with the temperature, so a column computes them once per grid point when the temperature there changes and the
+  // mixture prediction uses the 'adjusted' functions below.
+  inline TemperatureFactors temperatureFactors(double temperature) const
+  {
+    TemperatureFactors factors;
+    double energy = affinityEnergy();
+    if(energy != 0.0)
+    {
+      factors.affinity = std::exp(-energy / (Runiv * temperature));
+    }
+    switch(saturationDependence)
+    {
+      case SaturationDependence::Linear:
+        factors.saturation = 1.0 + saturationCoefficient * (temperature - referenceTemperature);
+        break;
+      case SaturationDependence::Exponential:
+        factors.saturation = std::exp(saturationCoefficient * (1.0 - temperature / referenceTemperature));
+        break;
+      default:
+        break;
+    }
+    return factors;
+  }
+
+  // Non isothermal: the isotherm with unit temperature factors, i.e. the pre-exponential affinity and the saturation
+  // capacity at the reference temperature, for the code shared with the isothermal model (fitting, MultiSiteIsotherm)
+  inline double value(double pressure) const
+  {
+    return adjustedValue(pressure, TemperatureFactors{});
+  }
+
+  inline double psiForPressure(double pressure) const
+  {
+    return adjustedPsiForPressure(pressure, TemperatureFactors{});
+  }
+
+  inline double inversePressureForPsi(double reduced_grand_potential, double &cachedP0) const
+  {
+    return adjustedInversePressureForPsi(reduced_grand_potential, cachedP0, TemperatureFactors{});
+  }
+
+  void addValues(const double *pressures, double *loadings, size_t n) const;
+
   inline double value(double pressure, double temperature) const
+  {
+    return adjustedValue(pressure, temperatureFactors(temperature));
+  }
+
+  inline double psiForPressure(double pressure, double temperature) const
+  {
+    return adjustedPsiForPressure(pressure, temperatureFactors(temperature));
+  }
+
+  inline double inversePressureForPsi(double reduced_grand_potential, double &cachedP0, double temperature) const
+  {
+    return adjustedInversePressureForPsi(reduced_grand_potential, cachedP0, temperatureFactors(temperature));
+  }
+
+  // Non isothermal: adds the loadings at n grid points with pressures 'pressures' and temperatures 'temperatures'
+  void addValues(const double *pressures, const double *temperatures, double *loadings, size_t n) const;
+
+  // Non isothermal: the loading for the given temperature factors (see 'temperatureFactors')
+  inline double adjustedValue(double pressure, const TemperatureFactors &factors) const
   { switch(type)
     {
       case Isotherm::Type::Langmuir:
       {
         // Non isothermal: temperature dependent computation of langmuir model
-        double temp = parameters[1] * std::exp(-parameters[2] / (Runiv * temperature)) * pressure;
-        return parameters[0] * temp / (1.0 + temp);
+        double temp = parameters[1] * factors.affinity * pressure;
+        return parameters[0] * factors.saturation * temp / (1.0 + temp);
       }
       case Isotherm::Type::Anti_Langmuir:
       {
@@ -104,13 +222,13 @@ struct Isotherm
       }
       case Isotherm::Type::Sips:
       {
-        double temp = std::pow(parameters[1] * pressure, 1.0 / parameters[2]);
-        return parameters[0] * temp / (1.0 + temp);
+        double temp = std::pow(parameters[1] * factors.affinity * pressure, 1.0 / parameters[2]);
+        return parameters[0] * factors.saturation * temp / (1.0 + temp);
       }
       case Isotherm::Type::Langmuir_Freundlich:
       {
-        double temp = parameters[1] * std::pow(pressure, parameters[2]);
-        return parameters[0] * temp / (1.0 + temp);
+        double temp = parameters[1] * factors.affinity * std::pow(pressure, parameters[2]);
+        return parameters[0] * factors.saturation * temp / (1.0 + temp);
       }
       case Isotherm::Type::Redlich_Peterson:
       {
@@ -118,8 +236,8 @@ struct Isotherm
       }
       case Isotherm::Type::Toth:
       {
-        double temp = parameters[1] * pressure;
-        return parameters[0] * temp / std::pow(1.0 + std::pow(temp, parameters[2]), 1.0 / parameters[2]);
+        double temp = parameters[1] * factors.affinity * pressure;
+        return parameters[0] * factors.saturation * temp / std::pow(1.0 + std::pow(temp, parameters[2]), 1.0 / parameters[2]);
       }
       case Isotherm::Type::Unilan:
       {
@@ -155,14 +273,14 @@ struct Isotherm
     }
   }
 
-  // the reduced grand potential psi (spreading pressure) for this pressure
-  inline double psiForPressure(double pressure, double temperature) const
+  // the reduced grand potential psi (spreading pressure) for this pressure and temperature factors
+  inline double adjustedPsiForPressure(double pressure, const TemperatureFactors &factors) const
   {
     switch(type)
     {
       case Isotherm::Type::Langmuir:
       {
-        return parameters[0] * std::log(1.0 + parameters[1] * std::exp(-parameters[2] / (Runiv * temperature)) * pressure);
+        return parameters[0] * factors.saturation * std::log(1.0 + parameters[1] * factors.affinity * pressure);
       }
       case Isotherm::Type::Anti_Langmuir:
       {
@@ -184,11 +302,13 @@ struct Isotherm
       }
       case Isotherm::Type::Sips:
       {
-        return parameters[2] * parameters[0] * std::log(1.0 + std::pow(parameters[1] * pressure, 1.0/parameters[2]));
+        return parameters[2] * parameters[0] * factors.saturation *
+               std::log(1.0 + std::pow(parameters[1] * factors.affinity * pressure, 1.0/parameters[2]));
       }
       case Isotherm::Type::Langmuir_Freundlich:
       {
-        return (parameters[0] / parameters[2]) * std::log(1.0 + parameters[1] * std::pow(pressure, parameters[2]));
+        return (parameters[0] * factors.saturation / parameters[2]) *
+               std::log(1.0 + parameters[1] * factors.affinity * std::pow(pressure, parameters[2]));
       }
       case Isotherm::Type::Redlich_Peterson:
       {
@@ -216,13 +336,14 @@ struct Isotherm
       }
       case Isotherm::Type::Toth:
       {
-        double temp = parameters[1] * pressure;
+        double q_sat = parameters[0] * factors.saturation;
+        double temp = parameters[1] * factors.affinity * pressure;
         double theta = temp / std::pow(1.0 + std::pow(temp, parameters[2]), 1.0 / parameters[2]);
         double theta_pow = std::pow(theta, parameters[2]);
-        double psi = parameters[0] * (theta - (theta / parameters[2]) * std::log(1.0-theta_pow));
+        double psi = q_sat * (theta - (theta / parameters[2]) * std::log(1.0-theta_pow));
 
         // use the first 100 terms of the sum
-        double temp1 = parameters[0] * theta;
+        double temp1 = q_sat * theta;
         double temp2 = 0.0;
         for(size_t k = 1; k <= 100; ++k)
         {
@@ -266,8 +387,8 @@ struct Isotherm
         std::vector<double> R1(max_steps), R2(max_steps); // buffers
         double *Rp = &R1[0], *Rc = &R2[0]; // Rp is previous row, Rc is current row
         double h = pressure - start; //step size
-        // Non isothermal: Added temperature argument
-        Rp[0] = (value(start, temperature)/start + value(pressure, temperature) / pressure)*h*0.5; // first trapezoidal step
+        // Non isothermal: Added temperature-factors argument
+        Rp[0] = (adjustedValue(start, factors)/start + adjustedValue(pressure, factors) / pressure)*h*0.5; // first trapezoidal step
 
         for (size_t i = 1; i < max_steps; ++i)
         {
@@ -276,8 +397,8 @@ struct Isotherm
           size_t ep = size_t{1} << (i-1); //2^(n-1)
           for (size_t j = 1; j <= ep; ++j)
           {
-            // Non isothermal: Added temperature argument
-             c += value(start + static_cast<double>(2*j-1)*h, temperature) / (start + static_cast<double>(2*j-1)*h);
+            // Non isothermal: Added temperature-factors argument
+             c += adjustedValue(start + static_cast<double>(2*j-1)*h, factors) / (start + static_cast<double>(2*j-1)*h);
           }
           Rc[0] = h*c + 0.5*Rp[0]; // R(i,0)
 
@@ -303,15 +424,16 @@ struct Isotherm
     }
   }
 
-  inline double inversePressureForPsi(double reduced_grand_potential, double &cachedP0, double temperature) const
+  inline double adjustedInversePressureForPsi(double reduced_grand_potential, double &cachedP0,
+                                              const TemperatureFactors &factors) const
   {
     switch(type)
     {
       case Isotherm::Type::Langmuir:
       {
         // Non isothermal: added temperature dependency
-        double denominator = std::exp(reduced_grand_potential / parameters[0]) - 1.0;
-        return parameters[1] * std::exp(-parameters[2] / (Runiv * temperature)) / denominator;
+        double denominator = std::exp(reduced_grand_potential / (parameters[0] * factors.saturation)) - 1.0;
+        return parameters[1] * factors.affinity / denominator;
       }
       case Isotherm::Type::Anti_Langmuir:
       {
@@ -328,13 +450,13 @@ struct Isotherm
       }
       case Isotherm::Type::Sips:
       {
-        return parameters[1] / std::pow((std::exp(reduced_grand_potential/
-                (parameters[2] * parameters[0])) - 1.0), parameters[2]);
+        return parameters[1] * factors.affinity / std::pow((std::exp(reduced_grand_potential/
+                (parameters[2] * parameters[0] * factors.saturation)) - 1.0), parameters[2]);
       }
       case Isotherm::Type::Langmuir_Freundlich:
       {
-        double denominator = std::exp(reduced_grand_potential * parameters[2] / parameters[0]) - 1.0;
-        return std::pow(parameters[1] / denominator, 1.0 / parameters[2]);
+        double denominator = std::exp(reduced_grand_potential * parameters[2] / (parameters[0] * factors.saturation)) - 1.0;
+        return std::pow(parameters[1] * factors.affinity / denominator, 1.0 / parameters[2]);
       }
       default:
       {
@@ -353,7 +475,7 @@ struct Isotherm
         }
 
         // use bisection algorithm
-        double s = psiForPressure(p_start, temperature);
+        double s = adjustedPsiForPressure(p_start, factors);
 
         size_t nr_steps = 0;
         double left_bracket = p_start;
@@ -365,7 +487,7 @@ struct Isotherm
           do
           {
             right_bracket *= 2.0;
-            s = psiForPressure(right_bracket, temperature);
+            s = adjustedPsiForPressure(right_bracket, factors);
 
             ++nr_steps;
             if(nr_steps>100000)
@@ -386,7 +508,7 @@ struct Isotherm
           do
           {
             left_bracket *= 0.5;
-            s = psiForPressure(left_bracket, temperature);
+            s = adjustedPsiForPressure(left_bracket, factors);
 
             ++nr_steps;
             if(nr_steps>100000)
@@ -405,7 +527,7 @@ struct Isotherm
         do
         {
           double middle = 0.5 * (left_bracket + right_bracket);
-          s = psiForPressure(middle, temperature);
+          s = adjustedPsiForPressure(middle, factors);
 
           if(s > reduced_grand_potential)
              right_bracket = middle;
@@ -0,0 +1,10 @@
+// Non isothermal: the mixture prediction kernels for the temperature factors of a grid point
+// (see mixture_prediction_temperature.h)
+
+#include "mixture_prediction_temperature.h"
+
+#include "mixture_prediction_kernels.h"
+
+template std::pair<size_t, size_t> MixturePrediction::predictMixture<TemperatureAdjustedIsotherms>(
+    const TemperatureAdjustedIsotherms &isotherms, const std::vector<double> &Yi, const double &P,
+    std::vector<double> &Xi, std::vector<double> &Ni, double *cachedP0, double *cachedPsi);
@@ -0,0 +1,103 @@
+#pragma once
+
+// Non isothermal: the mixture prediction for the temperature of a grid point. The column caches the temperature
+// factors of every isotherm site per grid point (Breakthrough::updateTemperatureFactors) and the IAST, SIAST and
+// explicit-isotherm kernels of MixturePrediction evaluate the sites with the 'adjusted' isotherm functions for those
+// factors, so the exponentials of the temperature are only computed when the temperature at a grid point changes.
+
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+#include "mixture_prediction.h"
+#include "multi_site_isotherm.h"
+
+// Non isothermal: the isotherm of a component with the temperature factors of its sites at a grid point
+struct AdjustedIsotherm
+{
+  const MultiSiteIsotherm &isotherm;
+  const TemperatureFactors *factors;  // the factors of site k are factors[k * stride]
+  size_t stride;
+
+  inline double value(double pressure) const
+  {
+    double sum = 0.0;
+    for (size_t k = 0; k < isotherm.numberOfSites; ++k)
+    {
+      sum += isotherm.sites[k].adjustedValue(pressure, factors[k * stride]);
+    }
+    return sum;
+  }
+
+  inline double value(size_t site, double pressure) const
+  {
+    if (site < isotherm.numberOfSites)
+    {
+      return isotherm.sites[site].adjustedValue(pressure, factors[site * stride]);
+    }
+    return 0.0;
+  }
+
+  inline double psiForPressure(double pressure) const
+  {
+    double sum = 0.0;
+    for (size_t k = 0; k < isotherm.numberOfSites; ++k)
+    {
+      sum += isotherm.sites[k].adjustedPsiForPressure(pressure, factors[k * stride]);
+    }
+    return sum;
+  }
+
+  inline double psiForPressure(size_t site, double pressure) const
+  {
+    if (site < isotherm.numberOfSites)
+    {
+      return isotherm.sites[site].adjustedPsiForPressure(pressure, factors[site * stride]);
+    }
+    return 0.0;
+  }
+
+  inline double inversePressureForPsi(double reduced_grand_potential, double &cachedP0) const
+  {
+    if (isotherm.numberOfSites == 1)
+    {
+      return inversePressureForPsi(0, reduced_grand_potential, cachedP0);
+    }
+    return inversePressureForPsiBisection([this](double pressure) { return psiForPressure(pressure); },
+                                          reduced_grand_potential, cachedP0);
+  }
+
+  inline double inversePressureForPsi(size_t site, double reduced_grand_potential, double &cachedP0) const
+  {
+    if (site < isotherm.numberOfSites)
+    {
+      return isotherm.sites[site].adjustedInversePressureForPsi(reduced_grand_potential, cachedP0,
+                                                                factors[site * stride]);
+    }
+    return 0.0;
+  }
+};
+
+// Non isothermal: the isotherm accessor of the mixture prediction kernels (see PlainIsotherms) for the temperature
+// factors of a grid point, factors[site * stride + id]
+struct TemperatureAdjustedIsotherms
+{
+  const TemperatureFactors *factors;
+  size_t stride;
+
+  AdjustedIsotherm isotherm(const Component &component) const
+  {
+    return {component.isotherm, factors + component.id, stride};
+  }
+
+  IsothermStore::LangmuirSite langmuirSite(const IsothermStore::LangmuirSite &site) const
+  {
+    const TemperatureFactors &f = factors[site.site * stride + site.id];
+    return {site.saturation * f.saturation, site.affinity * f.affinity, site.id, site.site};
+  }
+};
+
+// instantiated in mixture_prediction_temperature.cpp
+extern template std::pair<size_t, size_t> MixturePrediction::predictMixture<TemperatureAdjustedIsotherms>(
+    const TemperatureAdjustedIsotherms &isotherms, const std::vector<double> &Yi, const double &P,
+    std::vector<double> &Xi, std::vector<double> &Ni, double *cachedP0, double *cachedPsi);
@@ -7,11 +7,13 @@
 namespace py = pybind11;
 
 #include "breakthrough.h"
+#include "breakthrough_batch.h"
 #include "component.h"
 #include "fitting.h"
 #include "isotherm.h"
 #include "mixture_prediction.h"
 #include "multi_site_isotherm.h"
+#include "snapshot_file.h"
 
 PYBIND11_MODULE(_ruptura, m)
 {
@@ -37,9 +39,36 @@ PYBIND11_MODULE(_ruptura, m)
       .def("getComponentsParameters", &Breakthrough::getComponentsParameters)
       .def("setComponentsParameters", &Breakthrough::setComponentsParameters)
       .def("compute", &Breakthrough::compute)
+      .def("advance", &Breakthrough::advance)
+      .def("setExplicitTiling", &Breakthrough::setExplicitTiling)
       .def("__repr__", &Breakthrough::repr);
+  py::class_<BreakthroughBatch>(m, "BreakthroughBatch")
+      .def(py::init<const Breakthrough &, py::array_t<double, py::array::c_style | py::array::forcecast>,
+                    py::array_t<double, py::array::c_style | py::array::forcecast>>())
+      .def("scenarios", &BreakthroughBatch::scenarios)
+      .def("compute", &BreakthroughBatch::compute);
   py::class_<Fitting>(m, "Fitting")
       .def(py::init<std::string, std::vector<Component>, std::vector<std::vector<double>>, size_t>())
       .def("evaluate", &Fitting::evaluate)
+      .def("evaluateParameterSets",
+           py::overload_cast<size_t, py::array_t<double, py::array::c_style | py::array::forcecast>,
+                             py::array_t<double, py::array::c_style | py::array::forcecast>>(
+               &Fitting::evaluateParameterSets))
       .def("compute", &Fitting::compute);
+  py::class_<SnapshotWriter>(m, "SnapshotWriter")
+      .def(py::init<std::string, size_t, size_t, size_t, size_t>())
+      .def("append", &SnapshotWriter::appendArray)
+      .def("close", &SnapshotWriter::close)
+      .def("frames", &SnapshotWriter::frames);
+  py::class_<SnapshotReader>(m, "SnapshotReader")
+      .def(py::init<std::string>())
+      .def("frames", &SnapshotReader::frames)
+      .def("rows", &SnapshotReader::rows)
+      .def("columns", &SnapshotReader::columns)
+      .def("compressed", &SnapshotReader::compressed)
+      .def("columnNames", &SnapshotReader::columnNames)
+      .def("snapshot", &SnapshotReader::snapshotView)
+      .def("column", &SnapshotReader::columnValues)
+      .def("timeSeries", &SnapshotReader::timeSeriesValues)
+      .def("array", &SnapshotReader::view);
 }
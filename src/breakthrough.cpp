@@ -1,1526 +1,3127 @@
-/*
- *	Summary of changes:
- *
- *		Sundials CVode objects are initialized within breakthrough::initialize()
- *
- *		A function "getDerivatives()" is added to provide the derivatives of Q and P to the Sundials CVode solver
- * */
-
-#include <cmath>
-#include <string>
-#include <iostream>
-#include <fstream>
-#include <limits>
-#include <algorithm>
-#include <numeric>
-#include <sstream>
-
-
-#if __cplusplus >= 201703L && __has_include(<filesystem>)
-  #include <filesystem>
-#elif __cplusplus >= 201703L && __has_include(<experimental/filesystem>)
-  #include <experimental/filesystem>
-#else
-  #include <sys/stat.h>
-#endif
-
-#include "breakthrough.h"
-
-const double R=8.31446261815324;
-
-inline double maxVectorDifference(const std::vector<double> &v, const std::vector<double> &w	)
-{
-
-  if(v.empty() || w.empty()) return 0.0;
-  if(v.size() != w.size()) throw std::runtime_error("Error: unequal vector size\n");
-
-  double max = std::abs(v[0] - w[0]);
-  for(size_t i = 1; i < v.size(); ++i)
-  {
-    double temp = std::abs(v[i] - w[i]);
-    if(temp > max) max = temp;
-  }
-  return max;
-}
-
-
-// allow std::pairs to be added
-template <typename T,typename U>                                                   
-std::pair<T,U> operator+(const std::pair<T,U> & l,const std::pair<T,U> & r) {   
-    return {l.first+r.first,l.second+r.second};
-}
-template <typename T, typename U>
-std::pair<T,U> &operator+=(std::pair<T,U> & l, const std::pair<T,U> & r) {
-
-    l.first += r.first;
-    l.second += r.second;
-    return l;
-
-}
-
-Breakthrough::Breakthrough(const InputReader &inputReader):
-    displayName(inputReader.displayName),
-    components(inputReader.components),
-    carrierGasComponent(inputReader.carrierGasComponent),
-    Ncomp(components.size()),
-    Ngrid(inputReader.numberOfGridPoints),
-    printEvery(inputReader.printEvery),
-    writeEvery(inputReader.writeEvery),
-    T(inputReader.temperature),
-    p_total(inputReader.totalPressure),
-    dptdx(inputReader.pressureGradient),
-    epsilon(inputReader.columnVoidFraction),
-    rho_p(inputReader.particleDensity),
-    v_in(inputReader.columnEntranceVelocity),
-    L(inputReader.columnLength),
-    dx(L / static_cast<double>(Ngrid)),
-    dt(inputReader.timeStep),
-    Nsteps(inputReader.numberOfTimeSteps),
-    autoSteps(inputReader.autoNumberOfTimeSteps),
-    pulse(inputReader.pulseBreakthrough),
-    tpulse(inputReader.pulseTime),
-    mixture(inputReader),
-    maxIsothermTerms(inputReader.maxIsothermTerms),
-    prefactor(Ncomp),
-    Yi(Ncomp),
-    Xi(Ncomp),
-    Ni(Ncomp),
-    V(Ngrid+1),
-    Vnew(Ngrid+1),
-    Pt(Ngrid+1),
-    P((Ngrid + 1) * Ncomp),
-    Pnew((Ngrid + 1) * Ncomp),
-    Q((Ngrid + 1) * Ncomp),
-    Qnew((Ngrid + 1) * Ncomp),
-    Qeq((Ngrid + 1) * Ncomp),
-    Qeqnew((Ngrid + 1) * Ncomp),
-    Dpdt((Ngrid + 1) * Ncomp),
-    Dpdtnew((Ngrid + 1) * Ncomp),
-    Dqdt((Ngrid + 1) * Ncomp),
-    Dqdtnew((Ngrid + 1) * Ncomp),
-    cachedP0((Ngrid + 1) * Ncomp * maxIsothermTerms),
-    cachedPsi((Ngrid + 1) * maxIsothermTerms)
-{
-}
-
-Breakthrough::Breakthrough(std::string _displayName, std::vector<Component> _components, size_t _carrierGasComponent,
-                           size_t _numberOfGridPoints, size_t _printEvery, size_t _writeEvery, double _temperature,
-                           double _p_total, double _columnVoidFraction, double _pressureGradient,
-                           double _particleDensity, double _columnEntranceVelocity, double _columnLength,
-                           double _timeStep, size_t _numberOfTimeSteps, bool _autoSteps, bool _pulse, double _pulseTime,
-                           const MixturePrediction _mixture)
-    : displayName(_displayName),
-      components(normalize_molfracs(_components)),
-      carrierGasComponent(_carrierGasComponent),
-      Ncomp(_components.size()),
-      Ngrid(_numberOfGridPoints),
-      printEvery(_printEvery),
-      writeEvery(_writeEvery),
-      T(_temperature),
-      p_total(_p_total),
-      dptdx(_pressureGradient),
-      epsilon(_columnVoidFraction),
-      rho_p(_particleDensity),
-      v_in(_columnEntranceVelocity),
-      L(_columnLength),
-      dx(L / static_cast<double>(Ngrid)),
-      dt(_timeStep),
-      Nsteps(_numberOfTimeSteps),
-      autoSteps(_autoSteps),
-      pulse(_pulse),
-      tpulse(_pulseTime),
-      mixture(_mixture),
-      maxIsothermTerms(mixture.maxIsothermTerms),
-      prefactor(Ncomp),
-      Yi(Ncomp),
-      Xi(Ncomp),
-      Ni(Ncomp),
-      V(Ngrid + 1),
-      Vnew(Ngrid + 1),
-      Pt(Ngrid + 1),
-      P((Ngrid + 1) * Ncomp),
-      Pnew((Ngrid + 1) * Ncomp),
-      Q((Ngrid + 1) * Ncomp),
-      Qnew((Ngrid + 1) * Ncomp),
-      Qeq((Ngrid + 1) * Ncomp),
-      Qeqnew((Ngrid + 1) * Ncomp),
-      Dpdt((Ngrid + 1) * Ncomp),
-      Dpdtnew((Ngrid + 1) * Ncomp),
-      Dqdt((Ngrid + 1) * Ncomp),
-      Dqdtnew((Ngrid + 1) * Ncomp),
-      cachedP0((Ngrid + 1) * Ncomp * maxIsothermTerms),
-      cachedPsi((Ngrid + 1) * maxIsothermTerms)
-{
-  // normally ran in main.cpp, now run by default
-  initialize();
-}
-
-// Get derivatives of sundials solution vector u (Q and P)
-static int getDerivatives( sunrealtype t, N_Vector u, N_Vector udot, void* user_data){
-
-	auto *breakthrough = reinterpret_cast<Breakthrough*>(user_data);
-	breakthrough->numCalls++; // Increment number of calls to this function
-
-	// Get the size of each of the two components inside u
-	const size_t vecLen = breakthrough->Qnew.size();
-	sunrealtype *const udata  = N_VGetArrayPointer(u);
-	sunrealtype *const Qdata = udata;											// Pointer to start of storage of Q
-	sunrealtype *const Pdata = udata + vecLen;						// Pointer to start of storage of P
-	// Copy most recently computed results into the solver's vector
-	std::copy(Qdata, Qdata + vecLen, breakthrough->Qnew.begin() );
-	std::copy(Pdata, Pdata + vecLen, breakthrough->Pnew.begin() );
-
-	// Compute new equilibrium loadings and velocity via the breakthrough object
-	breakthrough->computeEquilibriumLoadings();
-	breakthrough->computeVelocity();
-
-	// Vector containing the time derivative of u (Q and P)
-	sunrealtype *const dudtData = N_VGetArrayPointer(udot);
-	sunrealtype *const dQdtData = dudtData;							// pointer to storage of derivative of Q
-	sunrealtype *const dPdtData = dudtData + vecLen;		// pointer to storage of derivative of P
-
-	// Compute derivatives via the breakthrough object
-	breakthrough->computeFirstDerivatives(breakthrough->Dqdt,breakthrough->Dpdt,
-																				breakthrough->Qeqnew, breakthrough->Qnew,
-																				breakthrough->Vnew, breakthrough->Pnew);
-
-	// Copy the results into the "udot" vector
-	std::copy( breakthrough->Dqdt.begin(), breakthrough->Dqdt.end(), dQdtData );
-	std::copy( breakthrough->Dpdt.begin(), breakthrough->Dpdt.end(), dPdtData );
-
-	return 0;
-}
-
-
-void Breakthrough::initialize()
-{
-  // precomputed factor for mass transfer
-  for(size_t j = 0; j < Ncomp; ++j)
-  {
-    prefactor[j] = R * T * ((1.0 - epsilon) / epsilon) * rho_p * components[j].Kl;
-  }
-
-  // set P and Q to zero
-  std::fill(P.begin(), P.end(), 0.0);
-  std::fill(Q.begin(), Q.end(), 0.0);
-
-  // initial pressure along the column
-  std::vector<double> pt_init(Ngrid + 1);
-
-  // set the initial total pressure along the column assuming the pressure gradient is constant
-  for(size_t i = 0; i < Ngrid + 1; ++i)
-  {
-    pt_init[i] = p_total + dptdx * static_cast<double>(i) * dx;
-  }
-
-  // initialize the interstitial gas velocity in the column
-  for(size_t i = 0; i < Ngrid + 1; ++i)
-  {
-    V[i] = v_in * p_total / pt_init[i];
-  }
-
-  // set the partial pressure of the carrier gas to the total initial pressure
-  // for the column except for the entrance (i=0)
-  for(size_t i = 1; i < Ngrid + 1; ++i)
-  {
-    P[i * Ncomp + carrierGasComponent] = pt_init[i];
-  }
-
-  // at the column entrance, the mol-fractions of the components in the gas phase are fixed
-  // the partial pressures of the components at the entrance are the mol-fractions times the 
-  // total pressure
-  for(size_t j = 0; j < Ncomp; ++j)
-  {
-    P[0 * Ncomp + j] = p_total * components[j].Yi0;
-  }
-
-  // at the entrance: mol-fractions Yi are the gas-phase mol-fractions
-  // for the column: the initial mol-fraction of the carrier-gas is 1, and 0 for the other components
-  //
-  // the K of the carrier gas is chosen as zero 
-  // so Qeq is zero for all components in the column after the entrance
-  // only the values for Yi at the entrance are effected by adsorption
-  for(size_t i = 0; i < Ngrid + 1; ++i)
-  {
-    double sum = 0.0;
-    for(size_t j = 0; j < Ncomp; ++j)
-    {
-      Yi[j] = std::max(P[i * Ncomp + j] / pt_init[i], 0.0);
-      sum += Yi[j];
-    }
-    for(size_t j = 0; j < Ncomp; ++j)
-    {
-      Yi[j] /= sum;
-    }
-
-    iastPerformance += mixture.predictMixture(Yi, pt_init[i], Xi, Ni,
-        &cachedP0[i * Ncomp * maxIsothermTerms], &cachedPsi[i * maxIsothermTerms]);
-
-    for(size_t j = 0; j < Ncomp; ++j)
-    {
-      Qeq[i * Ncomp + j] = Ni[j];
-    }
-  }
-
-  for(size_t i = 0; i < Ngrid + 1; ++i)
-  {
-    Pt[i] = 0.0;
-    for(size_t j = 0; j < Ncomp; ++j)
-    {
-      Pt[i] += std::max(0.0, P[i * Ncomp + j]);
-    }
-  }
-
-	// initialize sundials objects would be better as another member func
-	// Create required sundials object
-	SUNContext_Create( SUN_COMM_NULL, &sunContext );
-
-	SUNLogger_Create( SUN_COMM_NULL, 0, &sunLogger );
-	SUNContext_SetLogger( sunContext, sunLogger );
-
-	// Create a vector which stores both Q and P for inside the solver
-	const size_t vecLen = ( Ngrid + 1 ) * Ncomp;
-	const size_t totalLen = 2 * vecLen; // both P and Q are of vecLen
-	u = N_VNew_Serial( static_cast<sunindextype>(totalLen), sunContext );
-
-	sunrealtype *udata = N_VGetArrayPointer( u );
-	sunrealtype *Qdata = udata;												// First half of the u vector that should store Q
-	sunrealtype *Pdata = udata + vecLen;							// Second half of the u vector that should store P
-
-	// Copy initial states from Q and P to the sundial's vector
-	std::copy(Q.begin(), Q.end(), Qdata);
-	std::copy(P.begin(), P.end(), Pdata);
-
-	// Set memory location of cvode's storage in cvodeMem and assign a solver:
-	// CV_BDF (backwards differentiation formula) is used here which is a solver used for stiff equations
-	// sundials also offers CV_ADAMS which is the Adams-Moulton family that is used for non-stiff equations
-	cvodeMem = CVodeCreate( CV_BDF, sunContext );
-
-	// Set the maximum order of convergence for the solver: maximum is 5 for the BDF solver.
-	// Up until order 2, the BDF scheme is A-stable.
-	// However, the CVode solver is variable order meaning it should be able to change to a lower order scheme if
-	// stability issues are found by its checks. For higher order (>2) schemes the areas of instability on the left plane
-	// are on the border close to the origin but not at the origin itself. Hence, small eigenvalues L with
-	// Re(L)<0 and Im(L)=/=0 could technically cause instability.
-	CVodeSetMaxOrd( cvodeMem, 5 );
-
-	// Maximum internal steps of the solver within a given timestep
-	CVodeSetMaxNumSteps( cvodeMem, 1e6 );
-	// Allow the solver to access the breakthrough object
-	CVodeSetUserData(cvodeMem, this );
-
-	// Set initial conditions with initial state of u (Q and P) and t
-	// and provide the func that returns derivatives of u (Q and P)
-	CVodeInit( cvodeMem, getDerivatives, 0.0, u );
-
-	// Set relative and absolute tolerances for the sundials solver
-	const sunrealtype relTol = 1.e-8;
-	const sunrealtype absTol = 1.e-5;
-	CVodeSStolerances( cvodeMem, relTol, absTol );
-
-	// Set the non linear solver to a modified Newton iteration and the linear solver that it uses to a dense matrix solver.
-	solver = SUNNonlinSol_Newton( u, sunContext );
-	CVodeSetNonlinearSolver( cvodeMem, solver );
-	A = SUNDenseMatrix(totalLen, totalLen, sunContext );
-	linSolver = SUNLinSol_Dense(u, A, sunContext);
-	CVodeSetLinearSolver( cvodeMem, linSolver, A );
-	CVodeSetJacFn(cvodeMem, nullptr );
-}
-
-void Breakthrough::run( bool impl )
-{
-	implicit = impl;
-  // create the output files
-  std::vector<std::ofstream> streams;
-  for (size_t i = 0; i < Ncomp; i++)
-  {
-    std::string fileName = "component_" + std::to_string(i) + "_" + components[i].name + ".data";
-    streams.emplace_back(std::ofstream{fileName});
-  }
-
-  std::ofstream movieStream("column.data");
-
-  size_t column_nr = 1;
-  movieStream << "# column " << column_nr++ << ": z  (column position)\n";
-  movieStream << "# column " << column_nr++ << ": V  (velocity)\n";
-  movieStream << "# column " << column_nr++ << ": Pt (total pressure)\n";
-  for (size_t j = 0; j < Ncomp; ++j)
-  {
-    movieStream << "# column " << column_nr++ << ": component " << j << " Q     (loading) \n";
-    movieStream << "# column " << column_nr++ << ": component " << j << " Qeq   (equilibrium loading)\n";
-    movieStream << "# column " << column_nr++ << ": component " << j << " P     (partial pressure)\n";
-    movieStream << "# column " << column_nr++ << ": component " << j << " Pnorm (normalized partial pressure)\n";
-    movieStream << "# column " << column_nr++ << ": component " << j << " Dpdt  (derivative P with t)\n";
-    movieStream << "# column " << column_nr++ << ": component " << j << " Dqdt  (derivative Q with tn\n";
-  }
-
-	// For the implicit solver, set a bigger timestep as the solver can internally decide internal timesteps.
-	if( impl ){
-		double dtNew = 10.0;
-		double conv  = dt / dtNew;
-		Nsteps = std::max( (size_t)1, (size_t) ( (double) Nsteps  * conv ) );
-		writeEvery = std::max( (size_t)1, (size_t) ( (double) writeEvery  * conv ) );
-		dt = dtNew;
-	}
-
-	std::cout << "dt: " << dt << " Nsteps:  " << Nsteps << " writeEvery: " << writeEvery << std::endl;
-
-  //for (size_t step = 0; (step < Nsteps || autoSteps); ++step)
-	for (size_t step = 0; (step < writeEvery * 1000 + 1); ++step)
-  {
-    // compute new step
-    computeStep(step);
-
-    double t = static_cast<double>(step) * dt;
-
-    if (step % writeEvery == 0)
-    {
-
-			std::cout << "step: " << step << " t: " << step * dt << std::endl;
-      // write breakthrough output to files
-      // column 1: dimensionless time
-      // column 2: time [minutes]
-      // column 3: normalized partial pressure
-      for (size_t j = 0; j < Ncomp; ++j)
-      {
-        streams[j] << t * v_in / L << " " << t / 60.0 << " "
-                   << P[Ngrid * Ncomp + j] / ((p_total + dptdx * L) * components[j].Yi0) << std::endl;
-      }
-
-      for (size_t i = 0; i < Ngrid + 1; ++i)
-      {
-        movieStream << static_cast<double>(i) * dx << " ";
-        movieStream << V[i] << " ";
-        movieStream << Pt[i] << " ";
-        for (size_t j = 0; j < Ncomp; ++j)
-        {
-          movieStream << Q[i * Ncomp + j] << " " << Qeq[i * Ncomp + j] << " " << P[i * Ncomp + j] << " "
-                      << P[i * Ncomp + j] / (Pt[i] * components[j].Yi0) << " " << Dpdt[i * Ncomp + j] << " "
-                      << Dqdt[i * Ncomp + j] << " ";
-        }
-        movieStream << "\n";
-      }
-      movieStream << "\n\n";
-    }
-
-    if (step % printEvery == 0)
-    {
-      std::cout << "Timestep " + std::to_string(step) + ", time: " + std::to_string(t) + " [s]\n";
-      std::cout << "    Average number of mixture-prediction steps: " +
-                       std::to_string(static_cast<double>(iastPerformance.first) /
-                                      static_cast<double>(iastPerformance.second))
-                << std::endl;
-    }
-  }
-
-  std::cout << "Final timestep " + std::to_string(Nsteps) +
-                   ", time: " + std::to_string(dt * static_cast<double>(Nsteps)) + " [s]\n";
-}
-
-void Breakthrough::computeStep(size_t step)
-{
-  double t = static_cast<double>(step) * dt;
-	double nextTime = static_cast<double>(step + 1) * dt;
-
-  // check if we can set the expected end-time based on 10% longer time than when all
-  // adorbed mol-fractions are smaller than 1% of unity
-  if (autoSteps)
-  {
-    double tolerance = 0.0;
-    for (size_t j = 0; j < Ncomp; ++j)
-    {
-      tolerance =
-          std::max(tolerance, std::abs((P[Ngrid * Ncomp + j] / ((p_total + dptdx * L) * components[j].Yi0)) - 1.0));
-    }
-
-    // consider 1% as being visibily indistinguishable from 'converged'
-    // use a 10% longer time for display purposes
-    if (tolerance < 0.01)
-    {
-      std::cout << "\nConvergence criteria reached, running 10% longer\n\n" << std::endl;
-      Nsteps = static_cast<size_t>(1.1 * static_cast<double>(step));
-      autoSteps = false;
-    }
-  }
-
-	if( !implicit )
-	{
-		// SSP-RK Step 1
-		// ======================================================================
-
-		// calculate the derivatives Dq/dt and Dp/dt based on Qeq, Q, V, and P
-		computeFirstDerivatives( Dqdt, Dpdt, Qeq, Q, V, P );
-
-		// Dqdt and Dpdt are calculated at old time step
-		// make estimate for the new loadings and new gas phase partial pressures
-		// first iteration is made using the Explicit Euler scheme
-		for ( size_t i = 0; i < Ngrid + 1; ++i ) {
-			for ( size_t j = 0; j < Ncomp; ++j ) {
-				Qnew[i * Ncomp + j] = Q[i * Ncomp + j] + dt * Dqdt[i * Ncomp + j];
-				Pnew[i * Ncomp + j] = P[i * Ncomp + j] + dt * Dpdt[i * Ncomp + j];
-			}
-		}
-
-		computeEquilibriumLoadings();
-
-		computeVelocity();
-
-		// SSP-RK Step 2
-		// ======================================================================
-
-		// calculate new derivatives at new (current) timestep
-		// calculate the derivatives Dq/dt and Dp/dt based on Qeq, Q, V, and P at new (current) timestep
-		computeFirstDerivatives( Dqdtnew, Dpdtnew, Qeqnew, Qnew, Vnew, Pnew );
-
-		for ( size_t i = 0; i < Ngrid + 1; ++i ) {
-			for ( size_t j = 0; j < Ncomp; ++j ) {
-				Qnew[i * Ncomp + j] = 0.75 * Q[i * Ncomp + j] + 0.25 * Qnew[i * Ncomp + j] + 0.25 * dt * Dqdtnew[i * Ncomp + j];
-				Pnew[i * Ncomp + j] = 0.75 * P[i * Ncomp + j] + 0.25 * Pnew[i * Ncomp + j] + 0.25 * dt * Dpdtnew[i * Ncomp + j];
-			}
-		}
-
-		computeEquilibriumLoadings();
-
-		computeVelocity();
-
-		// SSP-RK Step 3
-		// ======================================================================
-
-		// calculate new derivatives at new (current) timestep
-		// calculate the derivatives Dq/dt and Dp/dt based on Qeq, Q, V, and P at new (current) timestep
-		computeFirstDerivatives( Dqdtnew, Dpdtnew, Qeqnew, Qnew, Vnew, Pnew );
-
-		for ( size_t i = 0; i < Ngrid + 1; ++i ) {
-			for ( size_t j = 0; j < Ncomp; ++j ) {
-				Qnew[i * Ncomp + j] = ( 1.0 / 3.0 ) * Q[i * Ncomp + j] + ( 2.0 / 3.0 ) * Qnew[i * Ncomp + j] +
-															( 2.0 / 3.0 ) * dt * Dqdtnew[i * Ncomp + j];
-				Pnew[i * Ncomp + j] = ( 1.0 / 3.0 ) * P[i * Ncomp + j] + ( 2.0 / 3.0 ) * Pnew[i * Ncomp + j] +
-															( 2.0 / 3.0 ) * dt * Dpdtnew[i * Ncomp + j];
-			}
-		}
-
-		computeEquilibriumLoadings();
-
-		computeVelocity();
-	} else { // if implicit
-		numCalls = 0;									// Track number of calls for the derivative function to see what CVode is doing
-		sunrealtype tReturn = t;			// Later assigned the time the solver has reached, but not further used
-
-		// Solve from this timestep to the next: "nextTime"
-		CVode( cvodeMem, nextTime, u, &tReturn, CV_NORMAL );
-		std::cout << "num calls: " << numCalls << std::endl;
-
-	}
-
-  // update to the new time step
-  std::copy(Qnew.begin(), Qnew.end(), Q.begin());
-  std::copy(Pnew.begin(), Pnew.end(), P.begin());
-  std::copy(Qeqnew.begin(), Qeqnew.end(), Qeq.begin());
-  std::copy(Vnew.begin(), Vnew.end(), V.begin());
-
-  // pulse boundary condition
-  if (pulse == true)
-  {
-    if (t > tpulse)
-    {
-      for (size_t j = 0; j < Ncomp; ++j)
-      {
-        if (j == carrierGasComponent)
-        {
-          P[0 * Ncomp + j] = p_total;
-        }
-        else
-        {
-          P[0 * Ncomp + j] = 0.0;
-        }
-      }
-    }
-  }
-}
-
-void Breakthrough::computeEquilibriumLoadings()
-{
-    // calculate new equilibrium loadings Qeqnew corresponding to the new timestep
-  for(size_t i = 0; i < Ngrid + 1; ++i)
-  {
-    // estimation of total pressure Pt at each grid point from partial pressures
-    Pt[i] = 0.0;
-    for(size_t j = 0; j < Ncomp; ++j)
-    {
-      Pt[i] += std::max(0.0, Pnew[i * Ncomp + j]);
-    }
-
-    // compute gas-phase mol-fractions
-    // force the gas-phase mol-fractions to be positive and normalized
-    double sum = 0.0;
-    for(size_t j = 0; j < Ncomp; ++j)
-    {
-      Yi[j] = std::max(Pnew[i * Ncomp + j], 0.0);
-      sum += Yi[j];
-    }
-    for(size_t j = 0; j < Ncomp; ++j)
-    {
-      Yi[j] /= sum;
-    }
-
-    // use Yi and Pt[i] to compute the loadings in the adsorption mixture via mixture prediction
-    iastPerformance += mixture.predictMixture(Yi, Pt[i], Xi, Ni,
-        &cachedP0[i * Ncomp * maxIsothermTerms], &cachedPsi[i * maxIsothermTerms]);
-
-    for(size_t j = 0; j < Ncomp; ++j)
-    {
-      Qeqnew[i * Ncomp + j] = Ni[j];
-    }
-  }
-
-  // check the total pressure at the outlet, it should not be negative
-//  if (Pt[0] + dptdx * L < 0.0)
-//  {
-//    throw std::runtime_error("Error: pressure gradient is too large (negative outlet pressure)\n");
-//  }
-}
-
-
-// calculate the derivatives Dq/dt and Dp/dt along the column
-void Breakthrough::computeFirstDerivatives(std::vector<double> &dqdt,
-                                           std::vector<double> &dpdt,
-                                           const std::vector<double> &q_eq,
-                                           const std::vector<double> &q,
-                                           const std::vector<double> &v,
-                                           const std::vector<double> &p)
-{
-  double idx = 1.0 / dx;
-  double idx2 = 1.0 / (dx * dx);
-
-  // first gridpoint
-  for(size_t j = 0; j < Ncomp; ++j)
-  {
-    dqdt[0 * Ncomp + j] = components[j].Kl * (q_eq[0 * Ncomp + j] - q[0 * Ncomp + j]);
-    dpdt[0 * Ncomp + j] = 0.0;
-  }
-
-  // middle gridpoints
-  for(size_t i = 1; i < Ngrid; i++)
-  {
-    for(size_t j = 0; j < Ncomp; ++j)
-    {
-      dqdt[i * Ncomp + j] = components[j].Kl * (q_eq[i * Ncomp + j] - q[i * Ncomp + j]);
-      dpdt[i * Ncomp + j] = (v[i - 1] * p[(i - 1) * Ncomp + j] - v[i] * p[i * Ncomp + j]) * idx
-                            + components[j].D * (p[(i + 1) * Ncomp + j] - 2.0 * p[i * Ncomp + j] + p[(i - 1) * Ncomp + j]) * idx2
-                            - prefactor[j] * (q_eq[i * Ncomp + j] - q[i * Ncomp + j]);
-    }
-  }
-
-  // last gridpoint
-  for(size_t j = 0; j < Ncomp; ++j)
-  {
-    dqdt[Ngrid * Ncomp + j] = components[j].Kl * (q_eq[Ngrid * Ncomp + j] - q[Ngrid * Ncomp + j]);
-    dpdt[Ngrid * Ncomp + j] = (v[Ngrid - 1] * p[(Ngrid - 1) * Ncomp + j] - v[Ngrid] * p[Ngrid * Ncomp + j]) * idx
-                              + components[j].D * (p[(Ngrid - 1) * Ncomp + j] - p[Ngrid * Ncomp + j]) * idx2
-                              - prefactor[j] * (q_eq[Ngrid * Ncomp + j] - q[Ngrid * Ncomp + j]);
-  }
-}
-
-// calculate new velocity Vnew from Qnew, Qeqnew, Pnew, Pt
-void Breakthrough::computeVelocity()
-{
-  double idx2 = 1.0 / (dx * dx);
-
-  // first grid point
-  Vnew[0] = v_in;
- 
-  // middle gridpoints
-  for(size_t i = 1; i < Ngrid; ++i)  
-  {
-    // sum = derivative at the actual gridpoint i
-    double sum = 0.0;
-    for(size_t j = 0; j < Ncomp; ++j)
-    {
-      sum = sum - prefactor[j] * (Qeqnew[i * Ncomp + j] - Qnew[i * Ncomp + j]) +
-            components[j].D * (Pnew[(i - 1) * Ncomp + j] - 2.0 * Pnew[i * Ncomp + j] + Pnew[(i + 1) * Ncomp + j]) * idx2;
-    }
-  
-    // explicit version
-    Vnew[i] = Vnew[i - 1] + dx * (sum - Vnew[i - 1] * dptdx) / Pt[i];
-  }
-  
-  // last grid point
-  double sum = 0.0;
-  for(size_t j = 0; j < Ncomp; ++j)
-  {
-    sum = sum - prefactor[j] * (Qeqnew[Ngrid * Ncomp + j] - Qnew[Ngrid * Ncomp + j]) +
-          components[j].D * (Pnew[(Ngrid - 1) * Ncomp + j] - Pnew[Ngrid * Ncomp + j]) * idx2;
-  }
-  
-  // explicit version
-  Vnew[Ngrid] = Vnew[Ngrid-1] + dx * (sum - Vnew[Ngrid - 1] * dptdx) / Pt[Ngrid];
-}
-
-std::string Breakthrough::repr() const
-{
-  std::string s;
-  s += "Column properties\n";
-  s += "=======================================================\n";
-  s += "Display-name:                          " + displayName + "\n";
-  s += "Temperature:                           " + std::to_string(T) + " [K]\n";
-  s += "Column length:                         " + std::to_string(L) + " [m]\n";
-  s += "Column void-fraction:                  " + std::to_string(epsilon) + " [-]\n";
-  s += "Particle density:                      " + std::to_string(rho_p) + " [kg/m^3]\n";
-  s += "Total pressure:                        " + std::to_string(p_total) + " [Pa]\n";
-  s += "Pressure gradient:                     " + std::to_string(dptdx) + " [Pa/m]\n";
-  s += "Column entrance interstitial velocity: " + std::to_string(v_in) + " [m/s]\n";
-  s += "\n\n";
-
-  s += "Breakthrough settings\n";
-  s += "=======================================================\n";
-  s += "Number of time steps:          " + std::to_string(Nsteps) + "\n";
-  s += "Print every step:              " + std::to_string(printEvery) + "\n";
-  s += "Write data every step:         " + std::to_string(writeEvery) + "\n";
-  s += "\n\n";
-
-  s += "Integration details\n";
-  s += "=======================================================\n";
-  s += "Time step:                     " + std::to_string(dt) + " [s]\n";
-  s += "Number of column grid points:  " + std::to_string(Ngrid) + "\n";
-  s += "Column spacing:                " + std::to_string(dx) + " [m]\n";
-  s += "\n\n";
-
-  s += "Component data\n";
-  s += "=======================================================\n";
-  s += "maximum isotherm terms:        " + std::to_string(maxIsothermTerms) + "\n";
-  for(size_t i = 0; i < Ncomp; ++i)
-  {
-    s += components[i].repr() + "\n";
-  }
-  return s;
-}
-
-void Breakthrough::createPlotScript()
-{
-  #if defined(WIN32) || defined(_WIN32) || defined(__WIN32__) || defined(__NT__)
-    std::ofstream stream_graphs("make_graphs.bat");
-    stream_graphs << "set PATH=%PATH%;C:\\Program Files\\gnuplot\\bin;C:\\Program Files\\ffmpeg-master-latest-win64-gpl\\bin;C:\\Program Files\\ffmpeg\\bin\n";
-    stream_graphs << "gnuplot.exe plot_breakthrough\n";
-  #else
-    std::ofstream stream_graphs("make_graphs");
-    stream_graphs << "#!/bin/sh\n";
-    stream_graphs << "export LC_ALL='en_US.UTF-8'\n";
-    stream_graphs << "cd -- \"$(dirname \"$0\")\"\n";
-    stream_graphs << "gnuplot plot_breakthrough\n";
-  #endif
-
-  #if (__cplusplus >= 201703L)
-    std::filesystem::path path{"make_graphs"};
-    std::filesystem::permissions(path, std::filesystem::perms::owner_exec, std::filesystem::perm_options::add);
-  #else 
-    chmod("make_graphs", S_IRWXU);
-  #endif
-
-  std::ofstream stream("plot_breakthrough");
-  stream << "set encoding utf8\n";
-  #if defined(WIN32) || defined(_WIN32) || defined(__WIN32__) || defined(__NT__)
-    stream << "set xlabel 'Dimensionless time, {/Arial-Italic τ}={/Arial-Italic tv/L} / [-]' font \"Arial,14\"\n";
-    stream << "set ylabel 'Concentration exit gas, {/Arial-Italic c}_i/{/Arial-Italic c}_{i,0} / [-]' offset 0.0,0 font \"Arial,14\"\n";
-    stream << "set key outside top center horizontal samplen 2.5 height 0.5 spacing 1.5 font 'Arial, 10'\n";
-  #else
-    stream << "set xlabel 'Dimensionless time, {/Helvetica-Italic τ}={/Helvetica-Italic tv/L} / [-]' font \"Helvetica,18\"\n";
-    stream << "set ylabel 'Concentration exit gas, {/Helvetica-Italic c}_i/{/Helvetica-Italic c}_{i,0} / [-]' offset 0.0,0 font \"Helvetica,18\"\n";
-    stream << "set key outside top center horizontal samplen 2.5 height 0.5 spacing 1.5 font 'Helvetica, 10'\n";
-  #endif
-  stream << "set bmargin 4\n";
-  stream << "set yrange[0:]\n";
-
-  stream << "set key title '" << displayName << " {/:Italic T}=" << T << " K, {/:Italic p_t}=" << p_total*1e-3 << " kPa'\n";
-
-  stream << "set output 'breakthrough_dimensionless.pdf'\n";
-  stream << "set term pdf color solid\n";
-
-  // colorscheme from book 'gnuplot in action', listing 12.7
-  stream << "set linetype 1 pt 5 ps 1 lw 4 lc rgb '0xee0000'\n";
-  stream << "set linetype 2 pt 7 ps 1 lw 4 lc rgb '0x008b00'\n";
-  stream << "set linetype 3 pt 9 ps 1 lw 4 lc rgb '0x0000cd'\n";
-  stream << "set linetype 4 pt 11 ps 1 lw 4 lc rgb '0xff3fb3'\n";
-  stream << "set linetype 5 pt 13 ps 1 lw 4 lc rgb '0x00cdcd'\n";
-  stream << "set linetype 6 pt 15 ps 1 lw 4 lc rgb '0xcd9b1d'\n";
-  stream << "set linetype 7 pt  4 ps 1 lw 4 lc rgb '0x8968ed'\n";
-  stream << "set linetype 8 pt  6 ps 1 lw 4 lc rgb '0x8b8b83'\n";
-  stream << "set linetype 9 pt  8 ps 1 lw 4 lc rgb '0x00bb00'\n";
-  stream << "set linetype 10 pt 10 ps 1 lw 4 lc rgb '0x1e90ff'\n";
-  stream << "set linetype 11 pt 12 ps 1 lw 4 lc rgb '0x8b2500'\n";
-  stream << "set linetype 12 pt 14 ps 1 lw 4 lc rgb '0x000000'\n";
-
-  stream << "ev=1\n";
-  stream << "plot \\\n";
-  for (size_t i = 0; i < Ncomp; i++)
-  {
-    std::string fileName = "component_" + std::to_string(i) + "_" + components[i].name + ".data";
-    stream << "    " << "\"" << fileName << "\"" << " us ($1):($3) every ev" << " title \""
-           << components[i].name << " (y_i=" << components[i].Yi0 << ")\""
-           << " with li lt " << i+1 << (i < Ncomp - 1 ? ",\\" : "") << "\n";
-  }
-  stream << "set output 'breakthrough.pdf'\n";
-  #if defined(WIN32) || defined(_WIN32) || defined(__WIN32__) || defined(__NT__)
-     stream << "set xlabel 'Time, {/Arial-Italic t} / [min.]' font \"Arial,14\"\n";
-  #else
-     stream << "set xlabel 'Time, {/Helvetica-Italic t} / [min.]' font \"Helvetica,18\"\n";
-  #endif
-  stream << "plot \\\n";
-  for (size_t i = 0; i < Ncomp; i++)
-  {
-    std::string fileName = "component_" + std::to_string(i) + "_" + components[i].name + ".data";
-    stream << "    " << "\"" << fileName << "\"" << " us ($2):($3) every ev" << " title \""
-           << components[i].name << " (y_i=" << components[i].Yi0 << ")\""
-           << " with li lt " << i+1 << (i < Ncomp - 1 ? ",\\" : "") << "\n";
-  }
-}
-
-void Breakthrough::createMovieScripts()
-{
-  #if defined(WIN32) || defined(_WIN32) || defined(__WIN32__) || defined(__NT__)
-    std::ofstream makeMovieStream("make_movies.bat");
-    makeMovieStream << "CALL make_movie_V.bat %1 %2 %3 %4\n";
-    makeMovieStream << "CALL make_movie_Pt.bat %1 %2 %3 %4\n";
-    makeMovieStream << "CALL make_movie_Q.bat %1 %2 %3 %4\n";
-    makeMovieStream << "CALL make_movie_Qeq.bat %1 %2 %3 %4\n";
-    makeMovieStream << "CALL make_movie_P.bat %1 %2 %3 %4\n";
-    makeMovieStream << "CALL make_movie_Pnorm.bat %1 %2 %3 %4\n";
-    makeMovieStream << "CALL make_movie_Dpdt.bat %1 %2 %3 %4\n";
-    makeMovieStream << "CALL make_movie_Dqdt.bat %1 %2 %3 %4\n";
-  #else
-    std::ofstream makeMovieStream("make_movies");
-    makeMovieStream << "#!/bin/sh\n";
-    makeMovieStream << "cd -- \"$(dirname \"$0\")\"\n";
-    makeMovieStream << "./make_movie_V \"$@\"\n";
-    makeMovieStream << "./make_movie_Pt \"$@\"\n";
-    makeMovieStream << "./make_movie_Q \"$@\"\n";
-    makeMovieStream << "./make_movie_Qeq \"$@\"\n";
-    makeMovieStream << "./make_movie_P \"$@\"\n";
-    makeMovieStream << "./make_movie_Pnorm \"$@\"\n";
-    makeMovieStream << "./make_movie_Dpdt \"$@\"\n";
-    makeMovieStream << "./make_movie_Dqdt \"$@\"\n";
-  #endif
-
-  #if (__cplusplus >= 201703L)
-    std::filesystem::path path{"make_movies"};
-    std::filesystem::permissions(path, std::filesystem::perms::owner_exec, std::filesystem::perm_options::add);
-  #else 
-    chmod("make_movies", S_IRWXU);
-  #endif
-
-  createMovieScriptColumnV();
-  createMovieScriptColumnPt();
-  createMovieScriptColumnQ();
-  createMovieScriptColumnQeq();
-  createMovieScriptColumnP();
-  createMovieScriptColumnDpdt();
-  createMovieScriptColumnDqdt();
-  createMovieScriptColumnPnormalized();
-}
-
-// -crf 18: the range of the CRF scale is 0–51, where 0 is lossless, 23 is the default, 
-//          and 51 is worst quality possible; 18 is visually lossless or nearly so.
-// -pix_fmt yuv420p: needed on apple devices
-std::string movieScriptTemplate(std::string s)
-{
-  std::ostringstream stream;
-
-  #if defined(WIN32) || defined(_WIN32) || defined(__WIN32__) || defined(__NT__)
-    stream << "del column_movie_" << s << ".mp4\n";
-    stream << "set /A argVec[1]=1\n";
-    stream << "set /A argVec[2]=1200\n";
-    stream << "set /A argVec[3]=800\n";
-    stream << "set /A argVec[4]=18\n";
-    stream << "setlocal enabledelayedexpansion\n";
-    stream << "set argCount=0\n";
-    stream << "for %%x in (%*) do (\n";
-    stream << "   set /A argCount+=1\n";
-    stream << "   set \"argVec[!argCount!]=%%~x\"'n";
-    stream << ")\n";
-    stream << "set PATH=%PATH%;C:\\Program Files\\gnuplot\\bin;C:\\Program Files\\ffmpeg-master-latest-win64-gpl\\bin;C:\\Program Files\\ffmpeg\\bin\n";
-    stream << "gnuplot.exe -c plot_column_" << s << " %argVec[1]% %argVec[2]% %argVec[3]% | ffmpeg.exe -f png_pipe -s:v \"%argVec[2]%,%argVec[3]%\" -i pipe: -c:v libx264 -pix_fmt yuv420p -crf %argVec[4]% -c:a aac column_movie_" << s + ".mp4\n";
-  #else
-    stream << "rm -f " << "column_movie_" << s << ".mp4\n";
-    stream << "every=1\n";
-    stream << "format=\"-c:v libx265 -tag:v hvc1\"\n";
-    stream << "width=1200\n";
-    stream << "height=800\n";
-    stream << "quality=18\n";
-    stream << "while getopts e:w:h:q:l flag\n";
-    stream << "do\n";
-    stream << "    case \"${flag}\" in\n";
-    stream << "        e) every=${OPTARG};;\n";
-    stream << "        w) width=${OPTARG};;\n";
-    stream << "        h) height=${OPTARG};;\n";
-    stream << "        q) quality=${OPTARG};;\n";
-    stream << "        l) format=\"-c:v libx264\";;\n";
-    stream << "    esac\n";
-    stream << "done\n";
-    stream << "gnuplot -c plot_column_" << s << " $every $width $height | ffmpeg -f png_pipe -s:v \"${width},${height}\" -i pipe: $format -pix_fmt yuv420p -crf $quality -c:a aac column_movie_" << s + ".mp4\n";
-  #endif
-  return stream.str();
-}
-
-void Breakthrough::createMovieScriptColumnV()
-{
-  #if defined(WIN32) || defined(_WIN32) || defined(__WIN32__) || defined(__NT__)
-    std::ofstream makeMovieStream("make_movie_V.bat");
-  #else
-    std::ofstream makeMovieStream("make_movie_V");
-    makeMovieStream << "#!/bin/sh\n";
-    makeMovieStream << "cd -- \"$(dirname \"$0\")\"\n";
-  #endif
-  makeMovieStream << movieScriptTemplate("V");
-
-  #if (__cplusplus >= 201703L)
-    std::filesystem::path path{"make_movie_V"};
-    std::filesystem::permissions(path, std::filesystem::perms::owner_exec, std::filesystem::perm_options::add);
-  #else
-    chmod("make_movie_V", S_IRWXU);
-  #endif
-
-  std::ofstream stream("plot_column_V");
-
-  stream << "set encoding utf8\n";
-  #if defined(WIN32) || defined(_WIN32) || defined(__WIN32__) || defined(__NT__)
-    stream << "set terminal pngcairo size ARG2,ARG3 enhanced font 'Arial,10'\n";
-    stream << "set xlabel 'Adsorber position / [m]' font 'Arial,14'\n";
-    stream << "set ylabel 'Interstitial velocity, {/Arial-Italic v} / [m/s]' offset 0.0,0 font 'Arial,14'\n";
-    stream << "set key outside top center horizontal samplen 2.5 height 0.5 spacing 1.5 font 'Arial, 10'\n";
-  #else
-    stream << "set terminal pngcairo size ARG2,ARG3 enhanced font 'Helvetica,10'\n";
-    stream << "set xlabel 'Adsorber position / [m]' font 'Helvetica,18'\n";
-    stream << "set ylabel 'Interstitial velocity, {/Helvetica-Italic v} / [m/s]' offset 0.0,0 font 'Helvetica,18'\n";
-    stream << "set key outside top center horizontal samplen 2.5 height 0.5 spacing 1.5 font 'Helvetica, 10'\n";
-  #endif
-
-  // colorscheme from book 'gnuplot in action', listing 12.7
-  stream << "set linetype 1 pt 5 ps 1 lw 4 lc rgb '0xee0000'\n";
-  stream << "set linetype 2 pt 7 ps 1 lw 4 lc rgb '0x008b00'\n";
-  stream << "set linetype 3 pt 9 ps 1 lw 4 lc rgb '0x0000cd'\n";
-  stream << "set linetype 4 pt 11 ps 1 lw 4 lc rgb '0xff3fb3'\n";
-  stream << "set linetype 5 pt 13 ps 1 lw 4 lc rgb '0x00cdcd'\n";
-  stream << "set linetype 6 pt 15 ps 1 lw 4 lc rgb '0xcd9b1d'\n";
-  stream << "set linetype 7 pt  4 ps 1 lw 4 lc rgb '0x8968ed'\n";
-  stream << "set linetype 8 pt  6 ps 1 lw 4 lc rgb '0x8b8b83'\n";
-  stream << "set linetype 9 pt  8 ps 1 lw 4 lc rgb '0x00bb00'\n";
-  stream << "set linetype 10 pt 10 ps 1 lw 4 lc rgb '0x1e90ff'\n";
-  stream << "set linetype 11 pt 12 ps 1 lw 4 lc rgb '0x8b2500'\n";
-  stream << "set linetype 12 pt 14 ps 1 lw 4 lc rgb '0x000000'\n";
-
-  stream << "set bmargin 4\n";
-  stream << "set title '" << displayName << " {/:Italic T}=" << T << " K, {/:Italic p_t}=" << p_total*1e-3 << " kPa'\n";
-  stream << "stats 'column.data' us 2 nooutput\n";
-  stream << "max=STATS_max\n";
-  stream << "stats 'column.data' us 1 nooutput\n";
-  stream << "set xrange[0:STATS_max]\n";
-  stream << "set yrange[0:1.1*max]\n";
-  stream << "ev=int(ARG1)\n";
-  stream << "do for [i=0:int((STATS_blocks-2)/ev)] {\n";
-  stream << "  plot \\\n";
-  stream << "    " << "'column.data'" << " us 1:2 index ev*i notitle with li lt 1,\\\n";
-  stream << "    " << "'column.data'" << " us 1:2 index ev*i notitle with po lt 1\n";
-  stream << "}\n";
-}
-
-
-void Breakthrough::createMovieScriptColumnPt()
-{
-  #if defined(WIN32) || defined(_WIN32) || defined(__WIN32__) || defined(__NT__)
-    std::ofstream makeMovieStream("make_movie_Pt.bat");
-  #else
-    std::ofstream makeMovieStream("make_movie_Pt");
-    makeMovieStream << "#!/bin/sh\n";
-    makeMovieStream << "cd -- \"$(dirname \"$0\")\"\n";
-  #endif
-  makeMovieStream << movieScriptTemplate("Pt");
-
-  #if (__cplusplus >= 201703L)
-    std::filesystem::path path{"make_movie_Pt"};
-    std::filesystem::permissions(path, std::filesystem::perms::owner_exec, std::filesystem::perm_options::add);
-  #else
-    chmod("make_movie_Pt", S_IRWXU);
-  #endif
-
-  std::ofstream stream("plot_column_Pt");
-
-  stream << "set encoding utf8\n";
-  #if defined(WIN32) || defined(_WIN32) || defined(__WIN32__) || defined(__NT__)
-    stream << "set terminal pngcairo size ARG2,ARG3 enhanced font 'Arial,10'\n";
-    stream << "set xlabel 'Adsorber position / [m]' font 'Arial,14'\n";
-    stream << "set ylabel 'Total Pressure, {/Arial-Italic p_t} / [Pa]' offset 0.0,0 font 'Arial,14'\n";
-    stream << "set key outside top center horizontal samplen 2.5 height 0.5 spacing 1.5 font 'Arial, 10'\n";
-  #else 
-    stream << "set terminal pngcairo size ARG2,ARG3 enhanced font 'Helvetica,10'\n";
-    stream << "set xlabel 'Adsorber position / [m]' font 'Helvetica,18'\n";
-    stream << "set ylabel 'Total Pressure, {/Helvetica-Italic p_t} / [Pa]' offset 0.0,0 font 'Helvetica,18'\n";
-    stream << "set key outside top center horizontal samplen 2.5 height 0.5 spacing 1.5 font 'Helvetica, 10'\n";
-  #endif
-
-  // colorscheme from book 'gnuplot in action', listing 12.7
-  stream << "set linetype 1 pt 5 ps 1 lw 4 lc rgb '0xee0000'\n";
-  stream << "set linetype 2 pt 7 ps 1 lw 4 lc rgb '0x008b00'\n";
-  stream << "set linetype 3 pt 9 ps 1 lw 4 lc rgb '0x0000cd'\n";
-  stream << "set linetype 4 pt 11 ps 1 lw 4 lc rgb '0xff3fb3'\n";
-  stream << "set linetype 5 pt 13 ps 1 lw 4 lc rgb '0x00cdcd'\n";
-  stream << "set linetype 6 pt 15 ps 1 lw 4 lc rgb '0xcd9b1d'\n";
-  stream << "set linetype 7 pt  4 ps 1 lw 4 lc rgb '0x8968ed'\n";
-  stream << "set linetype 8 pt  6 ps 1 lw 4 lc rgb '0x8b8b83'\n";
-  stream << "set linetype 9 pt  8 ps 1 lw 4 lc rgb '0x00bb00'\n";
-  stream << "set linetype 10 pt 10 ps 1 lw 4 lc rgb '0x1e90ff'\n";
-  stream << "set linetype 11 pt 12 ps 1 lw 4 lc rgb '0x8b2500'\n";
-  stream << "set linetype 12 pt 14 ps 1 lw 4 lc rgb '0x000000'\n";
-
-  stream << "set bmargin 4\n";
-  stream << "set title '" << displayName << " {/:Italic T}=" << T << " K, {/:Italic p_t}=" << p_total*1e-3 << " kPa'\n";
-  stream << "stats 'column.data' us 3 nooutput\n";
-  stream << "max=STATS_max\n";
-  stream << "stats 'column.data' us 1 nooutput\n";
-  stream << "set xrange[0:STATS_max]\n";
-  stream << "set yrange[0:1.1*max]\n";
-  stream << "ev=int(ARG1)\n";
-  stream << "do for [i=0:int((STATS_blocks-2)/ev)] {\n";
-  stream << "  plot \\\n";
-  stream << "    " << "'column.data'" << " us 1:3 index ev*i notitle with li lt 1,\\\n";
-  stream << "    " << "'column.data'" << " us 1:3 index ev*i notitle with po lt 1\n";
-  stream << "}\n";
-}
-
-void Breakthrough::createMovieScriptColumnQ()
-{
-  #if defined(WIN32) || defined(_WIN32) || defined(__WIN32__) || defined(__NT__)
-    std::ofstream makeMovieStream("make_movie_Q.bat");
-  #else
-    std::ofstream makeMovieStream("make_movie_Q");
-    makeMovieStream << "#!/bin/sh\n";
-    makeMovieStream << "cd -- \"$(dirname \"$0\")\"\n";
-  #endif
-  makeMovieStream << movieScriptTemplate("Q");
-
-  #if (__cplusplus >= 201703L)
-    std::filesystem::path path{"make_movie_Q"};
-    std::filesystem::permissions(path, std::filesystem::perms::owner_exec, std::filesystem::perm_options::add);
-  #else
-    chmod("make_movie_Q", S_IRWXU);
-  #endif
-
-  std::ofstream stream("plot_column_Q");
-
-  stream << "set encoding utf8\n";
-  #if defined(WIN32) || defined(_WIN32) || defined(__WIN32__) || defined(__NT__)
-    stream << "set terminal pngcairo size ARG2,ARG3 enhanced font 'Arial,10'\n";
-    stream << "set xlabel 'Adsorber position / [m]' font 'Arial,14'\n";
-    stream << "set ylabel 'Concentration, {/Arial-Italic c}_i / [mol/kg]' offset 0.0,0 font 'Arial,14'\n";
-    stream << "set key outside top center horizontal samplen 2.5 height 0.5 spacing 1.5 font 'Arial, 10'\n";
-  #else
-    stream << "set terminal pngcairo size ARG2,ARG3 enhanced font 'Helvetica,10'\n";
-    stream << "set xlabel 'Adsorber position / [m]' font 'Helvetica,18'\n";
-    stream << "set ylabel 'Concentration, {/Helvetica-Italic c}_i / [mol/kg]' offset 0.0,0 font 'Helvetica,18'\n";
-    stream << "set key outside top center horizontal samplen 2.5 height 0.5 spacing 1.5 font 'Helvetica, 10'\n";
-  #endif
-
-  // colorscheme from book 'gnuplot in action', listing 12.7
-  stream << "set linetype 1 pt 5 ps 1 lw 4 lc rgb '0xee0000'\n";
-  stream << "set linetype 2 pt 7 ps 1 lw 4 lc rgb '0x008b00'\n";
-  stream << "set linetype 3 pt 9 ps 1 lw 4 lc rgb '0x0000cd'\n";
-  stream << "set linetype 4 pt 11 ps 1 lw 4 lc rgb '0xff3fb3'\n";
-  stream << "set linetype 5 pt 13 ps 1 lw 4 lc rgb '0x00cdcd'\n";
-  stream << "set linetype 6 pt 15 ps 1 lw 4 lc rgb '0xcd9b1d'\n";
-  stream << "set linetype 7 pt  4 ps 1 lw 4 lc rgb '0x8968ed'\n";
-  stream << "set linetype 8 pt  6 ps 1 lw 4 lc rgb '0x8b8b83'\n";
-  stream << "set linetype 9 pt  8 ps 1 lw 4 lc rgb '0x00bb00'\n";
-  stream << "set linetype 10 pt 10 ps 1 lw 4 lc rgb '0x1e90ff'\n";
-  stream << "set linetype 11 pt 12 ps 1 lw 4 lc rgb '0x8b2500'\n";
-  stream << "set linetype 12 pt 14 ps 1 lw 4 lc rgb '0x000000'\n";
-
-  stream << "set bmargin 4\n";
-  stream << "set key title '" << displayName << " {/:Italic T}=" << T << " K, {/:Italic p_t}=" << p_total*1e-3 << " kPa'\n";
-  stream << "stats 'column.data' nooutput\n";
-  stream << "max = 0.0;\n";
-  stream << "do for [i=4:STATS_columns:6] {\n";
-  stream << "  stats 'column.data' us i nooutput\n";
-  stream << "  if (max<STATS_max) {\n";
-  stream << "    max=STATS_max\n";
-  stream << "  }\n";
-  stream << "}\n";
-  stream << "stats 'column.data' us 1 nooutput\n";
-  stream << "set xrange[0:STATS_max]\n";
-  stream << "set yrange[0:1.1*max]\n";
-  stream << "ev=int(ARG1)\n";
-  stream << "do for [i=0:int((STATS_blocks-2)/ev)] {\n";
-  stream << "  plot \\\n";
-  for (size_t i = 0; i < Ncomp; i++)
-  {
-    stream << "    " << "'column.data'" << " us 1:" << std::to_string(4 + i * 6) << " index ev*i notitle "
-           << " with li lt " << i+1 << ",\\\n";
-  }
-  for (size_t i = 0; i < Ncomp; i++)
-  {
-    stream << "    " << "'column.data'" << " us 1:" << std::to_string(4 + i * 6) << " index ev*i title '"
-           << components[i].name << " (y_i=" << components[i].Yi0 << ")'"
-           << " with po lt " << i+1 << (i < Ncomp - 1 ? ",\\" : "") << "\n";
-  }
-  stream << "}\n";
-}
-
-void Breakthrough::createMovieScriptColumnQeq()
-{
-  #if defined(WIN32) || defined(_WIN32) || defined(__WIN32__) || defined(__NT__)
-    std::ofstream makeMovieStream("make_movie_Qeq.bat");
-  #else
-    std::ofstream makeMovieStream("make_movie_Qeq");
-    makeMovieStream << "#!/bin/sh\n";
-    makeMovieStream << "cd -- \"$(dirname \"$0\")\"\n";
-  #endif
-  makeMovieStream << movieScriptTemplate("Qeq");
-
-  #if (__cplusplus >= 201703L)
-    std::filesystem::path path{"make_movie_Qeq"};
-    std::filesystem::permissions(path, std::filesystem::perms::owner_exec, std::filesystem::perm_options::add);
-  #else
-    chmod("make_movie_Qeq", S_IRWXU);
-  #endif
-
-  std::ofstream stream("plot_column_Qeq");
-
-  stream << "set encoding utf8\n";
-  #if defined(WIN32) || defined(_WIN32) || defined(__WIN32__) || defined(__NT__)
-    stream << "set terminal pngcairo size ARG2,ARG3 enhanced font 'Arial,10'\n";
-    stream << "set xlabel 'Adsorber position / [m]' font 'Arial,14'\n";
-    stream << "set ylabel 'Concentration, {/Arial-Italic c}_i / [mol/kg]' offset 0.0,0 font 'Arial,14'\n";
-    stream << "set key outside top center horizontal samplen 2.5 height 0.5 spacing 1.5 font 'Arial, 10'\n";
-  #else
-    stream << "set terminal pngcairo size ARG2,ARG3 enhanced font 'Helvetica,10'\n";
-    stream << "set xlabel 'Adsorber position / [m]' font 'Helvetica,18'\n";
-    stream << "set ylabel 'Concentration, {/Helvetica-Italic c}_i / [mol/kg]' offset 0.0,0 font 'Helvetica,18'\n";
-    stream << "set key outside top center horizontal samplen 2.5 height 0.5 spacing 1.5 font 'Helvetica, 10'\n";
-  #endif
-  
-  // colorscheme from book 'gnuplot in action', listing 12.7
-  stream << "set linetype 1 pt 5 ps 1 lw 4 lc rgb '0xee0000'\n";
-  stream << "set linetype 2 pt 7 ps 1 lw 4 lc rgb '0x008b00'\n";
-  stream << "set linetype 3 pt 9 ps 1 lw 4 lc rgb '0x0000cd'\n";
-  stream << "set linetype 4 pt 11 ps 1 lw 4 lc rgb '0xff3fb3'\n";
-  stream << "set linetype 5 pt 13 ps 1 lw 4 lc rgb '0x00cdcd'\n";
-  stream << "set linetype 6 pt 15 ps 1 lw 4 lc rgb '0xcd9b1d'\n";
-  stream << "set linetype 7 pt  4 ps 1 lw 4 lc rgb '0x8968ed'\n";
-  stream << "set linetype 8 pt  6 ps 1 lw 4 lc rgb '0x8b8b83'\n";
-  stream << "set linetype 9 pt  8 ps 1 lw 4 lc rgb '0x00bb00'\n";
-  stream << "set linetype 10 pt 10 ps 1 lw 4 lc rgb '0x1e90ff'\n";
-  stream << "set linetype 11 pt 12 ps 1 lw 4 lc rgb '0x8b2500'\n";
-  stream << "set linetype 12 pt 14 ps 1 lw 4 lc rgb '0x000000'\n";
-
-  stream << "set bmargin 4\n";
-  stream << "set key title '" << displayName << " {/:Italic T}=" << T << " K, {/:Italic p_t}=" << p_total*1e-3 << " kPa'\n";
-  stream << "stats 'column.data' nooutput\n";
-  stream << "max = 0.0;\n";
-  stream << "do for [i=5:STATS_columns:6] {\n";
-  stream << "  stats 'column.data' us i nooutput\n";
-  stream << "  if (max<STATS_max) {\n";
-  stream << "    max=STATS_max\n";
-  stream << "  }\n";
-  stream << "}\n";
-  stream << "stats 'column.data' us 1 nooutput\n";
-  stream << "set xrange[0:STATS_max]\n";
-  stream << "set yrange[0:1.1*max]\n";
-  stream << "ev=int(ARG1)\n";
-  stream << "do for [i=0:int((STATS_blocks-2)/ev)] {\n";
-  stream << "  plot \\\n";
-  for (size_t i = 0; i < Ncomp; i++)
-  {
-    stream << "    " << "'column.data'" << " us 1:" << std::to_string(5 + i * 6) << " index ev*i notitle "
-           << " with li lt " << i+1 << ",\\\n";
-  }
-  for (size_t i = 0; i < Ncomp; i++)
-  {
-    stream << "    " << "'column.data'" << " us 1:" << std::to_string(5 + i * 6) << " index ev*i title '"
-           << components[i].name << " (y_i=" << components[i].Yi0 << ")'"
-           << " with po lt " << i+1 << (i < Ncomp - 1 ? ",\\" : "") << "\n";
-  }
-  stream << "}\n";
-}
-
-void Breakthrough::createMovieScriptColumnP()
-{
-  #if defined(WIN32) || defined(_WIN32) || defined(__WIN32__) || defined(__NT__)
-    std::ofstream makeMovieStream("make_movie_P.bat");
-  #else
-    std::ofstream makeMovieStream("make_movie_P");
-    makeMovieStream << "#!/bin/sh\n";
-    makeMovieStream << "cd -- \"$(dirname \"$0\")\"\n";
-  #endif
-  makeMovieStream << movieScriptTemplate("P");
-
-  #if (__cplusplus >= 201703L)
-    std::filesystem::path path{"make_movie_P"};
-    std::filesystem::permissions(path, std::filesystem::perms::owner_exec, std::filesystem::perm_options::add);
-  #else
-    chmod("make_movie_P", S_IRWXU);
-  #endif
-
-  std::ofstream stream("plot_column_P");
-
-  stream << "set encoding utf8\n";
-  #if defined(WIN32) || defined(_WIN32) || defined(__WIN32__) || defined(__NT__)
-    stream << "set terminal pngcairo size ARG2,ARG3 enhanced font 'Arial,10'\n";
-    stream << "set xlabel 'Adsorber position / [m]' font 'Arial,14'\n";
-    stream << "set ylabel 'Partial pressure, {/Arial-Italic p}_i / [Pa]' offset 0.0,0 font 'Arial,14'\n";
-    stream << "set key outside top center horizontal samplen 2.5 height 0.5 spacing 1.5 font 'Arial, 10'\n";
-  #else
-    stream << "set terminal pngcairo size ARG2,ARG3 enhanced font 'Helvetica,10'\n";
-    stream << "set xlabel 'Adsorber position / [m]' font 'Helvetica,18'\n";
-    stream << "set ylabel 'Partial pressure, {/Helvetica-Italic p}_i / [Pa]' offset 0.0,0 font 'Helvetica,18'\n";
-    stream << "set key outside top center horizontal samplen 2.5 height 0.5 spacing 1.5 font 'Helvetica, 10'\n";
-  #endif
-
-  // colorscheme from book 'gnuplot in action', listing 12.7
-  stream << "set linetype 1 pt 5 ps 1 lw 4 lc rgb '0xee0000'\n";
-  stream << "set linetype 2 pt 7 ps 1 lw 4 lc rgb '0x008b00'\n";
-  stream << "set linetype 3 pt 9 ps 1 lw 4 lc rgb '0x0000cd'\n";
-  stream << "set linetype 4 pt 11 ps 1 lw 4 lc rgb '0xff3fb3'\n";
-  stream << "set linetype 5 pt 13 ps 1 lw 4 lc rgb '0x00cdcd'\n";
-  stream << "set linetype 6 pt 15 ps 1 lw 4 lc rgb '0xcd9b1d'\n";
-  stream << "set linetype 7 pt  4 ps 1 lw 4 lc rgb '0x8968ed'\n";
-  stream << "set linetype 8 pt  6 ps 1 lw 4 lc rgb '0x8b8b83'\n";
-  stream << "set linetype 9 pt  8 ps 1 lw 4 lc rgb '0x00bb00'\n";
-  stream << "set linetype 10 pt 10 ps 1 lw 4 lc rgb '0x1e90ff'\n";
-  stream << "set linetype 11 pt 12 ps 1 lw 4 lc rgb '0x8b2500'\n";
-  stream << "set linetype 12 pt 14 ps 1 lw 4 lc rgb '0x000000'\n";
-
-  stream << "set bmargin 4\n";
-  stream << "set key title '" << displayName << " {/:Italic T}=" << T << " K, {/:Italic p_t}=" << p_total*1e-3 << " kPa'\n";
-  stream << "stats 'column.data' nooutput\n";
-  stream << "max = 0.0;\n";
-  stream << "do for [i=6:STATS_columns:6] {\n";
-  stream << "  stats 'column.data' us i nooutput\n";
-  stream << "  if (max<STATS_max) {\n";
-  stream << "    max=STATS_max\n";
-  stream << "  }\n";
-  stream << "}\n";
-  stream << "stats 'column.data' us 1 nooutput\n";
-  stream << "set xrange[0:STATS_max]\n";
-  stream << "set yrange[0:1.1*max]\n";
-  stream << "ev=int(ARG1)\n";
-  stream << "do for [i=0:int((STATS_blocks-2)/ev)] {\n";
-  stream << "  plot \\\n";
-  for (size_t i = 0; i < Ncomp; i++)
-  {
-    stream << "    " << "'column.data'" << " us 1:" << std::to_string(6 + i * 6) << " index ev*i notitle "
-           << " with li lt " << i+1 << ",\\\n";
-  }
-  for (size_t i = 0; i < Ncomp; i++)
-  {
-    stream << "    " << "'column.data'" << " us 1:" << std::to_string(6 + i * 6) << " index ev*i title '"
-           << components[i].name << " (y_i=" << components[i].Yi0 << ")'"
-           << " with po lt " << i+1 << (i < Ncomp - 1 ? ",\\" : "") << "\n";
-  }
-  stream << "}\n";
-}
-
-void Breakthrough::createMovieScriptColumnPnormalized()
-{
-  #if defined(WIN32) || defined(_WIN32) || defined(__WIN32__) || defined(__NT__)
-    std::ofstream makeMovieStream("make_movie_Pnorm.bat");
-  #else
-    std::ofstream makeMovieStream("make_movie_Pnorm");
-    makeMovieStream << "#!/bin/sh\n";
-    makeMovieStream << "cd -- \"$(dirname \"$0\")\"\n";
-  #endif
-  makeMovieStream << movieScriptTemplate("Pnorm");
-
-  #if (__cplusplus >= 201703L)
-    std::filesystem::path path{"make_movie_Pnorm"};
-    std::filesystem::permissions(path, std::filesystem::perms::owner_exec, std::filesystem::perm_options::add);
-  #else
-    chmod("make_movie_Pnorm", S_IRWXU);
-  #endif
-
-  std::ofstream stream("plot_column_Pnorm");
-
-  stream << "set encoding utf8\n";
-  #if defined(WIN32) || defined(_WIN32) || defined(__WIN32__) || defined(__NT__)
-    stream << "set terminal pngcairo size ARG2,ARG3 enhanced font 'Arial,10'\n";
-    stream << "set xlabel 'Adsorber position / [m]' font 'Arial,14'\n";
-    stream << "set ylabel 'Partial pressure, {/Arial-Italic p}_i / [-]' offset 0.0,0 font 'Arial,14'\n";
-    stream << "set key outside top center horizontal samplen 2.5 height 0.5 spacing 1.5 font 'Arial, 10'\n";
-  #else
-    stream << "set terminal pngcairo size ARG2,ARG3 enhanced font 'Helvetica,10'\n";
-    stream << "set xlabel 'Adsorber position / [m]' font 'Helvetica,18'\n";
-    stream << "set ylabel 'Partial pressure, {/Helvetica-Italic p}_i / [-]' offset 0.0,0 font 'Helvetica,18'\n";
-    stream << "set key outside top center horizontal samplen 2.5 height 0.5 spacing 1.5 font 'Helvetica, 10'\n";
-  #endif
-
-  // colorscheme from book 'gnuplot in action', listing 12.7
-  stream << "set linetype 1 pt 5 ps 1 lw 4 lc rgb '0xee0000'\n";
-  stream << "set linetype 2 pt 7 ps 1 lw 4 lc rgb '0x008b00'\n";
-  stream << "set linetype 3 pt 9 ps 1 lw 4 lc rgb '0x0000cd'\n";
-  stream << "set linetype 4 pt 11 ps 1 lw 4 lc rgb '0xff3fb3'\n";
-  stream << "set linetype 5 pt 13 ps 1 lw 4 lc rgb '0x00cdcd'\n";
-  stream << "set linetype 6 pt 15 ps 1 lw 4 lc rgb '0xcd9b1d'\n";
-  stream << "set linetype 7 pt  4 ps 1 lw 4 lc rgb '0x8968ed'\n";
-  stream << "set linetype 8 pt  6 ps 1 lw 4 lc rgb '0x8b8b83'\n";
-  stream << "set linetype 9 pt  8 ps 1 lw 4 lc rgb '0x00bb00'\n";
-  stream << "set linetype 10 pt 10 ps 1 lw 4 lc rgb '0x1e90ff'\n";
-  stream << "set linetype 11 pt 12 ps 1 lw 4 lc rgb '0x8b2500'\n";
-  stream << "set linetype 12 pt 14 ps 1 lw 4 lc rgb '0x000000'\n";
-
-  stream << "set bmargin 4\n";
-  stream << "set key title '" << displayName << " {/:Italic T}=" << T << " K, {/:Italic p_t}=" << p_total*1e-3 << " kPa'\n";
-  stream << "stats 'column.data' nooutput\n";
-  stream << "max = 0.0;\n";
-  stream << "do for [i=7:STATS_columns:6] {\n";
-  stream << "  stats 'column.data' us i nooutput\n";
-  stream << "  if (max<STATS_max) {\n";
-  stream << "    max=STATS_max\n";
-  stream << "  }\n";
-  stream << "}\n";
-  stream << "stats 'column.data' us 1 nooutput\n";
-  stream << "set xrange[0:STATS_max]\n";
-  stream << "set yrange[0:1.1*max]\n";
-  stream << "ev=int(ARG1)\n";
-  stream << "do for [i=0:int((STATS_blocks-2)/ev)] {\n";
-  stream << "  plot \\\n";
-  for (size_t i = 0; i < Ncomp; i++)
-  {
-    stream << "    " << "'column.data'" << " us 1:" << std::to_string(7 + i * 6) << " index ev*i notitle "
-           << " with li lt " << i+1 << ",\\\n";
-  }
-  for (size_t i = 0; i < Ncomp; i++)
-  {
-    stream << "    " << "'column.data'" << " us 1:" << std::to_string(7 + i * 6) << " index ev*i title '"
-           << components[i].name << " (y_i=" << components[i].Yi0 << ")'"
-           << " with po lt " << i+1 << (i < Ncomp - 1 ? ",\\" : "") << "\n";
-  }
-  stream << "}\n";
-}
-
-void Breakthrough::createMovieScriptColumnDpdt()
-{
-  #if defined(WIN32) || defined(_WIN32) || defined(__WIN32__) || defined(__NT__)
-    std::ofstream makeMovieStream("make_movie_Dpdt.bat");
-  #else
-    std::ofstream makeMovieStream("make_movie_Dpdt");
-    makeMovieStream << "#!/bin/sh\n";
-    makeMovieStream << "cd -- \"$(dirname \"$0\")\"\n";
-  #endif
-  makeMovieStream << movieScriptTemplate("Dpdt");
-
-  #if (__cplusplus >= 201703L)
-    std::filesystem::path path{"make_movie_Dpdt"};
-    std::filesystem::permissions(path, std::filesystem::perms::owner_exec, std::filesystem::perm_options::add);
-  #else
-    chmod("make_movie_Dpdt", S_IRWXU);
-  #endif
-
-  std::ofstream stream("plot_column_Dpdt");
-
-  stream << "set encoding utf8\n";
-  #if defined(WIN32) || defined(_WIN32) || defined(__WIN32__) || defined(__NT__)
-    stream << "set terminal pngcairo size ARG2,ARG3 enhanced font 'Arial,10'\n";
-    stream << "set xlabel 'Adsorber position / [m]' font 'Arial,14'\n";
-    stream << "set ylabel 'Pressure derivative, {/Arial-Italic dp_/dt} / [Pa/s]' offset 0.0,0 font 'Arial,14'\n";
-    stream << "set key outside top center horizontal samplen 2.5 height 0.5 spacing 1.5 font 'Arial, 10'\n";
-  #else
-    stream << "set terminal pngcairo size ARG2,ARG3 enhanced font 'Helvetica,10'\n";
-    stream << "set xlabel 'Adsorber position / [m]' font 'Helvetica,18'\n";
-    stream << "set ylabel 'Pressure derivative, {/Helvetica-Italic dp_/dt} / [Pa/s]' offset 0.0,0 font 'Helvetica,18'\n";
-    stream << "set key outside top center horizontal samplen 2.5 height 0.5 spacing 1.5 font 'Helvetica, 10'\n";
-  #endif
-
-  // colorscheme from book 'gnuplot in action', listing 12.7
-  stream << "set linetype 1 pt 5 ps 1 lw 4 lc rgb '0xee0000'\n";
-  stream << "set linetype 2 pt 7 ps 1 lw 4 lc rgb '0x008b00'\n";
-  stream << "set linetype 3 pt 9 ps 1 lw 4 lc rgb '0x0000cd'\n";
-  stream << "set linetype 4 pt 11 ps 1 lw 4 lc rgb '0xff3fb3'\n";
-  stream << "set linetype 5 pt 13 ps 1 lw 4 lc rgb '0x00cdcd'\n";
-  stream << "set linetype 6 pt 15 ps 1 lw 4 lc rgb '0xcd9b1d'\n";
-  stream << "set linetype 7 pt  4 ps 1 lw 4 lc rgb '0x8968ed'\n";
-  stream << "set linetype 8 pt  6 ps 1 lw 4 lc rgb '0x8b8b83'\n";
-  stream << "set linetype 9 pt  8 ps 1 lw 4 lc rgb '0x00bb00'\n";
-  stream << "set linetype 10 pt 10 ps 1 lw 4 lc rgb '0x1e90ff'\n";
-  stream << "set linetype 11 pt 12 ps 1 lw 4 lc rgb '0x8b2500'\n";
-  stream << "set linetype 12 pt 14 ps 1 lw 4 lc rgb '0x000000'\n";
-
-  stream << "set bmargin 4\n";
-  stream << "set key title '" << displayName << " {/:Italic T}=" << T << " K, {/:Italic p_t}=" << p_total*1e-3 << " kPa'\n";
-  stream << "stats 'column.data' nooutput\n";
-  stream << "max = -1e10;\n";
-  stream << "min = 1e10;\n";
-  stream << "do for [i=8:STATS_columns:6] {\n";
-  stream << "  stats 'column.data' us i nooutput\n";
-  stream << "  if (STATS_max>max) {\n";
-  stream << "    max=STATS_max\n";
-  stream << "  }\n";
-  stream << "  if (STATS_min<min) {\n";
-  stream << "    min=STATS_min\n";
-  stream << "  }\n";
-  stream << "}\n";
-  stream << "stats 'column.data' us 1 nooutput\n";
-  stream << "set xrange[0:STATS_max]\n";
-  stream << "set yrange[1.1*min:1.1*max]\n";
-  stream << "ev=int(ARG1)\n";
-  stream << "do for [i=0:int((STATS_blocks-2)/ev)] {\n";
-  stream << "  plot \\\n";
-  for (size_t i = 0; i < Ncomp; i++)
-  {
-    stream << "    " << "'column.data'" << " us 1:" << std::to_string(8 + i * 6) << " index ev*i notitle "
-           << " with li lt " << i+1 << ",\\\n";
-  }
-  for (size_t i = 0; i < Ncomp; i++)
-  {
-    stream << "    " << "'column.data'" << " us 1:" << std::to_string(8 + i * 6) << " index ev*i title '"
-           << components[i].name << " (y_i=" << components[i].Yi0 << ")'"
-           << " with po lt " << i+1 << (i < Ncomp - 1 ? ",\\" : "") << "\n";
-  }
-  stream << "}\n";
-}
-
-void Breakthrough::createMovieScriptColumnDqdt()
-{
-  #if defined(WIN32) || defined(_WIN32) || defined(__WIN32__) || defined(__NT__)
-    std::ofstream makeMovieStream("make_movie_Dqdt.bat");
-  #else
-    std::ofstream makeMovieStream("make_movie_Dqdt");
-    makeMovieStream << "#!/bin/sh\n";
-    makeMovieStream << "cd -- \"$(dirname \"$0\")\"\n";
-  #endif
-  makeMovieStream << movieScriptTemplate("Dqdt");
-
-  #if (__cplusplus >= 201703L)
-    std::filesystem::path path{"make_movie_Dqdt"};
-    std::filesystem::permissions(path, std::filesystem::perms::owner_exec, std::filesystem::perm_options::add);
-  #else
-    chmod("make_movie_Dqdt", S_IRWXU);
-  #endif
-
-  std::ofstream stream("plot_column_Dqdt");
-
-  stream << "set encoding utf8\n";
-  #if defined(WIN32) || defined(_WIN32) || defined(__WIN32__) || defined(__NT__)
-    stream << "set terminal pngcairo size ARG2,ARG3 enhanced font 'Arial,10'\n";
-    stream << "set xlabel 'Adsorber position / [m]' font 'Arial,14'\n";
-    stream << "set ylabel 'Loading derivative, {/Arial-Italic dq_i/dt} / [mol/kg/s]' offset 0.0,0 font 'Arial,14'\n";
-    stream << "set key outside top center horizontal samplen 2.5 height 0.5 spacing 1.5 font 'Arial, 10'\n";
-  #else
-    stream << "set terminal pngcairo size ARG2,ARG3 enhanced font 'Helvetica,10'\n";
-    stream << "set xlabel 'Adsorber position / [m]' font 'Helvetica,18'\n";
-    stream << "set ylabel 'Loading derivative, {/Helvetica-Italic dq_i/dt} / [mol/kg/s]' offset 0.0,0 font 'Helvetica,18'\n";
-    stream << "set key outside top center horizontal samplen 2.5 height 0.5 spacing 1.5 font 'Helvetica, 10'\n";
-  #endif
-
-  // colorscheme from book 'gnuplot in action', listing 12.7
-  stream << "set linetype 1 pt 5 ps 1 lw 4 lc rgb '0xee0000'\n";
-  stream << "set linetype 2 pt 7 ps 1 lw 4 lc rgb '0x008b00'\n";
-  stream << "set linetype 3 pt 9 ps 1 lw 4 lc rgb '0x0000cd'\n";
-  stream << "set linetype 4 pt 11 ps 1 lw 4 lc rgb '0xff3fb3'\n";
-  stream << "set linetype 5 pt 13 ps 1 lw 4 lc rgb '0x00cdcd'\n";
-  stream << "set linetype 6 pt 15 ps 1 lw 4 lc rgb '0xcd9b1d'\n";
-  stream << "set linetype 7 pt  4 ps 1 lw 4 lc rgb '0x8968ed'\n";
-  stream << "set linetype 8 pt  6 ps 1 lw 4 lc rgb '0x8b8b83'\n";
-  stream << "set linetype 9 pt  8 ps 1 lw 4 lc rgb '0x00bb00'\n";
-  stream << "set linetype 10 pt 10 ps 1 lw 4 lc rgb '0x1e90ff'\n";
-  stream << "set linetype 11 pt 12 ps 1 lw 4 lc rgb '0x8b2500'\n";
-  stream << "set linetype 12 pt 14 ps 1 lw 4 lc rgb '0x000000'\n";
-
-  stream << "set bmargin 4\n";
-  stream << "set key title '" << displayName << " {/:Italic T}=" << T << " K, {/:Italic p_t}=" << p_total*1e-3 << " kPa'\n";
-  stream << "stats 'column.data' nooutput\n";
-  stream << "max = -1e10;\n";
-  stream << "min = 1e10;\n";
-  stream << "min = 10000000000000.0;\n";
-  stream << "do for [i=9:STATS_columns:6] {\n";
-  stream << "  stats 'column.data' us i nooutput\n";
-  stream << "  if (STATS_max>max) {\n";
-  stream << "    max=STATS_max\n";
-  stream << "  }\n";
-  stream << "  if (STATS_min<min) {\n";
-  stream << "    min=STATS_min\n";
-  stream << "  }\n";
-  stream << "}\n";
-  stream << "stats 'column.data' us 1 nooutput\n";
-  stream << "set xrange[0:STATS_max]\n";
-  stream << "set yrange[1.1*min:1.1*max]\n";
-  stream << "ev=int(ARG1)\n";
-  stream << "do for [i=0:int((STATS_blocks-2)/ev)] {\n";
-  stream << "  plot \\\n";
-  for (size_t i = 0; i < Ncomp; i++)
-  {
-    stream << "    " << "'column.data'" << " us 1:" << std::to_string(9 + i * 6) << " index ev*i notitle "
-           << " with li lt " << i+1 << ",\\\n";
-  }
-  for (size_t i = 0; i < Ncomp; i++)
-  {
-    stream << "    " << "'column.data'" << " us 1:" << std::to_string(9 + i * 6) << " index ev*i title '"
-           << components[i].name << " (y_i=" << components[i].Yi0 << ")'"
-           << " with po lt " << i+1 << (i < Ncomp - 1 ? ",\\" : "") << "\n";
-  }
-  stream << "}\n";
-}
-
-#ifdef PYBUILD
-py::array_t<double> Breakthrough::compute()
-{
-  size_t colsize = 6 * Ncomp + 5;
-  std::vector<std::vector<std::vector<double>>> brk;
-
-  // loop can quit early if autoSteps
-  for (size_t step = 0; (step < Nsteps || autoSteps); ++step)
-  {
-    // check for error from python side (keyboard interrupt)
-    if (PyErr_CheckSignals() != 0)
-    {
-      throw py::error_already_set();
-    }
-
-    computeStep(step);
-    double t = static_cast<double>(step) * dt;
-    if (step % writeEvery == 0)
-    {
-      std::vector<std::vector<double>> t_brk(Ngrid + 1, std::vector<double>(colsize));
-      for (size_t i = 0; i < Ngrid + 1; ++i)
-      {
-        t_brk[i][0] = t * v_in / L;
-        t_brk[i][1] = t / 60.0;
-        t_brk[i][2] = static_cast<double>(i) * dx;
-        t_brk[i][3] = V[i];
-        t_brk[i][4] = Pt[i];
-
-        for (size_t j = 0; j < Ncomp; ++j)
-        {
-          t_brk[i][5 + 6 * j] = Q[i * Ncomp + j];
-          t_brk[i][6 + 6 * j] = Qeq[i * Ncomp + j];
-          t_brk[i][7 + 6 * j] = P[i * Ncomp + j];
-          t_brk[i][8 + 6 * j] = P[i * Ncomp + j] / (Pt[i] * components[j].Yi0);
-          t_brk[i][9 + 6 * j] = Dpdt[i * Ncomp + j];
-          t_brk[i][10 + 6 * j] = Dqdt[i * Ncomp + j];
-        }
-      }
-      brk.push_back(t_brk);
-    }
-    if (step % printEvery == 0)
-    {
-      std::cout << "Timestep " + std::to_string(step) + ", time: " + std::to_string(t) + " [s]\n";
-      std::cout << "    Average number of mixture-prediction steps: " +
-                       std::to_string(static_cast<double>(iastPerformance.first) /
-                                      static_cast<double>(iastPerformance.second))
-                << "\n";
-    }
-  }
-  std::cout << "Final timestep " + std::to_string(Nsteps) +
-                   ", time: " + std::to_string(dt * static_cast<double>(Nsteps)) + " [s]\n";
-
-  std::vector<double> buffer;
-  buffer.reserve(brk.size() * (Ngrid + 1) * colsize);
-  for (const auto &vec1 : brk)
-  {
-    for (const auto &vec2 : vec1)
-    {
-      buffer.insert(buffer.end(), vec2.begin(), vec2.end());
-    }
-  }
-  std::array<size_t, 3> shape{{brk.size(), Ngrid + 1, colsize}};
-  py::array_t<double> py_breakthrough(shape, buffer.data());
-  py_breakthrough.resize(shape);
-
-  return py_breakthrough;
-}
-#endif  // PYBUILD
+/*
+ *	Summary of changes:
+ *
+ *		Sundials CVode objects are initialized within breakthrough::initialize()
+ *
+ *		A function "getDerivatives()" is added to provide the derivatives of Q and P to the Sundials CVode solver
+ * */
+
+#include <cmath>
+#include <string>
+#include <iostream>
+#include <fstream>
+#include <limits>
+#include <algorithm>
+#include <array>
+#include <numeric>
+#include <sstream>
+
+
+#if __cplusplus >= 201703L && __has_include(<filesystem>)
+  #include <filesystem>
+#elif __cplusplus >= 201703L && __has_include(<experimental/filesystem>)
+  #include <experimental/filesystem>
+#else
+  #include <sys/stat.h>
+#endif
+
+#include "breakthrough.h"
+#include "column_kernels.h"
+
+const double R=8.31446261815324;
+
+// names and descriptions of the column-profile fields, in the order of 'Breakthrough::ColumnField'
+const std::array<std::string, 8> columnFieldNames{ { "V", "Pt", "Q", "Qeq", "P", "Pnorm", "Dpdt", "Dqdt" } };
+const std::array<std::string, 8> columnFieldDescriptions{
+    { "V  (velocity)", "Pt (total pressure)", "Q     (loading) ", "Qeq   (equilibrium loading)",
+      "P     (partial pressure)", "Pnorm (normalized partial pressure)", "Dpdt  (derivative P with t)",
+      "Dqdt  (derivative Q with tn" } };
+
+// selection of the column-profile fields from their names (all fields when none are given)
+static std::array<bool, 8> columnFieldSelection(const std::vector<std::string> &names)
+{
+  std::array<bool, 8> selection{};
+  selection.fill(names.empty());
+  for (const std::string &name : names)
+  {
+    auto it = std::find(columnFieldNames.begin(), columnFieldNames.end(), name);
+    if (it == columnFieldNames.end())
+    {
+      throw std::runtime_error("Error: unknown column output field '" + name +
+                               "' (options are V, Pt, Q, Qeq, P, Pnorm, Dpdt and Dqdt)\n");
+    }
+    selection[static_cast<size_t>(it - columnFieldNames.begin())] = true;
+  }
+  return selection;
+}
+
+inline double maxVectorDifference(const std::vector<double> &v, const std::vector<double> &w	)
+{
+
+  if(v.empty() || w.empty()) return 0.0;
+  if(v.size() != w.size()) throw std::runtime_error("Error: unequal vector size\n");
+
+  double max = std::abs(v[0] - w[0]);
+  for(size_t i = 1; i < v.size(); ++i)
+  {
+    double temp = std::abs(v[i] - w[i]);
+    if(temp > max) max = temp;
+  }
+  return max;
+}
+
+
+// allow std::pairs to be added
+template <typename T,typename U>                                                   
+std::pair<T,U> operator+(const std::pair<T,U> & l,const std::pair<T,U> & r) {   
+    return {l.first+r.first,l.second+r.second};
+}
+template <typename T, typename U>
+std::pair<T,U> &operator+=(std::pair<T,U> & l, const std::pair<T,U> & r) {
+
+    l.first += r.first;
+    l.second += r.second;
+    return l;
+
+}
+
+// the fields along the column: V, Vnew and Pt, the ten fields per grid point and component, cachedP0, cachedPsi and
+// the massTransferRate of the Strang splitting
+static std::shared_ptr<FieldArena> columnFieldArena(size_t Ngrid, size_t Ncomp, size_t maxIsothermTerms)
+{
+  const size_t points = Ngrid + 1;
+  const size_t values = points * Ncomp;
+  return std::make_shared<FieldArena>(std::initializer_list<size_t>{
+      points, points, points, values, values, values, values, values, values, values, values, values, values,
+      values * maxIsothermTerms, points * maxIsothermTerms, values});
+}
+
+Breakthrough::Breakthrough(const InputReader &inputReader):
+    displayName(inputReader.displayName),
+    components(inputReader.components),
+    carrierGasComponent(inputReader.carrierGasComponent),
+    Ncomp(components.size()),
+    Ngrid(inputReader.numberOfGridPoints),
+    printEvery(inputReader.printEvery),
+    writeEvery(inputReader.writeEvery),
+    outletOnly(inputReader.outletOnly),
+    columnFields(columnFieldSelection(inputReader.columnOutputFields)),
+    columnStride(inputReader.columnOutputStride),
+    columnFormat(ColumnFormat(inputReader.columnOutputFormat)),
+    columnMantissaBits(inputReader.columnOutputMantissaBits),
+    T(inputReader.temperature),
+    p_total(inputReader.totalPressure),
+    dptdx(inputReader.pressureGradient),
+    epsilon(inputReader.columnVoidFraction),
+    rho_p(inputReader.particleDensity),
+    v_in(inputReader.columnEntranceVelocity),
+    L(inputReader.columnLength),
+    dx(L / static_cast<double>(Ngrid)),
+    dt(inputReader.timeStep),
+    Nsteps(inputReader.numberOfTimeSteps),
+    autoSteps(inputReader.autoNumberOfTimeSteps),
+    pulse(inputReader.pulseBreakthrough),
+    tpulse(inputReader.pulseTime),
+    mixture(inputReader),
+    maxIsothermTerms(inputReader.maxIsothermTerms),
+    equilibriumReuseTolerance(inputReader.equilibriumReuseTolerance),
+    equilibriumReuseCorrection(inputReader.equilibriumReuseCorrection),
+    cycleSteps(inputReader.cycleSteps),
+    numberOfCycles(inputReader.numberOfCycles),
+    cyclicSteadyStateTolerance(inputReader.cyclicSteadyStateTolerance),
+    andersonDepth(inputReader.cyclicSteadyStateAcceleration),
+    fieldArena(columnFieldArena(Ngrid, Ncomp, maxIsothermTerms)),
+    prefactor(Ncomp),
+    Yi(Ncomp),
+    Xi(Ncomp),
+    Ni(Ncomp),
+    V(Ngrid + 1, fieldAllocator()),
+    Vnew(Ngrid + 1, fieldAllocator()),
+    Pt(Ngrid + 1, fieldAllocator()),
+    P((Ngrid + 1) * Ncomp, fieldAllocator()),
+    Pnew((Ngrid + 1) * Ncomp, fieldAllocator()),
+    Q((Ngrid + 1) * Ncomp, fieldAllocator()),
+    Qnew((Ngrid + 1) * Ncomp, fieldAllocator()),
+    Qeq((Ngrid + 1) * Ncomp, fieldAllocator()),
+    Qeqnew((Ngrid + 1) * Ncomp, fieldAllocator()),
+    Dpdt((Ngrid + 1) * Ncomp, fieldAllocator()),
+    Dpdtnew((Ngrid + 1) * Ncomp, fieldAllocator()),
+    Dqdt((Ngrid + 1) * Ncomp, fieldAllocator()),
+    Dqdtnew((Ngrid + 1) * Ncomp, fieldAllocator()),
+    cachedP0((Ngrid + 1) * Ncomp * maxIsothermTerms, fieldAllocator()),
+    cachedPsi((Ngrid + 1) * maxIsothermTerms, fieldAllocator()),
+    velocityBlock((Ngrid + velocityLanes) / velocityLanes),
+    velocityScale(velocityLanes * velocityBlock, 1.0),
+    velocityShift(velocityLanes * velocityBlock, 0.0),
+    tileSize(inputReader.explicitTileSize),
+    tileSteps(inputReader.explicitTileSteps),
+    implicitIntegrator(static_cast<ImplicitIntegrator>(inputReader.implicitIntegrator)),
+    multirateRatio(inputReader.multirateRatio),
+    linearSolver(static_cast<LinearSolver>(inputReader.linearSolver)),
+    linearSolverMemoryLimit(inputReader.linearSolverMemoryLimit),
+    nonlinearSolver(static_cast<NonlinearSolver>(inputReader.nonlinearSolver)),
+    fixedPointAndersonDepth(inputReader.fixedPointAndersonDepth),
+    massTransferRate(fieldAllocator())
+{
+}
+
+// the gas-phase mol-fractions given through Python are normalized to unity, as the InputReader does for input files
+static std::vector<Component> normalize_molfracs(std::vector<Component> components)
+{
+  double sum = 0.0;
+  for (const Component &component : components)
+  {
+    sum += component.Yi0;
+  }
+  if (sum > 0.0)
+  {
+    for (Component &component : components)
+    {
+      component.Yi0 /= sum;
+    }
+  }
+  return components;
+}
+
+Breakthrough::Breakthrough(std::string _displayName, std::vector<Component> _components, size_t _carrierGasComponent,
+                           size_t _numberOfGridPoints, size_t _printEvery, size_t _writeEvery, double _temperature,
+                           double _p_total, double _columnVoidFraction, double _pressureGradient,
+                           double _particleDensity, double _columnEntranceVelocity, double _columnLength,
+                           double _timeStep, size_t _numberOfTimeSteps, bool _autoSteps, bool _pulse, double _pulseTime,
+                           const MixturePrediction _mixture)
+    : displayName(_displayName),
+      components(normalize_molfracs(_components)),
+      carrierGasComponent(_carrierGasComponent),
+      Ncomp(_components.size()),
+      Ngrid(_numberOfGridPoints),
+      printEvery(_printEvery),
+      writeEvery(_writeEvery),
+      T(_temperature),
+      p_total(_p_total),
+      dptdx(_pressureGradient),
+      epsilon(_columnVoidFraction),
+      rho_p(_particleDensity),
+      v_in(_columnEntranceVelocity),
+      L(_columnLength),
+      dx(L / static_cast<double>(Ngrid)),
+      dt(_timeStep),
+      Nsteps(_numberOfTimeSteps),
+      autoSteps(_autoSteps),
+      pulse(_pulse),
+      tpulse(_pulseTime),
+      mixture(_mixture),
+      maxIsothermTerms(mixture.getMaxIsothermTerms()),
+      fieldArena(columnFieldArena(Ngrid, Ncomp, maxIsothermTerms)),
+      prefactor(Ncomp),
+      Yi(Ncomp),
+      Xi(Ncomp),
+      Ni(Ncomp),
+      V(Ngrid + 1, fieldAllocator()),
+      Vnew(Ngrid + 1, fieldAllocator()),
+      Pt(Ngrid + 1, fieldAllocator()),
+      P((Ngrid + 1) * Ncomp, fieldAllocator()),
+      Pnew((Ngrid + 1) * Ncomp, fieldAllocator()),
+      Q((Ngrid + 1) * Ncomp, fieldAllocator()),
+      Qnew((Ngrid + 1) * Ncomp, fieldAllocator()),
+      Qeq((Ngrid + 1) * Ncomp, fieldAllocator()),
+      Qeqnew((Ngrid + 1) * Ncomp, fieldAllocator()),
+      Dpdt((Ngrid + 1) * Ncomp, fieldAllocator()),
+      Dpdtnew((Ngrid + 1) * Ncomp, fieldAllocator()),
+      Dqdt((Ngrid + 1) * Ncomp, fieldAllocator()),
+      Dqdtnew((Ngrid + 1) * Ncomp, fieldAllocator()),
+      cachedP0((Ngrid + 1) * Ncomp * maxIsothermTerms, fieldAllocator()),
+      cachedPsi((Ngrid + 1) * maxIsothermTerms, fieldAllocator()),
+      velocityBlock((Ngrid + velocityLanes) / velocityLanes),
+      velocityScale(velocityLanes * velocityBlock, 1.0),
+      velocityShift(velocityLanes * velocityBlock, 0.0),
+      massTransferRate(fieldAllocator())
+{
+  // normally ran in main.cpp, now run by default
+  initialize();
+}
+
+// Get derivatives of sundials solution vector u (Q and P)
+static int getDerivatives( sunrealtype t, N_Vector u, N_Vector udot, void* user_data){
+
+	auto *breakthrough = reinterpret_cast<Breakthrough*>(user_data);
+	breakthrough->numCalls++; // Increment number of calls to this function
+
+	// Get the size of each of the two components inside u
+	const size_t vecLen = breakthrough->Qnew.size();
+	sunrealtype *const udata  = N_VGetArrayPointer(u);
+	sunrealtype *const Qdata = udata;											// Pointer to start of storage of Q
+	sunrealtype *const Pdata = udata + vecLen;						// Pointer to start of storage of P
+	// Copy most recently computed results into the solver's vector
+	std::copy(Qdata, Qdata + vecLen, breakthrough->Qnew.begin() );
+	std::copy(Pdata, Pdata + vecLen, breakthrough->Pnew.begin() );
+
+	// Compute new equilibrium loadings and velocity via the breakthrough object
+	breakthrough->computeEquilibriumLoadings();
+	breakthrough->computeVelocity();
+
+	// Vector containing the time derivative of u (Q and P)
+	sunrealtype *const dudtData = N_VGetArrayPointer(udot);
+	sunrealtype *const dQdtData = dudtData;							// pointer to storage of derivative of Q
+	sunrealtype *const dPdtData = dudtData + vecLen;		// pointer to storage of derivative of P
+
+	// Compute derivatives via the breakthrough object
+	breakthrough->computeFirstDerivatives(breakthrough->Dqdt,breakthrough->Dpdt,
+																				breakthrough->Qeqnew, breakthrough->Qnew,
+																				breakthrough->Vnew, breakthrough->Pnew);
+
+	// Copy the results into the "udot" vector
+	std::copy( breakthrough->Dqdt.begin(), breakthrough->Dqdt.end(), dQdtData );
+	std::copy( breakthrough->Dpdt.begin(), breakthrough->Dpdt.end(), dPdtData );
+
+	return 0;
+}
+
+
+// IMEX split for ARKODE: the explicit part is the transport along the column (which needs the velocity, and
+// hence the equilibrium loadings, of the whole column)
+static int getTransportDerivatives( sunrealtype t, N_Vector u, N_Vector udot, void* user_data){
+	(void) t;
+	auto *breakthrough = reinterpret_cast<Breakthrough*>(user_data);
+	breakthrough->numCalls++;
+
+	const size_t vecLen = breakthrough->Qnew.size();
+	sunrealtype *const udata  = N_VGetArrayPointer(u);
+	std::copy(udata, udata + vecLen, breakthrough->Qnew.begin() );
+	std::copy(udata + vecLen, udata + 2 * vecLen, breakthrough->Pnew.begin() );
+
+	breakthrough->computeEquilibriumLoadings();
+	breakthrough->computeVelocity();
+	breakthrough->computeTransportDerivatives(breakthrough->Dqdt, breakthrough->Dpdt, breakthrough->Vnew, breakthrough->Pnew);
+
+	sunrealtype *const dudtData = N_VGetArrayPointer(udot);
+	std::copy( breakthrough->Dqdt.begin(), breakthrough->Dqdt.end(), dudtData );
+	std::copy( breakthrough->Dpdt.begin(), breakthrough->Dpdt.end(), dudtData + vecLen );
+
+	return 0;
+}
+
+// the implicit part is the mass transfer, which only couples the components at the same grid point
+static int getMassTransferDerivatives( sunrealtype t, N_Vector u, N_Vector udot, void* user_data){
+	(void) t;
+	auto *breakthrough = reinterpret_cast<Breakthrough*>(user_data);
+	breakthrough->numCalls++;
+
+	const size_t vecLen = breakthrough->Qnew.size();
+	sunrealtype *const udata  = N_VGetArrayPointer(u);
+	std::copy(udata, udata + vecLen, breakthrough->Qnew.begin() );
+	std::copy(udata + vecLen, udata + 2 * vecLen, breakthrough->Pnew.begin() );
+
+	breakthrough->computeEquilibriumLoadings();
+	breakthrough->computeMassTransferDerivatives(breakthrough->Dqdt, breakthrough->Dpdt, breakthrough->Qeqnew, breakthrough->Qnew);
+
+	sunrealtype *const dudtData = N_VGetArrayPointer(udot);
+	std::copy( breakthrough->Dqdt.begin(), breakthrough->Dqdt.end(), dudtData );
+	std::copy( breakthrough->Dpdt.begin(), breakthrough->Dpdt.end(), dudtData + vecLen );
+
+	return 0;
+}
+
+// multirate split for MRIStep: the slow part is the transport and the mass transfer of the slow components
+static int getSlowDerivatives( sunrealtype t, N_Vector u, N_Vector udot, void* user_data){
+	(void) t;
+	auto *breakthrough = reinterpret_cast<Breakthrough*>(user_data);
+	breakthrough->numCalls++;
+
+	const size_t vecLen = breakthrough->Qnew.size();
+	sunrealtype *const udata  = N_VGetArrayPointer(u);
+	std::copy(udata, udata + vecLen, breakthrough->Qnew.begin() );
+	std::copy(udata + vecLen, udata + 2 * vecLen, breakthrough->Pnew.begin() );
+
+	breakthrough->computeEquilibriumLoadings();
+	breakthrough->computeVelocity();
+	breakthrough->computeSlowDerivatives(N_VGetArrayPointer(udot));
+
+	return 0;
+}
+
+// the fast part is the mass transfer of the fast components, integrated with the inner (explicit) integrator
+static int getFastDerivatives( sunrealtype t, N_Vector u, N_Vector udot, void* user_data){
+	(void) t;
+	auto *breakthrough = reinterpret_cast<Breakthrough*>(user_data);
+	breakthrough->numCalls++;
+
+	const size_t vecLen = breakthrough->Qnew.size();
+	sunrealtype *const udata  = N_VGetArrayPointer(u);
+	std::copy(udata, udata + vecLen, breakthrough->Qnew.begin() );
+	std::copy(udata + vecLen, udata + 2 * vecLen, breakthrough->Pnew.begin() );
+
+	breakthrough->computeEquilibriumLoadings();
+	breakthrough->computeMassTransferDerivatives(breakthrough->Dqdt, breakthrough->Dpdt, breakthrough->Qeqnew,
+																							 breakthrough->Qnew, &breakthrough->fastComponents);
+
+	sunrealtype *const dudtData = N_VGetArrayPointer(udot);
+	std::copy( breakthrough->Dqdt.begin(), breakthrough->Dqdt.end(), dudtData );
+	std::copy( breakthrough->Dpdt.begin(), breakthrough->Dpdt.end(), dudtData + vecLen );
+
+	return 0;
+}
+
+// the Newton systems of the implicit stages are solved by GMRES, preconditioned with their exact (block-diagonal)
+// matrix; the Jacobian of the equilibrium loadings is only recomputed when ARKODE asks for it
+static int setupBlockPreconditioner( sunrealtype t, N_Vector y, N_Vector fy, sunbooleantype jok,
+																		sunbooleantype *jcurPtr, sunrealtype gamma, void *user_data){
+	(void) t;
+	(void) fy;
+	auto *breakthrough = reinterpret_cast<Breakthrough*>(user_data);
+	breakthrough->setupMassTransferPreconditioner(N_VGetArrayPointer(y), !jok, gamma);
+	*jcurPtr = jok ? SUNFALSE : SUNTRUE;
+	return 0;
+}
+
+static int solveBlockPreconditioner( sunrealtype t, N_Vector y, N_Vector fy, N_Vector r, N_Vector z,
+																		sunrealtype gamma, sunrealtype delta, int lr, void *user_data){
+	(void) t;
+	(void) y;
+	(void) fy;
+	(void) gamma;
+	(void) delta;
+	(void) lr;
+	auto *breakthrough = reinterpret_cast<Breakthrough*>(user_data);
+	breakthrough->solveMassTransferPreconditioner(N_VGetArrayPointer(r), N_VGetArrayPointer(z));
+	return 0;
+}
+
+
+void Breakthrough::initialize()
+{
+  // precomputed factor for mass transfer
+  for(size_t j = 0; j < Ncomp; ++j)
+  {
+    prefactor[j] = R * T * ((1.0 - epsilon) / epsilon) * rho_p * components[j].Kl;
+  }
+
+  // set P and Q to zero
+  std::fill(P.begin(), P.end(), 0.0);
+  std::fill(Q.begin(), Q.end(), 0.0);
+
+  // initial pressure along the column
+  std::vector<double> pt_init(Ngrid + 1);
+
+  // set the initial total pressure along the column assuming the pressure gradient is constant
+  for(size_t i = 0; i < Ngrid + 1; ++i)
+  {
+    pt_init[i] = p_total + dptdx * static_cast<double>(i) * dx;
+  }
+
+  // initialize the interstitial gas velocity in the column
+  for(size_t i = 0; i < Ngrid + 1; ++i)
+  {
+    V[i] = v_in * p_total / pt_init[i];
+  }
+
+  // set the partial pressure of the carrier gas to the total initial pressure
+  // for the column except for the entrance (i=0)
+  for(size_t i = 1; i < Ngrid + 1; ++i)
+  {
+    P[i * Ncomp + carrierGasComponent] = pt_init[i];
+  }
+
+  // at the column entrance, the mol-fractions of the components in the gas phase are fixed
+  // the partial pressures of the components at the entrance are the mol-fractions times the 
+  // total pressure
+  for(size_t j = 0; j < Ncomp; ++j)
+  {
+    P[0 * Ncomp + j] = p_total * components[j].Yi0;
+  }
+
+  // at the entrance: mol-fractions Yi are the gas-phase mol-fractions
+  // for the column: the initial mol-fraction of the carrier-gas is 1, and 0 for the other components
+  //
+  // the K of the carrier gas is chosen as zero 
+  // so Qeq is zero for all components in the column after the entrance
+  // only the values for Yi at the entrance are effected by adsorption
+  for(size_t i = 0; i < Ngrid + 1; ++i)
+  {
+    double sum = 0.0;
+    for(size_t j = 0; j < Ncomp; ++j)
+    {
+      Yi[j] = std::max(P[i * Ncomp + j] / pt_init[i], 0.0);
+      sum += Yi[j];
+    }
+    for(size_t j = 0; j < Ncomp; ++j)
+    {
+      Yi[j] /= sum;
+    }
+
+    iastPerformance += mixture.predictMixture(Yi, pt_init[i], Xi, Ni,
+        &cachedP0[i * Ncomp * maxIsothermTerms], &cachedPsi[i * maxIsothermTerms]);
+
+    for(size_t j = 0; j < Ncomp; ++j)
+    {
+      Qeq[i * Ncomp + j] = Ni[j];
+    }
+  }
+
+  for(size_t i = 0; i < Ngrid + 1; ++i)
+  {
+    Pt[i] = 0.0;
+    for(size_t j = 0; j < Ncomp; ++j)
+    {
+      Pt[i] += std::max(0.0, P[i * Ncomp + j]);
+    }
+  }
+
+	// initialize sundials objects would be better as another member func
+	// Create required sundials object
+	SUNContext_Create( SUN_COMM_NULL, &sunContext );
+
+	SUNLogger_Create( SUN_COMM_NULL, 0, &sunLogger );
+	SUNContext_SetLogger( sunContext, sunLogger );
+
+	// Create a vector which stores both Q and P for inside the solver
+	const size_t vecLen = ( Ngrid + 1 ) * Ncomp;
+	const size_t totalLen = 2 * vecLen; // both P and Q are of vecLen
+	u = N_VNew_Serial( static_cast<sunindextype>(totalLen), sunContext );
+
+	sunrealtype *udata = N_VGetArrayPointer( u );
+	sunrealtype *Qdata = udata;												// First half of the u vector that should store Q
+	sunrealtype *Pdata = udata + vecLen;							// Second half of the u vector that should store P
+
+	// Copy initial states from Q and P to the sundial's vector
+	std::copy(Q.begin(), Q.end(), Qdata);
+	std::copy(P.begin(), P.end(), Pdata);
+
+	// Strang splitting needs no SUNDIALS solver, its mass-transfer step is solved per grid point
+	if( implicitIntegrator == ImplicitIntegrator::Strang )
+	{
+		Pstage.resize(P.size());
+		massTransferRate.assign(P.size(), 0.0);
+		return;
+	}
+
+	// Multirate: components whose mass-transfer coefficient exceeds 'MultirateRatio' times the smallest one are fast;
+	// their mass transfer is substepped by an explicit inner integrator, while the transport and the slow components
+	// advance with the fixed macro step 'TimeStep' of MRIStep (limited by the transport, not by the fastest Kl)
+	if( implicitIntegrator == ImplicitIntegrator::Multirate )
+	{
+		// the carrier gas does not adsorb, its mass transfer is slow
+		double slowest = std::numeric_limits<double>::max();
+		for( size_t j = 0; j < Ncomp; ++j )
+		{
+			if( j != carrierGasComponent && components[j].Kl > 0.0 ) slowest = std::min( slowest, components[j].Kl );
+		}
+		fastComponents.resize( Ncomp );
+		slowComponents.resize( Ncomp );
+		std::cout << "Multirate: fast components:";
+		for( size_t j = 0; j < Ncomp; ++j )
+		{
+			fastComponents[j] = j != carrierGasComponent && components[j].Kl > multirateRatio * slowest;
+			slowComponents[j] = !fastComponents[j];
+			if( fastComponents[j] ) std::cout << " " << components[j].name;
+		}
+		std::cout << std::endl;
+
+		fastArkodeMem = ARKStepCreate( getFastDerivatives, nullptr, 0.0, u, sunContext );
+		ARKodeSetMaxNumSteps( fastArkodeMem, 1000000 );
+		ARKodeSetUserData( fastArkodeMem, this );
+		ARKodeSStolerances( fastArkodeMem, 1.e-8, 1.e-5 );
+		ARKodeCreateMRIStepInnerStepper( fastArkodeMem, &fastStepper );
+
+		arkodeMem = MRIStepCreate( getSlowDerivatives, nullptr, 0.0, u, fastStepper, sunContext );
+		ARKodeSetUserData( arkodeMem, this );
+		ARKodeSetFixedStep( arkodeMem, dt );
+		return;
+	}
+
+	// IMEX: ARKODE's additive Runge-Kutta methods integrate the transport explicitly and the stiff mass transfer
+	// implicitly; the implicit stages only couple the components at the same grid point, so instead of the dense
+	// Jacobian of the BDF solver the Newton systems are solved with block-diagonal preconditioned GMRES
+	if( implicitIntegrator == ImplicitIntegrator::IMEX )
+	{
+		arkodeMem = ARKStepCreate( getTransportDerivatives, getMassTransferDerivatives, 0.0, u, sunContext );
+		ARKodeSetMaxNumSteps( arkodeMem, 1000000 );
+		ARKodeSetUserData( arkodeMem, this );
+		ARKodeSStolerances( arkodeMem, 1.e-8, 1.e-5 );
+
+		linSolver = SUNLinSol_SPGMR( u, SUN_PREC_LEFT, 5, sunContext );
+		ARKodeSetLinearSolver( arkodeMem, linSolver, nullptr );
+		ARKodeSetPreconditioner( arkodeMem, setupBlockPreconditioner, solveBlockPreconditioner );
+		return;
+	}
+
+	// Set memory location of cvode's storage in cvodeMem and assign a solver:
+	// CV_BDF (backwards differentiation formula) is used here which is a solver used for stiff equations
+	// sundials also offers CV_ADAMS which is the Adams-Moulton family that is used for non-stiff equations
+	cvodeMem = CVodeCreate( CV_BDF, sunContext );
+
+	// Set the maximum order of convergence for the solver: maximum is 5 for the BDF solver.
+	// Up until order 2, the BDF scheme is A-stable.
+	// However, the CVode solver is variable order meaning it should be able to change to a lower order scheme if
+	// stability issues are found by its checks. For higher order (>2) schemes the areas of instability on the left plane
+	// are on the border close to the origin but not at the origin itself. Hence, small eigenvalues L with
+	// Re(L)<0 and Im(L)=/=0 could technically cause instability.
+	CVodeSetMaxOrd( cvodeMem, 5 );
+
+	// Maximum internal steps of the solver within a given timestep
+	CVodeSetMaxNumSteps( cvodeMem, 1e6 );
+	// Allow the solver to access the breakthrough object
+	CVodeSetUserData(cvodeMem, this );
+
+	// Set initial conditions with initial state of u (Q and P) and t
+	// and provide the func that returns derivatives of u (Q and P)
+	CVodeInit( cvodeMem, getDerivatives, 0.0, u );
+
+	// Set relative and absolute tolerances for the sundials solver
+	const sunrealtype relTol = 1.e-8;
+	const sunrealtype absTol = 1.e-5;
+	CVodeSStolerances( cvodeMem, relTol, absTol );
+
+	// the linear solver is chosen up front, also for the fixed-point iteration that may fall back to Newton, so that
+	// a column beyond 'LinearSolverMemoryLimit' is rejected before the run starts
+	newtonLinearSolver = chooseLinearSolver();
+
+	// Set the non linear solver to a modified Newton iteration, or to an Anderson-accelerated fixed-point iteration
+	// that needs no linear solver
+	if( nonlinearSolver == NonlinearSolver::FixedPoint )
+	{
+		solver = SUNNonlinSol_FixedPoint( u, static_cast<int>(fixedPointAndersonDepth), sunContext );
+		CVodeSetNonlinearSolver( cvodeMem, solver );
+		linSolver = nullptr;
+		A = nullptr;
+	}
+	else
+	{
+		attachNewtonSolver();
+	}
+}
+
+// Sets the non linear solver to a modified Newton iteration and the linear solver that it uses to a dense matrix
+// solver, or to GMRES with the block-diagonal mass-transfer preconditioner, as chosen by chooseLinearSolver.
+void Breakthrough::attachNewtonSolver()
+{
+	const sunindextype totalLen = static_cast<sunindextype>(2 * (Ngrid + 1) * Ncomp);
+	solver = SUNNonlinSol_Newton( u, sunContext );
+	CVodeSetNonlinearSolver( cvodeMem, solver );
+	if( newtonLinearSolver == LinearSolver::Dense )
+	{
+		A = SUNDenseMatrix(totalLen, totalLen, sunContext );
+		linSolver = SUNLinSol_Dense(u, A, sunContext);
+		CVodeSetLinearSolver( cvodeMem, linSolver, A );
+		CVodeSetJacFn(cvodeMem, nullptr );
+	}
+	else
+	{
+		A = nullptr;
+		linSolver = SUNLinSol_SPGMR( u, SUN_PREC_LEFT, gmresDimension, sunContext );
+		CVodeSetLinearSolver( cvodeMem, linSolver, nullptr );
+		CVodeSetPreconditioner( cvodeMem, setupBlockPreconditioner, solveBlockPreconditioner );
+	}
+}
+
+// The fixed-point iteration converges only while the step size times the stiffness stays below one, so CVODE
+// shrinks the steps after every convergence failure. The step has failed when CVODE gave up, or when more than
+// one in four steps (and at least 10) needed a retry; the integrator then switches to Newton for the rest of the run.
+bool Breakthrough::fixedPointFailed(int flag, long stepsBefore, long failuresBefore)
+{
+  if(nonlinearSolver != NonlinearSolver::FixedPoint) return false;
+
+  long steps = 0;
+  long failures = 0;
+  CVodeGetNumSteps(cvodeMem, &steps);
+  CVodeGetNumNonlinSolvConvFails(cvodeMem, &failures);
+  steps -= stepsBefore;
+  failures -= failuresBefore;
+  if(flag >= 0 && (failures < 10 || 4 * failures <= steps)) return false;
+
+  std::cout << "Fixed-point iteration failed to converge (CVODE flag " << flag << ", " << failures
+            << " convergence failures in " << steps << " steps), switching to Newton" << std::endl;
+  SUNNonlinearSolver fixedPointSolver = solver;
+  attachNewtonSolver();
+  SUNNonlinSolFree(fixedPointSolver);
+  nonlinearSolver = NonlinearSolver::Newton;
+  return true;
+}
+
+// The counters of CVODE since the start of the run, including those before re-initializations.
+Breakthrough::IntegratorStatistics Breakthrough::integratorStatistics() const
+{
+  IntegratorStatistics statistics = retiredStatistics;
+  long value = 0;
+  CVodeGetNumSteps(cvodeMem, &value);
+  statistics.steps += value;
+  CVodeGetNumRhsEvals(cvodeMem, &value);
+  statistics.rhsEvaluations += value;
+  CVodeGetNumNonlinSolvIters(cvodeMem, &value);
+  statistics.nonlinearIterations += value;
+  CVodeGetNumNonlinSolvConvFails(cvodeMem, &value);
+  statistics.convergenceFailures += value;
+  CVodeGetNumErrTestFails(cvodeMem, &value);
+  statistics.errorTestFailures += value;
+  return statistics;
+}
+
+// Restarts CVODE at time t from the state in 'u', keeping its counters for printIntegratorStatistics.
+void Breakthrough::reinitializeCVode(double t)
+{
+  retiredStatistics = integratorStatistics();
+  CVodeReInit(cvodeMem, t, u);
+}
+
+// Prints the counters of the BDF integrator, which compare the nonlinear solvers ('NonlinearSolver').
+void Breakthrough::printIntegratorStatistics() const
+{
+  if (!implicit || implicitIntegrator != ImplicitIntegrator::BDF) return;
+
+  const IntegratorStatistics statistics = integratorStatistics();
+  std::cout << "BDF integrator (" << (nonlinearSolver == NonlinearSolver::Newton ? "Newton" : "FixedPoint")
+            << " at the end of the run):\n"
+            << "    steps:                        " << statistics.steps << "\n"
+            << "    right-hand side evaluations:  " << statistics.rhsEvaluations << "\n"
+            << "    nonlinear iterations:         " << statistics.nonlinearIterations << "\n"
+            << "    convergence failures:         " << statistics.convergenceFailures << "\n"
+            << "    error test failures:          " << statistics.errorTestFailures << std::endl;
+}
+
+// Estimates the memory and the Jacobian cost of the linear solvers of the BDF integrator for n = 2 (Ngrid + 1) Ncomp
+// unknowns, and picks one within 'LinearSolverMemoryLimit':
+//  - dense: two n x n matrices (the Newton matrix and the saved Jacobian); a Jacobian costs n evaluations of the
+//    derivatives (difference quotients), but is exact, including the coupling through the velocity;
+//  - GMRES: the block-diagonal mass-transfer preconditioner, (Ngrid + 1) blocks of (2 Ncomp)^2 plus the
+//    equilibrium Jacobian; a preconditioner costs Ncomp + 1 mixture predictions per grid point, and every Krylov
+//    iteration one evaluation of the derivatives.
+// A band matrix is not considered: with the state ordered as [Q, P] the loading and the partial pressure of a grid
+// point are (Ngrid + 1) Ncomp apart, so the band would be as large as the dense matrix. 'Auto' prefers the exact
+// dense Jacobian up to 10000 unknowns; beyond that its n evaluations per Jacobian dominate the run.
+Breakthrough::LinearSolver Breakthrough::chooseLinearSolver() const
+{
+  const double n = 2.0 * static_cast<double>((Ngrid + 1) * Ncomp);
+  const double blocks = static_cast<double>((Ngrid + 1) * 5 * Ncomp * Ncomp);
+  const double mebibyte = 1024.0 * 1024.0;
+  const double doubleSize = static_cast<double>(sizeof(double));
+  const double integratorMemory = 25.0 * n * doubleSize / mebibyte;  // CVODE's own vectors (up to order 5)
+  const double denseMemory = integratorMemory + 2.0 * n * n * doubleSize / mebibyte;
+  const double gmresMemory = integratorMemory + ((gmresDimension + 5.0) * n + blocks) * doubleSize / mebibyte;
+
+  LinearSolver choice = linearSolver;
+  if(choice == LinearSolver::Auto)
+  {
+    choice = (denseMemory <= linearSolverMemoryLimit && n <= 10000.0) ? LinearSolver::Dense : LinearSolver::GMRES;
+  }
+  const std::string name = choice == LinearSolver::Dense ? "dense" : "GMRES";
+  const double memory = choice == LinearSolver::Dense ? denseMemory : gmresMemory;
+
+  std::cout << "Linear solver: " << name << " for " << n << " unknowns, estimated " << memory << " MiB (limit "
+            << linearSolverMemoryLimit << " MiB; dense " << denseMemory << " MiB and " << n
+            << " derivative evaluations per Jacobian, GMRES " << gmresMemory << " MiB and " << Ncomp + 1
+            << " mixture predictions per grid point per preconditioner)" << std::endl;
+  if(memory > linearSolverMemoryLimit)
+  {
+    throw std::runtime_error("Error: the " + name + " linear solver needs an estimated " + std::to_string(memory) +
+                             " MiB, more than 'LinearSolverMemoryLimit " + std::to_string(linearSolverMemoryLimit) +
+                             "' (Use e.g.: 'LinearSolver GMRES', fewer grid points or a larger limit)\n");
+  }
+  return choice;
+}
+
+void Breakthrough::run( bool impl )
+{
+	implicit = impl;
+  if (equilibriumReuseTolerance > 0.0 && !reusesEquilibrium())
+  {
+    std::cout << "EquilibriumReuseTolerance ignored: the implicit integrator needs the exact equilibrium loadings"
+              << std::endl;
+  }
+  // create the output files
+  std::vector<std::ofstream> streams;
+  for (size_t i = 0; i < Ncomp; i++)
+  {
+    std::string fileName = "component_" + std::to_string(i) + "_" + components[i].name + ".data";
+    streams.emplace_back(std::ofstream{fileName});
+  }
+
+  // the column profiles are skipped entirely for outlet-only output
+  std::ofstream movieStream;
+  std::unique_ptr<SnapshotWriter> snapshotStream;
+  if (!outletOnly)
+  {
+    openColumnProfiles(movieStream, snapshotStream);
+  }
+
+	// For the implicit solver, set a bigger timestep as the solver can internally decide internal timesteps.
+	// The transport of the Strang splitting and the macro step of the multirate scheme are explicit, their time step
+	// is limited by the CFL condition instead.
+	if( impl && implicitIntegrator != ImplicitIntegrator::Strang && implicitIntegrator != ImplicitIntegrator::Multirate ){
+		double dtNew = 10.0;
+		double conv  = dt / dtNew;
+		Nsteps = std::max( (size_t)1, (size_t) ( (double) Nsteps  * conv ) );
+		writeEvery = std::max( (size_t)1, (size_t) ( (double) writeEvery  * conv ) );
+		dt = dtNew;
+	}
+
+	std::cout << "dt: " << dt << " Nsteps:  " << Nsteps << " writeEvery: " << writeEvery << std::endl;
+
+  // 'NumberOfTimeSteps auto' runs 1000 output intervals, a fixed number of time steps ends the run there
+  const size_t endStep = autoSteps ? writeEvery * 1000 + 1 : Nsteps;
+	for (size_t step = 0; step < endStep; ++step)
+  {
+    // compute new step (the cache-tiled explicit scheme advances several steps at once, up to the next output)
+    const size_t count = tiledSweepLength(step, endStep);
+    computeStep(step, count);
+    step += count - 1;
+
+    double t = stepTime(step);
+
+    // the final step is always written
+    if (step % writeEvery == 0 || step + 1 == endStep)
+    {
+
+			std::cout << "step: " << step << " t: " << step * dt << std::endl;
+      // write breakthrough output to files
+      // column 1: dimensionless time
+      // column 2: time [minutes]
+      // column 3: normalized partial pressure
+      for (size_t j = 0; j < Ncomp; ++j)
+      {
+        streams[j] << t * v_in / L << " " << t / 60.0 << " "
+                   << P[Ngrid * Ncomp + j] / ((p_total + dptdx * L) * components[j].Yi0) << std::endl;
+      }
+
+      if (!outletOnly)
+      {
+        writeColumnProfiles(movieStream, snapshotStream.get());
+      }
+    }
+
+    if (step % printEvery == 0)
+    {
+      std::cout << "Timestep " + std::to_string(step) + ", time: " + std::to_string(t) + " [s]\n";
+      std::cout << "    Average number of mixture-prediction steps: " +
+                       std::to_string(static_cast<double>(iastPerformance.first) /
+                                      static_cast<double>(iastPerformance.second))
+                << std::endl;
+      if (equilibriumReuse.second > 0)
+      {
+        std::cout << "    Reused equilibrium loadings: " +
+                         std::to_string(100.0 * static_cast<double>(equilibriumReuse.first) /
+                                        static_cast<double>(equilibriumReuse.second)) +
+                         "% of " + std::to_string(equilibriumReuse.second) + " grid-point evaluations"
+                  << std::endl;
+      }
+    }
+  }
+
+  std::cout << "Final timestep " + std::to_string(Nsteps) +
+                   ", time: " + std::to_string(dt * static_cast<double>(Nsteps)) + " [s]\n";
+  printIntegratorStatistics();
+}
+
+// Opens 'column.data' (text), 'column.f32' (binary float32) or 'column.f32z' (compressed float32) and writes the
+// header describing the columns of the selected fields; the binary layouts are described in '<file>.txt'.
+void Breakthrough::openColumnProfiles(std::ofstream &stream, std::unique_ptr<SnapshotWriter> &snapshots)
+{
+  const std::string fileName = columnFormat == ColumnFormat::Text      ? "column.data"
+                               : columnFormat == ColumnFormat::Float32 ? "column.f32"
+                                                                       : "column.f32z";
+  std::ofstream layoutStream;
+  if (columnFormat == ColumnFormat::Text)
+  {
+    stream.open(fileName);
+  }
+  else
+  {
+    layoutStream.open(fileName + ".txt");
+  }
+  std::ofstream &header = columnFormat == ColumnFormat::Text ? stream : layoutStream;
+
+  const size_t globalFields = static_cast<size_t>(ColumnField::Q);
+  size_t column_nr = 1;
+  header << "# column " << column_nr++ << ": z  (column position)\n";
+  for (size_t f = 0; f < globalFields; ++f)
+  {
+    if (columnFields[f]) header << "# column " << column_nr++ << ": " << columnFieldDescriptions[f] << "\n";
+  }
+  for (size_t j = 0; j < Ncomp; ++j)
+  {
+    for (size_t f = globalFields; f < columnFields.size(); ++f)
+    {
+      if (columnFields[f])
+        header << "# column " << column_nr++ << ": component " << j << " " << columnFieldDescriptions[f] << "\n";
+    }
+  }
+
+  const uint32_t rows = static_cast<uint32_t>(Ngrid / columnStride + (Ngrid % columnStride != 0 ? 2 : 1));
+  const uint32_t columns = static_cast<uint32_t>(column_nr - 1);
+  if (columnFormat == ColumnFormat::Float32)
+  {
+    // binary layout: two uint32 (rows and columns per snapshot), followed by the snapshots as rows x columns
+    // little-endian float32 values
+    stream.open(fileName, std::ios::out | std::ios::binary);
+    const uint32_t shape[2] = {rows, columns};
+    writeLittleEndian(stream, shape, 2);
+    header << "# " << rows << " rows (grid points) x " << columns << " columns per snapshot, float32\n";
+    header << "# numpy: np.fromfile('column.f32', dtype='<f4', offset=8).reshape(-1, " << rows << ", " << columns
+           << ")\n";
+  }
+  else if (columnFormat == ColumnFormat::Compressed)
+  {
+    snapshots = std::make_unique<SnapshotWriter>(fileName, rows, columns, columnMantissaBits);
+    header << "# " << rows << " rows (grid points) x " << columns << " columns per snapshot, float32 with "
+           << columnMantissaBits << " mantissa bits, compressed (see snapshot_file.h)\n";
+  }
+}
+
+// Writes one snapshot of the column profiles; only the selected fields and grid points are formatted.
+void Breakthrough::writeColumnProfiles(std::ofstream &stream, SnapshotWriter *snapshots)
+{
+  std::vector<double> row;
+  row.reserve(3 + 6 * Ncomp);
+  std::vector<float> buffer;
+
+  for (size_t i = 0;; i = std::min(i + columnStride, Ngrid))
+  {
+    row.clear();
+    row.push_back(static_cast<double>(i) * dx);
+    if (columnFields[static_cast<size_t>(ColumnField::V)]) row.push_back(V[i]);
+    if (columnFields[static_cast<size_t>(ColumnField::Pt)]) row.push_back(Pt[i]);
+    for (size_t j = 0; j < Ncomp; ++j)
+    {
+      if (columnFields[static_cast<size_t>(ColumnField::Q)]) row.push_back(Q[i * Ncomp + j]);
+      if (columnFields[static_cast<size_t>(ColumnField::Qeq)]) row.push_back(Qeq[i * Ncomp + j]);
+      if (columnFields[static_cast<size_t>(ColumnField::P)]) row.push_back(P[i * Ncomp + j]);
+      if (columnFields[static_cast<size_t>(ColumnField::Pnorm)])
+        row.push_back(P[i * Ncomp + j] / (Pt[i] * components[j].Yi0));
+      if (columnFields[static_cast<size_t>(ColumnField::Dpdt)]) row.push_back(Dpdt[i * Ncomp + j]);
+      if (columnFields[static_cast<size_t>(ColumnField::Dqdt)]) row.push_back(Dqdt[i * Ncomp + j]);
+    }
+
+    if (columnFormat != ColumnFormat::Text)
+    {
+      buffer.insert(buffer.end(), row.begin(), row.end());
+    }
+    else
+    {
+      for (double value : row)
+      {
+        stream << value << " ";
+      }
+      stream << "\n";
+    }
+    if (i == Ngrid) break;
+  }
+
+  switch (columnFormat)
+  {
+    case ColumnFormat::Text:
+      stream << "\n\n";
+      break;
+    case ColumnFormat::Float32:
+      writeLittleEndian(stream, buffer.data(), buffer.size());
+      break;
+    case ColumnFormat::Compressed:
+      snapshots->append(buffer.data());
+      break;
+  }
+}
+
+// The gnuplot movie scripts address the columns of the full text profiles.
+bool Breakthrough::fullColumnProfiles() const
+{
+  return !outletOnly && columnFormat == ColumnFormat::Text &&
+         std::all_of(columnFields.begin(), columnFields.end(), [](bool selected) { return selected; });
+}
+
+// Anderson acceleration of a fixed-point iteration x = g(x) (type II, Walker and Ni, SIAM J. Numer. Anal. 49,
+// 1715 (2011)): the next iterate combines the last 'depth' images g(x) with the coefficients that minimize the
+// linearized residual g(x) - x, a secant (quasi-Newton) method that needs one evaluation of g per iteration
+class AndersonAcceleration
+{
+ public:
+  explicit AndersonAcceleration(size_t depth_) : depth(depth_) {}
+
+  void reset()
+  {
+    differencesF.clear();
+    differencesG.clear();
+    previousF.clear();
+    previousG.clear();
+  }
+
+  void next(const std::vector<double> &x, const std::vector<double> &g, std::vector<double> &xNext)
+  {
+    std::vector<double> f(x.size());
+    for (size_t i = 0; i < x.size(); ++i)
+    {
+      f[i] = g[i] - x[i];
+    }
+    if (!previousF.empty())
+    {
+      differencesF.emplace_back(f.size());
+      differencesG.emplace_back(f.size());
+      for (size_t i = 0; i < f.size(); ++i)
+      {
+        differencesF.back()[i] = f[i] - previousF[i];
+        differencesG.back()[i] = g[i] - previousG[i];
+      }
+      if (differencesF.size() > depth)
+      {
+        differencesF.erase(differencesF.begin());
+        differencesG.erase(differencesG.begin());
+      }
+    }
+    previousF = f;
+    previousG = g;
+
+    // least-squares coefficients from the (slightly regularized) normal equations of the m x m problem
+    const size_t m = differencesF.size();
+    std::vector<double> a(m * m);
+    std::vector<double> b(m);
+    for (size_t r = 0; r < m; ++r)
+    {
+      for (size_t c = 0; c < m; ++c)
+      {
+        a[r * m + c] = std::inner_product(differencesF[r].begin(), differencesF[r].end(), differencesF[c].begin(), 0.0);
+      }
+      b[r] = std::inner_product(differencesF[r].begin(), differencesF[r].end(), f.begin(), 0.0);
+    }
+    double trace = 0.0;
+    for (size_t r = 0; r < m; ++r) trace += a[r * m + r];
+    for (size_t r = 0; r < m; ++r) a[r * m + r] += 1.0e-10 * trace + std::numeric_limits<double>::min();
+
+    // Gaussian elimination with partial pivoting
+    for (size_t k = 0; k < m; ++k)
+    {
+      size_t pivot = k;
+      for (size_t r = k + 1; r < m; ++r)
+      {
+        if (std::abs(a[r * m + k]) > std::abs(a[pivot * m + k])) pivot = r;
+      }
+      for (size_t c = 0; c < m; ++c) std::swap(a[k * m + c], a[pivot * m + c]);
+      std::swap(b[k], b[pivot]);
+      for (size_t r = k + 1; r < m; ++r)
+      {
+        const double factor = a[r * m + k] / a[k * m + k];
+        for (size_t c = k; c < m; ++c) a[r * m + c] -= factor * a[k * m + c];
+        b[r] -= factor * b[k];
+      }
+    }
+    std::vector<double> gamma(m);
+    for (size_t k = m; k-- > 0;)
+    {
+      double sum = b[k];
+      for (size_t c = k + 1; c < m; ++c) sum -= a[k * m + c] * gamma[c];
+      gamma[k] = sum / a[k * m + k];
+    }
+
+    xNext = g;
+    for (size_t k = 0; k < m; ++k)
+    {
+      for (size_t i = 0; i < xNext.size(); ++i)
+      {
+        xNext[i] -= gamma[k] * differencesG[k][i];
+      }
+    }
+  }
+
+ private:
+  size_t depth;
+  std::vector<std::vector<double>> differencesF;
+  std::vector<std::vector<double>> differencesG;
+  std::vector<double> previousF;
+  std::vector<double> previousG;
+};
+
+// Runs the cycle of steps on the same column until cyclic steady state (CSS): the state (Q and P) at the start of
+// a cycle is reproduced by the cycle to within 'cyclicSteadyStateTolerance'. Instead of simply running cycle after
+// cycle (successive substitution on the cycle map), the start of the next cycle is by default extrapolated with
+// Anderson acceleration from the previous cycles. Per cycle, the amounts of feed, of product (gas leaving the
+// product end) and of exhaust (gas leaving the feed end) are written to 'cycles.data'.
+void Breakthrough::runCycles(bool impl)
+{
+  implicit = impl;
+  if (equilibriumReuseTolerance > 0.0 && !reusesEquilibrium())
+  {
+    std::cout << "EquilibriumReuseTolerance ignored: the implicit integrator needs the exact equilibrium loadings"
+              << std::endl;
+  }
+  if (cycleSteps.empty())
+  {
+    throw std::runtime_error("Error: no cycle steps (Use e.g.: 'CycleStep Adsorption 60')\n");
+  }
+
+  // the feed conditions are restored after the cycles
+  const double feedPressure = p_total;
+  const double feedVelocity = v_in;
+  const bool feedPulse = pulse;
+  pulse = false;
+  autoSteps = false;
+
+  // the state of the cycle map is scaled by the feed pressure and the loadings in equilibrium with the feed
+  pScale = feedPressure;
+  qScale.resize(Ncomp);
+  for (size_t j = 0; j < Ncomp; ++j)
+  {
+    qScale[j] = Qeq[0 * Ncomp + j] > 1.0e-10 ? Qeq[0 * Ncomp + j] : 1.0;
+  }
+
+  std::ofstream stream("cycles.data");
+  stream << "# column 1: cycle\n";
+  stream << "# column 2: CSS residual (largest scaled change of the state over the cycle)\n";
+  for (size_t j = 0; j < Ncomp; ++j)
+  {
+    stream << "# column " << 3 + 3 * j << ": component " << j << " feed [mol/m^2]\n";
+    stream << "# column " << 4 + 3 * j << ": component " << j << " product [mol/m^2]\n";
+    stream << "# column " << 5 + 3 * j << ": component " << j << " exhaust [mol/m^2]\n";
+  }
+
+  AndersonAcceleration anderson(andersonDepth);
+  std::vector<double> start;
+  std::vector<double> end;
+  std::vector<double> next;
+  std::vector<double> feed(Ncomp);
+  std::vector<double> product(Ncomp);
+  std::vector<double> exhaust(Ncomp);
+  double previousResidual = std::numeric_limits<double>::max();
+  bool converged = false;
+  size_t cycle = 0;
+  size_t step = 0;  // time steps over all cycles
+  while (!converged && cycle < numberOfCycles)
+  {
+    ++cycle;
+    cycleState(start);
+    std::fill(feed.begin(), feed.end(), 0.0);
+    std::fill(product.begin(), product.end(), 0.0);
+    std::fill(exhaust.begin(), exhaust.end(), 0.0);
+
+    for (const InputReader::CycleStep &cycleStep : cycleSteps)
+    {
+      startCycleStep(cycleStep, static_cast<double>(step) * dt);
+
+      // molar flux through the ends of the column: epsilon v p / (R T)
+      const double factor = epsilon * dt / (R * T);
+      const size_t steps = std::max(size_t{1}, static_cast<size_t>(std::llround(cycleStep.duration / dt)));
+      for (size_t k = 0; k < steps; ++k)
+      {
+        computeStep(step++);
+        for (size_t j = 0; j < Ncomp; ++j)
+        {
+          if (!cycleStep.carrierInlet) feed[j] += factor * V[0] * P[0 * Ncomp + j];
+          (cycleStep.countercurrent ? exhaust : product)[j] += factor * V[Ngrid] * P[Ngrid * Ncomp + j];
+        }
+      }
+
+      if (cycleStep.countercurrent) reverseColumn();
+    }
+
+    cycleState(end);
+    double residual = 0.0;
+    for (size_t i = 0; i < start.size(); ++i)
+    {
+      residual = std::max(residual, std::abs(end[i] - start[i]));
+    }
+    converged = residual < cyclicSteadyStateTolerance;
+
+    stream << cycle << " " << residual;
+    for (size_t j = 0; j < Ncomp; ++j)
+    {
+      stream << " " << feed[j] << " " << product[j] << " " << exhaust[j];
+    }
+    stream << std::endl;
+    std::cout << "Cycle " << cycle << ", CSS residual: " << residual << std::endl;
+
+    if (!converged && andersonDepth > 0)
+    {
+      // restart the acceleration from a plain cycle when the extrapolation made things worse
+      if (residual > previousResidual) anderson.reset();
+      anderson.next(start, end, next);
+      setCycleState(next);
+    }
+    previousResidual = residual;
+  }
+
+  std::cout << (converged ? "\nCyclic steady state reached after " : "\nNo cyclic steady state after ") << cycle
+            << " cycles\n";
+  double totalProduct = 0.0;
+  for (size_t j = 0; j < Ncomp; ++j) totalProduct += product[j];
+  for (size_t j = 0; j < Ncomp; ++j)
+  {
+    std::cout << "    " << components[j].name << ": product purity "
+              << (totalProduct > 0.0 ? product[j] / totalProduct : 0.0)
+              << ", recovery " << (feed[j] > 0.0 ? product[j] / feed[j] : 0.0) << "\n";
+  }
+
+  printIntegratorStatistics();
+
+  p_total = feedPressure;
+  v_in = feedVelocity;
+  pulse = feedPulse;
+}
+
+// Sets the boundary conditions of a cycle step; a counter-current step mirrors the column so that its gas also
+// enters at grid point 0. A pressure change is taken to be instantaneous: the gas phase is rescaled to the pressure
+// profile of the step keeping its composition, and the loadings follow through the mass transfer.
+void Breakthrough::startCycleStep(const InputReader::CycleStep &step, double t)
+{
+  if (step.countercurrent) reverseColumn();
+
+  p_total = step.pressure;
+  v_in = step.velocity;
+  for (size_t i = 0; i < Ngrid + 1; ++i)
+  {
+    double pt = 0.0;
+    for (size_t j = 0; j < Ncomp; ++j)
+    {
+      pt += std::max(0.0, P[i * Ncomp + j]);
+    }
+    if (pt > 0.0)
+    {
+      const double factor = (p_total + dptdx * static_cast<double>(i) * dx) / pt;
+      for (size_t j = 0; j < Ncomp; ++j)
+      {
+        P[i * Ncomp + j] *= factor;
+      }
+    }
+  }
+  for (size_t j = 0; j < Ncomp; ++j)
+  {
+    const double y = step.carrierInlet ? (j == carrierGasComponent ? 1.0 : 0.0) : components[j].Yi0;
+    P[0 * Ncomp + j] = p_total * y;
+  }
+  refreshColumnState();
+
+  if (implicit && implicitIntegrator != ImplicitIntegrator::Strang)
+  {
+    sunrealtype *udata = N_VGetArrayPointer(u);
+    std::copy(Q.begin(), Q.end(), udata);
+    std::copy(P.begin(), P.end(), udata + Q.size());
+    if (implicitIntegrator == ImplicitIntegrator::IMEX)
+    {
+      ARKStepReInit(arkodeMem, getTransportDerivatives, getMassTransferDerivatives, t, u);
+    }
+    else if (implicitIntegrator == ImplicitIntegrator::Multirate)
+    {
+      MRIStepReInit(arkodeMem, getSlowDerivatives, nullptr, t, u);
+    }
+    else
+    {
+      reinitializeCVode(t);
+    }
+  }
+}
+
+// Mirrors the column: grid point i becomes grid point Ngrid - i.
+void Breakthrough::reverseColumn()
+{
+  for (FieldVector *field : {&P, &Q, &Qeq, &V, &Pt, &cachedP0, &cachedPsi, &massTransferRate})
+  {
+    const size_t block = field->size() / (Ngrid + 1);  // 0 for unused fields
+    for (size_t i = 0; i < (Ngrid + 1) / 2; ++i)
+    {
+      std::swap_ranges(field->begin() + static_cast<std::ptrdiff_t>(i * block),
+                       field->begin() + static_cast<std::ptrdiff_t>((i + 1) * block),
+                       field->begin() + static_cast<std::ptrdiff_t>((Ngrid - i) * block));
+    }
+  }
+}
+
+// Recomputes the equilibrium loadings, total pressures and velocities after P or Q were changed.
+void Breakthrough::refreshColumnState()
+{
+  std::copy(Q.begin(), Q.end(), Qnew.begin());
+  std::copy(P.begin(), P.end(), Pnew.begin());
+  computeEquilibriumLoadings();
+  computeVelocity();
+  std::copy(Qeqnew.begin(), Qeqnew.end(), Qeq.begin());
+  std::copy(Vnew.begin(), Vnew.end(), V.begin());
+}
+
+// The state of the cycle map: the scaled loadings followed by the scaled partial pressures.
+void Breakthrough::cycleState(std::vector<double> &state) const
+{
+  state.resize(Q.size() + P.size());
+  for (size_t k = 0; k < Q.size(); ++k)
+  {
+    state[k] = Q[k] / qScale[k % Ncomp];
+    state[Q.size() + k] = P[k] / pScale;
+  }
+}
+
+void Breakthrough::setCycleState(const std::vector<double> &state)
+{
+  for (size_t k = 0; k < Q.size(); ++k)
+  {
+    Q[k] = std::max(0.0, state[k]) * qScale[k % Ncomp];
+    P[k] = std::max(0.0, state[Q.size() + k]) * pScale;
+  }
+  refreshColumnState();
+}
+
+void Breakthrough::computeStep(size_t step, size_t count)
+{
+  double t = static_cast<double>(step) * dt;
+	double nextTime = static_cast<double>(step + 1) * dt;
+
+  // check if we can set the expected end-time based on 10% longer time than when all
+  // adorbed mol-fractions are smaller than 1% of unity
+  if (autoSteps)
+  {
+    double tolerance = 0.0;
+    for (size_t j = 0; j < Ncomp; ++j)
+    {
+      tolerance =
+          std::max(tolerance, std::abs((P[Ngrid * Ncomp + j] / ((p_total + dptdx * L) * components[j].Yi0)) - 1.0));
+    }
+
+    // consider 1% as being visibily indistinguishable from 'converged'
+    // use a 10% longer time for display purposes
+    if (tolerance < 0.01)
+    {
+      std::cout << "\nConvergence criteria reached, running 10% longer\n\n" << std::endl;
+      Nsteps = static_cast<size_t>(1.1 * static_cast<double>(step));
+      autoSteps = false;
+    }
+  }
+
+	if( tiled() )
+	{
+		computeTiledSteps( count );
+	}
+	else if( !implicit )
+	{
+		// SSP-RK Step 1
+		// ======================================================================
+
+		// calculate the derivatives Dq/dt and Dp/dt based on Qeq, Q, V, and P
+		computeFirstDerivatives( Dqdt, Dpdt, Qeq, Q, V, P );
+
+		// Dqdt and Dpdt are calculated at old time step
+		// make estimate for the new loadings and new gas phase partial pressures
+		// first iteration is made using the Explicit Euler scheme
+		for ( size_t i = 0; i < Ngrid + 1; ++i ) {
+			for ( size_t j = 0; j < Ncomp; ++j ) {
+				const size_t k = i * Ncomp + j;
+				Qnew[k] = ColumnKernels::sspStage( 1, Q[k], Q[k], Dqdt[k], dt );
+				Pnew[k] = ColumnKernels::sspStage( 1, P[k], P[k], Dpdt[k], dt );
+			}
+		}
+
+		computeEquilibriumLoadings();
+
+		computeVelocity();
+
+		// SSP-RK Step 2
+		// ======================================================================
+
+		// calculate new derivatives at new (current) timestep
+		// calculate the derivatives Dq/dt and Dp/dt based on Qeq, Q, V, and P at new (current) timestep
+		computeFirstDerivatives( Dqdtnew, Dpdtnew, Qeqnew, Qnew, Vnew, Pnew );
+
+		for ( size_t i = 0; i < Ngrid + 1; ++i ) {
+			for ( size_t j = 0; j < Ncomp; ++j ) {
+				const size_t k = i * Ncomp + j;
+				Qnew[k] = ColumnKernels::sspStage( 2, Q[k], Qnew[k], Dqdtnew[k], dt );
+				Pnew[k] = ColumnKernels::sspStage( 2, P[k], Pnew[k], Dpdtnew[k], dt );
+			}
+		}
+
+		computeEquilibriumLoadings();
+
+		computeVelocity();
+
+		// SSP-RK Step 3
+		// ======================================================================
+
+		// calculate new derivatives at new (current) timestep
+		// calculate the derivatives Dq/dt and Dp/dt based on Qeq, Q, V, and P at new (current) timestep
+		computeFirstDerivatives( Dqdtnew, Dpdtnew, Qeqnew, Qnew, Vnew, Pnew );
+
+		for ( size_t i = 0; i < Ngrid + 1; ++i ) {
+			for ( size_t j = 0; j < Ncomp; ++j ) {
+				const size_t k = i * Ncomp + j;
+				Qnew[k] = ColumnKernels::sspStage( 3, Q[k], Qnew[k], Dqdtnew[k], dt );
+				Pnew[k] = ColumnKernels::sspStage( 3, P[k], Pnew[k], Dpdtnew[k], dt );
+			}
+		}
+
+		computeEquilibriumLoadings();
+
+		computeVelocity();
+	} else if( implicitIntegrator == ImplicitIntegrator::Strang ) {
+		computeStrangStep();
+	} else { // if implicit
+		numCalls = 0;									// Track number of calls for the derivative function to see what CVode is doing
+		sunrealtype tReturn = t;			// Later assigned the time the solver has reached, but not further used
+
+		// Solve from this timestep to the next: "nextTime"
+		if( implicitIntegrator == ImplicitIntegrator::IMEX || implicitIntegrator == ImplicitIntegrator::Multirate )
+		{
+			ARKodeEvolve( arkodeMem, nextTime, u, &tReturn, ARK_NORMAL );
+
+			// the split right-hand sides leave partial derivatives behind: recompute the state and its derivatives
+			sunrealtype *udata = N_VGetArrayPointer( u );
+			std::copy( udata, udata + Qnew.size(), Qnew.begin() );
+			std::copy( udata + Qnew.size(), udata + 2 * Qnew.size(), Pnew.begin() );
+			computeEquilibriumLoadings();
+			computeVelocity();
+			computeFirstDerivatives( Dqdt, Dpdt, Qeqnew, Qnew, Vnew, Pnew );
+		}
+		else
+		{
+			long steps = 0;
+			long failures = 0;
+			CVodeGetNumSteps( cvodeMem, &steps );
+			CVodeGetNumNonlinSolvConvFails( cvodeMem, &failures );
+			const int flag = CVode( cvodeMem, nextTime, u, &tReturn, CV_NORMAL );
+			if( fixedPointFailed( flag, steps, failures ) )
+			{
+				// redo the step with Newton from the state at its start
+				sunrealtype *udata = N_VGetArrayPointer( u );
+				std::copy( Q.begin(), Q.end(), udata );
+				std::copy( P.begin(), P.end(), udata + Q.size() );
+				reinitializeCVode( t );
+				CVode( cvodeMem, nextTime, u, &tReturn, CV_NORMAL );
+			}
+		}
+		std::cout << "num calls: " << numCalls << std::endl;
+
+	}
+
+  // update to the new time step
+  std::copy(Qnew.begin(), Qnew.end(), Q.begin());
+  std::copy(Pnew.begin(), Pnew.end(), P.begin());
+  std::copy(Qeqnew.begin(), Qeqnew.end(), Qeq.begin());
+  std::copy(Vnew.begin(), Vnew.end(), V.begin());
+
+  // pulse boundary condition
+  if (pulse == true)
+  {
+    if (t > tpulse)
+    {
+      for (size_t j = 0; j < Ncomp; ++j)
+      {
+        if (j == carrierGasComponent)
+        {
+          P[0 * Ncomp + j] = p_total;
+        }
+        else
+        {
+          P[0 * Ncomp + j] = 0.0;
+        }
+      }
+    }
+  }
+}
+
+// The number of time steps from 'step' that one sweep of the cache-tiled scheme advances: at most 'tileSteps', and
+// ending at the next step that is written or printed (or at 'end').
+size_t Breakthrough::tiledSweepLength(size_t step, size_t end) const
+{
+  if(!tiled()) return 1;
+  size_t count = 1;
+  while(count < tileSteps && step + count < end && (step + count - 1) % writeEvery != 0 &&
+        (step + count - 1) % printEvery != 0)
+  {
+    ++count;
+  }
+  return count;
+}
+
+// Advances 'count' time steps of the explicit SSP-RK3 scheme tile by tile. Stage k of time step n is level
+// l = 3 n + k; level l at grid point i needs level l - 1 at i - 1, i and i + 1 and its velocity at i, which needs
+// level l - 1 at i + 1 (dispersion) and its velocity at i - 1: the velocity recurrence runs downstream only. So a
+// tile [a, b) computes level l on [a - l + 1, b - l + 1) after level l - 1 on [a - l + 2, b - l + 2), and all
+// 3 count levels of a tile stay in cache. Level l is stored in ring buffer l % 4: level l + 4 only overwrites
+// points of level l that levels l + 1, ..., l + 3 (which read it as the previous stage or as the state at the start
+// of the step) have passed. At every grid point the levels are computed in the order of the untiled scheme, so the
+// warm-started mixture predictions are the same; the velocity is summed sequentially instead of as a blocked scan.
+void Breakthrough::computeTiledSteps(size_t count)
+{
+  const size_t n = Ngrid + 1;
+  for(size_t k = 0; k < 4; ++k)
+  {
+    tileQ[k].resize(n * Ncomp);
+    tileP[k].resize(n * Ncomp);
+    tileQeq[k].resize(n * Ncomp);
+    tileV[k].resize(n);
+    tilePt[k].resize(n);
+  }
+  std::copy(Q.begin(), Q.end(), tileQ[0].begin());
+  std::copy(P.begin(), P.end(), tileP[0].begin());
+  std::copy(Qeq.begin(), Qeq.end(), tileQeq[0].begin());
+  std::copy(V.begin(), V.end(), tileV[0].begin());
+  std::copy(Pt.begin(), Pt.end(), tilePt[0].begin());
+
+  const size_t levels = 3 * count;
+  for(size_t a = 0; a < n + levels - 1; a += tileSize)
+  {
+    for(size_t level = 1; level <= levels; ++level)
+    {
+      const size_t begin = std::min(n, a >= level - 1 ? a - (level - 1) : 0);
+      const size_t end = std::min(n, a + tileSize >= level - 1 ? a + tileSize - (level - 1) : 0);
+      if(begin < end) computeTiledLevel(level, begin, end);
+    }
+  }
+
+  const size_t last = levels % 4;
+  std::copy(tileQ[last].begin(), tileQ[last].end(), Qnew.begin());
+  std::copy(tileP[last].begin(), tileP[last].end(), Pnew.begin());
+  std::copy(tileQeq[last].begin(), tileQeq[last].end(), Qeqnew.begin());
+  std::copy(tileV[last].begin(), tileV[last].end(), Vnew.begin());
+  std::copy(tilePt[last].begin(), tilePt[last].end(), Pt.begin());
+}
+
+// level 'level' of computeTiledSteps on the grid points [begin, end): the SSP-RK3 stage, the equilibrium loadings
+// and the velocity up to end - 2 (up to the outlet for the last tile)
+void Breakthrough::computeTiledLevel(size_t level, size_t begin, size_t end)
+{
+  const double idx = 1.0 / dx;
+  const double idx2 = 1.0 / (dx * dx);
+  const size_t stage = (level - 1) % 3 + 1;
+  const size_t start = (level - stage) % 4;  // the state at the start of the time step
+  const size_t previous = (level - 1) % 4;
+  const size_t current = level % 4;
+  const double *q0 = tileQ[start].data();
+  const double *p0 = tileP[start].data();
+  const double *q = tileQ[previous].data();
+  const double *p = tileP[previous].data();
+  const double *qeq = tileQeq[previous].data();
+  const double *v = tileV[previous].data();
+  double *qn = tileQ[current].data();
+  double *pn = tileP[current].data();
+  double *qeqn = tileQeq[current].data();
+  double *vn = tileV[current].data();
+  double *ptn = tilePt[current].data();
+
+  // V[i] from V[i - 1], see computeVelocity
+  auto velocity = [&](size_t i)
+  {
+    double sum = 0.0;
+    for(size_t j = 0; j < Ncomp; ++j)
+    {
+      const size_t k = i * Ncomp + j;
+      const double difference = i < Ngrid ? ColumnKernels::dispersion(pn[k - Ncomp], pn[k], pn[k + Ncomp])
+                                          : ColumnKernels::outletDispersion(pn[k - Ncomp], pn[k]);
+      sum = sum + ColumnKernels::gasTransfer(prefactor[j], qeqn[k], qn[k]) + components[j].D * difference * idx2;
+    }
+    vn[i] = ColumnKernels::velocity(vn[i - 1], sum, ptn[i], dx, dptdx);
+  };
+
+  for(size_t i = begin; i < end; ++i)
+  {
+    for(size_t j = 0; j < Ncomp; ++j)
+    {
+      const size_t k = i * Ncomp + j;
+      const double dqdt = ColumnKernels::loadingRate(components[j].Kl, qeq[k], q[k]);
+      double dpdt = 0.0;  // the partial pressures at the entrance are fixed
+      if(i > 0)
+      {
+        const double difference = i < Ngrid ? ColumnKernels::dispersion(p[k + Ncomp], p[k], p[k - Ncomp])
+                                            : ColumnKernels::outletDispersion(p[k - Ncomp], p[k]);
+        dpdt = ColumnKernels::pressureRate(v[i - 1], p[k - Ncomp], v[i], p[k], components[j].D, difference,
+                                           ColumnKernels::gasTransfer(prefactor[j], qeq[k], q[k]), idx, idx2);
+      }
+      qn[k] = ColumnKernels::sspStage(stage, q0[k], q[k], dqdt, dt);
+      pn[k] = ColumnKernels::sspStage(stage, p0[k], p[k], dpdt, dt);
+      if(stage == 1)
+      {
+        Dqdt[k] = dqdt;
+        Dpdt[k] = dpdt;
+      }
+    }
+    computeEquilibriumLoading(i, &pn[i * Ncomp], &qeqn[i * Ncomp], ptn[i]);
+
+    // the velocity at i - 1 needs the partial pressures at i
+    if(i == 0)
+    {
+      vn[0] = v_in;
+    }
+    else if(i > 1)
+    {
+      velocity(i - 1);
+    }
+    if(i == Ngrid)
+    {
+      velocity(Ngrid);
+    }
+  }
+}
+
+void Breakthrough::computeEquilibriumLoadings()
+{
+    // calculate new equilibrium loadings Qeqnew corresponding to the new timestep
+  for(size_t i = 0; i < Ngrid + 1; ++i)
+  {
+    computeEquilibriumLoading(i, &Pnew[i * Ncomp], &Qeqnew[i * Ncomp], Pt[i]);
+  }
+
+  // check the total pressure at the outlet, it should not be negative
+//  if (Pt[0] + dptdx * L < 0.0)
+//  {
+//    throw std::runtime_error("Error: pressure gradient is too large (negative outlet pressure)\n");
+//  }
+}
+
+// the equilibrium loadings 'qeq' and the total pressure 'pt' at grid point i for the partial pressures 'p'
+void Breakthrough::computeEquilibriumLoading(size_t i, const double *p, double *qeq, double &pt)
+{
+  // estimation of total pressure Pt at each grid point from partial pressures
+  pt = ColumnKernels::totalPressure(p, 1, Ncomp);
+
+  // reuse the last mixture prediction of this grid point if its partial pressures barely changed
+  // (never before the first one: the change from -infinity is infinite)
+  const bool reuse = reusesEquilibrium();
+  if(reuse)
+  {
+    if(reusedPressures.empty())
+    {
+      reusedPressures.assign((Ngrid + 1) * Ncomp, -std::numeric_limits<double>::infinity());
+      reusedLoadings.assign((Ngrid + 1) * Ncomp, 0.0);
+      if(equilibriumReuseCorrection)
+      {
+        reusedGradients.assign((Ngrid + 1) * Ncomp * Ncomp, 0.0);
+      }
+    }
+    const double *last = &reusedPressures[i * Ncomp];
+    double change = 0.0;
+    double lastTotal = 0.0;
+    for(size_t j = 0; j < Ncomp; ++j)
+    {
+      change = std::max(change, std::abs(p[j] - last[j]));
+      lastTotal += std::max(0.0, last[j]);
+    }
+    ++equilibriumReuse.second;
+    if(change <= equilibriumReuseTolerance * lastTotal)
+    {
+      ++equilibriumReuse.first;
+      for(size_t j = 0; j < Ncomp; ++j)
+      {
+        double q = reusedLoadings[i * Ncomp + j];
+        if(equilibriumReuseCorrection)
+        {
+          for(size_t k = 0; k < Ncomp; ++k)
+          {
+            q += reusedGradients[(i * Ncomp + j) * Ncomp + k] * (p[k] - last[k]);
+          }
+        }
+        qeq[j] = q;
+      }
+      return;
+    }
+  }
+
+  // use the gas-phase mol-fractions and pt to compute the loadings in the adsorption mixture via mixture prediction
+  iastPerformance += ColumnKernels::predictLoadings(mixture, p, 1, pt, Yi, Xi, Ni,
+      &cachedP0[i * Ncomp * maxIsothermTerms], &cachedPsi[i * maxIsothermTerms]);
+
+  std::copy(Ni.begin(), Ni.end(), qeq);
+  if(reuse)
+  {
+    std::copy(p, p + Ncomp, &reusedPressures[i * Ncomp]);
+    std::copy(qeq, qeq + Ncomp, &reusedLoadings[i * Ncomp]);
+    if(equilibriumReuseCorrection)
+    {
+      equilibriumGradientAt(i, p, qeq, &reusedGradients[i * Ncomp * Ncomp]);
+    }
+  }
+}
+
+
+// calculate the derivatives Dq/dt and Dp/dt along the column
+void Breakthrough::computeFirstDerivatives(FieldVector &dqdtField,
+                                           FieldVector &dpdtField,
+                                           const FieldVector &q_eqField,
+                                           const FieldVector &qField,
+                                           const FieldVector &vField,
+                                           const FieldVector &pField)
+{
+  double *dqdt = assumeFieldAligned(dqdtField.data());
+  double *dpdt = assumeFieldAligned(dpdtField.data());
+  const double *q_eq = assumeFieldAligned(q_eqField.data());
+  const double *q = assumeFieldAligned(qField.data());
+  const double *v = assumeFieldAligned(vField.data());
+  const double *p = assumeFieldAligned(pField.data());
+  double idx = 1.0 / dx;
+  double idx2 = 1.0 / (dx * dx);
+
+  // first gridpoint
+  for(size_t j = 0; j < Ncomp; ++j)
+  {
+    dqdt[0 * Ncomp + j] = ColumnKernels::loadingRate(components[j].Kl, q_eq[0 * Ncomp + j], q[0 * Ncomp + j]);
+    dpdt[0 * Ncomp + j] = 0.0;
+  }
+
+  // middle gridpoints
+  for(size_t i = 1; i < Ngrid; i++)
+  {
+    for(size_t j = 0; j < Ncomp; ++j)
+    {
+      const size_t k = i * Ncomp + j;
+      dqdt[k] = ColumnKernels::loadingRate(components[j].Kl, q_eq[k], q[k]);
+      dpdt[k] = ColumnKernels::pressureRate(v[i - 1], p[k - Ncomp], v[i], p[k], components[j].D,
+                                            ColumnKernels::dispersion(p[k + Ncomp], p[k], p[k - Ncomp]),
+                                            ColumnKernels::gasTransfer(prefactor[j], q_eq[k], q[k]), idx, idx2);
+    }
+  }
+
+  // last gridpoint
+  for(size_t j = 0; j < Ncomp; ++j)
+  {
+    const size_t k = Ngrid * Ncomp + j;
+    dqdt[k] = ColumnKernels::loadingRate(components[j].Kl, q_eq[k], q[k]);
+    dpdt[k] = ColumnKernels::pressureRate(v[Ngrid - 1], p[k - Ncomp], v[Ngrid], p[k], components[j].D,
+                                          ColumnKernels::outletDispersion(p[k - Ncomp], p[k]),
+                                          ColumnKernels::gasTransfer(prefactor[j], q_eq[k], q[k]), idx, idx2);
+  }
+}
+
+// the transport part of computeFirstDerivatives: advection and axial dispersion of the gas phase
+void Breakthrough::computeTransportDerivatives(FieldVector &dqdtField, FieldVector &dpdtField,
+                                               const FieldVector &vField, const FieldVector &pField)
+{
+  double *dqdt = assumeFieldAligned(dqdtField.data());
+  double *dpdt = assumeFieldAligned(dpdtField.data());
+  const double *v = assumeFieldAligned(vField.data());
+  const double *p = assumeFieldAligned(pField.data());
+  double idx = 1.0 / dx;
+  double idx2 = 1.0 / (dx * dx);
+
+  // first gridpoint
+  for(size_t j = 0; j < Ncomp; ++j)
+  {
+    dqdt[0 * Ncomp + j] = 0.0;
+    dpdt[0 * Ncomp + j] = 0.0;
+  }
+
+  // middle gridpoints
+  for(size_t i = 1; i < Ngrid; i++)
+  {
+    for(size_t j = 0; j < Ncomp; ++j)
+    {
+      const size_t k = i * Ncomp + j;
+      dqdt[k] = 0.0;
+      dpdt[k] = ColumnKernels::transportRate(v[i - 1], p[k - Ncomp], v[i], p[k], components[j].D,
+                                             ColumnKernels::dispersion(p[k + Ncomp], p[k], p[k - Ncomp]), idx, idx2);
+    }
+  }
+
+  // last gridpoint
+  for(size_t j = 0; j < Ncomp; ++j)
+  {
+    const size_t k = Ngrid * Ncomp + j;
+    dqdt[k] = 0.0;
+    dpdt[k] = ColumnKernels::transportRate(v[Ngrid - 1], p[k - Ncomp], v[Ngrid], p[k], components[j].D,
+                                           ColumnKernels::outletDispersion(p[k - Ncomp], p[k]), idx, idx2);
+  }
+}
+
+// the mass-transfer part of computeFirstDerivatives: linear driving force between the gas and the adsorbed phase
+// (only for the selected components when 'selection' is given)
+void Breakthrough::computeMassTransferDerivatives(FieldVector &dqdtField, FieldVector &dpdtField,
+                                                  const FieldVector &q_eqField, const FieldVector &qField,
+                                                  const std::vector<bool> *selection)
+{
+  double *dqdt = assumeFieldAligned(dqdtField.data());
+  double *dpdt = assumeFieldAligned(dpdtField.data());
+  const double *q_eq = assumeFieldAligned(q_eqField.data());
+  const double *q = assumeFieldAligned(qField.data());
+  for(size_t i = 0; i < Ngrid + 1; i++)
+  {
+    for(size_t j = 0; j < Ncomp; ++j)
+    {
+      if(selection && !(*selection)[j])
+      {
+        dqdt[i * Ncomp + j] = 0.0;
+        dpdt[i * Ncomp + j] = 0.0;
+        continue;
+      }
+      dqdt[i * Ncomp + j] = ColumnKernels::loadingRate(components[j].Kl, q_eq[i * Ncomp + j], q[i * Ncomp + j]);
+      // the partial pressures at the entrance are fixed
+      dpdt[i * Ncomp + j] =
+          i == 0 ? 0.0 : ColumnKernels::gasTransfer(prefactor[j], q_eq[i * Ncomp + j], q[i * Ncomp + j]);
+    }
+  }
+}
+
+// the slow part of the multirate split, from Qnew, Qeqnew, Vnew and Pnew: transport and the mass transfer of the
+// slow components, as dQ/dt followed by dP/dt
+void Breakthrough::computeSlowDerivatives(double *dudt)
+{
+  const size_t vecLen = (Ngrid + 1) * Ncomp;
+  computeTransportDerivatives(Dqdt, Dpdt, Vnew, Pnew);
+  computeMassTransferDerivatives(Dqdtnew, Dpdtnew, Qeqnew, Qnew, &slowComponents);
+  for(size_t k = 0; k < vecLen; ++k)
+  {
+    dudt[k] = Dqdt[k] + Dqdtnew[k];
+    dudt[vecLen + k] = Dpdt[k] + Dpdtnew[k];
+  }
+}
+
+// in-place LU factorization with partial pivoting of a dense n x n block (row-major)
+static void factorizeBlock(double *a, size_t *pivots, size_t n)
+{
+  for(size_t k = 0; k < n; ++k)
+  {
+    size_t pivot = k;
+    for(size_t r = k + 1; r < n; ++r)
+    {
+      if(std::abs(a[r * n + k]) > std::abs(a[pivot * n + k])) pivot = r;
+    }
+    pivots[k] = pivot;
+    if(pivot != k)
+    {
+      std::swap_ranges(a + k * n, a + (k + 1) * n, a + pivot * n);
+    }
+    for(size_t r = k + 1; r < n; ++r)
+    {
+      a[r * n + k] /= a[k * n + k];
+      for(size_t c = k + 1; c < n; ++c)
+      {
+        a[r * n + c] -= a[r * n + k] * a[k * n + c];
+      }
+    }
+  }
+}
+
+static void solveBlock(const double *lu, const size_t *pivots, size_t n, double *x)
+{
+  for(size_t k = 0; k < n; ++k)
+  {
+    std::swap(x[k], x[pivots[k]]);
+    for(size_t r = k + 1; r < n; ++r)
+    {
+      x[r] -= lu[r * n + k] * x[k];
+    }
+  }
+  for(size_t k = n; k-- > 0;)
+  {
+    for(size_t c = k + 1; c < n; ++c)
+    {
+      x[k] -= lu[k * n + c] * x[c];
+    }
+    x[k] /= lu[k * n + k];
+  }
+}
+
+// The implicit part at grid point i is dq/dt = Kl (Qeq(p) - q) and dp/dt = -prefactor (Qeq(p) - q), so the blocks
+// of its Jacobian follow from G = d Qeq / d p, which is obtained by forward differences of the mixture prediction.
+void Breakthrough::setupMassTransferPreconditioner(const sunrealtype *y, bool recomputeJacobian, double gamma)
+{
+  const size_t vecLen = (Ngrid + 1) * Ncomp;
+  const size_t n = 2 * Ncomp;
+
+  if(recomputeJacobian || equilibriumJacobian.empty())
+  {
+    equilibriumJacobian.resize((Ngrid + 1) * Ncomp * Ncomp);
+    std::vector<double> p(Ncomp);
+    std::vector<double> qeq(Ncomp);
+    for(size_t i = 0; i < Ngrid + 1; ++i)
+    {
+      const sunrealtype *pi = y + vecLen + i * Ncomp;
+      std::copy(pi, pi + Ncomp, p.begin());
+      equilibriumLoadingsAt(i, p.data(), qeq);
+      equilibriumGradientAt(i, p.data(), qeq.data(), &equilibriumJacobian[i * Ncomp * Ncomp]);
+    }
+  }
+
+  // I - gamma J, with the loadings in the first Ncomp rows and columns and the partial pressures in the others
+  preconditionerBlocks.assign((Ngrid + 1) * n * n, 0.0);
+  preconditionerPivots.resize((Ngrid + 1) * n);
+  for(size_t i = 0; i < Ngrid + 1; ++i)
+  {
+    double *m = &preconditionerBlocks[i * n * n];
+    const double *g = &equilibriumJacobian[i * Ncomp * Ncomp];
+    for(size_t j = 0; j < n; ++j)
+    {
+      m[j * n + j] = 1.0;
+    }
+    for(size_t j = 0; j < Ncomp; ++j)
+    {
+      m[j * n + j] += gamma * components[j].Kl;
+      for(size_t k = 0; k < Ncomp; ++k)
+      {
+        m[j * n + Ncomp + k] -= gamma * components[j].Kl * g[j * Ncomp + k];
+      }
+      if(i > 0)
+      {
+        m[(Ncomp + j) * n + j] -= gamma * prefactor[j];
+        for(size_t k = 0; k < Ncomp; ++k)
+        {
+          m[(Ncomp + j) * n + Ncomp + k] += gamma * prefactor[j] * g[j * Ncomp + k];
+        }
+      }
+    }
+    factorizeBlock(m, &preconditionerPivots[i * n], n);
+  }
+}
+
+void Breakthrough::solveMassTransferPreconditioner(const sunrealtype *r, sunrealtype *z) const
+{
+  const size_t vecLen = (Ngrid + 1) * Ncomp;
+  const size_t n = 2 * Ncomp;
+  std::vector<double> x(n);
+  for(size_t i = 0; i < Ngrid + 1; ++i)
+  {
+    std::copy(r + i * Ncomp, r + (i + 1) * Ncomp, x.begin());
+    std::copy(r + vecLen + i * Ncomp, r + vecLen + (i + 1) * Ncomp, x.begin() + static_cast<std::ptrdiff_t>(Ncomp));
+    solveBlock(&preconditionerBlocks[i * n * n], &preconditionerPivots[i * n], n, x.data());
+    std::copy(x.begin(), x.begin() + static_cast<std::ptrdiff_t>(Ncomp), z + i * Ncomp);
+    std::copy(x.begin() + static_cast<std::ptrdiff_t>(Ncomp), x.end(), z + vecLen + i * Ncomp);
+  }
+}
+
+// equilibrium loadings for the partial pressures p at grid point i (warm-started from the cache of that point)
+void Breakthrough::equilibriumLoadingsAt(size_t i, const double *p, std::vector<double> &loadings)
+{
+  const double pt = ColumnKernels::totalPressure(p, 1, Ncomp);
+  iastPerformance += ColumnKernels::predictLoadings(mixture, p, 1, pt, Yi, Xi, Ni,
+      &cachedP0[i * Ncomp * maxIsothermTerms], &cachedPsi[i * maxIsothermTerms]);
+  std::copy(Ni.begin(), Ni.end(), loadings.begin());
+}
+
+// G = d Qeq / d p at grid point i by forward differences, gradient[j * Ncomp + k] = d Qeq_j / d p_k, for the
+// partial pressures 'p' with equilibrium loadings 'qeq'
+void Breakthrough::equilibriumGradientAt(size_t i, const double *p, const double *qeq, double *gradient)
+{
+  gradientPressures.resize(Ncomp);
+  gradientLoadings.resize(Ncomp);
+  double pt = 0.0;
+  for(size_t j = 0; j < Ncomp; ++j)
+  {
+    pt += std::max(p[j], 0.0);
+  }
+  for(size_t k = 0; k < Ncomp; ++k)
+  {
+    const double h = 1.0e-7 * std::max(std::abs(p[k]), 1.0e-3 * pt);
+    std::copy(p, p + Ncomp, gradientPressures.begin());
+    gradientPressures[k] += h;
+    equilibriumLoadingsAt(i, gradientPressures.data(), gradientLoadings);
+    for(size_t j = 0; j < Ncomp; ++j)
+    {
+      gradient[j * Ncomp + k] = (gradientLoadings[j] - qeq[j]) / h;
+    }
+  }
+}
+
+// Strang splitting of a time step: the stiff mass transfer, which only couples the components at the same grid
+// point, is solved implicitly per grid point between two half steps of the explicit transport, so that the time
+// step is limited by the transport (CFL) and not by the mass-transfer coefficients. The ordering is second-order
+// accurate. Starts from Q and P and leaves the new state in Qnew, Pnew, Qeqnew and Vnew.
+void Breakthrough::computeStrangStep()
+{
+  std::copy(Q.begin(), Q.end(), Qnew.begin());
+  std::copy(P.begin(), P.end(), Pnew.begin());
+  std::copy(Qeq.begin(), Qeq.end(), Qeqnew.begin());
+  std::copy(V.begin(), V.end(), Vnew.begin());
+
+  computeTransportStep(0.5 * dt, true);
+  computeMassTransferStep(dt);
+  computeTransportStep(0.5 * dt, false);
+
+  computeEquilibriumLoadings();
+  computeVelocity(massTransferRate.data());
+  computeFirstDerivatives(Dqdt, Dpdt, Qeqnew, Qnew, Vnew, Pnew);
+}
+
+// SSP-RK3 for the advection and dispersion of Pnew. The velocity follows the partial pressures at every stage; the
+// mass transfer enters it as the mean rate of the (latest) mass-transfer step, not as the instantaneous rate
+// prefactor (Qeq - q), which is stiff: right after transport the gas is far from equilibrium with the adsorbent.
+// 'velocityCurrent': Vnew already belongs to the state at the first stage.
+void Breakthrough::computeTransportStep(double h, bool velocityCurrent)
+{
+  std::copy(Pnew.begin(), Pnew.end(), Pstage.begin());
+
+  const std::array<double, 3> weightStage{ { 0.0, 0.75, 1.0 / 3.0 } };
+  for(size_t stage = 0; stage < 3; ++stage)
+  {
+    if(stage > 0 || !velocityCurrent)
+    {
+      for(size_t i = 0; i < Ngrid + 1; ++i)
+      {
+        Pt[i] = 0.0;
+        for(size_t j = 0; j < Ncomp; ++j)
+        {
+          Pt[i] += std::max(0.0, Pnew[i * Ncomp + j]);
+        }
+      }
+      computeVelocity(massTransferRate.data());
+    }
+    computeTransportDerivatives(Dqdtnew, Dpdtnew, Vnew, Pnew);
+
+    const double weight = weightStage[stage];
+    for(size_t k = 0; k < Pnew.size(); ++k)
+    {
+      Pnew[k] = weight * Pstage[k] + (1.0 - weight) * (Pnew[k] + h * Dpdtnew[k]);
+    }
+  }
+}
+
+// exp(a) of a dense n x n block (row-major) by scaling and squaring of its Taylor series
+static void exponentiateBlock(std::vector<double> &a, size_t n)
+{
+  double norm = 0.0;
+  for(size_t r = 0; r < n; ++r)
+  {
+    double sum = 0.0;
+    for(size_t c = 0; c < n; ++c) sum += std::abs(a[r * n + c]);
+    norm = std::max(norm, sum);
+  }
+  const int squarings = norm > 0.5 ? static_cast<int>(std::ceil(std::log2(norm / 0.5))) : 0;
+  const double scale = std::ldexp(1.0, -squarings);
+  for(double &x : a) x *= scale;
+
+  std::vector<double> term(n * n, 0.0), product(n * n), result(n * n, 0.0);
+  for(size_t r = 0; r < n; ++r)
+  {
+    term[r * n + r] = 1.0;
+    result[r * n + r] = 1.0;
+  }
+  auto multiply = [n](const std::vector<double> &x, const std::vector<double> &y, std::vector<double> &z)
+  {
+    for(size_t r = 0; r < n; ++r)
+    {
+      for(size_t c = 0; c < n; ++c)
+      {
+        double sum = 0.0;
+        for(size_t k = 0; k < n; ++k) sum += x[r * n + k] * y[k * n + c];
+        z[r * n + c] = sum;
+      }
+    }
+  };
+  for(size_t k = 1; k <= 16; ++k)
+  {
+    multiply(term, a, product);
+    for(size_t m = 0; m < n * n; ++m)
+    {
+      term[m] = product[m] / static_cast<double>(k);
+      result[m] += term[m];
+    }
+  }
+  for(int s = 0; s < squarings; ++s)
+  {
+    multiply(result, result, product);
+    result.swap(product);
+  }
+  a.swap(result);
+}
+
+// The mass transfer at a grid point, dq/dt = Kl (Qeq(p) - q) and dp/dt = -prefactor (Qeq(p) - q), leaves
+// p + c q unchanged (c = R T rho_p (1 - epsilon) / epsilon, prefactor = c Kl), so it reduces to Ncomp equations
+// f(q) = Kl (Qeq(p0 - c (q - q0)) - q) for the loadings, with Jacobian J = -Kl (I + c G), G = d Qeq / d p. These
+// are advanced analytically for the isotherm linearized at the start of the step (exponential Rosenbrock-Euler,
+// q = q0 + h phi1(h J) f(q0), second order): exact for linear isotherms and for any relaxation rate, so the
+// equilibrium is approached without overshoot however large Kl h is. phi1 follows from the exponential of the
+// augmented matrix [[h J, h f], [0, 0]]. The partial pressures at the entrance are fixed.
+void Breakthrough::computeMassTransferStep(double h)
+{
+  const double c = R * T * ((1.0 - epsilon) / epsilon) * rho_p;
+  const size_t n = Ncomp;
+  const size_t m = n + 1;
+
+  std::vector<double> q0(n), p0(n), qeq(n);
+  std::vector<double> gradient(n * n), augmented(m * m);
+
+  for(size_t i = 0; i < Ngrid + 1; ++i)
+  {
+    std::copy(&Qnew[i * n], &Qnew[i * n] + n, q0.begin());
+    std::copy(&Pnew[i * n], &Pnew[i * n] + n, p0.begin());
+    const bool fixedPressure = (i == 0);
+
+    // d Qeq / d p at the start of the step, by forward differences
+    equilibriumLoadingsAt(i, p0.data(), qeq);
+    std::fill(gradient.begin(), gradient.end(), 0.0);
+    if(!fixedPressure)
+    {
+      equilibriumGradientAt(i, p0.data(), qeq.data(), gradient.data());
+    }
+
+    std::fill(augmented.begin(), augmented.end(), 0.0);
+    for(size_t j = 0; j < n; ++j)
+    {
+      const double kl = components[j].Kl;
+      for(size_t k = 0; k < n; ++k)
+      {
+        augmented[j * m + k] = -h * kl * c * gradient[j * n + k];
+      }
+      augmented[j * m + j] -= h * kl;
+      augmented[j * m + n] = h * kl * (qeq[j] - q0[j]);
+    }
+    exponentiateBlock(augmented, m);
+
+    for(size_t j = 0; j < n; ++j)
+    {
+      const double q = q0[j] + augmented[j * m + n];
+      Qnew[i * n + j] = q;
+      Pnew[i * n + j] = fixedPressure ? p0[j] : p0[j] - c * (q - q0[j]);
+      massTransferRate[i * n + j] = (Pnew[i * n + j] - p0[j]) / h;
+    }
+  }
+}
+
+// calculate new velocity Vnew from Qnew, Qeqnew, Pnew, Pt
+// The velocity follows from the recurrence V[i] = V[i-1] + dx (sum[i] - V[i-1] dptdx) / Pt[i] along the column,
+// i.e. from the affine maps V[i] = a[i] V[i-1] + b[i] with a[i] = 1 - dx dptdx / Pt[i] and b[i] = dx sum[i] / Pt[i].
+// The coefficients are independent per grid point, and since the composition of affine maps is associative the
+// recurrence is evaluated as a scan: the column is split in 'velocityLanes' blocks, the maps are composed within
+// all blocks at once (lane-interleaved, so the loops over the blocks vectorize), a short serial pass carries the
+// velocity into each block, and the blocks are then swept again all at once. The result agrees with the serial
+// recurrence to round-off. 'transferRate' optionally replaces the mass transfer -prefactor (Qeq - q) of the
+// gas phase (e.g. by the mean rate of a split mass-transfer step).
+void Breakthrough::computeVelocity(const double *transferRate)
+{
+  double idx2 = 1.0 / (dx * dx);
+
+  // first grid point
+  velocityScale[0] = 0.0;
+  velocityShift[0] = v_in;
+
+  // middle gridpoints
+  for(size_t i = 1; i < Ngrid; ++i)
+  {
+    // sum = derivative at the actual gridpoint i
+    double sum = 0.0;
+    for(size_t j = 0; j < Ncomp; ++j)
+    {
+      const size_t k = i * Ncomp + j;
+      const double transfer =
+          transferRate ? transferRate[k] : ColumnKernels::gasTransfer(prefactor[j], Qeqnew[k], Qnew[k]);
+      sum = sum + transfer +
+            components[j].D * ColumnKernels::dispersion(Pnew[k - Ncomp], Pnew[k], Pnew[k + Ncomp]) * idx2;
+    }
+
+    const size_t index = (i % velocityBlock) * velocityLanes + i / velocityBlock;
+    velocityScale[index] = 1.0 - dx * dptdx / Pt[i];
+    velocityShift[index] = dx * sum / Pt[i];
+  }
+
+  // last grid point
+  double sum = 0.0;
+  for(size_t j = 0; j < Ncomp; ++j)
+  {
+    const size_t k = Ngrid * Ncomp + j;
+    const double transfer =
+        transferRate ? transferRate[k] : ColumnKernels::gasTransfer(prefactor[j], Qeqnew[k], Qnew[k]);
+    sum = sum + transfer + components[j].D * ColumnKernels::outletDispersion(Pnew[k - Ncomp], Pnew[k]) * idx2;
+  }
+  const size_t last = (Ngrid % velocityBlock) * velocityLanes + Ngrid / velocityBlock;
+  velocityScale[last] = 1.0 - dx * dptdx / Pt[Ngrid];
+  velocityShift[last] = dx * sum / Pt[Ngrid];
+
+  // compose the maps within every block
+  std::array<double, velocityLanes> scale;
+  std::array<double, velocityLanes> shift;
+  scale.fill(1.0);
+  shift.fill(0.0);
+  for(size_t k = 0; k < velocityBlock; ++k)
+  {
+    const double *a = &velocityScale[k * velocityLanes];
+    const double *b = &velocityShift[k * velocityLanes];
+    for(size_t lane = 0; lane < velocityLanes; ++lane)
+    {
+      scale[lane] *= a[lane];
+      shift[lane] = a[lane] * shift[lane] + b[lane];
+    }
+  }
+
+  // the velocity entering each block
+  std::array<double, velocityLanes> v;
+  double carry = 0.0;
+  for(size_t lane = 0; lane < velocityLanes; ++lane)
+  {
+    v[lane] = carry;
+    carry = scale[lane] * carry + shift[lane];
+  }
+
+  // sweep all blocks
+  for(size_t k = 0; k < velocityBlock; ++k)
+  {
+    const double *a = &velocityScale[k * velocityLanes];
+    const double *b = &velocityShift[k * velocityLanes];
+    for(size_t lane = 0; lane < velocityLanes; ++lane)
+    {
+      v[lane] = a[lane] * v[lane] + b[lane];
+    }
+    for(size_t lane = 0; lane < velocityLanes; ++lane)
+    {
+      const size_t i = lane * velocityBlock + k;
+      if(i < Ngrid + 1) Vnew[i] = v[lane];
+    }
+  }
+}
+
+std::string Breakthrough::repr() const
+{
+  std::string s;
+  s += "Column properties\n";
+  s += "=======================================================\n";
+  s += "Display-name:                          " + displayName + "\n";
+  s += "Temperature:                           " + std::to_string(T) + " [K]\n";
+  s += "Column length:                         " + std::to_string(L) + " [m]\n";
+  s += "Column void-fraction:                  " + std::to_string(epsilon) + " [-]\n";
+  s += "Particle density:                      " + std::to_string(rho_p) + " [kg/m^3]\n";
+  s += "Total pressure:                        " + std::to_string(p_total) + " [Pa]\n";
+  s += "Pressure gradient:                     " + std::to_string(dptdx) + " [Pa/m]\n";
+  s += "Column entrance interstitial velocity: " + std::to_string(v_in) + " [m/s]\n";
+  s += "\n\n";
+
+  s += "Breakthrough settings\n";
+  s += "=======================================================\n";
+  s += "Number of time steps:          " + std::to_string(Nsteps) + "\n";
+  s += "Print every step:              " + std::to_string(printEvery) + "\n";
+  s += "Write data every step:         " + std::to_string(writeEvery) + "\n";
+  s += "\n\n";
+
+  s += "Integration details\n";
+  s += "=======================================================\n";
+  s += "Time step:                     " + std::to_string(dt) + " [s]\n";
+  s += "Number of column grid points:  " + std::to_string(Ngrid) + "\n";
+  s += "Column spacing:                " + std::to_string(dx) + " [m]\n";
+  s += "\n\n";
+
+  s += "Component data\n";
+  s += "=======================================================\n";
+  s += "maximum isotherm terms:        " + std::to_string(maxIsothermTerms) + "\n";
+  for(size_t i = 0; i < Ncomp; ++i)
+  {
+    s += components[i].repr() + "\n";
+  }
+  return s;
+}
+
+void Breakthrough::createPlotScript()
+{
+  #if defined(WIN32) || defined(_WIN32) || defined(__WIN32__) || defined(__NT__)
+    std::ofstream stream_graphs("make_graphs.bat");
+    stream_graphs << "set PATH=%PATH%;C:\\Program Files\\gnuplot\\bin;C:\\Program Files\\ffmpeg-master-latest-win64-gpl\\bin;C:\\Program Files\\ffmpeg\\bin\n";
+    stream_graphs << "gnuplot.exe plot_breakthrough\n";
+  #else
+    std::ofstream stream_graphs("make_graphs");
+    stream_graphs << "#!/bin/sh\n";
+    stream_graphs << "export LC_ALL='en_US.UTF-8'\n";
+    stream_graphs << "cd -- \"$(dirname \"$0\")\"\n";
+    stream_graphs << "gnuplot plot_breakthrough\n";
+  #endif
+
+  #if (__cplusplus >= 201703L)
+    std::filesystem::path path{"make_graphs"};
+    std::filesystem::permissions(path, std::filesystem::perms::owner_exec, std::filesystem::perm_options::add);
+  #else 
+    chmod("make_graphs", S_IRWXU);
+  #endif
+
+  std::ofstream stream("plot_breakthrough");
+  stream << "set encoding utf8\n";
+  #if defined(WIN32) || defined(_WIN32) || defined(__WIN32__) || defined(__NT__)
+    stream << "set xlabel 'Dimensionless time, {/Arial-Italic τ}={/Arial-Italic tv/L} / [-]' font \"Arial,14\"\n";
+    stream << "set ylabel 'Concentration exit gas, {/Arial-Italic c}_i/{/Arial-Italic c}_{i,0} / [-]' offset 0.0,0 font \"Arial,14\"\n";
+    stream << "set key outside top center horizontal samplen 2.5 height 0.5 spacing 1.5 font 'Arial, 10'\n";
+  #else
+    stream << "set xlabel 'Dimensionless time, {/Helvetica-Italic τ}={/Helvetica-Italic tv/L} / [-]' font \"Helvetica,18\"\n";
+    stream << "set ylabel 'Concentration exit gas, {/Helvetica-Italic c}_i/{/Helvetica-Italic c}_{i,0} / [-]' offset 0.0,0 font \"Helvetica,18\"\n";
+    stream << "set key outside top center horizontal samplen 2.5 height 0.5 spacing 1.5 font 'Helvetica, 10'\n";
+  #endif
+  stream << "set bmargin 4\n";
+  stream << "set yrange[0:]\n";
+
+  stream << "set key title '" << displayName << " {/:Italic T}=" << T << " K, {/:Italic p_t}=" << p_total*1e-3 << " kPa'\n";
+
+  stream << "set output 'breakthrough_dimensionless.pdf'\n";
+  stream << "set term pdf color solid\n";
+
+  // colorscheme from book 'gnuplot in action', listing 12.7
+  stream << "set linetype 1 pt 5 ps 1 lw 4 lc rgb '0xee0000'\n";
+  stream << "set linetype 2 pt 7 ps 1 lw 4 lc rgb '0x008b00'\n";
+  stream << "set linetype 3 pt 9 ps 1 lw 4 lc rgb '0x0000cd'\n";
+  stream << "set linetype 4 pt 11 ps 1 lw 4 lc rgb '0xff3fb3'\n";
+  stream << "set linetype 5 pt 13 ps 1 lw 4 lc rgb '0x00cdcd'\n";
+  stream << "set linetype 6 pt 15 ps 1 lw 4 lc rgb '0xcd9b1d'\n";
+  stream << "set linetype 7 pt  4 ps 1 lw 4 lc rgb '0x8968ed'\n";
+  stream << "set linetype 8 pt  6 ps 1 lw 4 lc rgb '0x8b8b83'\n";
+  stream << "set linetype 9 pt  8 ps 1 lw 4 lc rgb '0x00bb00'\n";
+  stream << "set linetype 10 pt 10 ps 1 lw 4 lc rgb '0x1e90ff'\n";
+  stream << "set linetype 11 pt 12 ps 1 lw 4 lc rgb '0x8b2500'\n";
+  stream << "set linetype 12 pt 14 ps 1 lw 4 lc rgb '0x000000'\n";
+
+  stream << "ev=1\n";
+  stream << "plot \\\n";
+  for (size_t i = 0; i < Ncomp; i++)
+  {
+    std::string fileName = "component_" + std::to_string(i) + "_" + components[i].name + ".data";
+    stream << "    " << "\"" << fileName << "\"" << " us ($1):($3) every ev" << " title \""
+           << components[i].name << " (y_i=" << components[i].Yi0 << ")\""
+           << " with li lt " << i+1 << (i < Ncomp - 1 ? ",\\" : "") << "\n";
+  }
+  stream << "set output 'breakthrough.pdf'\n";
+  #if defined(WIN32) || defined(_WIN32) || defined(__WIN32__) || defined(__NT__)
+     stream << "set xlabel 'Time, {/Arial-Italic t} / [min.]' font \"Arial,14\"\n";
+  #else
+     stream << "set xlabel 'Time, {/Helvetica-Italic t} / [min.]' font \"Helvetica,18\"\n";
+  #endif
+  stream << "plot \\\n";
+  for (size_t i = 0; i < Ncomp; i++)
+  {
+    std::string fileName = "component_" + std::to_string(i) + "_" + components[i].name + ".data";
+    stream << "    " << "\"" << fileName << "\"" << " us ($2):($3) every ev" << " title \""
+           << components[i].name << " (y_i=" << components[i].Yi0 << ")\""
+           << " with li lt " << i+1 << (i < Ncomp - 1 ? ",\\" : "") << "\n";
+  }
+}
+
+void Breakthrough::createMovieScripts()
+{
+  if (!fullColumnProfiles())
+  {
+    std::cout << "Movie scripts are only written for the full column profiles (all fields, text format)\n";
+    return;
+  }
+
+  #if defined(WIN32) || defined(_WIN32) || defined(__WIN32__) || defined(__NT__)
+    std::ofstream makeMovieStream("make_movies.bat");
+    makeMovieStream << "CALL make_movie_V.bat %1 %2 %3 %4\n";
+    makeMovieStream << "CALL make_movie_Pt.bat %1 %2 %3 %4\n";
+    makeMovieStream << "CALL make_movie_Q.bat %1 %2 %3 %4\n";
+    makeMovieStream << "CALL make_movie_Qeq.bat %1 %2 %3 %4\n";
+    makeMovieStream << "CALL make_movie_P.bat %1 %2 %3 %4\n";
+    makeMovieStream << "CALL make_movie_Pnorm.bat %1 %2 %3 %4\n";
+    makeMovieStream << "CALL make_movie_Dpdt.bat %1 %2 %3 %4\n";
+    makeMovieStream << "CALL make_movie_Dqdt.bat %1 %2 %3 %4\n";
+  #else
+    std::ofstream makeMovieStream("make_movies");
+    makeMovieStream << "#!/bin/sh\n";
+    makeMovieStream << "cd -- \"$(dirname \"$0\")\"\n";
+    makeMovieStream << "./make_movie_V \"$@\"\n";
+    makeMovieStream << "./make_movie_Pt \"$@\"\n";
+    makeMovieStream << "./make_movie_Q \"$@\"\n";
+    makeMovieStream << "./make_movie_Qeq \"$@\"\n";
+    makeMovieStream << "./make_movie_P \"$@\"\n";
+    makeMovieStream << "./make_movie_Pnorm \"$@\"\n";
+    makeMovieStream << "./make_movie_Dpdt \"$@\"\n";
+    makeMovieStream << "./make_movie_Dqdt \"$@\"\n";
+  #endif
+
+  #if (__cplusplus >= 201703L)
+    std::filesystem::path path{"make_movies"};
+    std::filesystem::permissions(path, std::filesystem::perms::owner_exec, std::filesystem::perm_options::add);
+  #else 
+    chmod("make_movies", S_IRWXU);
+  #endif
+
+  createMovieScriptColumnV();
+  createMovieScriptColumnPt();
+  createMovieScriptColumnQ();
+  createMovieScriptColumnQeq();
+  createMovieScriptColumnP();
+  createMovieScriptColumnDpdt();
+  createMovieScriptColumnDqdt();
+  createMovieScriptColumnPnormalized();
+}
+
+// -crf 18: the range of the CRF scale is 0–51, where 0 is lossless, 23 is the default, 
+//          and 51 is worst quality possible; 18 is visually lossless or nearly so.
+// -pix_fmt yuv420p: needed on apple devices
+std::string movieScriptTemplate(std::string s)
+{
+  std::ostringstream stream;
+
+  #if defined(WIN32) || defined(_WIN32) || defined(__WIN32__) || defined(__NT__)
+    stream << "del column_movie_" << s << ".mp4\n";
+    stream << "set /A argVec[1]=1\n";
+    stream << "set /A argVec[2]=1200\n";
+    stream << "set /A argVec[3]=800\n";
+    stream << "set /A argVec[4]=18\n";
+    stream << "setlocal enabledelayedexpansion\n";
+    stream << "set argCount=0\n";
+    stream << "for %%x in (%*) do (\n";
+    stream << "   set /A argCount+=1\n";
+    stream << "   set \"argVec[!argCount!]=%%~x\"'n";
+    stream << ")\n";
+    stream << "set PATH=%PATH%;C:\\Program Files\\gnuplot\\bin;C:\\Program Files\\ffmpeg-master-latest-win64-gpl\\bin;C:\\Program Files\\ffmpeg\\bin\n";
+    stream << "gnuplot.exe -c plot_column_" << s << " %argVec[1]% %argVec[2]% %argVec[3]% | ffmpeg.exe -f png_pipe -s:v \"%argVec[2]%,%argVec[3]%\" -i pipe: -c:v libx264 -pix_fmt yuv420p -crf %argVec[4]% -c:a aac column_movie_" << s + ".mp4\n";
+  #else
+    stream << "rm -f " << "column_movie_" << s << ".mp4\n";
+    stream << "every=1\n";
+    stream << "format=\"-c:v libx265 -tag:v hvc1\"\n";
+    stream << "width=1200\n";
+    stream << "height=800\n";
+    stream << "quality=18\n";
+    stream << "while getopts e:w:h:q:l flag\n";
+    stream << "do\n";
+    stream << "    case \"${flag}\" in\n";
+    stream << "        e) every=${OPTARG};;\n";
+    stream << "        w) width=${OPTARG};;\n";
+    stream << "        h) height=${OPTARG};;\n";
+    stream << "        q) quality=${OPTARG};;\n";
+    stream << "        l) format=\"-c:v libx264\";;\n";
+    stream << "    esac\n";
+    stream << "done\n";
+    stream << "gnuplot -c plot_column_" << s << " $every $width $height | ffmpeg -f png_pipe -s:v \"${width},${height}\" -i pipe: $format -pix_fmt yuv420p -crf $quality -c:a aac column_movie_" << s + ".mp4\n";
+  #endif
+  return stream.str();
+}
+
+void Breakthrough::createMovieScriptColumnV()
+{
+  #if defined(WIN32) || defined(_WIN32) || defined(__WIN32__) || defined(__NT__)
+    std::ofstream makeMovieStream("make_movie_V.bat");
+  #else
+    std::ofstream makeMovieStream("make_movie_V");
+    makeMovieStream << "#!/bin/sh\n";
+    makeMovieStream << "cd -- \"$(dirname \"$0\")\"\n";
+  #endif
+  makeMovieStream << movieScriptTemplate("V");
+
+  #if (__cplusplus >= 201703L)
+    std::filesystem::path path{"make_movie_V"};
+    std::filesystem::permissions(path, std::filesystem::perms::owner_exec, std::filesystem::perm_options::add);
+  #else
+    chmod("make_movie_V", S_IRWXU);
+  #endif
+
+  std::ofstream stream("plot_column_V");
+
+  stream << "set encoding utf8\n";
+  #if defined(WIN32) || defined(_WIN32) || defined(__WIN32__) || defined(__NT__)
+    stream << "set terminal pngcairo size ARG2,ARG3 enhanced font 'Arial,10'\n";
+    stream << "set xlabel 'Adsorber position / [m]' font 'Arial,14'\n";
+    stream << "set ylabel 'Interstitial velocity, {/Arial-Italic v} / [m/s]' offset 0.0,0 font 'Arial,14'\n";
+    stream << "set key outside top center horizontal samplen 2.5 height 0.5 spacing 1.5 font 'Arial, 10'\n";
+  #else
+    stream << "set terminal pngcairo size ARG2,ARG3 enhanced font 'Helvetica,10'\n";
+    stream << "set xlabel 'Adsorber position / [m]' font 'Helvetica,18'\n";
+    stream << "set ylabel 'Interstitial velocity, {/Helvetica-Italic v} / [m/s]' offset 0.0,0 font 'Helvetica,18'\n";
+    stream << "set key outside top center horizontal samplen 2.5 height 0.5 spacing 1.5 font 'Helvetica, 10'\n";
+  #endif
+
+  // colorscheme from book 'gnuplot in action', listing 12.7
+  stream << "set linetype 1 pt 5 ps 1 lw 4 lc rgb '0xee0000'\n";
+  stream << "set linetype 2 pt 7 ps 1 lw 4 lc rgb '0x008b00'\n";
+  stream << "set linetype 3 pt 9 ps 1 lw 4 lc rgb '0x0000cd'\n";
+  stream << "set linetype 4 pt 11 ps 1 lw 4 lc rgb '0xff3fb3'\n";
+  stream << "set linetype 5 pt 13 ps 1 lw 4 lc rgb '0x00cdcd'\n";
+  stream << "set linetype 6 pt 15 ps 1 lw 4 lc rgb '0xcd9b1d'\n";
+  stream << "set linetype 7 pt  4 ps 1 lw 4 lc rgb '0x8968ed'\n";
+  stream << "set linetype 8 pt  6 ps 1 lw 4 lc rgb '0x8b8b83'\n";
+  stream << "set linetype 9 pt  8 ps 1 lw 4 lc rgb '0x00bb00'\n";
+  stream << "set linetype 10 pt 10 ps 1 lw 4 lc rgb '0x1e90ff'\n";
+  stream << "set linetype 11 pt 12 ps 1 lw 4 lc rgb '0x8b2500'\n";
+  stream << "set linetype 12 pt 14 ps 1 lw 4 lc rgb '0x000000'\n";
+
+  stream << "set bmargin 4\n";
+  stream << "set title '" << displayName << " {/:Italic T}=" << T << " K, {/:Italic p_t}=" << p_total*1e-3 << " kPa'\n";
+  stream << "stats 'column.data' us 2 nooutput\n";
+  stream << "max=STATS_max\n";
+  stream << "stats 'column.data' us 1 nooutput\n";
+  stream << "set xrange[0:STATS_max]\n";
+  stream << "set yrange[0:1.1*max]\n";
+  stream << "ev=int(ARG1)\n";
+  stream << "do for [i=0:int((STATS_blocks-2)/ev)] {\n";
+  stream << "  plot \\\n";
+  stream << "    " << "'column.data'" << " us 1:2 index ev*i notitle with li lt 1,\\\n";
+  stream << "    " << "'column.data'" << " us 1:2 index ev*i notitle with po lt 1\n";
+  stream << "}\n";
+}
+
+
+void Breakthrough::createMovieScriptColumnPt()
+{
+  #if defined(WIN32) || defined(_WIN32) || defined(__WIN32__) || defined(__NT__)
+    std::ofstream makeMovieStream("make_movie_Pt.bat");
+  #else
+    std::ofstream makeMovieStream("make_movie_Pt");
+    makeMovieStream << "#!/bin/sh\n";
+    makeMovieStream << "cd -- \"$(dirname \"$0\")\"\n";
+  #endif
+  makeMovieStream << movieScriptTemplate("Pt");
+
+  #if (__cplusplus >= 201703L)
+    std::filesystem::path path{"make_movie_Pt"};
+    std::filesystem::permissions(path, std::filesystem::perms::owner_exec, std::filesystem::perm_options::add);
+  #else
+    chmod("make_movie_Pt", S_IRWXU);
+  #endif
+
+  std::ofstream stream("plot_column_Pt");
+
+  stream << "set encoding utf8\n";
+  #if defined(WIN32) || defined(_WIN32) || defined(__WIN32__) || defined(__NT__)
+    stream << "set terminal pngcairo size ARG2,ARG3 enhanced font 'Arial,10'\n";
+    stream << "set xlabel 'Adsorber position / [m]' font 'Arial,14'\n";
+    stream << "set ylabel 'Total Pressure, {/Arial-Italic p_t} / [Pa]' offset 0.0,0 font 'Arial,14'\n";
+    stream << "set key outside top center horizontal samplen 2.5 height 0.5 spacing 1.5 font 'Arial, 10'\n";
+  #else 
+    stream << "set terminal pngcairo size ARG2,ARG3 enhanced font 'Helvetica,10'\n";
+    stream << "set xlabel 'Adsorber position / [m]' font 'Helvetica,18'\n";
+    stream << "set ylabel 'Total Pressure, {/Helvetica-Italic p_t} / [Pa]' offset 0.0,0 font 'Helvetica,18'\n";
+    stream << "set key outside top center horizontal samplen 2.5 height 0.5 spacing 1.5 font 'Helvetica, 10'\n";
+  #endif
+
+  // colorscheme from book 'gnuplot in action', listing 12.7
+  stream << "set linetype 1 pt 5 ps 1 lw 4 lc rgb '0xee0000'\n";
+  stream << "set linetype 2 pt 7 ps 1 lw 4 lc rgb '0x008b00'\n";
+  stream << "set linetype 3 pt 9 ps 1 lw 4 lc rgb '0x0000cd'\n";
+  stream << "set linetype 4 pt 11 ps 1 lw 4 lc rgb '0xff3fb3'\n";
+  stream << "set linetype 5 pt 13 ps 1 lw 4 lc rgb '0x00cdcd'\n";
+  stream << "set linetype 6 pt 15 ps 1 lw 4 lc rgb '0xcd9b1d'\n";
+  stream << "set linetype 7 pt  4 ps 1 lw 4 lc rgb '0x8968ed'\n";
+  stream << "set linetype 8 pt  6 ps 1 lw 4 lc rgb '0x8b8b83'\n";
+  stream << "set linetype 9 pt  8 ps 1 lw 4 lc rgb '0x00bb00'\n";
+  stream << "set linetype 10 pt 10 ps 1 lw 4 lc rgb '0x1e90ff'\n";
+  stream << "set linetype 11 pt 12 ps 1 lw 4 lc rgb '0x8b2500'\n";
+  stream << "set linetype 12 pt 14 ps 1 lw 4 lc rgb '0x000000'\n";
+
+  stream << "set bmargin 4\n";
+  stream << "set title '" << displayName << " {/:Italic T}=" << T << " K, {/:Italic p_t}=" << p_total*1e-3 << " kPa'\n";
+  stream << "stats 'column.data' us 3 nooutput\n";
+  stream << "max=STATS_max\n";
+  stream << "stats 'column.data' us 1 nooutput\n";
+  stream << "set xrange[0:STATS_max]\n";
+  stream << "set yrange[0:1.1*max]\n";
+  stream << "ev=int(ARG1)\n";
+  stream << "do for [i=0:int((STATS_blocks-2)/ev)] {\n";
+  stream << "  plot \\\n";
+  stream << "    " << "'column.data'" << " us 1:3 index ev*i notitle with li lt 1,\\\n";
+  stream << "    " << "'column.data'" << " us 1:3 index ev*i notitle with po lt 1\n";
+  stream << "}\n";
+}
+
+void Breakthrough::createMovieScriptColumnQ()
+{
+  #if defined(WIN32) || defined(_WIN32) || defined(__WIN32__) || defined(__NT__)
+    std::ofstream makeMovieStream("make_movie_Q.bat");
+  #else
+    std::ofstream makeMovieStream("make_movie_Q");
+    makeMovieStream << "#!/bin/sh\n";
+    makeMovieStream << "cd -- \"$(dirname \"$0\")\"\n";
+  #endif
+  makeMovieStream << movieScriptTemplate("Q");
+
+  #if (__cplusplus >= 201703L)
+    std::filesystem::path path{"make_movie_Q"};
+    std::filesystem::permissions(path, std::filesystem::perms::owner_exec, std::filesystem::perm_options::add);
+  #else
+    chmod("make_movie_Q", S_IRWXU);
+  #endif
+
+  std::ofstream stream("plot_column_Q");
+
+  stream << "set encoding utf8\n";
+  #if defined(WIN32) || defined(_WIN32) || defined(__WIN32__) || defined(__NT__)
+    stream << "set terminal pngcairo size ARG2,ARG3 enhanced font 'Arial,10'\n";
+    stream << "set xlabel 'Adsorber position / [m]' font 'Arial,14'\n";
+    stream << "set ylabel 'Concentration, {/Arial-Italic c}_i / [mol/kg]' offset 0.0,0 font 'Arial,14'\n";
+    stream << "set key outside top center horizontal samplen 2.5 height 0.5 spacing 1.5 font 'Arial, 10'\n";
+  #else
+    stream << "set terminal pngcairo size ARG2,ARG3 enhanced font 'Helvetica,10'\n";
+    stream << "set xlabel 'Adsorber position / [m]' font 'Helvetica,18'\n";
+    stream << "set ylabel 'Concentration, {/Helvetica-Italic c}_i / [mol/kg]' offset 0.0,0 font 'Helvetica,18'\n";
+    stream << "set key outside top center horizontal samplen 2.5 height 0.5 spacing 1.5 font 'Helvetica, 10'\n";
+  #endif
+
+  // colorscheme from book 'gnuplot in action', listing 12.7
+  stream << "set linetype 1 pt 5 ps 1 lw 4 lc rgb '0xee0000'\n";
+  stream << "set linetype 2 pt 7 ps 1 lw 4 lc rgb '0x008b00'\n";
+  stream << "set linetype 3 pt 9 ps 1 lw 4 lc rgb '0x0000cd'\n";
+  stream << "set linetype 4 pt 11 ps 1 lw 4 lc rgb '0xff3fb3'\n";
+  stream << "set linetype 5 pt 13 ps 1 lw 4 lc rgb '0x00cdcd'\n";
+  stream << "set linetype 6 pt 15 ps 1 lw 4 lc rgb '0xcd9b1d'\n";
+  stream << "set linetype 7 pt  4 ps 1 lw 4 lc rgb '0x8968ed'\n";
+  stream << "set linetype 8 pt  6 ps 1 lw 4 lc rgb '0x8b8b83'\n";
+  stream << "set linetype 9 pt  8 ps 1 lw 4 lc rgb '0x00bb00'\n";
+  stream << "set linetype 10 pt 10 ps 1 lw 4 lc rgb '0x1e90ff'\n";
+  stream << "set linetype 11 pt 12 ps 1 lw 4 lc rgb '0x8b2500'\n";
+  stream << "set linetype 12 pt 14 ps 1 lw 4 lc rgb '0x000000'\n";
+
+  stream << "set bmargin 4\n";
+  stream << "set key title '" << displayName << " {/:Italic T}=" << T << " K, {/:Italic p_t}=" << p_total*1e-3 << " kPa'\n";
+  stream << "stats 'column.data' nooutput\n";
+  stream << "max = 0.0;\n";
+  stream << "do for [i=4:STATS_columns:6] {\n";
+  stream << "  stats 'column.data' us i nooutput\n";
+  stream << "  if (max<STATS_max) {\n";
+  stream << "    max=STATS_max\n";
+  stream << "  }\n";
+  stream << "}\n";
+  stream << "stats 'column.data' us 1 nooutput\n";
+  stream << "set xrange[0:STATS_max]\n";
+  stream << "set yrange[0:1.1*max]\n";
+  stream << "ev=int(ARG1)\n";
+  stream << "do for [i=0:int((STATS_blocks-2)/ev)] {\n";
+  stream << "  plot \\\n";
+  for (size_t i = 0; i < Ncomp; i++)
+  {
+    stream << "    " << "'column.data'" << " us 1:" << std::to_string(4 + i * 6) << " index ev*i notitle "
+           << " with li lt " << i+1 << ",\\\n";
+  }
+  for (size_t i = 0; i < Ncomp; i++)
+  {
+    stream << "    " << "'column.data'" << " us 1:" << std::to_string(4 + i * 6) << " index ev*i title '"
+           << components[i].name << " (y_i=" << components[i].Yi0 << ")'"
+           << " with po lt " << i+1 << (i < Ncomp - 1 ? ",\\" : "") << "\n";
+  }
+  stream << "}\n";
+}
+
+void Breakthrough::createMovieScriptColumnQeq()
+{
+  #if defined(WIN32) || defined(_WIN32) || defined(__WIN32__) || defined(__NT__)
+    std::ofstream makeMovieStream("make_movie_Qeq.bat");
+  #else
+    std::ofstream makeMovieStream("make_movie_Qeq");
+    makeMovieStream << "#!/bin/sh\n";
+    makeMovieStream << "cd -- \"$(dirname \"$0\")\"\n";
+  #endif
+  makeMovieStream << movieScriptTemplate("Qeq");
+
+  #if (__cplusplus >= 201703L)
+    std::filesystem::path path{"make_movie_Qeq"};
+    std::filesystem::permissions(path, std::filesystem::perms::owner_exec, std::filesystem::perm_options::add);
+  #else
+    chmod("make_movie_Qeq", S_IRWXU);
+  #endif
+
+  std::ofstream stream("plot_column_Qeq");
+
+  stream << "set encoding utf8\n";
+  #if defined(WIN32) || defined(_WIN32) || defined(__WIN32__) || defined(__NT__)
+    stream << "set terminal pngcairo size ARG2,ARG3 enhanced font 'Arial,10'\n";
+    stream << "set xlabel 'Adsorber position / [m]' font 'Arial,14'\n";
+    stream << "set ylabel 'Concentration, {/Arial-Italic c}_i / [mol/kg]' offset 0.0,0 font 'Arial,14'\n";
+    stream << "set key outside top center horizontal samplen 2.5 height 0.5 spacing 1.5 font 'Arial, 10'\n";
+  #else
+    stream << "set terminal pngcairo size ARG2,ARG3 enhanced font 'Helvetica,10'\n";
+    stream << "set xlabel 'Adsorber position / [m]' font 'Helvetica,18'\n";
+    stream << "set ylabel 'Concentration, {/Helvetica-Italic c}_i / [mol/kg]' offset 0.0,0 font 'Helvetica,18'\n";
+    stream << "set key outside top center horizontal samplen 2.5 height 0.5 spacing 1.5 font 'Helvetica, 10'\n";
+  #endif
+  
+  // colorscheme from book 'gnuplot in action', listing 12.7
+  stream << "set linetype 1 pt 5 ps 1 lw 4 lc rgb '0xee0000'\n";
+  stream << "set linetype 2 pt 7 ps 1 lw 4 lc rgb '0x008b00'\n";
+  stream << "set linetype 3 pt 9 ps 1 lw 4 lc rgb '0x0000cd'\n";
+  stream << "set linetype 4 pt 11 ps 1 lw 4 lc rgb '0xff3fb3'\n";
+  stream << "set linetype 5 pt 13 ps 1 lw 4 lc rgb '0x00cdcd'\n";
+  stream << "set linetype 6 pt 15 ps 1 lw 4 lc rgb '0xcd9b1d'\n";
+  stream << "set linetype 7 pt  4 ps 1 lw 4 lc rgb '0x8968ed'\n";
+  stream << "set linetype 8 pt  6 ps 1 lw 4 lc rgb '0x8b8b83'\n";
+  stream << "set linetype 9 pt  8 ps 1 lw 4 lc rgb '0x00bb00'\n";
+  stream << "set linetype 10 pt 10 ps 1 lw 4 lc rgb '0x1e90ff'\n";
+  stream << "set linetype 11 pt 12 ps 1 lw 4 lc rgb '0x8b2500'\n";
+  stream << "set linetype 12 pt 14 ps 1 lw 4 lc rgb '0x000000'\n";
+
+  stream << "set bmargin 4\n";
+  stream << "set key title '" << displayName << " {/:Italic T}=" << T << " K, {/:Italic p_t}=" << p_total*1e-3 << " kPa'\n";
+  stream << "stats 'column.data' nooutput\n";
+  stream << "max = 0.0;\n";
+  stream << "do for [i=5:STATS_columns:6] {\n";
+  stream << "  stats 'column.data' us i nooutput\n";
+  stream << "  if (max<STATS_max) {\n";
+  stream << "    max=STATS_max\n";
+  stream << "  }\n";
+  stream << "}\n";
+  stream << "stats 'column.data' us 1 nooutput\n";
+  stream << "set xrange[0:STATS_max]\n";
+  stream << "set yrange[0:1.1*max]\n";
+  stream << "ev=int(ARG1)\n";
+  stream << "do for [i=0:int((STATS_blocks-2)/ev)] {\n";
+  stream << "  plot \\\n";
+  for (size_t i = 0; i < Ncomp; i++)
+  {
+    stream << "    " << "'column.data'" << " us 1:" << std::to_string(5 + i * 6) << " index ev*i notitle "
+           << " with li lt " << i+1 << ",\\\n";
+  }
+  for (size_t i = 0; i < Ncomp; i++)
+  {
+    stream << "    " << "'column.data'" << " us 1:" << std::to_string(5 + i * 6) << " index ev*i title '"
+           << components[i].name << " (y_i=" << components[i].Yi0 << ")'"
+           << " with po lt " << i+1 << (i < Ncomp - 1 ? ",\\" : "") << "\n";
+  }
+  stream << "}\n";
+}
+
+void Breakthrough::createMovieScriptColumnP()
+{
+  #if defined(WIN32) || defined(_WIN32) || defined(__WIN32__) || defined(__NT__)
+    std::ofstream makeMovieStream("make_movie_P.bat");
+  #else
+    std::ofstream makeMovieStream("make_movie_P");
+    makeMovieStream << "#!/bin/sh\n";
+    makeMovieStream << "cd -- \"$(dirname \"$0\")\"\n";
+  #endif
+  makeMovieStream << movieScriptTemplate("P");
+
+  #if (__cplusplus >= 201703L)
+    std::filesystem::path path{"make_movie_P"};
+    std::filesystem::permissions(path, std::filesystem::perms::owner_exec, std::filesystem::perm_options::add);
+  #else
+    chmod("make_movie_P", S_IRWXU);
+  #endif
+
+  std::ofstream stream("plot_column_P");
+
+  stream << "set encoding utf8\n";
+  #if defined(WIN32) || defined(_WIN32) || defined(__WIN32__) || defined(__NT__)
+    stream << "set terminal pngcairo size ARG2,ARG3 enhanced font 'Arial,10'\n";
+    stream << "set xlabel 'Adsorber position / [m]' font 'Arial,14'\n";
+    stream << "set ylabel 'Partial pressure, {/Arial-Italic p}_i / [Pa]' offset 0.0,0 font 'Arial,14'\n";
+    stream << "set key outside top center horizontal samplen 2.5 height 0.5 spacing 1.5 font 'Arial, 10'\n";
+  #else
+    stream << "set terminal pngcairo size ARG2,ARG3 enhanced font 'Helvetica,10'\n";
+    stream << "set xlabel 'Adsorber position / [m]' font 'Helvetica,18'\n";
+    stream << "set ylabel 'Partial pressure, {/Helvetica-Italic p}_i / [Pa]' offset 0.0,0 font 'Helvetica,18'\n";
+    stream << "set key outside top center horizontal samplen 2.5 height 0.5 spacing 1.5 font 'Helvetica, 10'\n";
+  #endif
+
+  // colorscheme from book 'gnuplot in action', listing 12.7
+  stream << "set linetype 1 pt 5 ps 1 lw 4 lc rgb '0xee0000'\n";
+  stream << "set linetype 2 pt 7 ps 1 lw 4 lc rgb '0x008b00'\n";
+  stream << "set linetype 3 pt 9 ps 1 lw 4 lc rgb '0x0000cd'\n";
+  stream << "set linetype 4 pt 11 ps 1 lw 4 lc rgb '0xff3fb3'\n";
+  stream << "set linetype 5 pt 13 ps 1 lw 4 lc rgb '0x00cdcd'\n";
+  stream << "set linetype 6 pt 15 ps 1 lw 4 lc rgb '0xcd9b1d'\n";
+  stream << "set linetype 7 pt  4 ps 1 lw 4 lc rgb '0x8968ed'\n";
+  stream << "set linetype 8 pt  6 ps 1 lw 4 lc rgb '0x8b8b83'\n";
+  stream << "set linetype 9 pt  8 ps 1 lw 4 lc rgb '0x00bb00'\n";
+  stream << "set linetype 10 pt 10 ps 1 lw 4 lc rgb '0x1e90ff'\n";
+  stream << "set linetype 11 pt 12 ps 1 lw 4 lc rgb '0x8b2500'\n";
+  stream << "set linetype 12 pt 14 ps 1 lw 4 lc rgb '0x000000'\n";
+
+  stream << "set bmargin 4\n";
+  stream << "set key title '" << displayName << " {/:Italic T}=" << T << " K, {/:Italic p_t}=" << p_total*1e-3 << " kPa'\n";
+  stream << "stats 'column.data' nooutput\n";
+  stream << "max = 0.0;\n";
+  stream << "do for [i=6:STATS_columns:6] {\n";
+  stream << "  stats 'column.data' us i nooutput\n";
+  stream << "  if (max<STATS_max) {\n";
+  stream << "    max=STATS_max\n";
+  stream << "  }\n";
+  stream << "}\n";
+  stream << "stats 'column.data' us 1 nooutput\n";
+  stream << "set xrange[0:STATS_max]\n";
+  stream << "set yrange[0:1.1*max]\n";
+  stream << "ev=int(ARG1)\n";
+  stream << "do for [i=0:int((STATS_blocks-2)/ev)] {\n";
+  stream << "  plot \\\n";
+  for (size_t i = 0; i < Ncomp; i++)
+  {
+    stream << "    " << "'column.data'" << " us 1:" << std::to_string(6 + i * 6) << " index ev*i notitle "
+           << " with li lt " << i+1 << ",\\\n";
+  }
+  for (size_t i = 0; i < Ncomp; i++)
+  {
+    stream << "    " << "'column.data'" << " us 1:" << std::to_string(6 + i * 6) << " index ev*i title '"
+           << components[i].name << " (y_i=" << components[i].Yi0 << ")'"
+           << " with po lt " << i+1 << (i < Ncomp - 1 ? ",\\" : "") << "\n";
+  }
+  stream << "}\n";
+}
+
+void Breakthrough::createMovieScriptColumnPnormalized()
+{
+  #if defined(WIN32) || defined(_WIN32) || defined(__WIN32__) || defined(__NT__)
+    std::ofstream makeMovieStream("make_movie_Pnorm.bat");
+  #else
+    std::ofstream makeMovieStream("make_movie_Pnorm");
+    makeMovieStream << "#!/bin/sh\n";
+    makeMovieStream << "cd -- \"$(dirname \"$0\")\"\n";
+  #endif
+  makeMovieStream << movieScriptTemplate("Pnorm");
+
+  #if (__cplusplus >= 201703L)
+    std::filesystem::path path{"make_movie_Pnorm"};
+    std::filesystem::permissions(path, std::filesystem::perms::owner_exec, std::filesystem::perm_options::add);
+  #else
+    chmod("make_movie_Pnorm", S_IRWXU);
+  #endif
+
+  std::ofstream stream("plot_column_Pnorm");
+
+  stream << "set encoding utf8\n";
+  #if defined(WIN32) || defined(_WIN32) || defined(__WIN32__) || defined(__NT__)
+    stream << "set terminal pngcairo size ARG2,ARG3 enhanced font 'Arial,10'\n";
+    stream << "set xlabel 'Adsorber position / [m]' font 'Arial,14'\n";
+    stream << "set ylabel 'Partial pressure, {/Arial-Italic p}_i / [-]' offset 0.0,0 font 'Arial,14'\n";
+    stream << "set key outside top center horizontal samplen 2.5 height 0.5 spacing 1.5 font 'Arial, 10'\n";
+  #else
+    stream << "set terminal pngcairo size ARG2,ARG3 enhanced font 'Helvetica,10'\n";
+    stream << "set xlabel 'Adsorber position / [m]' font 'Helvetica,18'\n";
+    stream << "set ylabel 'Partial pressure, {/Helvetica-Italic p}_i / [-]' offset 0.0,0 font 'Helvetica,18'\n";
+    stream << "set key outside top center horizontal samplen 2.5 height 0.5 spacing 1.5 font 'Helvetica, 10'\n";
+  #endif
+
+  // colorscheme from book 'gnuplot in action', listing 12.7
+  stream << "set linetype 1 pt 5 ps 1 lw 4 lc rgb '0xee0000'\n";
+  stream << "set linetype 2 pt 7 ps 1 lw 4 lc rgb '0x008b00'\n";
+  stream << "set linetype 3 pt 9 ps 1 lw 4 lc rgb '0x0000cd'\n";
+  stream << "set linetype 4 pt 11 ps 1 lw 4 lc rgb '0xff3fb3'\n";
+  stream << "set linetype 5 pt 13 ps 1 lw 4 lc rgb '0x00cdcd'\n";
+  stream << "set linetype 6 pt 15 ps 1 lw 4 lc rgb '0xcd9b1d'\n";
+  stream << "set linetype 7 pt  4 ps 1 lw 4 lc rgb '0x8968ed'\n";
+  stream << "set linetype 8 pt  6 ps 1 lw 4 lc rgb '0x8b8b83'\n";
+  stream << "set linetype 9 pt  8 ps 1 lw 4 lc rgb '0x00bb00'\n";
+  stream << "set linetype 10 pt 10 ps 1 lw 4 lc rgb '0x1e90ff'\n";
+  stream << "set linetype 11 pt 12 ps 1 lw 4 lc rgb '0x8b2500'\n";
+  stream << "set linetype 12 pt 14 ps 1 lw 4 lc rgb '0x000000'\n";
+
+  stream << "set bmargin 4\n";
+  stream << "set key title '" << displayName << " {/:Italic T}=" << T << " K, {/:Italic p_t}=" << p_total*1e-3 << " kPa'\n";
+  stream << "stats 'column.data' nooutput\n";
+  stream << "max = 0.0;\n";
+  stream << "do for [i=7:STATS_columns:6] {\n";
+  stream << "  stats 'column.data' us i nooutput\n";
+  stream << "  if (max<STATS_max) {\n";
+  stream << "    max=STATS_max\n";
+  stream << "  }\n";
+  stream << "}\n";
+  stream << "stats 'column.data' us 1 nooutput\n";
+  stream << "set xrange[0:STATS_max]\n";
+  stream << "set yrange[0:1.1*max]\n";
+  stream << "ev=int(ARG1)\n";
+  stream << "do for [i=0:int((STATS_blocks-2)/ev)] {\n";
+  stream << "  plot \\\n";
+  for (size_t i = 0; i < Ncomp; i++)
+  {
+    stream << "    " << "'column.data'" << " us 1:" << std::to_string(7 + i * 6) << " index ev*i notitle "
+           << " with li lt " << i+1 << ",\\\n";
+  }
+  for (size_t i = 0; i < Ncomp; i++)
+  {
+    stream << "    " << "'column.data'" << " us 1:" << std::to_string(7 + i * 6) << " index ev*i title '"
+           << components[i].name << " (y_i=" << components[i].Yi0 << ")'"
+           << " with po lt " << i+1 << (i < Ncomp - 1 ? ",\\" : "") << "\n";
+  }
+  stream << "}\n";
+}
+
+void Breakthrough::createMovieScriptColumnDpdt()
+{
+  #if defined(WIN32) || defined(_WIN32) || defined(__WIN32__) || defined(__NT__)
+    std::ofstream makeMovieStream("make_movie_Dpdt.bat");
+  #else
+    std::ofstream makeMovieStream("make_movie_Dpdt");
+    makeMovieStream << "#!/bin/sh\n";
+    makeMovieStream << "cd -- \"$(dirname \"$0\")\"\n";
+  #endif
+  makeMovieStream << movieScriptTemplate("Dpdt");
+
+  #if (__cplusplus >= 201703L)
+    std::filesystem::path path{"make_movie_Dpdt"};
+    std::filesystem::permissions(path, std::filesystem::perms::owner_exec, std::filesystem::perm_options::add);
+  #else
+    chmod("make_movie_Dpdt", S_IRWXU);
+  #endif
+
+  std::ofstream stream("plot_column_Dpdt");
+
+  stream << "set encoding utf8\n";
+  #if defined(WIN32) || defined(_WIN32) || defined(__WIN32__) || defined(__NT__)
+    stream << "set terminal pngcairo size ARG2,ARG3 enhanced font 'Arial,10'\n";
+    stream << "set xlabel 'Adsorber position / [m]' font 'Arial,14'\n";
+    stream << "set ylabel 'Pressure derivative, {/Arial-Italic dp_/dt} / [Pa/s]' offset 0.0,0 font 'Arial,14'\n";
+    stream << "set key outside top center horizontal samplen 2.5 height 0.5 spacing 1.5 font 'Arial, 10'\n";
+  #else
+    stream << "set terminal pngcairo size ARG2,ARG3 enhanced font 'Helvetica,10'\n";
+    stream << "set xlabel 'Adsorber position / [m]' font 'Helvetica,18'\n";
+    stream << "set ylabel 'Pressure derivative, {/Helvetica-Italic dp_/dt} / [Pa/s]' offset 0.0,0 font 'Helvetica,18'\n";
+    stream << "set key outside top center horizontal samplen 2.5 height 0.5 spacing 1.5 font 'Helvetica, 10'\n";
+  #endif
+
+  // colorscheme from book 'gnuplot in action', listing 12.7
+  stream << "set linetype 1 pt 5 ps 1 lw 4 lc rgb '0xee0000'\n";
+  stream << "set linetype 2 pt 7 ps 1 lw 4 lc rgb '0x008b00'\n";
+  stream << "set linetype 3 pt 9 ps 1 lw 4 lc rgb '0x0000cd'\n";
+  stream << "set linetype 4 pt 11 ps 1 lw 4 lc rgb '0xff3fb3'\n";
+  stream << "set linetype 5 pt 13 ps 1 lw 4 lc rgb '0x00cdcd'\n";
+  stream << "set linetype 6 pt 15 ps 1 lw 4 lc rgb '0xcd9b1d'\n";
+  stream << "set linetype 7 pt  4 ps 1 lw 4 lc rgb '0x8968ed'\n";
+  stream << "set linetype 8 pt  6 ps 1 lw 4 lc rgb '0x8b8b83'\n";
+  stream << "set linetype 9 pt  8 ps 1 lw 4 lc rgb '0x00bb00'\n";
+  stream << "set linetype 10 pt 10 ps 1 lw 4 lc rgb '0x1e90ff'\n";
+  stream << "set linetype 11 pt 12 ps 1 lw 4 lc rgb '0x8b2500'\n";
+  stream << "set linetype 12 pt 14 ps 1 lw 4 lc rgb '0x000000'\n";
+
+  stream << "set bmargin 4\n";
+  stream << "set key title '" << displayName << " {/:Italic T}=" << T << " K, {/:Italic p_t}=" << p_total*1e-3 << " kPa'\n";
+  stream << "stats 'column.data' nooutput\n";
+  stream << "max = -1e10;\n";
+  stream << "min = 1e10;\n";
+  stream << "do for [i=8:STATS_columns:6] {\n";
+  stream << "  stats 'column.data' us i nooutput\n";
+  stream << "  if (STATS_max>max) {\n";
+  stream << "    max=STATS_max\n";
+  stream << "  }\n";
+  stream << "  if (STATS_min<min) {\n";
+  stream << "    min=STATS_min\n";
+  stream << "  }\n";
+  stream << "}\n";
+  stream << "stats 'column.data' us 1 nooutput\n";
+  stream << "set xrange[0:STATS_max]\n";
+  stream << "set yrange[1.1*min:1.1*max]\n";
+  stream << "ev=int(ARG1)\n";
+  stream << "do for [i=0:int((STATS_blocks-2)/ev)] {\n";
+  stream << "  plot \\\n";
+  for (size_t i = 0; i < Ncomp; i++)
+  {
+    stream << "    " << "'column.data'" << " us 1:" << std::to_string(8 + i * 6) << " index ev*i notitle "
+           << " with li lt " << i+1 << ",\\\n";
+  }
+  for (size_t i = 0; i < Ncomp; i++)
+  {
+    stream << "    " << "'column.data'" << " us 1:" << std::to_string(8 + i * 6) << " index ev*i title '"
+           << components[i].name << " (y_i=" << components[i].Yi0 << ")'"
+           << " with po lt " << i+1 << (i < Ncomp - 1 ? ",\\" : "") << "\n";
+  }
+  stream << "}\n";
+}
+
+void Breakthrough::createMovieScriptColumnDqdt()
+{
+  #if defined(WIN32) || defined(_WIN32) || defined(__WIN32__) || defined(__NT__)
+    std::ofstream makeMovieStream("make_movie_Dqdt.bat");
+  #else
+    std::ofstream makeMovieStream("make_movie_Dqdt");
+    makeMovieStream << "#!/bin/sh\n";
+    makeMovieStream << "cd -- \"$(dirname \"$0\")\"\n";
+  #endif
+  makeMovieStream << movieScriptTemplate("Dqdt");
+
+  #if (__cplusplus >= 201703L)
+    std::filesystem::path path{"make_movie_Dqdt"};
+    std::filesystem::permissions(path, std::filesystem::perms::owner_exec, std::filesystem::perm_options::add);
+  #else
+    chmod("make_movie_Dqdt", S_IRWXU);
+  #endif
+
+  std::ofstream stream("plot_column_Dqdt");
+
+  stream << "set encoding utf8\n";
+  #if defined(WIN32) || defined(_WIN32) || defined(__WIN32__) || defined(__NT__)
+    stream << "set terminal pngcairo size ARG2,ARG3 enhanced font 'Arial,10'\n";
+    stream << "set xlabel 'Adsorber position / [m]' font 'Arial,14'\n";
+    stream << "set ylabel 'Loading derivative, {/Arial-Italic dq_i/dt} / [mol/kg/s]' offset 0.0,0 font 'Arial,14'\n";
+    stream << "set key outside top center horizontal samplen 2.5 height 0.5 spacing 1.5 font 'Arial, 10'\n";
+  #else
+    stream << "set terminal pngcairo size ARG2,ARG3 enhanced font 'Helvetica,10'\n";
+    stream << "set xlabel 'Adsorber position / [m]' font 'Helvetica,18'\n";
+    stream << "set ylabel 'Loading derivative, {/Helvetica-Italic dq_i/dt} / [mol/kg/s]' offset 0.0,0 font 'Helvetica,18'\n";
+    stream << "set key outside top center horizontal samplen 2.5 height 0.5 spacing 1.5 font 'Helvetica, 10'\n";
+  #endif
+
+  // colorscheme from book 'gnuplot in action', listing 12.7
+  stream << "set linetype 1 pt 5 ps 1 lw 4 lc rgb '0xee0000'\n";
+  stream << "set linetype 2 pt 7 ps 1 lw 4 lc rgb '0x008b00'\n";
+  stream << "set linetype 3 pt 9 ps 1 lw 4 lc rgb '0x0000cd'\n";
+  stream << "set linetype 4 pt 11 ps 1 lw 4 lc rgb '0xff3fb3'\n";
+  stream << "set linetype 5 pt 13 ps 1 lw 4 lc rgb '0x00cdcd'\n";
+  stream << "set linetype 6 pt 15 ps 1 lw 4 lc rgb '0xcd9b1d'\n";
+  stream << "set linetype 7 pt  4 ps 1 lw 4 lc rgb '0x8968ed'\n";
+  stream << "set linetype 8 pt  6 ps 1 lw 4 lc rgb '0x8b8b83'\n";
+  stream << "set linetype 9 pt  8 ps 1 lw 4 lc rgb '0x00bb00'\n";
+  stream << "set linetype 10 pt 10 ps 1 lw 4 lc rgb '0x1e90ff'\n";
+  stream << "set linetype 11 pt 12 ps 1 lw 4 lc rgb '0x8b2500'\n";
+  stream << "set linetype 12 pt 14 ps 1 lw 4 lc rgb '0x000000'\n";
+
+  stream << "set bmargin 4\n";
+  stream << "set key title '" << displayName << " {/:Italic T}=" << T << " K, {/:Italic p_t}=" << p_total*1e-3 << " kPa'\n";
+  stream << "stats 'column.data' nooutput\n";
+  stream << "max = -1e10;\n";
+  stream << "min = 1e10;\n";
+  stream << "min = 10000000000000.0;\n";
+  stream << "do for [i=9:STATS_columns:6] {\n";
+  stream << "  stats 'column.data' us i nooutput\n";
+  stream << "  if (STATS_max>max) {\n";
+  stream << "    max=STATS_max\n";
+  stream << "  }\n";
+  stream << "  if (STATS_min<min) {\n";
+  stream << "    min=STATS_min\n";
+  stream << "  }\n";
+  stream << "}\n";
+  stream << "stats 'column.data' us 1 nooutput\n";
+  stream << "set xrange[0:STATS_max]\n";
+  stream << "set yrange[1.1*min:1.1*max]\n";
+  stream << "ev=int(ARG1)\n";
+  stream << "do for [i=0:int((STATS_blocks-2)/ev)] {\n";
+  stream << "  plot \\\n";
+  for (size_t i = 0; i < Ncomp; i++)
+  {
+    stream << "    " << "'column.data'" << " us 1:" << std::to_string(9 + i * 6) << " index ev*i notitle "
+           << " with li lt " << i+1 << ",\\\n";
+  }
+  for (size_t i = 0; i < Ncomp; i++)
+  {
+    stream << "    " << "'column.data'" << " us 1:" << std::to_string(9 + i * 6) << " index ev*i title '"
+           << components[i].name << " (y_i=" << components[i].Yi0 << ")'"
+           << " with po lt " << i+1 << (i < Ncomp - 1 ? ",\\" : "") << "\n";
+  }
+  stream << "}\n";
+}
+
+#ifdef PYBUILD
+py::array_t<double> Breakthrough::compute()
+{
+  size_t colsize = 6 * Ncomp + 5;
+  std::vector<std::vector<std::vector<double>>> brk;
+
+  // loop can quit early if autoSteps
+  for (size_t step = 0; (step < Nsteps || autoSteps); ++step)
+  {
+    // check for error from python side (keyboard interrupt)
+    if (PyErr_CheckSignals() != 0)
+    {
+      throw py::error_already_set();
+    }
+
+    // the cache-tiled explicit scheme advances several steps at once, up to the next output
+    const size_t count = tiledSweepLength(step, autoSteps ? std::numeric_limits<size_t>::max() : Nsteps);
+    computeStep(step, count);
+    step += count - 1;
+    double t = stepTime(step);
+    if (step % writeEvery == 0)
+    {
+      std::vector<std::vector<double>> t_brk(Ngrid + 1, std::vector<double>(colsize));
+      for (size_t i = 0; i < Ngrid + 1; ++i)
+      {
+        t_brk[i][0] = t * v_in / L;
+        t_brk[i][1] = t / 60.0;
+        t_brk[i][2] = static_cast<double>(i) * dx;
+        t_brk[i][3] = V[i];
+        t_brk[i][4] = Pt[i];
+
+        for (size_t j = 0; j < Ncomp; ++j)
+        {
+          t_brk[i][5 + 6 * j] = Q[i * Ncomp + j];
+          t_brk[i][6 + 6 * j] = Qeq[i * Ncomp + j];
+          t_brk[i][7 + 6 * j] = P[i * Ncomp + j];
+          t_brk[i][8 + 6 * j] = P[i * Ncomp + j] / (Pt[i] * components[j].Yi0);
+          t_brk[i][9 + 6 * j] = Dpdt[i * Ncomp + j];
+          t_brk[i][10 + 6 * j] = Dqdt[i * Ncomp + j];
+        }
+      }
+      brk.push_back(t_brk);
+    }
+    if (step % printEvery == 0)
+    {
+      std::cout << "Timestep " + std::to_string(step) + ", time: " + std::to_string(t) + " [s]\n";
+      std::cout << "    Average number of mixture-prediction steps: " +
+                       std::to_string(static_cast<double>(iastPerformance.first) /
+                                      static_cast<double>(iastPerformance.second))
+                << "\n";
+      if (equilibriumReuse.second > 0)
+      {
+        std::cout << "    Reused equilibrium loadings: " +
+                         std::to_string(100.0 * static_cast<double>(equilibriumReuse.first) /
+                                        static_cast<double>(equilibriumReuse.second)) +
+                         "% of " + std::to_string(equilibriumReuse.second) + " grid-point evaluations\n";
+      }
+    }
+  }
+  std::cout << "Final timestep " + std::to_string(Nsteps) +
+                   ", time: " + std::to_string(dt * static_cast<double>(Nsteps)) + " [s]\n";
+
+  std::vector<double> buffer;
+  buffer.reserve(brk.size() * (Ngrid + 1) * colsize);
+  for (const auto &vec1 : brk)
+  {
+    for (const auto &vec2 : vec1)
+    {
+      buffer.insert(buffer.end(), vec2.begin(), vec2.end());
+    }
+  }
+  std::array<size_t, 3> shape{{brk.size(), Ngrid + 1, colsize}};
+  py::array_t<double> py_breakthrough(shape, buffer.data());
+  py_breakthrough.resize(shape);
+
+  return py_breakthrough;
+}
+
+py::object Breakthrough::advance(size_t steps, const std::vector<std::string> &fields)
+{
+  // the end time may still be extended while 'autoSteps' is set
+  if (currentStep >= Nsteps && !autoSteps)
+  {
+    return py::none();
+  }
+
+  const size_t target = currentStep + std::max(steps, size_t{1});
+  while (currentStep < target && (currentStep < Nsteps || autoSteps))
+  {
+    // check for error from python side (keyboard interrupt)
+    if (PyErr_CheckSignals() != 0)
+    {
+      throw py::error_already_set();
+    }
+
+    // the cache-tiled explicit scheme advances several steps at once, but never past the requested step
+    const size_t count = tiledSweepLength(currentStep, autoSteps ? target : std::min(target, Nsteps));
+    computeStep(currentStep, count);
+    currentStep += count;
+  }
+
+  // the views keep this object alive through their base, but share its storage
+  py::object self = py::cast(this, py::return_value_policy::reference);
+  auto view = [&](const FieldVector &field, size_t columns)
+  {
+    py::array_t<double> array = columns == 1 ? py::array_t<double>(std::vector<size_t>{Ngrid + 1}, field.data(), self)
+                                             : py::array_t<double>(std::vector<size_t>{Ngrid + 1, columns},
+                                                                   field.data(), self);
+    array.attr("setflags")(py::arg("write") = false);
+    return array;
+  };
+
+  // labelled like the rows of 'compute': by the last computed step
+  const size_t step = currentStep - 1;
+  py::dict snapshot;
+  snapshot["step"] = step;
+  snapshot["t"] = stepTime(step);
+  for (const std::string &field : fields)
+  {
+    if (field == "P") snapshot["P"] = view(P, Ncomp);
+    else if (field == "Q") snapshot["Q"] = view(Q, Ncomp);
+    else if (field == "Qeq") snapshot["Qeq"] = view(Qeq, Ncomp);
+    else if (field == "Dpdt") snapshot["Dpdt"] = view(Dpdt, Ncomp);
+    else if (field == "Dqdt") snapshot["Dqdt"] = view(Dqdt, Ncomp);
+    else if (field == "V") snapshot["V"] = view(V, 1);
+    else if (field == "Pt") snapshot["Pt"] = view(Pt, 1);
+    else
+    {
+      throw std::runtime_error("Error: unknown breakthrough field '" + field +
+                               "' (options are P, Q, Qeq, Dpdt, Dqdt, V and Pt)");
+    }
+  }
+  return snapshot;
+}
+
+void Breakthrough::setComponentsParameters(std::vector<double> molfracs, std::vector<double> params)
+{
+  size_t index = 0;
+  for (size_t i = 0; i < Ncomp; ++i)
+  {
+    components[i].Yi0 = molfracs[i];
+    size_t n_params = components[i].isotherm.numberOfParameters;
+    std::vector<double> slicedVec(params.begin() + static_cast<std::ptrdiff_t>(index),
+                                  params.begin() + static_cast<std::ptrdiff_t>(index + n_params));
+    index = index + n_params;
+    components[i].isotherm.setParameters(slicedVec);
+  }
+
+  // also set for mixture
+  mixture.setComponentsParameters(molfracs, params);
+
+  // loadings predicted with the previous parameters can no longer be reused
+  reusedPressures.clear();
+  reusedLoadings.clear();
+}
+
+std::vector<double> Breakthrough::getComponentsParameters()
+{
+  std::vector<double> params;
+  for (size_t i = 0; i < Ncomp; ++i)
+  {
+    std::vector<double> compParams = components[i].isotherm.getParameters();
+    params.insert(params.end(), compParams.begin(), compParams.end());
+  }
+  return params;
+}
+
+void Breakthrough::setExplicitTiling(size_t size, size_t steps)
+{
+  if (steps == 0)
+  {
+    throw std::runtime_error("Error: explicit tile steps must be at least 1");
+  }
+  tileSize = size;
+  tileSteps = steps;
+}
+#endif  // PYBUILD
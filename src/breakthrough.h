@@ -1,165 +1,364 @@
-#include <cstddef>
-#include <vector>
-#include <tuple>
-#include <ctime>
-
-#include "component.h"
-#include "inputreader.h"
-#include "mixture_prediction.h"
-
-#include <cvode/cvode.h> /* main integrator header file                 */
-#include <math.h>
-#include <nvector/nvector_serial.h> /* serial N_Vector types, fct. and macros      */
-#include <stdio.h>
-#include <stdlib.h>
-#include <sundials/sundials_dense.h> /* use generic DENSE solver in preconditioning */
-#include <sundials/sundials_logger.h>
-#include <sundials/sundials_types.h> /* definition of sunrealtype                      */
-#include <sunlinsol/sunlinsol_spbcgs.h> /* access to SPBCGS SUNLinearSolver            */
-#include <sunlinsol/sunlinsol_spfgmr.h> /* access to SPFGMR SUNLinearSolver            */
-#include <sunlinsol/sunlinsol_spgmr.h> /* access to SPGMR SUNLinearSolver             */
-#include <sunlinsol/sunlinsol_sptfqmr.h> /* access to SPTFQMR SUNLinearSolver           */
-#include <sunnonlinsol/sunnonlinsol_newton.h> /* access to Newton SUNNonlinearSolver         */
-#include <sunmatrix/sunmatrix_dense.h>
-#include <sunlinsol/sunlinsol_dense.h>
-
-#ifdef PYBUILD
-#include <pybind11/numpy.h>
-#include <pybind11/pybind11.h>
-namespace py = pybind11;
-#endif  // PYBUILD
-
-
-struct Breakthrough
-{
-
-		void computeFirstDerivatives(std::vector<double> &dqdt,
-																 std::vector<double> &dpdt,
-																 const std::vector<double> &q_eq,
-																 const std::vector<double> &q,
-																 const std::vector<double> &v,
-																 const std::vector<double> &p);
-
-		void computeEquilibriumLoadings();
-
-		void computeVelocity();
-
-public:
-    Breakthrough(const InputReader &inputreader);
-    Breakthrough(std::string _displayName, std::vector<Component> _components, size_t _carrierGasComponent,
-                 size_t _numberOfGridPoints, size_t _printEvery, size_t _writeEvery, double _temperature,
-                 double _p_total, double _columnVoidFraction, double _pressureGradient, double _particleDensity,
-                 double _columnEntranceVelocity, double _columnLength, double _timeStep, size_t _numberOfTimeSteps,
-                 bool _autoSteps, bool _pulse, double _pulseTime, const MixturePrediction _mixture);
-
-    std::string repr() const;
-    void initialize();
-    void run( bool impl );
-    void computeStep(size_t step);
-
-    void createPlotScript();
-    void createMovieScripts();
-
-#ifdef PYBUILD
-    py::array_t<double> compute();
-#endif  // PYBUILD
-
-   private:
-
-    const std::string displayName;
-    const std::vector<Component> components;
-    size_t carrierGasComponent{ 0 };
-		size_t Ncomp;      // number of components
-		size_t Ngrid;      // number of grid points
-
-    size_t printEvery; // print time step to the screen every printEvery steps
-    size_t writeEvery; // write data to files every writeEvery steps
-
-		bool implicit;
-
-    double T;          // absolute temperature [K]
-    double p_total;    // total pressure column [Pa]
-    double dptdx;      // pressure gradient [N/m3]
-    double epsilon;    // void-fraction of the column [-]
-    double rho_p;      // particle density [kg/m3]
-    double v_in;       // interstitial velocity at the begin of the column [m/s]
-    
-    double L;          // length of the column
-    double dx;         // spacing in spatial direction
-    double dt;         // timestep integration
-    size_t Nsteps;     // total number of steps
-    bool autoSteps;    // use automatic number of steps
-    bool pulse;        // pulsed inlet condition for breakthrough
-    double tpulse;     // pulse time
-    MixturePrediction mixture;
-    size_t maxIsothermTerms;
-    std::pair<size_t, size_t> iastPerformance{ 0, 0 };
-    
-    // vector of size 'Ncomp'
-    std::vector<double> prefactor;
-    std::vector<double> Yi;        // ideal gas mol-fraction for each component
-    std::vector<double> Xi;        // adsorbed mol-fraction for each component
-    std::vector<double> Ni;        // number of molecules for each component
-
-    // vector of size '(Ngrid + 1)'
-    std::vector<double> V;         // interstitial gas velocity along the column
-		std::vector<double> Pt;        // total pressure along the column
-
-
-//    std::vector<double> P;         // partial pressure at every grid point for each component
-//		std::vector<double> Q;         // volume-averaged adsorption amount at every grid point for each component
-
-		// derivative of P with respect to time
-    std::vector<double> Dpdtnew;
-		// derivative of Q with respect to time
-    std::vector<double> Dqdtnew;
-    std::vector<double> cachedP0;  // cached hypothetical pressure
-    std::vector<double> cachedPsi; // cached reduced grand potential over the column
-
-		// objects for sundials setup
-		SUNContext sunContext;
-		SUNLogger sunLogger;
-		N_Vector u;										// Solver's solution vector storing both Q and P
-		SUNMatrix A;									// Solver's matrix object for the Jacobian matrix
-		void *cvodeMem;
-		SUNNonlinearSolver solver;
-		SUNLinearSolver linSolver;
-
-
-
-
-		enum class IntegrationScheme
-    {
-      SSP_RK = 0,
-      Iterative = 1
-    };
-
-		//static int f(sunrealtype t, N_Vector u, N_Vector udot, void* user_data);
-
-		void createMovieScriptColumnV();
-    void createMovieScriptColumnPt();
-    void createMovieScriptColumnQ();
-    void createMovieScriptColumnQeq();
-    void createMovieScriptColumnP();
-    void createMovieScriptColumnDpdt();
-    void createMovieScriptColumnDqdt();
-    void createMovieScriptColumnPnormalized();
-
-public:
-		size_t numCalls {0};
-
-		// vector of size '(Ngrid + 1)'
-		std::vector<double> Vnew;					// storage for velocity during solving
-
-		// vector of size '(Ngrid + 1) * Ncomp', for each grid point, data per component (contiguous)
-		std::vector<double> P;						// partial pressure at every grid point for each component
-		std::vector<double> Pnew;
-		std::vector<double> Q;						// volume-averaged adsorption amount at every grid point for each component
-		std::vector<double> Qnew;
-		std::vector<double> Dqdt;					// derivative of Q over time
-		std::vector<double> Dpdt;					// derivative of P over time
-
-		// equilibrium adsorption amount at every grid point for each component
-		std::vector<double> Qeq;
-		std::vector<double> Qeqnew;
-};
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <fstream>
+#include <memory>
+#include <vector>
+#include <tuple>
+#include <ctime>
+
+#include "component.h"
+#include "field_arena.h"
+#include "inputreader.h"
+#include "mixture_prediction.h"
+#include "snapshot_file.h"
+
+#include <arkode/arkode_arkstep.h> /* additive Runge-Kutta (IMEX) integrator    */
+#include <arkode/arkode_mristep.h> /* multirate infinitesimal (MRI) integrator  */
+#include <cvode/cvode.h> /* main integrator header file                 */
+#include <math.h>
+#include <nvector/nvector_serial.h> /* serial N_Vector types, fct. and macros      */
+#include <stdio.h>
+#include <stdlib.h>
+#include <sundials/sundials_dense.h> /* use generic DENSE solver in preconditioning */
+#include <sundials/sundials_logger.h>
+#include <sundials/sundials_types.h> /* definition of sunrealtype                      */
+#include <sunlinsol/sunlinsol_spbcgs.h> /* access to SPBCGS SUNLinearSolver            */
+#include <sunlinsol/sunlinsol_spfgmr.h> /* access to SPFGMR SUNLinearSolver            */
+#include <sunlinsol/sunlinsol_spgmr.h> /* access to SPGMR SUNLinearSolver             */
+#include <sunlinsol/sunlinsol_sptfqmr.h> /* access to SPTFQMR SUNLinearSolver           */
+#include <sunnonlinsol/sunnonlinsol_newton.h> /* access to Newton SUNNonlinearSolver         */
+#include <sunnonlinsol/sunnonlinsol_fixedpoint.h> /* access to FixedPoint SUNNonlinearSolver */
+#include <sunmatrix/sunmatrix_dense.h>
+#include <sunlinsol/sunlinsol_dense.h>
+
+#ifdef PYBUILD
+#include <pybind11/numpy.h>
+#include <pybind11/pybind11.h>
+namespace py = pybind11;
+#endif  // PYBUILD
+
+
+struct Breakthrough
+{
+
+		void computeFirstDerivatives(FieldVector &dqdt,
+																 FieldVector &dpdt,
+																 const FieldVector &q_eq,
+																 const FieldVector &q,
+																 const FieldVector &v,
+																 const FieldVector &p);
+
+		void computeEquilibriumLoadings();
+		void computeEquilibriumLoading(size_t i, const double *p, double *qeq, double &pt);
+
+		void computeVelocity(const double *transferRate = nullptr);
+
+		// the IMEX split of the derivatives: transport (advection and dispersion, explicit) and the point-local
+		// mass transfer (implicit); their sum equals computeFirstDerivatives
+		void computeTransportDerivatives(FieldVector &dqdt, FieldVector &dpdt,
+																		 const FieldVector &v, const FieldVector &p);
+		void computeMassTransferDerivatives(FieldVector &dqdt, FieldVector &dpdt,
+																				const FieldVector &q_eq, const FieldVector &q,
+																				const std::vector<bool> *selection = nullptr);
+
+		// the multirate split: transport and the slow components' mass transfer at the macro step, the mass transfer
+		// of the fast components ('fastComponents', see 'MultirateRatio') substepped by the inner integrator
+		std::vector<bool> fastComponents;
+		std::vector<bool> slowComponents;
+		void computeSlowDerivatives(double *dudt);
+
+		// block-diagonal preconditioner I - gamma J of the mass transfer, one (2 Ncomp)^2 block per grid point;
+		// exact for the implicit part of the IMEX split, so its linear solves converge in a single iteration
+		// (also used by GMRES for the BDF integrator)
+		void setupMassTransferPreconditioner(const sunrealtype *y, bool recomputeJacobian, double gamma);
+		void solveMassTransferPreconditioner(const sunrealtype *r, sunrealtype *z) const;
+
+public:
+    Breakthrough(const InputReader &inputreader);
+    Breakthrough(std::string _displayName, std::vector<Component> _components, size_t _carrierGasComponent,
+                 size_t _numberOfGridPoints, size_t _printEvery, size_t _writeEvery, double _temperature,
+                 double _p_total, double _columnVoidFraction, double _pressureGradient, double _particleDensity,
+                 double _columnEntranceVelocity, double _columnLength, double _timeStep, size_t _numberOfTimeSteps,
+                 bool _autoSteps, bool _pulse, double _pulseTime, const MixturePrediction _mixture);
+
+    std::string repr() const;
+    void initialize();
+    void run( bool impl );
+    // advances time step 'step', or 'count' steps at once with the cache-tiled explicit scheme (see tiledSweepLength)
+    void computeStep(size_t step, size_t count = 1);
+
+    // the time [s] with which the state after 'computeStep(step)' is reported by 'run', 'compute' and 'advance'
+    double stepTime(size_t step) const { return static_cast<double>(step) * dt; }
+
+    // runs the 'CycleStep's repeatedly on the same column until cyclic steady state (or 'NumberOfCycles')
+    void runCycles(bool impl);
+
+    void createPlotScript();
+    void createMovieScripts();
+
+#ifdef PYBUILD
+    py::array_t<double> compute();
+
+    // advances the column by 'steps' time steps from where the previous call stopped and returns a dict with
+    // the last computed 'step', its time 't' and zero-copy read-only views of the requested fields (P, Q, Qeq,
+    // Dpdt, Dqdt, V, Pt); the views are overwritten by the next call, returns None once the run has finished
+    py::object advance(size_t steps, const std::vector<std::string> &fields);
+
+    // sets the mol-fractions and the isotherm parameters of all components (also of the mixture prediction)
+    void setComponentsParameters(std::vector<double> molfracs, std::vector<double> params);
+    // the isotherm parameters of all components, in the order expected by 'setComponentsParameters'
+    std::vector<double> getComponentsParameters();
+
+    // the cache-tiled explicit scheme of 'compute' and 'advance', as 'ExplicitTileSize' and 'ExplicitTileSteps'
+    // (a tile size of 0 switches it off)
+    void setExplicitTiling(size_t size, size_t steps);
+#endif  // PYBUILD
+
+   private:
+    // the scenarios of a batch are set up from the parameters of a column
+    friend class BreakthroughBatch;
+
+    const std::string displayName;
+    std::vector<Component> components;
+    size_t carrierGasComponent{ 0 };
+		size_t Ncomp;      // number of components
+		size_t Ngrid;      // number of grid points
+
+    size_t printEvery; // print time step to the screen every printEvery steps
+    size_t writeEvery; // write data to files every writeEvery steps
+
+    // fields of the column profiles, in the order of the columns of 'column.data'
+    enum class ColumnField
+    {
+      V = 0, Pt = 1, Q = 2, Qeq = 3, P = 4, Pnorm = 5, Dpdt = 6, Dqdt = 7
+    };
+    bool outletOnly{ false };           // only write the breakthrough curves at the outlet (no column profiles)
+    std::array<bool, 8> columnFields{ { true, true, true, true, true, true, true, true } };  // written fields
+    size_t columnStride{ 1 };           // write every columnStride-th grid point (and the outlet) of the profiles
+    // format of the column profiles: text 'column.data', binary float32 'column.f32' or compressed 'column.f32z'
+    enum class ColumnFormat
+    {
+      Text = 0, Float32 = 1, Compressed = 2
+    };
+    ColumnFormat columnFormat{ ColumnFormat::Text };
+    size_t columnMantissaBits{ 23 };    // mantissa bits kept in the compressed profiles (23 is lossless)
+
+		bool implicit{ false };
+
+    double T;          // absolute temperature [K]
+    double p_total;    // total pressure column [Pa]
+    double dptdx;      // pressure gradient [N/m3]
+    double epsilon;    // void-fraction of the column [-]
+    double rho_p;      // particle density [kg/m3]
+    double v_in;       // interstitial velocity at the begin of the column [m/s]
+    
+    double L;          // length of the column
+    double dx;         // spacing in spatial direction
+    double dt;         // timestep integration
+    size_t Nsteps;     // total number of steps
+    bool autoSteps;    // use automatic number of steps
+    bool pulse;        // pulsed inlet condition for breakthrough
+    double tpulse;     // pulse time
+    MixturePrediction mixture;
+    size_t maxIsothermTerms;
+    std::pair<size_t, size_t> iastPerformance{ 0, 0 };
+
+    // the loadings of a grid point are reused while its partial pressures change by less than
+    // 'EquilibriumReuseTolerance' times their total (with 'EquilibriumReuseCorrection' corrected by G (p - p_last),
+    // with G = d Qeq / d p at p_last, which costs Ncomp more mixture predictions per new prediction); only for the
+    // explicit and the Strang steps, the Newton iterations and difference-quotient Jacobians of CVODE and ARKODE need
+    // the exact loadings
+    double equilibriumReuseTolerance{ 0.0 };
+    bool equilibriumReuseCorrection{ false };
+    std::vector<double> reusedPressures;  // partial pressures of the last mixture prediction per grid point
+    std::vector<double> reusedLoadings;   // loadings of the last mixture prediction per grid point
+    std::vector<double> reusedGradients;  // G at the last mixture prediction per grid point, Ncomp * Ncomp each
+    std::pair<size_t, size_t> equilibriumReuse{ 0, 0 };  // reused and total grid-point evaluations
+    bool reusesEquilibrium() const
+    {
+      return equilibriumReuseTolerance > 0.0 && (!implicit || implicitIntegrator == ImplicitIntegrator::Strang);
+    }
+    size_t currentStep{ 0 };  // number of time steps taken by 'advance'
+
+    // cyclic operation: the steps, the cycle limit, the CSS tolerance and the Anderson depth of the CSS search
+    std::vector<InputReader::CycleStep> cycleSteps;
+    size_t numberOfCycles{ 0 };
+    double cyclicSteadyStateTolerance{ 1.0e-6 };
+    size_t andersonDepth{ 0 };
+    std::vector<double> qScale;    // scale of the loadings of each component in the state of the cycle map
+    double pScale{ 1.0 };          // scale of the partial pressures in the state of the cycle map
+
+    // the fields along the column share one cache-line aligned arena, which must be created before them
+    std::shared_ptr<FieldArena> fieldArena;
+    FieldAllocator<double> fieldAllocator() const { return FieldAllocator<double>(fieldArena); }
+    
+    // vector of size 'Ncomp'
+    std::vector<double> prefactor;
+    std::vector<double> Yi;        // ideal gas mol-fraction for each component
+    std::vector<double> Xi;        // adsorbed mol-fraction for each component
+    std::vector<double> Ni;        // number of molecules for each component
+
+    // vector of size '(Ngrid + 1)'
+    FieldVector V;                 // interstitial gas velocity along the column
+		FieldVector Pt;                // total pressure along the column
+
+
+//    std::vector<double> P;         // partial pressure at every grid point for each component
+//		std::vector<double> Q;         // volume-averaged adsorption amount at every grid point for each component
+
+		// derivative of P with respect to time
+    FieldVector Dpdtnew;
+		// derivative of Q with respect to time
+    FieldVector Dqdtnew;
+    FieldVector cachedP0;          // cached hypothetical pressure
+    FieldVector cachedPsi;         // cached reduced grand potential over the column
+
+    // the velocity recurrence as a scan of affine maps V[i] = a[i] V[i-1] + b[i], evaluated in 'velocityLanes'
+    // contiguous blocks of the column at once; the coefficients are stored lane-interleaved, [k * lanes + block]
+    static constexpr size_t velocityLanes{ 8 };
+    size_t velocityBlock;                // grid points per block
+    std::vector<double> velocityScale;   // a[i], padded with identity maps to velocityLanes * velocityBlock
+    std::vector<double> velocityShift;   // b[i]
+
+    // cache-tiled explicit SSP-RK3 ('ExplicitTileSize', 'ExplicitTileSteps'): the column is swept in tiles of
+    // 'tileSize' grid points, each advanced through all stages of up to 'tileSteps' time steps before the next;
+    // level l (stage l % 3 of a step) trails level l - 1 by one grid point and is kept in ring buffer l % 4
+    size_t tileSize{ 0 };
+    size_t tileSteps{ 1 };
+    std::array<std::vector<double>, 4> tileQ;
+    std::array<std::vector<double>, 4> tileP;
+    std::array<std::vector<double>, 4> tileQeq;
+    std::array<std::vector<double>, 4> tileV;
+    std::array<std::vector<double>, 4> tilePt;
+    bool tiled() const { return !implicit && tileSize > 0 && !pulse; }
+    size_t tiledSweepLength(size_t step, size_t end) const;
+    void computeTiledSteps(size_t count);
+    void computeTiledLevel(size_t level, size_t begin, size_t end);
+
+		// objects for sundials setup
+		SUNContext sunContext;
+		SUNLogger sunLogger;
+		N_Vector u;										// Solver's solution vector storing both Q and P
+		SUNMatrix A;									// Solver's matrix object for the Jacobian matrix
+		void *cvodeMem;
+		SUNNonlinearSolver solver;
+		SUNLinearSolver linSolver;
+
+		// alternatives to CVODE: 'ImplicitIntegrator IMEX' (ARKODE), 'Strang' and 'Multirate' (ARKODE MRIStep)
+		enum class ImplicitIntegrator
+		{
+			BDF = 0,
+			IMEX = 1,
+			Strang = 2,
+			Multirate = 3
+		};
+		ImplicitIntegrator implicitIntegrator{ ImplicitIntegrator::BDF };
+		void *arkodeMem{ nullptr };       // ARKStep (IMEX) or the slow MRIStep integrator
+		double multirateRatio{ 10.0 };
+		void *fastArkodeMem{ nullptr };   // explicit ARKStep integrator of the fast mass transfer
+		MRIStepInnerStepper fastStepper{ nullptr };
+
+		// linear solver of the BDF integrator: 'LinearSolver Auto|Dense|GMRES' within 'LinearSolverMemoryLimit'
+		enum class LinearSolver
+		{
+			Auto = 0,
+			Dense = 1,
+			GMRES = 2
+		};
+		LinearSolver linearSolver{ LinearSolver::Auto };
+		double linearSolverMemoryLimit{ 1024.0 };  // [MiB]
+		static constexpr int gmresDimension{ 30 };  // Krylov subspace dimension of GMRES
+		LinearSolver newtonLinearSolver{ LinearSolver::Dense };  // the choice of chooseLinearSolver in 'initialize'
+		LinearSolver chooseLinearSolver() const;
+
+		// nonlinear solver of the BDF integrator: 'NonlinearSolver Newton|FixedPoint [depth]'; the fixed-point
+		// iteration (with Anderson acceleration) needs no Jacobian, and falls back to Newton when it fails to converge
+		enum class NonlinearSolver
+		{
+			Newton = 0,
+			FixedPoint = 1
+		};
+		NonlinearSolver nonlinearSolver{ NonlinearSolver::Newton };
+		size_t fixedPointAndersonDepth{ 3 };
+		void attachNewtonSolver();
+		bool fixedPointFailed(int flag, long stepsBefore, long failuresBefore);
+
+		// CVODE counters of a BDF run, printed at its end; a re-initialization resets those of CVODE, so they are first
+		// added to 'retiredStatistics'
+		struct IntegratorStatistics
+		{
+			long steps{ 0 };
+			long rhsEvaluations{ 0 };
+			long nonlinearIterations{ 0 };
+			long convergenceFailures{ 0 };
+			long errorTestFailures{ 0 };
+		};
+		IntegratorStatistics retiredStatistics;
+		IntegratorStatistics integratorStatistics() const;
+		void reinitializeCVode(double t);
+		void printIntegratorStatistics() const;
+		std::vector<double> equilibriumJacobian;   // d Qeq / d P per grid point, (Ngrid + 1) * Ncomp * Ncomp
+		std::vector<double> preconditionerBlocks;  // LU factors of I - gamma J per grid point
+		std::vector<size_t> preconditionerPivots;
+
+		// Strang splitting: half a transport step, a point-local mass-transfer step, half a transport step
+		void computeStrangStep();
+		void computeTransportStep(double h, bool velocityCurrent);
+		void computeMassTransferStep(double h);
+		void equilibriumLoadingsAt(size_t i, const double *p, std::vector<double> &loadings);
+		void equilibriumGradientAt(size_t i, const double *p, const double *qeq, double *gradient);
+		std::vector<double> gradientPressures;  // perturbed partial pressures of 'equilibriumGradientAt'
+		std::vector<double> gradientLoadings;   // their equilibrium loadings
+		std::vector<double> Pstage;    // partial pressures at the start of a transport step
+		FieldVector massTransferRate;          // mean dP/dt of the latest mass-transfer step
+
+
+
+
+		enum class IntegrationScheme
+    {
+      SSP_RK = 0,
+      Iterative = 1
+    };
+
+		//static int f(sunrealtype t, N_Vector u, N_Vector udot, void* user_data);
+
+		void openColumnProfiles(std::ofstream &stream, std::unique_ptr<SnapshotWriter> &snapshots);
+		void writeColumnProfiles(std::ofstream &stream, SnapshotWriter *snapshots);
+		bool fullColumnProfiles() const;
+
+		void startCycleStep(const InputReader::CycleStep &step, double t);
+		void reverseColumn();
+		void refreshColumnState();
+		void cycleState(std::vector<double> &state) const;
+		void setCycleState(const std::vector<double> &state);
+
+		void createMovieScriptColumnV();
+    void createMovieScriptColumnPt();
+    void createMovieScriptColumnQ();
+    void createMovieScriptColumnQeq();
+    void createMovieScriptColumnP();
+    void createMovieScriptColumnDpdt();
+    void createMovieScriptColumnDqdt();
+    void createMovieScriptColumnPnormalized();
+
+public:
+		size_t numCalls {0};
+
+		// vector of size '(Ngrid + 1)'
+		FieldVector Vnew;					// storage for velocity during solving
+
+		// vector of size '(Ngrid + 1) * Ncomp', for each grid point, data per component (contiguous)
+		FieldVector P;						// partial pressure at every grid point for each component
+		FieldVector Pnew;
+		FieldVector Q;						// volume-averaged adsorption amount at every grid point for each component
+		FieldVector Qnew;
+		FieldVector Dqdt;					// derivative of Q over time
+		FieldVector Dpdt;					// derivative of P over time
+
+		// equilibrium adsorption amount at every grid point for each component
+		FieldVector Qeq;
+		FieldVector Qeqnew;
+};
@@ -0,0 +1,377 @@
+#include "breakthrough_batch.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+
+#include "column_kernels.h"
+
+static const double R = 8.31446261815324;
+
+template <typename T, typename U>
+std::pair<T, U> &operator+=(std::pair<T, U> &l, const std::pair<T, U> &r)
+{
+  l.first += r.first;
+  l.second += r.second;
+  return l;
+}
+
+BreakthroughBatch::BreakthroughBatch(const Breakthrough &column, const std::vector<double> &molFractions,
+                                     const std::vector<double> &massTransferCoefficients, size_t numberOfScenarios)
+    : components(column.components),
+      carrierGasComponent(column.carrierGasComponent),
+      Ncomp(column.Ncomp),
+      Ngrid(column.Ngrid),
+      S(numberOfScenarios),
+      printEvery(column.printEvery),
+      writeEvery(column.writeEvery),
+      T(column.T),
+      p_total(column.p_total),
+      dptdx(column.dptdx),
+      epsilon(column.epsilon),
+      rho_p(column.rho_p),
+      v_in(column.v_in),
+      L(column.L),
+      dx(column.dx),
+      dt(column.dt),
+      Nsteps(column.Nsteps),
+      autoSteps(column.autoSteps),
+      pulse(column.pulse),
+      tpulse(column.tpulse),
+      mixture(column.mixture),
+      maxIsothermTerms(column.maxIsothermTerms),
+      Yi0(Ncomp * S),
+      Kl(Ncomp * S),
+      prefactor(Ncomp * S),
+      V((Ngrid + 1) * S),
+      Vnew((Ngrid + 1) * S),
+      Pt((Ngrid + 1) * S),
+      P((Ngrid + 1) * Ncomp * S),
+      Pnew((Ngrid + 1) * Ncomp * S),
+      Q((Ngrid + 1) * Ncomp * S),
+      Qnew((Ngrid + 1) * Ncomp * S),
+      Qeq((Ngrid + 1) * Ncomp * S),
+      Qeqnew((Ngrid + 1) * Ncomp * S),
+      Dpdt((Ngrid + 1) * Ncomp * S),
+      Dqdt((Ngrid + 1) * Ncomp * S),
+      cachedP0((Ngrid + 1) * S * Ncomp * maxIsothermTerms),
+      cachedPsi((Ngrid + 1) * S * maxIsothermTerms),
+      Yi(Ncomp),
+      Xi(Ncomp),
+      Ni(Ncomp)
+{
+  if (S == 0)
+  {
+    throw std::runtime_error("Error: a breakthrough batch needs at least one scenario\n");
+  }
+  if (!molFractions.empty() && molFractions.size() != S * Ncomp)
+  {
+    throw std::runtime_error("Error: the feed mol-fractions of a breakthrough batch must be given as " +
+                             std::to_string(S) + " x " + std::to_string(Ncomp) + " values\n");
+  }
+  if (!massTransferCoefficients.empty() && massTransferCoefficients.size() != S * Ncomp)
+  {
+    throw std::runtime_error("Error: the mass-transfer coefficients of a breakthrough batch must be given as " +
+                             std::to_string(S) + " x " + std::to_string(Ncomp) + " values\n");
+  }
+
+  // transpose the per-scenario rows to the scenario-innermost layout
+  for (size_t s = 0; s < S; ++s)
+  {
+    for (size_t j = 0; j < Ncomp; ++j)
+    {
+      Yi0[j * S + s] = molFractions.empty() ? components[j].Yi0 : molFractions[s * Ncomp + j];
+      Kl[j * S + s] = massTransferCoefficients.empty() ? components[j].Kl : massTransferCoefficients[s * Ncomp + j];
+    }
+  }
+  // the carrier gas does not adsorb (its Kl is not set)
+  std::fill(&Kl[carrierGasComponent * S], &Kl[carrierGasComponent * S] + S, 0.0);
+}
+
+void BreakthroughBatch::initialize()
+{
+  for (size_t k = 0; k < Ncomp * S; ++k)
+  {
+    prefactor[k] = R * T * ((1.0 - epsilon) / epsilon) * rho_p * Kl[k];
+  }
+
+  std::fill(P.begin(), P.end(), 0.0);
+  std::fill(Q.begin(), Q.end(), 0.0);
+
+  // the column is filled with the carrier gas at the initial pressure, the entrance holds the feed
+  for (size_t i = 0; i < Ngrid + 1; ++i)
+  {
+    const double pt_init = p_total + dptdx * static_cast<double>(i) * dx;
+    for (size_t s = 0; s < S; ++s)
+    {
+      V[i * S + s] = v_in * p_total / pt_init;
+      if (i > 0) P[(i * Ncomp + carrierGasComponent) * S + s] = pt_init;
+    }
+  }
+  for (size_t j = 0; j < Ncomp; ++j)
+  {
+    for (size_t s = 0; s < S; ++s)
+    {
+      P[j * S + s] = p_total * Yi0[j * S + s];
+    }
+  }
+
+  computeEquilibriumLoadings(P, Qeq);
+  times.clear();
+  curves.clear();
+}
+
+// the mixture predictions of all scenarios at a grid point, each warm-started from the cache of its own column
+void BreakthroughBatch::computeEquilibriumLoadings(const std::vector<double> &p, std::vector<double> &qeq)
+{
+  for (size_t i = 0; i < Ngrid + 1; ++i)
+  {
+    for (size_t s = 0; s < S; ++s)
+    {
+      const double *ps = &p[i * Ncomp * S + s];
+      const double pt = ColumnKernels::totalPressure(ps, S, Ncomp);
+      Pt[i * S + s] = pt;
+      iastPerformance += ColumnKernels::predictLoadings(mixture, ps, S, pt, Yi, Xi, Ni,
+                                                        &cachedP0[(i * S + s) * Ncomp * maxIsothermTerms],
+                                                        &cachedPsi[(i * S + s) * maxIsothermTerms]);
+      for (size_t j = 0; j < Ncomp; ++j)
+      {
+        qeq[(i * Ncomp + j) * S + s] = Ni[j];
+      }
+    }
+  }
+}
+
+// V[i] = (1 - dx dptdx / Pt[i]) V[i - 1] + dx / Pt[i] (sum of the mass transfer and the dispersion at i), for all
+// scenarios at once
+void BreakthroughBatch::computeVelocity(const std::vector<double> &p, const std::vector<double> &q,
+                                        const std::vector<double> &qeq, std::vector<double> &v)
+{
+  const double idx2 = 1.0 / (dx * dx);
+  std::vector<double> sum(S);
+
+  std::fill(v.begin(), v.begin() + static_cast<std::ptrdiff_t>(S), v_in);
+  for (size_t i = 1; i < Ngrid + 1; ++i)
+  {
+    std::fill(sum.begin(), sum.end(), 0.0);
+    for (size_t j = 0; j < Ncomp; ++j)
+    {
+      const size_t k = (i * Ncomp + j) * S;
+      const size_t previous = ((i - 1) * Ncomp + j) * S;
+      const size_t next = ((i + 1) * Ncomp + j) * S;
+      const double *a = &prefactor[j * S];
+      for (size_t s = 0; s < S; ++s)
+      {
+        const double difference = i < Ngrid ? ColumnKernels::dispersion(p[previous + s], p[k + s], p[next + s])
+                                            : ColumnKernels::outletDispersion(p[previous + s], p[k + s]);
+        sum[s] = sum[s] + ColumnKernels::gasTransfer(a[s], qeq[k + s], q[k + s]) + components[j].D * difference * idx2;
+      }
+    }
+    for (size_t s = 0; s < S; ++s)
+    {
+      v[i * S + s] = ColumnKernels::velocity(v[(i - 1) * S + s], sum[s], Pt[i * S + s], dx, dptdx);
+    }
+  }
+}
+
+void BreakthroughBatch::computeFirstDerivatives(const std::vector<double> &qeq, const std::vector<double> &q,
+                                                const std::vector<double> &v, const std::vector<double> &p)
+{
+  const double idx = 1.0 / dx;
+  const double idx2 = 1.0 / (dx * dx);
+
+  // the partial pressures at the entrance are fixed
+  for (size_t j = 0; j < Ncomp; ++j)
+  {
+    for (size_t s = 0; s < S; ++s)
+    {
+      Dqdt[j * S + s] = ColumnKernels::loadingRate(Kl[j * S + s], qeq[j * S + s], q[j * S + s]);
+      Dpdt[j * S + s] = 0.0;
+    }
+  }
+
+  for (size_t i = 1; i < Ngrid + 1; ++i)
+  {
+    const double *vi = &v[i * S];
+    const double *vp = &v[(i - 1) * S];
+    for (size_t j = 0; j < Ncomp; ++j)
+    {
+      const size_t k = (i * Ncomp + j) * S;
+      const size_t previous = ((i - 1) * Ncomp + j) * S;
+      const size_t next = ((i + 1) * Ncomp + j) * S;
+      const double D = components[j].D;
+      for (size_t s = 0; s < S; ++s)
+      {
+        const double difference = i < Ngrid ? ColumnKernels::dispersion(p[next + s], p[k + s], p[previous + s])
+                                            : ColumnKernels::outletDispersion(p[previous + s], p[k + s]);
+        const double transfer = ColumnKernels::gasTransfer(prefactor[j * S + s], qeq[k + s], q[k + s]);
+        Dqdt[k + s] = ColumnKernels::loadingRate(Kl[j * S + s], qeq[k + s], q[k + s]);
+        Dpdt[k + s] = ColumnKernels::pressureRate(vp[s], p[previous + s], vi[s], p[k + s], D, difference, transfer,
+                                                  idx, idx2);
+      }
+    }
+  }
+}
+
+void BreakthroughBatch::computeStep(size_t step)
+{
+  const double t = static_cast<double>(step) * dt;
+
+  // same end-time criterion as Breakthrough, for the slowest scenario
+  if (autoSteps && converged())
+  {
+    std::cout << "\nConvergence criteria reached for all scenarios, running 10% longer\n\n" << std::endl;
+    Nsteps = static_cast<size_t>(1.1 * static_cast<double>(step));
+    autoSteps = false;
+  }
+
+  // SSP-RK3, see Breakthrough::computeStep
+  computeFirstDerivatives(Qeq, Q, V, P);
+  computeStage<1>();
+  computeFirstDerivatives(Qeqnew, Qnew, Vnew, Pnew);
+  computeStage<2>();
+  computeFirstDerivatives(Qeqnew, Qnew, Vnew, Pnew);
+  computeStage<3>();
+
+  std::swap(P, Pnew);
+  std::swap(Q, Qnew);
+  std::swap(Qeq, Qeqnew);
+  std::swap(V, Vnew);
+
+  // pulse boundary condition
+  if (pulse && t > tpulse)
+  {
+    for (size_t j = 0; j < Ncomp; ++j)
+    {
+      std::fill(&P[j * S], &P[j * S] + S, j == carrierGasComponent ? p_total : 0.0);
+    }
+  }
+}
+
+// stage 'stage' of SSP-RK3 from the derivatives, followed by the equilibrium loadings and the velocity of the new
+// state; the stage is a template argument so that the update loop is branch-free and vectorises
+template <size_t stage>
+void BreakthroughBatch::computeStage()
+{
+  const std::vector<double> &q = stage == 1 ? Q : Qnew;
+  const std::vector<double> &p = stage == 1 ? P : Pnew;
+  for (size_t k = 0; k < P.size(); ++k)
+  {
+    Qnew[k] = ColumnKernels::sspStage(stage, Q[k], q[k], Dqdt[k], dt);
+    Pnew[k] = ColumnKernels::sspStage(stage, P[k], p[k], Dpdt[k], dt);
+  }
+  computeEquilibriumLoadings(Pnew, Qeqnew);
+  computeVelocity(Pnew, Qnew, Qeqnew, Vnew);
+}
+
+bool BreakthroughBatch::converged() const
+{
+  double tolerance = 0.0;
+  for (size_t j = 0; j < Ncomp; ++j)
+  {
+    for (size_t s = 0; s < S; ++s)
+    {
+      tolerance = std::max(
+          tolerance, std::abs(P[(Ngrid * Ncomp + j) * S + s] / ((p_total + dptdx * L) * Yi0[j * S + s]) - 1.0));
+    }
+  }
+  return tolerance < 0.01;
+}
+
+void BreakthroughBatch::recordOutlet(double t)
+{
+  times.push_back(t);
+  for (size_t s = 0; s < S; ++s)
+  {
+    for (size_t j = 0; j < Ncomp; ++j)
+    {
+      curves.push_back(P[(Ngrid * Ncomp + j) * S + s] / (Pt[Ngrid * S + s] * Yi0[j * S + s]));
+    }
+  }
+}
+
+void BreakthroughBatch::run()
+{
+  initialize();
+  for (size_t step = 0; (step < Nsteps || autoSteps); ++step)
+  {
+    computeStep(step);
+    const double t = static_cast<double>(step) * dt;
+    if (step % writeEvery == 0)
+    {
+      recordOutlet(t);
+    }
+    if (step % printEvery == 0)
+    {
+      std::cout << "Timestep " + std::to_string(step) + ", time: " + std::to_string(t) + " [s], " +
+                       std::to_string(S) + " scenarios\n";
+      std::cout << "    Average number of mixture-prediction steps: " +
+                       std::to_string(static_cast<double>(iastPerformance.first) /
+                                      static_cast<double>(iastPerformance.second))
+                << std::endl;
+    }
+  }
+}
+
+#ifdef PYBUILD
+
+static std::vector<double> scenarioMatrix(py::array_t<double, py::array::c_style | py::array::forcecast> matrix)
+{
+  return std::vector<double>(matrix.data(), matrix.data() + matrix.size());
+}
+
+static size_t numberOfScenarios(py::array_t<double, py::array::c_style | py::array::forcecast> molFractions,
+                                py::array_t<double, py::array::c_style | py::array::forcecast> massTransferCoefficients)
+{
+  if (molFractions.size() > 0) return static_cast<size_t>(molFractions.shape(0));
+  if (massTransferCoefficients.size() > 0) return static_cast<size_t>(massTransferCoefficients.shape(0));
+  return 1;
+}
+
+BreakthroughBatch::BreakthroughBatch(
+    const Breakthrough &column, py::array_t<double, py::array::c_style | py::array::forcecast> molFractions,
+    py::array_t<double, py::array::c_style | py::array::forcecast> massTransferCoefficients)
+    : BreakthroughBatch(column, scenarioMatrix(molFractions), scenarioMatrix(massTransferCoefficients),
+                        numberOfScenarios(molFractions, massTransferCoefficients))
+{
+}
+
+py::array_t<double> BreakthroughBatch::compute()
+{
+  initialize();
+  for (size_t step = 0; (step < Nsteps || autoSteps); ++step)
+  {
+    // check for error from python side (keyboard interrupt)
+    if (PyErr_CheckSignals() != 0)
+    {
+      throw py::error_already_set();
+    }
+
+    computeStep(step);
+    if (step % writeEvery == 0)
+    {
+      recordOutlet(static_cast<double>(step) * dt);
+    }
+  }
+
+  const size_t columns = 2 + Ncomp;
+  std::array<size_t, 3> shape{{S, times.size(), columns}};
+  py::array_t<double> result(shape);
+  double *data = result.mutable_data();
+  for (size_t s = 0; s < S; ++s)
+  {
+    for (size_t k = 0; k < times.size(); ++k)
+    {
+      double *row = data + (s * times.size() + k) * columns;
+      row[0] = times[k] * v_in / L;
+      row[1] = times[k] / 60.0;
+      std::copy(&curves[(k * S + s) * Ncomp], &curves[(k * S + s) * Ncomp] + Ncomp, row + 2);
+    }
+  }
+  return result;
+}
+
+#endif  // PYBUILD
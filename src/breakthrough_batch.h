@@ -0,0 +1,139 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "breakthrough.h"
+#include "component.h"
+#include "mixture_prediction.h"
+
+#ifdef PYBUILD
+#include <pybind11/numpy.h>
+#include <pybind11/pybind11.h>
+namespace py = pybind11;
+#endif  // PYBUILD
+
+/**
+ * \brief Scenarios of the same column, differing in the feed composition and the mass-transfer coefficients,
+ * advanced together by the explicit SSP-RK3 scheme of Breakthrough.
+ *
+ * The physics at a grid point is that of Breakthrough, from the kernels of ColumnKernels called per scenario.
+ * All fields are stored scenario-innermost, field[(i * Ncomp + j) * S + s] for grid point i, component j and
+ * scenario s, so that the transport and mass-transfer kernels run over contiguous scenarios and vectorise; the
+ * velocity recurrence runs along the column for all scenarios at once. The mixture predictions are made per grid
+ * point for all scenarios in turn, each warm-started from its own cache. All scenarios share the time loop: the
+ * time step, the output times and, with 'auto' steps, the end time (when the slowest scenario has converged).
+ * The breakthrough curves at the outlet are recorded every 'WriteEvery' steps.
+ */
+class BreakthroughBatch
+{
+ public:
+  /**
+   * \brief Creates the scenarios of a column.
+   *
+   * \param column The column; its settings and components are those of every scenario.
+   * \param molFractions Row-major (numberOfScenarios x Ncomp) gas-phase mol-fractions of the feed, or empty to use
+   *        those of the components for all scenarios.
+   * \param massTransferCoefficients Row-major (numberOfScenarios x Ncomp) mass-transfer coefficients Kl [1/s], or
+   *        empty to use those of the components for all scenarios.
+   * \param numberOfScenarios The number of scenarios.
+   */
+  BreakthroughBatch(const Breakthrough &column, const std::vector<double> &molFractions,
+                    const std::vector<double> &massTransferCoefficients, size_t numberOfScenarios);
+
+  size_t scenarios() const { return S; }  ///< Number of scenarios.
+
+  /// Sets the initial column (carrier gas only) and the feed of every scenario.
+  void initialize();
+
+  /// Advances all scenarios from time step 'step' to the next.
+  void computeStep(size_t step);
+
+  /// Runs all scenarios to the end time and records the outlet breakthrough curves.
+  void run();
+
+  /// Times [s] of the recorded breakthrough curves.
+  const std::vector<double> &outletTimes() const { return times; }
+
+  /// Outlet breakthrough curves P / (Pt Yi0) as (outletTimes().size() x S x Ncomp) values.
+  const std::vector<double> &outletCurves() const { return curves; }
+
+#ifdef PYBUILD
+  BreakthroughBatch(const Breakthrough &column,
+                    py::array_t<double, py::array::c_style | py::array::forcecast> molFractions,
+                    py::array_t<double, py::array::c_style | py::array::forcecast> massTransferCoefficients);
+
+  // runs all scenarios and returns the outlet breakthrough curves with shape (S, times, 2 + Ncomp): the
+  // dimensionless time t v / L, the time [min] and P / (Pt Yi0) of every component
+  py::array_t<double> compute();
+#endif  // PYBUILD
+
+ private:
+  const std::vector<Component> components;
+  size_t carrierGasComponent;
+  size_t Ncomp;
+  size_t Ngrid;
+  size_t S;
+
+  size_t printEvery;
+  size_t writeEvery;
+
+  double T;
+  double p_total;
+  double dptdx;
+  double epsilon;
+  double rho_p;
+  double v_in;
+  double L;
+  double dx;
+  double dt;
+  size_t Nsteps;
+  bool autoSteps;
+  bool pulse;
+  double tpulse;
+  MixturePrediction mixture;
+  size_t maxIsothermTerms;
+  std::pair<size_t, size_t> iastPerformance{0, 0};
+
+  // per component and scenario, [j * S + s]
+  std::vector<double> Yi0;        // gas-phase mol-fraction of the feed
+  std::vector<double> Kl;         // mass-transfer coefficient
+  std::vector<double> prefactor;  // R T (1 - epsilon) / epsilon rho_p Kl
+
+  // per grid point and scenario, [i * S + s]
+  std::vector<double> V;
+  std::vector<double> Vnew;
+  std::vector<double> Pt;
+
+  // per grid point, component and scenario, [(i * Ncomp + j) * S + s]
+  std::vector<double> P;
+  std::vector<double> Pnew;
+  std::vector<double> Q;
+  std::vector<double> Qnew;
+  std::vector<double> Qeq;
+  std::vector<double> Qeqnew;
+  std::vector<double> Dpdt;
+  std::vector<double> Dqdt;
+
+  // mixture-prediction caches per grid point and scenario
+  std::vector<double> cachedP0;
+  std::vector<double> cachedPsi;
+  std::vector<double> Yi;
+  std::vector<double> Xi;
+  std::vector<double> Ni;
+
+  std::vector<double> times;
+  std::vector<double> curves;
+
+  void computeEquilibriumLoadings(const std::vector<double> &p, std::vector<double> &qeq);
+  void computeVelocity(const std::vector<double> &p, const std::vector<double> &q, const std::vector<double> &qeq,
+                       std::vector<double> &v);
+  void computeFirstDerivatives(const std::vector<double> &qeq, const std::vector<double> &q,
+                               const std::vector<double> &v, const std::vector<double> &p);
+  template <size_t stage>
+  void computeStage();
+  bool converged() const;
+  void recordOutlet(double t);
+};
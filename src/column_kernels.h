@@ -0,0 +1,91 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+#include "mixture_prediction.h"
+
+/**
+ * \brief The physics of the explicit column model at a single grid point.
+ *
+ * Shared by Breakthrough, which stores its fields as [i * Ncomp + j], and BreakthroughBatch, which stores them
+ * scenario-innermost and calls the kernels for every scenario within its innermost loops. The kernels are inline so
+ * that those loops still vectorise; the order of the floating-point operations is fixed here, so both give the
+ * same results for the same column.
+ */
+namespace ColumnKernels
+{
+/// dq/dt of the linear driving force model, Kl (Qeq - q).
+inline double loadingRate(double Kl, double qeq, double q) { return Kl * (qeq - q); }
+
+/// The mass transfer seen by the gas phase, -prefactor (Qeq - q) with prefactor = R T (1 - epsilon) / epsilon rho_p Kl.
+inline double gasTransfer(double prefactor, double qeq, double q) { return -prefactor * (qeq - q); }
+
+/// The second difference a - 2 p + b of the partial pressure p between its neighbours a and b.
+inline double dispersion(double a, double p, double b) { return a - 2.0 * p + b; }
+
+/// The one-sided difference at the outlet.
+inline double outletDispersion(double upstream, double p) { return upstream - p; }
+
+/// dp/dt by advection from the upstream grid point and by axial dispersion ('difference' from the two above).
+inline double transportRate(double vUpstream, double pUpstream, double v, double p, double D, double difference,
+                            double idx, double idx2)
+{
+  return (vUpstream * pUpstream - v * p) * idx + D * difference * idx2;
+}
+
+/// dp/dt of the transport plus the mass transfer 'transfer' (see gasTransfer).
+inline double pressureRate(double vUpstream, double pUpstream, double v, double p, double D, double difference,
+                           double transfer, double idx, double idx2)
+{
+  return transportRate(vUpstream, pUpstream, v, p, D, difference, idx, idx2) + transfer;
+}
+
+/// The velocity from the upstream one, V = (1 - dx dptdx / Pt) V_upstream + dx sum / Pt, where 'sum' is the mass
+/// transfer plus the dispersion of all components at the grid point.
+inline double velocity(double vUpstream, double sum, double pt, double dx, double dptdx)
+{
+  return (1.0 - dx * dptdx / pt) * vUpstream + dx * sum / pt;
+}
+
+/// Stage 1, 2 or 3 of SSP-RK3 for x with derivative dxdt, starting from x0 at the beginning of the time step.
+inline double sspStage(size_t stage, double x0, double x, double dxdt, double dt)
+{
+  switch (stage)
+  {
+    case 1:
+      return x + dt * dxdt;
+    case 2:
+      return 0.75 * x0 + 0.25 * x + 0.25 * dt * dxdt;
+    default:
+      return (1.0 / 3.0) * x0 + (2.0 / 3.0) * x + (2.0 / 3.0) * dt * dxdt;
+  }
+}
+
+/// The total pressure, the sum of the positive partial pressures p[0], p[stride], ... of 'Ncomp' components.
+inline double totalPressure(const double *p, size_t stride, size_t Ncomp)
+{
+  double pt = 0.0;
+  for (size_t j = 0; j < Ncomp; ++j)
+  {
+    pt += std::max(0.0, p[j * stride]);
+  }
+  return pt;
+}
+
+/// The mixture prediction for the partial pressures p[0], p[stride], ... at total pressure 'pt', warm-started from
+/// the caches of the grid point; the loadings are left in Ni.
+inline std::pair<size_t, size_t> predictLoadings(MixturePrediction &mixture, const double *p, size_t stride,
+                                                 double pt, std::vector<double> &Yi, std::vector<double> &Xi,
+                                                 std::vector<double> &Ni, double *cachedP0, double *cachedPsi)
+{
+  // force the gas-phase mol-fractions to be positive and normalized
+  for (size_t j = 0; j < Yi.size(); ++j)
+  {
+    Yi[j] = std::max(p[j * stride], 0.0) / pt;
+  }
+  return mixture.predictMixture(Yi, pt, Xi, Ni, cachedP0, cachedPsi);
+}
+}  // namespace ColumnKernels
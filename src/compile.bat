@@ -1 +1,2 @@
-cl /W4 /EHsc /Zi /std:c++20 /O2 /Zc:__cplusplus *.cpp /link /out:ruptura.exe
+cl /W4 /EHsc /Zi /std:c++20 /O2 /Zc:__cplusplus main.cpp fitting.cpp fitness_cache.cpp mapped_file.cpp breakthrough.cpp breakthrough_batch.cpp field_arena.cpp snapshot_file.cpp inputreader.cpp mixture_prediction.cpp component.cpp multi_site_isotherm.cpp isotherm.cpp special_functions.cpp random_numbers.cpp /link /out:ruptura.exe
+cl /W4 /EHsc /Zi /std:c++20 /O2 /Zc:__cplusplus snapshot_tool.cpp snapshot_file.cpp mapped_file.cpp /link /out:ruptura-snapshots.exe
@@ -0,0 +1,58 @@
+#include "field_arena.h"
+
+#include <functional>
+
+#if defined(__linux__)
+#include <sys/mman.h>
+#endif
+
+// transparent huge pages on x86-64 and most aarch64 kernels
+static constexpr size_t hugePageSize = size_t{2} << 20;
+
+FieldArena::FieldArena(std::initializer_list<size_t> fieldSizes)
+{
+  for (size_t n : fieldSizes)
+  {
+    size += padded(n * sizeof(double));
+  }
+  if (size == 0) return;
+
+#if defined(__linux__)
+  // a huge page saves TLB misses on every sweep over the column, but only once the fields fill one
+  if (size >= hugePageSize)
+  {
+    size = (size + hugePageSize - 1) / hugePageSize * hugePageSize;
+    blockAlignment = hugePageSize;
+  }
+#endif
+
+  begin = static_cast<char *>(::operator new(size, std::align_val_t{blockAlignment}));
+
+#if defined(__linux__) && defined(MADV_HUGEPAGE)
+  // only a hint: without transparent huge pages the arena is simply backed by normal pages
+  if (blockAlignment == hugePageSize) madvise(begin, size, MADV_HUGEPAGE);
+#endif
+}
+
+FieldArena::~FieldArena()
+{
+  if (begin != nullptr)
+  {
+    ::operator delete(begin, std::align_val_t{blockAlignment});
+  }
+}
+
+void *FieldArena::allocate(size_t bytes)
+{
+  const size_t length = padded(bytes);
+  if (bytes == 0 || length > size - used) return nullptr;
+  void *p = begin + used;
+  used += length;
+  return p;
+}
+
+bool FieldArena::owns(const void *p) const
+{
+  // pointers into different objects can only be ordered through std::less
+  return begin != nullptr && !std::less<const void *>()(p, begin) && std::less<const void *>()(p, begin + size);
+}
@@ -0,0 +1,119 @@
+#pragma once
+
+#include <cstddef>
+#include <initializer_list>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+/**
+ * \brief One contiguous block of memory from which the fields along a column are allocated.
+ *
+ * Every field starts on a cache line of its own, and each field is followed by one extra cache line, so that fields
+ * of equal length do not start at the same offset within a page and do not evict each other (4K aliasing) when they
+ * are traversed side by side. On Linux, arenas of at least a huge page are backed by transparent huge pages.
+ */
+class FieldArena
+{
+ public:
+  static constexpr size_t alignment = 64;  ///< Alignment in bytes of every field.
+
+  /**
+   * \brief Reserves room for fields with the given numbers of doubles.
+   *
+   * \param fieldSizes The number of doubles of each field, in order of allocation.
+   */
+  explicit FieldArena(std::initializer_list<size_t> fieldSizes);
+  ~FieldArena();
+
+  FieldArena(const FieldArena &) = delete;
+  FieldArena &operator=(const FieldArena &) = delete;
+
+  /// Returns aligned storage of the given size, or nullptr when the arena is exhausted.
+  void *allocate(size_t bytes);
+  /// Whether the given storage was handed out by this arena.
+  bool owns(const void *p) const;
+
+  size_t capacity() const { return size; }  ///< Size of the arena in bytes.
+
+ private:
+  static size_t padded(size_t bytes) { return (bytes + alignment - 1) / alignment * alignment + alignment; }
+
+  char *begin{nullptr};
+  size_t size{0};
+  size_t used{0};
+  size_t blockAlignment{alignment};
+};
+
+/**
+ * \brief Allocator handing out storage from a shared FieldArena.
+ *
+ * Requests that no longer fit in the arena, and copies of a container, fall back to the heap with the same
+ * alignment, so the storage of a field is always aligned to FieldArena::alignment.
+ */
+template <typename T>
+class FieldAllocator
+{
+ public:
+  using value_type = T;
+  using propagate_on_container_move_assignment = std::true_type;
+  using propagate_on_container_swap = std::true_type;
+
+  FieldAllocator() = default;
+  explicit FieldAllocator(std::shared_ptr<FieldArena> _arena) : arena(std::move(_arena)) {}
+  template <typename U>
+  FieldAllocator(const FieldAllocator<U> &other) : arena(other.arena)
+  {
+  }
+
+  T *allocate(size_t n)
+  {
+    if (arena)
+    {
+      if (void *p = arena->allocate(n * sizeof(T))) return static_cast<T *>(p);
+    }
+    return static_cast<T *>(::operator new(n * sizeof(T), std::align_val_t{FieldArena::alignment}));
+  }
+
+  void deallocate(T *p, size_t)
+  {
+    // storage of the arena is released together with the arena
+    if (arena && arena->owns(p)) return;
+    ::operator delete(p, std::align_val_t{FieldArena::alignment});
+  }
+
+  // a copy of a field is not part of the column, and must not use up the room of the remaining fields
+  FieldAllocator select_on_container_copy_construction() const { return FieldAllocator(); }
+
+  template <typename U>
+  bool operator==(const FieldAllocator<U> &other) const
+  {
+    return arena == other.arena;
+  }
+  template <typename U>
+  bool operator!=(const FieldAllocator<U> &other) const
+  {
+    return arena != other.arena;
+  }
+
+ private:
+  template <typename U>
+  friend class FieldAllocator;
+
+  std::shared_ptr<FieldArena> arena;
+};
+
+using FieldVector = std::vector<double, FieldAllocator<double>>;
+
+/// Tells the compiler that the storage of a field is aligned to FieldArena::alignment.
+template <typename T>
+inline T *assumeFieldAligned(T *p)
+{
+#if defined(__GNUC__)
+  return static_cast<T *>(__builtin_assume_aligned(p, FieldArena::alignment));
+#else
+  return p;
+#endif
+}
@@ -0,0 +1,64 @@
+#include "fitness_cache.h"
+
+#include <cstring>
+
+FitnessCache::FitnessCache(size_t capacity) : slots(capacity), locks(numberOfLocks) {}
+
+bool FitnessCache::lookup(size_t hash, const MultiSiteIsotherm &phenotype, double &fitness)
+{
+  if (slots.empty()) return false;
+
+  numberOfLookups.fetch_add(1, std::memory_order_relaxed);
+
+  const size_t index = hash % slots.size();
+  std::lock_guard<std::mutex> lock(locks[index % numberOfLocks]);
+
+  const Slot &slot = slots[index];
+  if (!slot.occupied || slot.hash != hash || slot.parameters.size() != phenotype.numberOfParameters) return false;
+
+  // exact-match verification: compare the bit patterns (also handles NaN-parameters created by mutation)
+  for (size_t i = 0; i < phenotype.numberOfParameters; ++i)
+  {
+    if (std::memcmp(&slot.parameters[i], &phenotype.parameters(i), sizeof(double)) != 0) return false;
+  }
+
+  fitness = slot.fitness;
+  numberOfHits.fetch_add(1, std::memory_order_relaxed);
+  return true;
+}
+
+void FitnessCache::insert(size_t hash, const MultiSiteIsotherm &phenotype, double fitness)
+{
+  if (slots.empty()) return;
+
+  const size_t index = hash % slots.size();
+  std::lock_guard<std::mutex> lock(locks[index % numberOfLocks]);
+
+  Slot &slot = slots[index];
+  slot.occupied = true;
+  slot.hash = hash;
+  slot.parameters.resize(phenotype.numberOfParameters);
+  for (size_t i = 0; i < phenotype.numberOfParameters; ++i)
+  {
+    slot.parameters[i] = phenotype.parameters(i);
+  }
+  slot.fitness = fitness;
+}
+
+void FitnessCache::clear()
+{
+  for (size_t i = 0; i < slots.size(); ++i)
+  {
+    std::lock_guard<std::mutex> lock(locks[i % numberOfLocks]);
+    slots[i].occupied = false;
+  }
+  numberOfHits.store(0, std::memory_order_relaxed);
+  numberOfLookups.store(0, std::memory_order_relaxed);
+}
+
+double FitnessCache::hitRate() const
+{
+  const size_t n = lookups();
+  if (n == 0) return 0.0;
+  return 100.0 * static_cast<double>(hits()) / static_cast<double>(n);
+}
@@ -0,0 +1,76 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <mutex>
+#include <vector>
+
+#include "multi_site_isotherm.h"
+
+/**
+ * \brief Bounded, thread-safe cache of fitness values keyed on the hash of the isotherm parameters.
+ *
+ * The genetic algorithm re-scores many identical phenotypes (elites, crossover clones, converged simplex vertices).
+ * The cache is direct-mapped: every hash maps to a single slot and a newer entry replaces the older one, so the
+ * memory use is fixed. A hit requires the stored parameters to be bitwise identical to the requested ones, so a hash
+ * collision can never return a wrong fitness. Slots are guarded by a fixed set of striped locks so that concurrently
+ * evolving islands can share one cache.
+ */
+class FitnessCache
+{
+ public:
+  /**
+   * \brief Constructs a cache with a fixed number of slots.
+   *
+   * \param capacity The number of slots (zero disables the cache).
+   */
+  explicit FitnessCache(size_t capacity);
+
+  /**
+   * \brief Looks up the fitness of a phenotype.
+   *
+   * \param hash The hash of the phenotype parameters.
+   * \param phenotype The phenotype to look up.
+   * \param fitness The cached fitness (output, only set on a hit).
+   * \return True on a hit.
+   */
+  bool lookup(size_t hash, const MultiSiteIsotherm &phenotype, double &fitness);
+
+  /**
+   * \brief Stores the fitness of a phenotype, replacing the entry previously stored in its slot.
+   *
+   * \param hash The hash of the phenotype parameters.
+   * \param phenotype The phenotype.
+   * \param fitness The fitness of the phenotype.
+   */
+  void insert(size_t hash, const MultiSiteIsotherm &phenotype, double fitness);
+
+  /**
+   * \brief Removes all entries and resets the statistics (the fitness depends on the data being fitted).
+   */
+  void clear();
+
+  size_t hits() const { return numberOfHits.load(std::memory_order_relaxed); }        ///< Number of cache hits.
+  size_t lookups() const { return numberOfLookups.load(std::memory_order_relaxed); }  ///< Number of lookups.
+
+  /**
+   * \brief Returns the percentage of lookups that were hits.
+   */
+  double hitRate() const;
+
+ private:
+  struct Slot
+  {
+    bool occupied{false};
+    size_t hash{0};
+    std::vector<double> parameters{};
+    double fitness{0.0};
+  };
+
+  static constexpr size_t numberOfLocks = 64;
+
+  std::vector<Slot> slots;
+  std::vector<std::mutex> locks;
+  std::atomic<size_t> numberOfHits{0};
+  std::atomic<size_t> numberOfLookups{0};
+};
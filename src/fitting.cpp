@@ -2,6 +2,7 @@
 
 #include <algorithm>
 #include <bitset>
+#include <charconv>
 #include <climits>
 #include <cmath>
 #include <cstdlib>
@@ -9,10 +10,15 @@
 #include <exception>
 #include <fstream>
 #include <iterator>
+#include <limits>
 #include <map>
+#include <memory>
+#include <numeric>
 #include <sstream>
+#include <thread>
 #include <unordered_set>
 
+#include "mapped_file.h"
 #include "random_numbers.h"
 #include "special_functions.h"
 #if __cplusplus >= 201703L && __has_include(<filesystem>)
@@ -40,6 +46,8 @@ Fitting::Fitting(const InputReader &inputreader)
       columnLoading(inputreader.columnLoading - 1),
       columnError(inputreader.columnError - 1),
       pressureScale(PressureScale(inputreader.pressureScale)),
+      objective(Objective(inputreader.fittingObjective)),
+      quiet(inputreader.quiet),
       GA_Size(static_cast<size_t>(std::pow(2.0, 12.0))),
       GA_MutationRate(1.0 / 3.0),
       GA_EliteRate(0.15),
@@ -47,6 +55,10 @@ Fitting::Fitting(const InputReader &inputreader)
       GA_DisasterRate(0.001),
       GA_Elitists(static_cast<size_t>(static_cast<double>(GA_Size) * GA_EliteRate)),
       GA_Motleists(static_cast<size_t>(static_cast<double>(GA_Size) * (1.0 - GA_MotleyCrowdRate))),
+      numberOfIslands(inputreader.numberOfIslands),
+      migrationInterval(inputreader.migrationInterval),
+      numberOfMigrants(inputreader.numberOfMigrants),
+      fitnessCache(std::make_shared<FitnessCache>(inputreader.fitnessCacheSize)),
       popAlpha(static_cast<size_t>(std::pow(2.0, 12.0))),
       popBeta(static_cast<size_t>(std::pow(2.0, 12.0))),
       parents(popAlpha),
@@ -58,47 +70,157 @@ Fitting::Fitting(const InputReader &inputreader)
     filename[i] = inputreader.components[i].filename;
     isotherms[i] = inputreader.components[i].isotherm;
   }
+
+  RandomNumber::setSeed(inputreader.randomSeed);
+}
+
+Fitting::Fitting(const Fitting &master, size_t populationSize)
+    : Ncomp(master.Ncomp),
+      components(master.components),
+      displayName(master.displayName),
+      componentName(master.componentName),
+      filename(master.filename),
+      isotherms(master.isotherms),
+      columnPressure(master.columnPressure),
+      columnLoading(master.columnLoading),
+      columnError(master.columnError),
+      maximumLoading(master.maximumLoading),
+      pressureScale(master.pressureScale),
+      objective(master.objective),
+      rawData(master.rawData),
+      modelLoading(master.modelLoading),
+      fittingFlag(master.fittingFlag),
+      physicalConstrainsFlag(master.physicalConstrainsFlag),
+      seedFlag(master.seedFlag),
+      pressureRangeFlag(master.pressureRangeFlag),
+      refittingFlag(master.refittingFlag),
+      quiet(master.quiet),
+      pressureRange(master.pressureRange),
+      logPressureRange(master.logPressureRange),
+      GA_Size(populationSize),
+      GA_MutationRate(master.GA_MutationRate),
+      GA_EliteRate(master.GA_EliteRate),
+      GA_MotleyCrowdRate(master.GA_MotleyCrowdRate),
+      GA_DisasterRate(master.GA_DisasterRate),
+      GA_Elitists(static_cast<size_t>(static_cast<double>(GA_Size) * GA_EliteRate)),
+      GA_Motleists(static_cast<size_t>(static_cast<double>(GA_Size) * (1.0 - GA_MotleyCrowdRate))),
+      numberOfIslands(1),
+      migrationInterval(master.migrationInterval),
+      numberOfMigrants(master.numberOfMigrants),
+      fitnessCache(master.fitnessCache),
+      popAlpha(populationSize),
+      popBeta(populationSize),
+      parents(popAlpha),
+      children(popBeta)
+{
+}
+
+void Fitting::DataPoints::sortByPressure()
+{
+  if (std::is_sorted(pressure.begin(), pressure.end())) return;
+
+  std::vector<size_t> order(pressure.size());
+  std::iota(order.begin(), order.end(), 0);
+  std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) { return pressure[a] < pressure[b]; });
+
+  DataPoints sorted;
+  sorted.reserve(order.size());
+  for (size_t i : order)
+  {
+    sorted.push_back(pressure[i], loading[i], error[i]);
+  }
+  *this = std::move(sorted);
+}
+
+inline bool isBlank(char c) { return c == ' ' || c == '\t' || c == '\r' || c == '\v' || c == '\f'; }
+
+// Parses the requested (zero-based) columns of the line [first, last) without allocating.
+// Fields are separated by whitespace and only the fields up to the highest requested column are scanned.
+// Returns false for comment lines, blank lines, lines with too few columns, and non-numeric fields.
+template <size_t N>
+bool parseColumns(const char *first, const char *last, const std::array<size_t, N> &columns,
+                  std::array<double, N> &values)
+{
+  const size_t maxColumn = *std::max_element(columns.begin(), columns.end());
+
+  const char *p = first;
+  while (p < last && isBlank(*p)) ++p;
+  if (p == last || *p == '#') return false;
+
+  for (size_t column = 0; column <= maxColumn; ++column)
+  {
+    while (p < last && isBlank(*p)) ++p;
+    if (p == last) return false;
+
+    const char *fieldEnd = p;
+    while (fieldEnd < last && !isBlank(*fieldEnd)) ++fieldEnd;
+
+    for (size_t k = 0; k < N; ++k)
+    {
+      if (columns[k] == column)
+      {
+        // unlike 'std::stod', 'std::from_chars' does not accept an explicit plus sign
+        const char *number = (*p == '+' && fieldEnd - p > 1 && p[1] != '-') ? p + 1 : p;
+        std::from_chars_result result = std::from_chars(number, fieldEnd, values[k]);
+        if (result.ec != std::errc() || result.ptr != fieldEnd) return false;
+      }
+    }
+    p = fieldEnd;
+  }
+  return true;
 }
 
 void Fitting::readData(size_t ID)
 {
-  std::ifstream fileInput{filename[ID]};
-  std::string errorOpeningFile = "File '" + filename[ID] + "' exists, but error opening file";
-  if (!fileInput) throw std::runtime_error(errorOpeningFile);
+  const MappedFile file(filename[ID]);
 
   std::cout << "Reading: " << filename[ID] << "\n";
 
-  std::string line{};
+  const char *data = file.data();
+  const char *end = data + file.size();
 
   maximumLoading = 0.0;
   rawData.clear();
-  while (std::getline(fileInput, line))
+  rawData.reserve(static_cast<size_t>(std::count(data, end, '\n')) + 1);
+
+  // the measurement errors are only read when the objective uses them
+  const bool readErrors = objective != Objective::LeastSquares;
+  const std::array<size_t, 2> columns{{columnPressure, columnLoading}};
+  const std::array<size_t, 3> columnsWithError{{columnPressure, columnLoading, columnError}};
+  std::array<double, 2> values;
+  std::array<double, 3> valuesWithError;
+  size_t lineNumber{0};
+  while (data < end)
   {
-    std::string trimmedLine = trim(line);
-    if (!startsWith(trimmedLine, "#"))
+    const char *lineEnd = static_cast<const char *>(std::memchr(data, '\n', static_cast<size_t>(end - data)));
+    if (lineEnd == nullptr) lineEnd = end;
+    ++lineNumber;
+
+    bool valid = readErrors ? parseColumns(data, lineEnd, columnsWithError, valuesWithError)
+                            : parseColumns(data, lineEnd, columns, values);
+    // a data point without its measurement error must not be skipped silently
+    if (readErrors && !valid && parseColumns(data, lineEnd, columns, values))
     {
-      if (!line.empty())
+      throw std::runtime_error("Error: no measurement error in column " + std::to_string(columnError + 1) +
+                               " (ColumnError) at line " + std::to_string(lineNumber) + " of file '" + filename[ID] +
+                               "'\n");
+    }
+    if (valid)
+    {
+      double pressure = readErrors ? valuesWithError[0] : values[0];
+      double loading = readErrors ? valuesWithError[1] : values[1];
+      double error = readErrors ? valuesWithError[2] : 1.0;
+      if (error <= 0.0)
       {
-        std::istringstream iss(line);
-
-        std::vector<std::string> results((std::istream_iterator<std::string>(iss)),
-                                         std::istream_iterator<std::string>());
-        if (columnPressure < results.size() && columnLoading < results.size())
-        {
-          double pressure;
-          double loading;
-          std::istringstream s(results[columnPressure]);
-          s >> pressure;
-          std::istringstream t(results[columnLoading]);
-          t >> loading;
-          if (loading > maximumLoading)
-          {
-            maximumLoading = loading;
-          }
-          rawData.push_back(std::make_pair(pressure, loading));
-        }
+        throw std::runtime_error("Error: measurement error must be positive in file '" + filename[ID] + "'\n");
+      }
+      if (loading > maximumLoading)
+      {
+        maximumLoading = loading;
       }
+      rawData.push_back(pressure, loading, error);
     }
+    data = lineEnd + 1;
   }
 
   if (rawData.empty())
@@ -107,15 +229,21 @@ void Fitting::readData(size_t ID)
   }
 
   // sort the pressures
-  std::sort(rawData.begin(), rawData.end());
+  rawData.sortByPressure();
+  modelLoading.resize(rawData.size());
 
-  pressureRange = std::make_pair(rawData.front().first, rawData.back().first);
+  pressureRange = std::make_pair(rawData.pressure.front(), rawData.pressure.back());
   logPressureRange = std::make_pair(std::log(pressureRange.first), std::log(pressureRange.second));
 
   std::cout << "Found " << rawData.size() << " data points\n";
-  for (const std::pair<double, double> &data : rawData)
+  if (!quiet)
   {
-    std::cout << data.first << " " << data.second << std::endl;
+    for (size_t i = 0; i < rawData.size(); ++i)
+    {
+      std::cout << rawData.pressure[i] << " " << rawData.loading[i];
+      if (readErrors) std::cout << " " << rawData.error[i];
+      std::cout << "\n";
+    }
   }
   std::cout << "\n";
   std::cout << "Lowest pressure: " << pressureRange.first << std::endl;
@@ -133,6 +261,7 @@ void Fitting::readData(size_t ID)
 void Fitting::run()
 {
   std::cout << "STARTING FITTING\n";
+  std::cout << "Random seed: " << RandomNumber::seed() << "\n";
   for (size_t i = 0; i < Ncomp; ++i)
   {
     readData(i);
@@ -161,6 +290,7 @@ Fitting::Fitting(std::string _displayName, std::vector<Component> _components,
       GA_DisasterRate(0.001),
       GA_Elitists(static_cast<size_t>(static_cast<double>(GA_Size) * GA_EliteRate)),
       GA_Motleists(static_cast<size_t>(static_cast<double>(GA_Size) * (1.0 - GA_MotleyCrowdRate))),
+      fitnessCache(std::make_shared<FitnessCache>(65536)),
       popAlpha(static_cast<size_t>(std::pow(2.0, 12.0))),
       popBeta(static_cast<size_t>(std::pow(2.0, 12.0))),
       parents(popAlpha),
@@ -177,30 +307,27 @@ void Fitting::sliceData(size_t ID)
 {
   // data shaped as (Npress, Ncomp)
   rawData.clear();
+  rawData.reserve(fullData.size());
   for (const auto &pressPoint : fullData)
   {
-    rawData.push_back(std::pair<double, double>(pressPoint[0], pressPoint[ID + 1]));
+    rawData.push_back(pressPoint[0], pressPoint[ID + 1], 1.0);
   }
 
   // get pressure range
-  std::sort(rawData.begin(), rawData.end());
-  pressureRange = std::make_pair(rawData.front().first, rawData.back().first);
+  rawData.sortByPressure();
+  modelLoading.resize(rawData.size());
+  pressureRange = std::make_pair(rawData.pressure.front(), rawData.pressure.back());
   logPressureRange = std::make_pair(std::log(pressureRange.first), std::log(pressureRange.second));
 
-  maximumLoading = 0.0;
-  for (const auto &pair : rawData)
-  {
-    if (pair.second > maximumLoading)
-    {
-      maximumLoading = pair.second;
-    }
-  }
+  maximumLoading = *std::max_element(rawData.loading.begin(), rawData.loading.end());
+  maximumLoading = std::max(maximumLoading, 0.0);
 }
 
 std::vector<double> Fitting::compute()
 {
   std::vector<double> output;
   std::cout << "STARTING FITTING\n";
+  std::cout << "Random seed: " << RandomNumber::seed() << "\n";
   for (size_t i = 0; i < Ncomp; ++i)
   {
     // check for error from python side (keyboard interrupt)
@@ -211,9 +338,12 @@ std::vector<double> Fitting::compute()
 
     // run algorithm
     sliceData(i);
-    for (const auto &pair : rawData)
+    if (!quiet)
     {
-      std::cout << "(" << pair.first << ", " << pair.second << ") ";
+      for (size_t j = 0; j < rawData.size(); ++j)
+      {
+        std::cout << "(" << rawData.pressure[j] << ", " << rawData.loading[j] << ") ";
+      }
     }
 
     const DNA bestCitizen = fit(i);
@@ -242,12 +372,46 @@ py::array_t<double> Fitting::evaluate()
   {
     for (size_t j = 0; j < Ncomp; j++)
     {
-      data[i * Ncomp + j] = components[j].isotherm.value(rawData[i].first);
+      data[i * Ncomp + j] = components[j].isotherm.value(rawData.pressure[i]);
     }
   }
   return output;
 }
 
+py::array_t<double> Fitting::evaluateParameterSets(
+    size_t ID, py::array_t<double, py::array::c_style | py::array::forcecast> parameterSets,
+    py::array_t<double, py::array::c_style | py::array::forcecast> pressures)
+{
+  if (ID >= Ncomp)
+  {
+    throw std::runtime_error("Error: component index out of range");
+  }
+  if (parameterSets.ndim() != 2 || static_cast<size_t>(parameterSets.shape(1)) != isotherms[ID].numberOfParameters)
+  {
+    throw std::runtime_error("Error: parameter sets must have shape (M, " +
+                             std::to_string(isotherms[ID].numberOfParameters) + ")");
+  }
+  if (pressures.ndim() != 1)
+  {
+    throw std::runtime_error("Error: pressures must be a one-dimensional array");
+  }
+
+  size_t M = static_cast<size_t>(parameterSets.shape(0));
+  size_t Npress = static_cast<size_t>(pressures.shape(0));
+  std::array<size_t, 2> shape{{M, Npress}};
+  py::array_t<double> output(shape);
+
+  const double *parameterData = parameterSets.data();
+  const double *pressureData = pressures.data();
+  double *data = output.mutable_data();
+  {
+    // the evaluation only touches the raw buffers, so other Python threads can run meanwhile
+    py::gil_scoped_release release;
+    evaluateParameterSets(ID, parameterData, M, pressureData, Npress, data);
+  }
+  return output;
+}
+
 #endif  // PYBUILD
 
 // create a new citizen in the Ensemble
@@ -271,12 +435,29 @@ Fitting::DNA Fitting::newCitizen(size_t ID)
   }
 
   citizen.hash = std::hash<MultiSiteIsotherm>{}(citizen.phenotype);
-  citizen.fitness = fitness(citizen.phenotype);
+  citizen.fitness = cachedFitness(citizen.phenotype, citizen.hash);
 
   return citizen;
 }
 
-void Fitting::updateCitizen(DNA &citizen) { citizen.fitness = fitness(citizen.phenotype); }
+void Fitting::updateCitizen(DNA &citizen) { citizen.fitness = cachedFitness(citizen.phenotype, citizen.hash); }
+
+double Fitting::cachedFitness(const MultiSiteIsotherm &phenotype, size_t hash)
+{
+  double value;
+  if (fitnessCache->lookup(hash, phenotype, value))
+  {
+    return value;
+  }
+  value = fitness(phenotype);
+  fitnessCache->insert(hash, phenotype, value);
+  return value;
+}
+
+double Fitting::cachedFitness(const MultiSiteIsotherm &phenotype)
+{
+  return cachedFitness(phenotype, std::hash<MultiSiteIsotherm>{}(phenotype));
+}
 
 inline bool my_isnan(double val)
 {
@@ -288,21 +469,64 @@ inline bool my_isnan(double val)
   return (u.x << 1) > (0x7ff0000000000000u << 1);
 }
 
+// tuning constants of the robust losses for 95% efficiency at normally distributed errors
+const double huberThreshold{1.345};
+const double cauchyScale{2.3849};
+
 double Fitting::fitness(const MultiSiteIsotherm &phenotype)
 // For evaluating isotherm goodness-of-fit:
-// Residual Root Mean Square Error (RMSE)
+// Residual Root Mean Square Error (RMSE), with the residuals scaled by the measurement errors
+// and passed through a robust loss for the weighted objectives
 {
   double fitnessValue = phenotype.fitness();
   size_t m = rawData.size();                // number of observations
   size_t p = phenotype.numberOfParameters;  // number of adjustable parameters
-  for (std::pair<double, double> dataPoint : rawData)
+  const double *pressure = rawData.pressure.data();
+  const double *loading = rawData.loading.data();
+  const double *error = rawData.error.data();
+  double *model = modelLoading.data();
+
+  phenotype.values(pressure, model, m);
+
+  switch (objective)
   {
-    double pressure = dataPoint.first;
-    double loading = dataPoint.second;
-    double difference = loading - phenotype.value(pressure);
-    // double weight = 1.0/(1.0+loading);
-    double weight = 1.0;
-    fitnessValue += weight * difference * difference;
+    case Objective::LeastSquares:
+    {
+      for (size_t i = 0; i < m; ++i)
+      {
+        double difference = loading[i] - model[i];
+        fitnessValue += difference * difference;
+      }
+      break;
+    }
+    case Objective::WeightedLeastSquares:
+    {
+      for (size_t i = 0; i < m; ++i)
+      {
+        double residual = (loading[i] - model[i]) / error[i];
+        fitnessValue += residual * residual;
+      }
+      break;
+    }
+    case Objective::Huber:
+    {
+      for (size_t i = 0; i < m; ++i)
+      {
+        double residual = std::abs(loading[i] - model[i]) / error[i];
+        fitnessValue += residual <= huberThreshold ? residual * residual
+                                                   : huberThreshold * (2.0 * residual - huberThreshold);
+      }
+      break;
+    }
+    case Objective::Cauchy:
+    {
+      for (size_t i = 0; i < m; ++i)
+      {
+        double residual = (loading[i] - model[i]) / (error[i] * cauchyScale);
+        fitnessValue += cauchyScale * cauchyScale * std::log1p(residual * residual);
+      }
+      break;
+    }
   }
   fitnessValue = sqrt(fitnessValue / static_cast<double>(m - p));
 
@@ -322,21 +546,20 @@ double Fitting::RCorrelation(const MultiSiteIsotherm &phenotype)
   double tmp2 = 0.0;
   double tmp3 = 0.0;
 
-  for (std::pair<double, double> dataPoint : rawData)
+  phenotype.values(rawData.pressure.data(), modelLoading.data(), m);
+
+  for (size_t i = 0; i < m; ++i)
   {
-    double pressure = dataPoint.first;
-    double loading = dataPoint.second;
-    loading_avg_o += loading / static_cast<double>(m);
-    loading_avg_e += phenotype.value(pressure) / static_cast<double>(m);
+    loading_avg_o += rawData.loading[i] / static_cast<double>(m);
+    loading_avg_e += modelLoading[i] / static_cast<double>(m);
   }
 
-  for (std::pair<double, double> dataPoint : rawData)
+  for (size_t i = 0; i < m; ++i)
   {
-    double pressure = dataPoint.first;
-    double loading = dataPoint.second;
-    tmp1 += (loading - loading_avg_o) * (phenotype.value(pressure) - loading_avg_e);
+    double loading = rawData.loading[i];
+    tmp1 += (loading - loading_avg_o) * (modelLoading[i] - loading_avg_e);
     tmp2 += (loading - loading_avg_o) * (loading - loading_avg_o);
-    tmp3 += (phenotype.value(pressure) - loading_avg_e) * (phenotype.value(pressure) - loading_avg_e);
+    tmp3 += (modelLoading[i] - loading_avg_e) * (modelLoading[i] - loading_avg_e);
   }
   RCorrelationValue = tmp1 / sqrt(tmp2 * tmp3);
 
@@ -373,6 +596,7 @@ void Fitting::nuclearDisaster(size_t ID)
 {
   for (size_t i = 1; i < children.size(); ++i)
   {
+    selectStream(ID, i, RandomStream::Disaster);
     children[i] = newCitizen(ID);
   }
 }
@@ -385,6 +609,10 @@ void Fitting::elitism()
 
 void Fitting::mutate(DNA &mutant)
 {
+  // the positions of the flipped bits, drawn in one batch
+  std::vector<double> flips(mutant.phenotype.numberOfParameters);
+  RandomNumber::Uniform(flips.data(), flips.size());
+
   mutant.genotype.clear();
   mutant.genotype.reserve((sizeof(double) * CHAR_BIT) * mutant.phenotype.numberOfParameters);
   for (size_t i = 0; i < mutant.phenotype.numberOfParameters; ++i)
@@ -395,7 +623,7 @@ void Fitting::mutate(DNA &mutant)
     std::bitset<sizeof(double) * CHAR_BIT> bitset(p);
 
     // mutation: randomly flip bit
-    bitset.flip(std::size_t((sizeof(double) * CHAR_BIT) * RandomNumber::Uniform()));
+    bitset.flip(std::size_t((sizeof(double) * CHAR_BIT) * flips[i]));
 
     // convert from bitset to double
     p = bitset.to_ullong();
@@ -430,6 +658,7 @@ void Fitting::crossover(size_t ID, size_t s1, size_t s2, size_t i1, size_t i2, s
   double tmp1;
   for (size_t i = s1; i < s2; ++i)
   {
+    selectStream(ID, i, RandomStream::Crossover);
     chooseRandomly(i1, i2, j1, j2, k1, k2);
     tmp1 = RandomNumber::Uniform();
     // choose between single cross-over using bit-strings or random parameter-swap
@@ -542,6 +771,8 @@ void Fitting::chooseRandomly(size_t kk1, size_t kk2, size_t jj1, size_t jj2, siz
 
 void Fitting::mate(size_t ID)
 {
+  ++generation;
+
   // retain the first 25% of the children
   elitism();
 
@@ -554,6 +785,7 @@ void Fitting::mate(size_t ID)
   // mutation from GA_Elitists to (GA_Size - GA_Elitists) with "GA_MutationRate" probability
   for (size_t i = GA_Elitists; i < GA_Size - GA_Elitists; ++i)
   {
+    selectStream(ID, i, RandomStream::Mutation);
     if (RandomNumber::Uniform() < GA_MutationRate)
     {
       mutate(children[i]);
@@ -564,10 +796,12 @@ void Fitting::mate(size_t ID)
   // replace the last GA_Elitists (the worst) of the children by new children
   for (size_t i = GA_Size - GA_Elitists; i < GA_Size; ++i)
   {
+    selectStream(ID, i, RandomStream::Replacement);
     children[i] = newCitizen(ID);
   }
 
   // replace the last (GA_Size - 1) children by new children
+  selectStream(ID, 0, RandomStream::Disaster);
   if (RandomNumber::Uniform() < GA_DisasterRate)
   {
     nuclearDisaster(ID);
@@ -594,6 +828,8 @@ void Fitting::writeCitizen(size_t citizen, size_t id, size_t step, size_t variet
              parents[citizen].fitness, pow(RCorrelation(parents[citizen].phenotype), 2), variety, GA_Size);
   }
   std::cout << info;
+  std::cout << "fitness cache: " << fitnessCache->hits() << "/" << fitnessCache->lookups() << " hits ("
+            << fitnessCache->hitRate() << "%)" << std::endl;
   std::cout << "number of parameters: " << parents[citizen].phenotype.numberOfParameters << std::endl;
   for (size_t i = 0; i < parents[citizen].phenotype.numberOfParameters; ++i)
   {
@@ -603,23 +839,72 @@ void Fitting::writeCitizen(size_t citizen, size_t id, size_t step, size_t variet
   std::cout << std::endl;
 }
 
+// termination criteria of the genetic algorithm
+const size_t maxOptimisationStep{1000};
+const size_t maxFullfilledConditionStep{100};
+const double minimumFitness{5.0e-1};
+const double toleranceEqualFitness{1e-3};
+const size_t minstep{10};
+
+// 'minimumFitness' is in units of loading; the error-scaled objectives are dimensionless and only stop on stagnation
+double Fitting::convergenceThreshold() const
+{
+  return objective == Objective::LeastSquares ? minimumFitness : std::numeric_limits<double>::max();
+}
+
+// Refitting: the genotypes of the two best citizens are rebuilt from their phenotypes, and the next generation is
+// mated from them.
+void Fitting::refit(size_t ID)
+{
+  if (islandIndex == 0) std::cout << "Refitting activated\n";
+  for (size_t citizen = 0; citizen < 2; ++citizen)
+  {
+    parents[citizen].genotype.clear();
+    parents[citizen].genotype.reserve((sizeof(double) * CHAR_BIT) * parents[citizen].phenotype.numberOfParameters);
+    for (size_t i = 0; i < parents[citizen].phenotype.numberOfParameters; ++i)
+    {
+      // convert from double to bitset
+      uint64_t p;
+      std::memcpy(&p, &parents[citizen].phenotype.parameters(i), sizeof(double));
+      std::bitset<sizeof(double) * CHAR_BIT> bitset(p);
+
+      // add the bit-string to the genotype representation
+      parents[citizen].genotype += bitset.to_string();
+    }
+    parents[citizen].hash = std::hash<MultiSiteIsotherm>{}(parents[citizen].phenotype);
+    updateCitizen(parents[citizen]);
+  }
+  std::copy(parents.begin(), parents.end(), children.begin());
+
+  mate(ID);
+
+  std::swap(parents, children);
+
+  sortByFitness();
+}
+
 Fitting::DNA Fitting::fit(size_t ID)
 {
+  // cached fitness values are only valid for the data of this component
+  fitnessCache->clear();
+
+  if (numberOfIslands > 1)
+  {
+    return fitIslands(ID);
+  }
+
   size_t optimisationStep{0};
-  const size_t maxOptimisationStep{1000};
   size_t fullFilledConditionStep{0};
-  const size_t maxFullfilledConditionStep{100};
-  const double minimumFitness{5.0e-1};
   double tempFitnessValue{999.0};
   size_t tempVarietyValue{0};
-  const double toleranceEqualFitness{1e-3};
-  const size_t minstep{10};
 
   fullFilledConditionStep = 0;
   optimisationStep = 0;
 
+  generation = 0;
   for (size_t i = 0; i < popAlpha.size(); ++i)
   {
+    selectStream(ID, i, RandomStream::Population);
     popAlpha[i] = newCitizen(ID);
     popBeta[i] = newCitizen(ID);
   }
@@ -634,31 +919,7 @@ Fitting::DNA Fitting::fit(size_t ID)
 
   if (refittingFlag)
   {
-    std::cout << "Refitting activated\n";
-    for (size_t citizen = 0; citizen < 2; ++citizen)
-    {
-      parents[citizen].genotype.clear();
-      parents[citizen].genotype.reserve((sizeof(double) * CHAR_BIT) * parents[citizen].phenotype.numberOfParameters);
-      for (size_t i = 0; i < parents[citizen].phenotype.numberOfParameters; ++i)
-      {
-        // convert from double to bitset
-        uint64_t p;
-        std::memcpy(&p, &parents[citizen].phenotype.parameters(i), sizeof(double));
-        std::bitset<sizeof(double) * CHAR_BIT> bitset(p);
-
-        // add the bit-string to the genotype representation
-        parents[citizen].genotype += bitset.to_string();
-      }
-      parents[citizen].hash = std::hash<MultiSiteIsotherm>{}(parents[citizen].phenotype);
-      updateCitizen(parents[citizen]);
-    }
-    std::copy(parents.begin(), parents.end(), children.begin());
-
-    mate(ID);
-
-    std::swap(parents, children);
-
-    sortByFitness();
+    refit(ID);
   }
 
   isotherms[ID] = parents[0].phenotype;
@@ -674,7 +935,7 @@ Fitting::DNA Fitting::fit(size_t ID)
 
     writeCitizen(0, ID, optimisationStep, tempVarietyValue, fullFilledConditionStep);
 
-    if (optimisationStep >= minstep && parents[0].fitness <= minimumFitness &&
+    if (optimisationStep >= minstep && parents[0].fitness <= convergenceThreshold() &&
         std::abs(parents[0].fitness - tempFitnessValue) <= toleranceEqualFitness)
     {
       fullFilledConditionStep += 1;
@@ -706,6 +967,166 @@ Fitting::DNA Fitting::fit(size_t ID)
   return parents[0];
 }
 
+// Island model: the population is split over 'numberOfIslands' islands that each evolve on their own thread
+// (with their own random-number generator). Every 'migrationInterval' generations the best 'numberOfMigrants'
+// citizens of an island are sent to the next island in a ring, where they replace the worst citizens.
+// All islands stop on the same criterion as 'fit', applied to the best fitness found over all islands.
+Fitting::DNA Fitting::fitIslands(size_t ID)
+{
+  const size_t islandSize = std::max(GA_Size / numberOfIslands, size_t{64});
+
+  std::vector<std::unique_ptr<Fitting>> islands;
+  std::vector<std::unique_ptr<Mailbox>> mailboxes;
+  for (size_t k = 0; k < numberOfIslands; ++k)
+  {
+    islands.push_back(std::make_unique<Fitting>(*this, islandSize));
+    mailboxes.push_back(std::make_unique<Mailbox>(numberOfMigrants));
+  }
+
+  std::cout << "Starting Genetic Algorithm optimization on " << numberOfIslands << " islands of " << islandSize
+            << " citizens\n";
+
+  std::atomic<double> globalBestFitness{std::numeric_limits<double>::max()};
+  std::atomic<bool> finished{false};
+  std::vector<std::exception_ptr> errors(numberOfIslands);
+  std::vector<std::thread> threads;
+  for (size_t k = 0; k < numberOfIslands; ++k)
+  {
+    threads.emplace_back(
+        [&, k]()
+        {
+          try
+          {
+            islands[k]->evolveIsland(ID, k, *mailboxes[k], *mailboxes[(k + 1) % numberOfIslands], globalBestFitness,
+                                     finished);
+          }
+          catch (...)
+          {
+            errors[k] = std::current_exception();
+            finished.store(true);
+          }
+        });
+  }
+  for (std::thread &thread : threads)
+  {
+    thread.join();
+  }
+  for (const std::exception_ptr &error : errors)
+  {
+    if (error) std::rethrow_exception(error);
+  }
+
+  // the best citizen over all islands
+  size_t bestIsland = 0;
+  for (size_t k = 1; k < numberOfIslands; ++k)
+  {
+    if (islands[k]->parents[0].fitness < islands[bestIsland]->parents[0].fitness)
+    {
+      bestIsland = k;
+    }
+  }
+  isotherms[ID] = islands[bestIsland]->parents[0].phenotype;
+
+  return islands[bestIsland]->parents[0];
+}
+
+void Fitting::evolveIsland(size_t ID, size_t island, Mailbox &inbox, Mailbox &outbox,
+                           std::atomic<double> &globalBestFitness, std::atomic<bool> &finished)
+{
+  islandIndex = island;
+
+  size_t optimisationStep{0};
+  size_t fullFilledConditionStep{0};
+  double tempFitnessValue{999.0};
+  size_t tempVarietyValue{0};
+
+  generation = 0;
+  for (size_t i = 0; i < popAlpha.size(); ++i)
+  {
+    selectStream(ID, i, RandomStream::Population);
+    popAlpha[i] = newCitizen(ID);
+    popBeta[i] = newCitizen(ID);
+  }
+
+  if (refittingFlag)
+  {
+    sortByFitness();
+    refit(ID);
+  }
+
+  do
+  {
+    sortByFitness();
+
+    // publish the best citizen of this island
+    double bestFitness = globalBestFitness.load();
+    while (parents[0].fitness < bestFitness && !globalBestFitness.compare_exchange_weak(bestFitness, parents[0].fitness))
+    {
+    }
+    bestFitness = std::min(bestFitness, parents[0].fitness);
+
+    if (island == 0)
+    {
+      tempVarietyValue = biodiversity(children);
+      writeCitizen(0, ID, optimisationStep, tempVarietyValue, fullFilledConditionStep);
+    }
+
+    if (optimisationStep >= minstep && bestFitness <= convergenceThreshold() &&
+        std::abs(bestFitness - tempFitnessValue) <= toleranceEqualFitness)
+    {
+      fullFilledConditionStep += 1;
+    }
+    else
+    {
+      fullFilledConditionStep = 0;
+    }
+
+    if (optimisationStep >= maxOptimisationStep || fullFilledConditionStep >= maxFullfilledConditionStep)
+    {
+      finished.store(true);
+    }
+
+    // migration: send the elites to the next island, the received migrants replace the worst citizens
+    if (optimisationStep > 0 && optimisationStep % migrationInterval == 0)
+    {
+      for (size_t i = 0; i < std::min(numberOfMigrants, GA_Elitists); ++i)
+      {
+        outbox.push(parents[i]);
+      }
+      size_t slot = GA_Size - 1;
+      while (slot >= GA_Elitists && inbox.pop(parents[slot]))
+      {
+        --slot;
+      }
+      sortByFitness();
+    }
+
+    // pairing
+    mate(ID);
+
+    std::swap(parents, children);
+
+    tempFitnessValue = bestFitness;
+
+    optimisationStep += 1;
+
+  } while (!finished.load());
+
+  sortByFitness();
+
+  if (island == 0)
+  {
+    writeCitizen(0, ID, optimisationStep, tempVarietyValue, fullFilledConditionStep);
+  }
+}
+
+// The stream identifier packs the component, island and purpose into the tag (the citizen and the generation
+// have their own counter words), see 'RandomNumber::selectStream'.
+void Fitting::selectStream(size_t ID, size_t citizen, RandomStream purpose)
+{
+  RandomNumber::selectStream(citizen, generation, (ID << 20) | (islandIndex << 4) | static_cast<size_t>(purpose));
+}
+
 // The Nelder-Mead method uses a simplex (a hyper-tetrahedron of n+1 vertices in n dimensions)
 // Advantage: it does not use derivates, works well, can tolerate some noise
 // Disadvantage: it is not garanteed to converge
@@ -771,7 +1192,7 @@ const Fitting::DNA Fitting::simplex(DNA citizen, double scale)
     {
       citizen.phenotype.parameters(j) = v[i][j];
     }
-    f[i] = fitness(citizen.phenotype);
+    f[i] = cachedFitness(citizen.phenotype);
   }
 
   // print out the initial simplex
@@ -827,7 +1248,7 @@ const Fitting::DNA Fitting::simplex(DNA citizen, double scale)
       vr[j] = (1.0 + ALPHA) * vm[j] - ALPHA * v[vg][j];
       citizen.phenotype.parameters(j) = vr[j];
     }
-    fr = fitness(citizen.phenotype);
+    fr = cachedFitness(citizen.phenotype);
 
     if ((fr <= f[vh]) && (fr > f[vs]))
     {
@@ -847,7 +1268,7 @@ const Fitting::DNA Fitting::simplex(DNA citizen, double scale)
         ve[j] = GAMMA * vr[j] + (1.0 - GAMMA) * vm[j];
         citizen.phenotype.parameters(j) = ve[j];
       }
-      fe = fitness(citizen.phenotype);
+      fe = cachedFitness(citizen.phenotype);
 
       // by making fe < fr as opposed to fe < f(vs), Rosenbrocks function
       // takes 62 iterations as opposed to 64.
@@ -879,7 +1300,7 @@ const Fitting::DNA Fitting::simplex(DNA citizen, double scale)
         vc[j] = BETA * v[vg][j] + (1.0 - BETA) * vm[j];
         citizen.phenotype.parameters(j) = vc[j];
       }
-      fc = fitness(citizen.phenotype);
+      fc = cachedFitness(citizen.phenotype);
       if (fc < f[vg])
       {
         for (size_t j = 0; j < n; ++j)
@@ -910,14 +1331,14 @@ const Fitting::DNA Fitting::simplex(DNA citizen, double scale)
           vtmp[m] = v[vg][m];
           citizen.phenotype.parameters(m) = vtmp[m];
         }
-        f[vg] = fitness(citizen.phenotype);
+        f[vg] = cachedFitness(citizen.phenotype);
 
         for (size_t m = 0; m < n; ++m)
         {
           vtmp[m] = v[vh][m];
           citizen.phenotype.parameters(m) = vtmp[m];
         }
-        f[vh] = fitness(citizen.phenotype);
+        f[vh] = cachedFitness(citizen.phenotype);
       }
     }
 
@@ -950,14 +1371,16 @@ const Fitting::DNA Fitting::simplex(DNA citizen, double scale)
       {
         citizen.phenotype.parameters(m) = v[vs][m];
       }
-      double min = fitness(citizen.phenotype);
+      double min = cachedFitness(citizen.phenotype);
 
       std::cout << "Final Values: " << std::endl;
       for (size_t j = 0; j < n; ++j)
       {
         std::cout << v[vs][j] << " ";
       }
-      std::cout << "Fit: " << min << " R2: " << pow(RCorrelation(citizen.phenotype), 2) << "\n\n";
+      std::cout << "Fit: " << min << " R2: " << pow(RCorrelation(citizen.phenotype), 2) << "\n";
+      std::cout << "fitness cache: " << fitnessCache->hits() << "/" << fitnessCache->lookups() << " hits ("
+                << fitnessCache->hitRate() << "%)\n\n";
 
       return citizen;
     }
@@ -1045,3 +1468,49 @@ void Fitting::createPlotScript()
   chmod("make_graphs", S_IRWXU);
 #endif
 }
+
+void Fitting::evaluateParameterSets(size_t ID, const double *parameterSets, size_t numberOfSets,
+                                    const double *pressures, size_t numberOfPressures, double *loadings) const
+{
+  const MultiSiteIsotherm &model = isotherms[ID];
+  const size_t numberOfParameters = model.numberOfParameters;
+
+  const size_t numberOfThreads =
+      std::max(size_t{1}, std::min(static_cast<size_t>(std::thread::hardware_concurrency()), numberOfSets));
+  std::vector<std::exception_ptr> errors(numberOfThreads);
+  std::vector<std::thread> threads;
+  for (size_t t = 0; t < numberOfThreads; ++t)
+  {
+    threads.emplace_back(
+        [&, t]()
+        {
+          try
+          {
+            // each thread evaluates a contiguous block of parameter sets on its own copy of the model
+            MultiSiteIsotherm isotherm = model;
+            const size_t first = t * numberOfSets / numberOfThreads;
+            const size_t last = (t + 1) * numberOfSets / numberOfThreads;
+            for (size_t m = first; m < last; ++m)
+            {
+              for (size_t j = 0; j < numberOfParameters; ++j)
+              {
+                isotherm.parameters(j) = parameterSets[m * numberOfParameters + j];
+              }
+              isotherm.values(pressures, loadings + m * numberOfPressures, numberOfPressures);
+            }
+          }
+          catch (...)
+          {
+            errors[t] = std::current_exception();
+          }
+        });
+  }
+  for (std::thread &thread : threads)
+  {
+    thread.join();
+  }
+  for (const std::exception_ptr &error : errors)
+  {
+    if (error) std::rethrow_exception(error);
+  }
+}
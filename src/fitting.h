@@ -1,12 +1,15 @@
 #pragma once
 
 #include <array>
+#include <atomic>
+#include <memory>
 #include <string>
 #include <tuple>
 #include <unordered_map>
 #include <vector>
 
 #include "component.h"
+#include "fitness_cache.h"
 #include "inputreader.h"
 #include "multi_site_isotherm.h"
 
@@ -47,6 +50,54 @@ struct Fitting
     size_t hash;                  ///< Hash value for uniqueness.
   };
 
+  /**
+   * \brief Lock-free mailbox used to migrate elites between islands.
+   *
+   * The islands are connected in a ring: island k only sends to island k + 1, so every mailbox has exactly one
+   * producer and one consumer. Migrants are dropped when the mailbox is full.
+   */
+  struct Mailbox
+  {
+    /**
+     * \brief Constructs a mailbox that can hold a given number of migrants.
+     * \param capacity Maximum number of migrants waiting in the mailbox.
+     */
+    explicit Mailbox(size_t capacity) : slots(capacity + 1) {}
+
+    /**
+     * \brief Posts a migrant (producer side).
+     * \param migrant DNA object to send.
+     * \return False if the mailbox is full.
+     */
+    bool push(const DNA &migrant)
+    {
+      const size_t t = tail.load(std::memory_order_relaxed);
+      const size_t next = (t + 1) % slots.size();
+      if (next == head.load(std::memory_order_acquire)) return false;
+      slots[t] = migrant;
+      tail.store(next, std::memory_order_release);
+      return true;
+    }
+
+    /**
+     * \brief Receives a migrant (consumer side).
+     * \param migrant DNA object that receives the migrant.
+     * \return False if the mailbox is empty.
+     */
+    bool pop(DNA &migrant)
+    {
+      const size_t h = head.load(std::memory_order_relaxed);
+      if (h == tail.load(std::memory_order_acquire)) return false;
+      migrant = slots[h];
+      head.store((h + 1) % slots.size(), std::memory_order_release);
+      return true;
+    }
+
+    std::vector<DNA> slots;        ///< Ring buffer of migrants (one slot is kept empty).
+    std::atomic<size_t> head{0};  ///< Index of the next migrant to receive.
+    std::atomic<size_t> tail{0};  ///< Index of the next free slot.
+  };
+
   /**
    * \brief Enum representing pressure scale options.
    */
@@ -56,12 +107,66 @@ struct Fitting
     Normal = 1  ///< Linear pressure scale.
   };
 
+  /**
+   * \brief Enum representing the objective minimised by the fitting.
+   */
+  enum class Objective
+  {
+    LeastSquares = 0,          ///< Unweighted least squares.
+    WeightedLeastSquares = 1,  ///< Least squares of the residuals divided by the measurement errors.
+    Huber = 2,                 ///< Huber loss of the error-scaled residuals (quadratic near zero, linear in the tails).
+    Cauchy = 3                 ///< Cauchy loss of the error-scaled residuals (logarithmic in the tails).
+  };
+
+  /**
+   * \brief Data points stored as separate arrays, so that the isotherm can be evaluated over all pressures at once.
+   */
+  struct DataPoints
+  {
+    std::vector<double> pressure;  ///< Pressures.
+    std::vector<double> loading;   ///< Measured loadings.
+    std::vector<double> error;     ///< Measurement errors (1.0 when no errors are read).
+
+    size_t size() const { return pressure.size(); }
+    bool empty() const { return pressure.empty(); }
+    void clear()
+    {
+      pressure.clear();
+      loading.clear();
+      error.clear();
+    }
+    void reserve(size_t n)
+    {
+      pressure.reserve(n);
+      loading.reserve(n);
+      error.reserve(n);
+    }
+    void push_back(double p, double q, double e)
+    {
+      pressure.push_back(p);
+      loading.push_back(q);
+      error.push_back(e);
+    }
+
+    /**
+     * \brief Sorts the data points on increasing pressure.
+     */
+    void sortByPressure();
+  };
+
   /**
    * \brief Constructs a Fitting object from input parameters.
    * \param inputreader InputReader containing simulation parameters.
    */
   Fitting(const InputReader &inputreader);
 
+  /**
+   * \brief Constructs an island: a copy of the fitting settings and data with its own population.
+   * \param master Fitting object holding the data and settings.
+   * \param populationSize Number of citizens on the island.
+   */
+  Fitting(const Fitting &master, size_t populationSize);
+
   /**
    * \brief Reads data for a specific component.
    * \param ID Index of the component.
@@ -91,6 +196,22 @@ struct Fitting
    */
   void createPlotScript();
 
+  /**
+   * \brief Evaluates the isotherm model of a component for many parameter sets at once.
+   *
+   * The parameter sets are distributed over the hardware threads; each thread evaluates its sets with the
+   * batched isotherm kernel.
+   *
+   * \param ID Index of the component whose isotherm model is evaluated.
+   * \param parameterSets Row-major (numberOfSets x numberOfParameters) matrix of parameter sets.
+   * \param numberOfSets Number of parameter sets.
+   * \param pressures Pressures at which to evaluate the isotherms.
+   * \param numberOfPressures Number of pressures.
+   * \param loadings Receives the row-major (numberOfSets x numberOfPressures) matrix of loadings.
+   */
+  void evaluateParameterSets(size_t ID, const double *parameterSets, size_t numberOfSets, const double *pressures,
+                             size_t numberOfPressures, double *loadings) const;
+
 #ifdef PYBUILD
   /**
    * \brief Constructs a Fitting object for Python integration.
@@ -122,6 +243,17 @@ struct Fitting
    */
   py::array_t<double> evaluate();
 
+  /**
+   * \brief Evaluates the isotherm model of a component for a matrix of parameter sets (GIL released).
+   * \param ID Index of the component.
+   * \param parameterSets NumPy array of shape (M, number of parameters).
+   * \param pressures NumPy array of N pressures.
+   * \return NumPy array of shape (M, N) with the loadings.
+   */
+  py::array_t<double> evaluateParameterSets(size_t ID,
+                                            py::array_t<double, py::array::c_style | py::array::forcecast> parameterSets,
+                                            py::array_t<double, py::array::c_style | py::array::forcecast> pressures);
+
 #endif  // PYBUILD
 
   /**
@@ -144,6 +276,21 @@ struct Fitting
    */
   double fitness(const MultiSiteIsotherm &phenotype);
 
+  /**
+   * \brief Calculates the fitness of a phenotype, reusing the result of an identical earlier evaluation.
+   * \param phenotype Phenotype to evaluate.
+   * \param hash Hash of the phenotype parameters.
+   * \return Fitness value.
+   */
+  double cachedFitness(const MultiSiteIsotherm &phenotype, size_t hash);
+
+  /**
+   * \brief Calculates the fitness of a phenotype through the fitness cache, computing the hash.
+   * \param phenotype Phenotype to evaluate.
+   * \return Fitness value.
+   */
+  double cachedFitness(const MultiSiteIsotherm &phenotype);
+
   /**
    * \brief Calculates the correlation coefficient R.
    * \param phenotype Phenotype to evaluate.
@@ -219,6 +366,18 @@ struct Fitting
    */
   void writeCitizen(size_t citizen, size_t id, size_t step, size_t variety, size_t fullfilledCondition);
 
+  /**
+   * \brief Fitness below which the genetic algorithm may stop once the best fitness stagnates.
+   * \return The threshold for the current objective.
+   */
+  double convergenceThreshold() const;
+
+  /**
+   * \brief Rebuilds the genotypes of the two best citizens and mates the next generation from them.
+   * \param ID Index of the component.
+   */
+  void refit(size_t ID);
+
   /**
    * \brief Fits the isotherm model to data for a specific component.
    * \param ID Index of the component.
@@ -226,6 +385,49 @@ struct Fitting
    */
   DNA fit(size_t ID);
 
+  /**
+   * \brief Fits the isotherm model using several islands that evolve concurrently and exchange elites.
+   * \param ID Index of the component.
+   * \return Best DNA object found on any of the islands.
+   */
+  DNA fitIslands(size_t ID);
+
+  /**
+   * \brief Evolves the population of a single island until the shared termination criterion is met.
+   * \param ID Index of the component.
+   * \param island Index of the island (island 0 reports the progress).
+   * \param inbox Mailbox receiving migrants from the previous island.
+   * \param outbox Mailbox of the next island.
+   * \param globalBestFitness Best fitness found so far over all islands.
+   * \param finished Flag signalling all islands to stop.
+   */
+  void evolveIsland(size_t ID, size_t island, Mailbox &inbox, Mailbox &outbox, std::atomic<double> &globalBestFitness,
+                    std::atomic<bool> &finished);
+
+  /**
+   * \brief Purpose of the random numbers drawn for a citizen, so that each purpose has its own stream.
+   */
+  enum class RandomStream : size_t
+  {
+    Population = 0,
+    Crossover = 1,
+    Mutation = 2,
+    Replacement = 3,
+    Disaster = 4
+  };
+
+  /**
+   * \brief Selects the random stream of a citizen in the current generation.
+   *
+   * The stream is determined by the seed, the citizen, the generation, the component, the island and the
+   * purpose, so that a fit with a fixed seed is reproducible.
+   *
+   * \param ID Identifier of the component.
+   * \param citizen Index of the citizen in the population.
+   * \param purpose What the random numbers are used for.
+   */
+  void selectStream(size_t ID, size_t citizen, RandomStream purpose);
+
   /**
    * \brief Optimizes a DNA object using the Nelder-Mead simplex method.
    * \param citizen DNA object to optimize.
@@ -246,13 +448,17 @@ struct Fitting
   double maximumLoading{0.0};                       ///< Maximum loading observed.
   PressureScale pressureScale{PressureScale::Log};  ///< Pressure scale type.
 
-  std::vector<std::pair<double, double>> rawData;  ///< Raw data points (pressure, loading).
+  Objective objective{Objective::LeastSquares};  ///< Objective minimised by the fitting.
+
+  DataPoints rawData;                ///< Raw data points (pressure, loading, error).
+  std::vector<double> modelLoading;  ///< Isotherm loadings at the data pressures (scratch for the fitness).
 
   bool fittingFlag{false};             ///< Flag indicating if fitting is active.
   bool physicalConstrainsFlag{false};  ///< Flag for physical constraints.
   bool seedFlag{false};                ///< Flag for seed initialization.
   bool pressureRangeFlag{false};       ///< Flag for pressure range usage.
   bool refittingFlag{false};           ///< Flag for refitting.
+  bool quiet{false};                   ///< Do not echo the data points that are read.
 
   std::pair<double, double> pressureRange;     ///< Range of pressures.
   std::pair<double, double> logPressureRange;  ///< Logarithmic pressure range.
@@ -265,6 +471,14 @@ struct Fitting
   size_t GA_Elitists;         ///< Number of elite individuals.
   size_t GA_Motleists;        ///< Number of diverse individuals.
 
+  size_t numberOfIslands{1};     ///< Number of islands evolved concurrently.
+  size_t migrationInterval{10};  ///< Generations between migrations.
+  size_t numberOfMigrants{4};    ///< Elites sent to the next island at each migration.
+  size_t islandIndex{0};         ///< Index of this island (0 for a single population).
+  size_t generation{0};          ///< Generation that is being bred, part of the random-stream identifier.
+
+  std::shared_ptr<FitnessCache> fitnessCache;  ///< Fitness cache (shared by all islands).
+
   std::vector<DNA> popAlpha;   ///< First population buffer.
   std::vector<DNA> popBeta;    ///< Second population buffer.
   std::vector<DNA> &parents;   ///< Reference to current parent population.
@@ -372,6 +372,289 @@ InputReader::InputReader(const std::string fileName) : components()
         this->writeEvery = value;
         continue;
       }
+      if (caseInSensStringCompare(keyword, "OutletOnly"))
+      {
+        bool value = parseBoolean(arguments, keyword, lineNumber);
+        this->outletOnly = value;
+        continue;
+      }
+      if (caseInSensStringCompare(keyword, "ColumnOutputFields"))
+      {
+        std::vector<std::string> values = parseListOfSystemValues<std::string>(arguments, keyword, lineNumber);
+        this->columnOutputFields = values;
+        continue;
+      }
+      if (caseInSensStringCompare(keyword, "ColumnOutputStride"))
+      {
+        size_t value = parse<size_t>(arguments, keyword, lineNumber);
+        this->columnOutputStride = value;
+        continue;
+      }
+      if (caseInSensStringCompare(keyword, "ColumnOutputMantissaBits"))
+      {
+        size_t value = parse<size_t>(arguments, keyword, lineNumber);
+        this->columnOutputMantissaBits = value;
+        continue;
+      }
+      if (caseInSensStringCompare(keyword, "CycleStep"))
+      {
+        // e.g. 'CycleStep Purge 60 Velocity 0.05': the type and duration, followed by optional overrides
+        const std::string usage = " (Use e.g.: 'CycleStep Adsorption 60'; types are Pressurization, Adsorption, "
+                                  "Blowdown and Purge, options are Pressure, Velocity, Direction and Inlet)\n";
+        CycleStep step;
+        std::string str;
+        std::istringstream ss(arguments);
+        if (!(ss >> str >> step.duration) || step.duration <= 0.0)
+        {
+          throw std::runtime_error("Error: cycle step needs a type and a positive duration at line: " +
+                                   std::to_string(lineNumber) + usage);
+        }
+        if (caseInSensStringCompare(str, "Pressurization")) step.type = CycleStep::Type::Pressurization;
+        else if (caseInSensStringCompare(str, "Adsorption")) step.type = CycleStep::Type::Adsorption;
+        else if (caseInSensStringCompare(str, "Blowdown")) step.type = CycleStep::Type::Blowdown;
+        else if (caseInSensStringCompare(str, "Purge")) step.type = CycleStep::Type::Purge;
+        else
+        {
+          throw std::runtime_error("Error: unknown cycle step '" + str + "' at line: " + std::to_string(lineNumber) +
+                                   usage);
+        }
+        step.countercurrent = step.type == CycleStep::Type::Blowdown || step.type == CycleStep::Type::Purge;
+        step.carrierInlet = step.countercurrent;
+
+        std::string option;
+        while (ss >> option && option.rfind("//", 0) != 0)
+        {
+          std::string value;
+          if (!(ss >> value))
+          {
+            throw std::runtime_error("Error: missing value of cycle-step option '" + option +
+                                     "' at line: " + std::to_string(lineNumber) + usage);
+          }
+          if (caseInSensStringCompare(option, "Pressure")) step.pressure = parseDouble(value, option, lineNumber);
+          else if (caseInSensStringCompare(option, "Velocity")) step.velocity = parseDouble(value, option, lineNumber);
+          else if (caseInSensStringCompare(option, "Direction") && caseInSensStringCompare(value, "Cocurrent"))
+            step.countercurrent = false;
+          else if (caseInSensStringCompare(option, "Direction") && caseInSensStringCompare(value, "Countercurrent"))
+            step.countercurrent = true;
+          else if (caseInSensStringCompare(option, "Inlet") && caseInSensStringCompare(value, "Feed"))
+            step.carrierInlet = false;
+          else if (caseInSensStringCompare(option, "Inlet") && caseInSensStringCompare(value, "Carrier"))
+            step.carrierInlet = true;
+          else
+          {
+            throw std::runtime_error("Error: unknown cycle-step option '" + option + " " + value +
+                                     "' at line: " + std::to_string(lineNumber) + usage);
+          }
+        }
+        cycleSteps.push_back(step);
+        continue;
+      }
+      if (caseInSensStringCompare(keyword, "NumberOfCycles"))
+      {
+        size_t value = parse<size_t>(arguments, keyword, lineNumber);
+        this->numberOfCycles = value;
+        continue;
+      }
+      if (caseInSensStringCompare(keyword, "PurgePressure"))
+      {
+        double value = parseDouble(arguments, keyword, lineNumber);
+        this->purgePressure = value;
+        continue;
+      }
+      if (caseInSensStringCompare(keyword, "PurgeVelocity"))
+      {
+        double value = parseDouble(arguments, keyword, lineNumber);
+        this->purgeVelocity = value;
+        continue;
+      }
+      if (caseInSensStringCompare(keyword, "CyclicSteadyStateTolerance"))
+      {
+        double value = parseDouble(arguments, keyword, lineNumber);
+        this->cyclicSteadyStateTolerance = value;
+        continue;
+      }
+      if (caseInSensStringCompare(keyword, "CyclicSteadyStateAcceleration"))
+      {
+        std::string str;
+        std::istringstream ss(arguments);
+        if (ss >> str)
+        {
+          if (caseInSensStringCompare(str, "None"))
+          {
+            cyclicSteadyStateAcceleration = 0;
+            continue;
+          }
+          if (caseInSensStringCompare(str, "Anderson"))
+          {
+            size_t depth{};
+            cyclicSteadyStateAcceleration = (ss >> depth && depth > 0) ? depth : 5;
+            continue;
+          }
+        }
+        throw std::runtime_error("Error: unknown cyclic-steady-state acceleration at line: " +
+                                 std::to_string(lineNumber) +
+                                 " (Use e.g.: 'CyclicSteadyStateAcceleration Anderson 5'; options are None and "
+                                 "Anderson with an optional depth)\n");
+      }
+      if (caseInSensStringCompare(keyword, "ColumnOutputFormat"))
+      {
+        std::string str;
+        std::istringstream ss(arguments);
+        if (ss >> str)
+        {
+          if (caseInSensStringCompare(str, "Text"))
+          {
+            columnOutputFormat = 0;
+            continue;
+          }
+          if (caseInSensStringCompare(str, "Float32"))
+          {
+            columnOutputFormat = 1;
+            continue;
+          }
+          if (caseInSensStringCompare(str, "Compressed"))
+          {
+            columnOutputFormat = 2;
+            continue;
+          }
+        }
+        throw std::runtime_error("Error: unknown column output format at line: " + std::to_string(lineNumber) +
+                                 " (Use e.g.: 'ColumnOutputFormat Float32'; options are Text, Float32 and Compressed)\n");
+      }
+      if (caseInSensStringCompare(keyword, "Integrator"))
+      {
+        std::string str;
+        std::istringstream ss(arguments);
+        if (ss >> str)
+        {
+          if (caseInSensStringCompare(str, "Implicit"))
+          {
+            explicitIntegrator = false;
+            continue;
+          }
+          if (caseInSensStringCompare(str, "Explicit"))
+          {
+            explicitIntegrator = true;
+            continue;
+          }
+        }
+        throw std::runtime_error("Error: unknown integrator at line: " + std::to_string(lineNumber) +
+                                 " (Use e.g.: 'Integrator Explicit'; options are Implicit and Explicit)\n");
+      }
+      if (caseInSensStringCompare(keyword, "ImplicitIntegrator"))
+      {
+        std::string str;
+        std::istringstream ss(arguments);
+        if (ss >> str)
+        {
+          if (caseInSensStringCompare(str, "BDF"))
+          {
+            implicitIntegrator = 0;
+            continue;
+          }
+          if (caseInSensStringCompare(str, "IMEX"))
+          {
+            implicitIntegrator = 1;
+            continue;
+          }
+          if (caseInSensStringCompare(str, "Strang"))
+          {
+            implicitIntegrator = 2;
+            continue;
+          }
+          if (caseInSensStringCompare(str, "Multirate"))
+          {
+            implicitIntegrator = 3;
+            continue;
+          }
+        }
+        throw std::runtime_error("Error: unknown implicit integrator at line: " + std::to_string(lineNumber) +
+                                 " (Use e.g.: 'ImplicitIntegrator IMEX'; options are BDF, IMEX, Strang and Multirate)\n");
+      }
+      if (caseInSensStringCompare(keyword, "LinearSolver"))
+      {
+        std::string str;
+        std::istringstream ss(arguments);
+        if (ss >> str)
+        {
+          if (caseInSensStringCompare(str, "Auto"))
+          {
+            linearSolver = 0;
+            continue;
+          }
+          if (caseInSensStringCompare(str, "Dense"))
+          {
+            linearSolver = 1;
+            continue;
+          }
+          if (caseInSensStringCompare(str, "GMRES"))
+          {
+            linearSolver = 2;
+            continue;
+          }
+        }
+        throw std::runtime_error("Error: unknown linear solver at line: " + std::to_string(lineNumber) +
+                                 " (Use e.g.: 'LinearSolver GMRES'; options are Auto, Dense and GMRES)\n");
+      }
+      if (caseInSensStringCompare(keyword, "LinearSolverMemoryLimit"))
+      {
+        double value = parseDouble(arguments, keyword, lineNumber);
+        this->linearSolverMemoryLimit = value;
+        continue;
+      }
+      if (caseInSensStringCompare(keyword, "NonlinearSolver"))
+      {
+        std::string str;
+        std::istringstream ss(arguments);
+        if (ss >> str)
+        {
+          if (caseInSensStringCompare(str, "Newton"))
+          {
+            nonlinearSolver = 0;
+            continue;
+          }
+          if (caseInSensStringCompare(str, "FixedPoint"))
+          {
+            size_t depth{};
+            nonlinearSolver = 1;
+            fixedPointAndersonDepth = (ss >> depth) ? depth : 3;
+            continue;
+          }
+        }
+        throw std::runtime_error("Error: unknown nonlinear solver at line: " + std::to_string(lineNumber) +
+                                 " (Use e.g.: 'NonlinearSolver FixedPoint 3'; options are Newton and FixedPoint "
+                                 "with an optional Anderson depth)\n");
+      }
+      if (caseInSensStringCompare(keyword, "EquilibriumReuseTolerance"))
+      {
+        double value = parseDouble(arguments, keyword, lineNumber);
+        this->equilibriumReuseTolerance = value;
+        continue;
+      }
+      if (caseInSensStringCompare(keyword, "EquilibriumReuseCorrection"))
+      {
+        bool value = parseBoolean(arguments, keyword, lineNumber);
+        this->equilibriumReuseCorrection = value;
+        continue;
+      }
+      if (caseInSensStringCompare(keyword, "ExplicitTileSize"))
+      {
+        size_t value = parse<size_t>(arguments, keyword, lineNumber);
+        this->explicitTileSize = value;
+        continue;
+      }
+      if (caseInSensStringCompare(keyword, "ExplicitTileSteps"))
+      {
+        size_t value = parse<size_t>(arguments, keyword, lineNumber);
+        this->explicitTileSteps = value;
+        continue;
+      }
+      if (caseInSensStringCompare(keyword, "MultirateRatio"))
+      {
+        double value = parseDouble(arguments, keyword, lineNumber);
+        this->multirateRatio = value;
+        continue;
+      }
       if (caseInSensStringCompare(keyword, "ColumnLength"))
       {
         double value = parseDouble(arguments, keyword, lineNumber);
@@ -406,6 +689,80 @@ InputReader::InputReader(const std::string fileName) : components()
         continue;
       }
 
+      if (caseInSensStringCompare(keyword, "FittingObjective"))
+      {
+        std::string str;
+        std::istringstream ss(arguments);
+        if (ss >> str)
+        {
+          if (caseInSensStringCompare(str, "LeastSquares"))
+          {
+            fittingObjective = 0;
+            continue;
+          }
+          if (caseInSensStringCompare(str, "WeightedLeastSquares"))
+          {
+            fittingObjective = 1;
+            continue;
+          }
+          if (caseInSensStringCompare(str, "Huber"))
+          {
+            fittingObjective = 2;
+            continue;
+          }
+          if (caseInSensStringCompare(str, "Cauchy"))
+          {
+            fittingObjective = 3;
+            continue;
+          }
+        }
+        throw std::runtime_error("Error: unknown fitting objective at line: " + std::to_string(lineNumber) +
+                                 " (Use e.g.: 'FittingObjective WeightedLeastSquares'; options are LeastSquares, "
+                                 "WeightedLeastSquares, Huber and Cauchy)\n");
+      }
+
+      if (caseInSensStringCompare(keyword, "Quiet"))
+      {
+        bool value = parseBoolean(arguments, keyword, lineNumber);
+        this->quiet = value;
+        continue;
+      }
+
+      if (caseInSensStringCompare(keyword, "NumberOfIslands"))
+      {
+        size_t value = parse<size_t>(arguments, keyword, lineNumber);
+        this->numberOfIslands = value;
+        continue;
+      }
+
+      if (caseInSensStringCompare(keyword, "MigrationInterval"))
+      {
+        size_t value = parse<size_t>(arguments, keyword, lineNumber);
+        this->migrationInterval = value;
+        continue;
+      }
+
+      if (caseInSensStringCompare(keyword, "NumberOfMigrants"))
+      {
+        size_t value = parse<size_t>(arguments, keyword, lineNumber);
+        this->numberOfMigrants = value;
+        continue;
+      }
+
+      if (caseInSensStringCompare(keyword, "FitnessCacheSize"))
+      {
+        size_t value = parse<size_t>(arguments, keyword, lineNumber);
+        this->fitnessCacheSize = value;
+        continue;
+      }
+
+      if (caseInSensStringCompare(keyword, "RandomSeed"))
+      {
+        size_t value = parse<size_t>(arguments, keyword, lineNumber);
+        this->randomSeed = value;
+        continue;
+      }
+
       if (caseInSensStringCompare(keyword, std::string("Component")))
       {
         std::istringstream ss(arguments);
@@ -693,6 +1050,23 @@ InputReader::InputReader(const std::string fileName) : components()
     maxIsothermTerms = maxIsothermTermsIterator->isotherm.numberOfSites;
   }
 
+  if (simulationType == SimulationType::Fitting)
+  {
+    if (numberOfIslands == 0)
+    {
+      throw std::runtime_error("Error: number of islands must be at least one (Use e.g.: 'NumberOfIslands 4'");
+    }
+    if (migrationInterval == 0)
+    {
+      throw std::runtime_error("Error: migration interval must be at least one (Use e.g.: 'MigrationInterval 10'");
+    }
+    if (fittingObjective != 0 && columnError == 0)
+    {
+      throw std::runtime_error(
+          "Error: column of the measurement errors not set, needed by the fitting objective (Use e.g.: 'ColumnError 3'");
+    }
+  }
+
   if (simulationType == SimulationType::Breakthrough)
   {
     if (numberOfCarrierGases == 0)
@@ -736,5 +1110,67 @@ InputReader::InputReader(const std::string fileName) : components()
     {
       throw std::runtime_error("Error: column length not set (Use e.g.: 'ColumnLength 0.3'");
     }
+    if (columnOutputStride == 0)
+    {
+      throw std::runtime_error("Error: column output stride must be at least 1 (Use e.g.: 'ColumnOutputStride 5'");
+    }
+    if (columnOutputMantissaBits == 0 || columnOutputMantissaBits > 23)
+    {
+      throw std::runtime_error(
+          "Error: column output mantissa bits must be between 1 and 23 (Use e.g.: 'ColumnOutputMantissaBits 12'");
+    }
+    if (linearSolverMemoryLimit <= 0.0)
+    {
+      throw std::runtime_error(
+          "Error: linear solver memory limit must be positive (Use e.g.: 'LinearSolverMemoryLimit 4096'");
+    }
+    if (explicitTileSteps == 0)
+    {
+      throw std::runtime_error("Error: explicit tile steps must be at least 1 (Use e.g.: 'ExplicitTileSteps 4'");
+    }
+    if (explicitTileSize > 0 && !explicitIntegrator)
+    {
+      throw std::runtime_error(
+          "Error: the cache-tiled scheme needs the explicit integrator (Use e.g.: 'Integrator Explicit'");
+    }
+    if (equilibriumReuseTolerance < 0.0)
+    {
+      throw std::runtime_error(
+          "Error: equilibrium reuse tolerance must be zero or positive (Use e.g.: 'EquilibriumReuseTolerance 1e-6'");
+    }
+    if (multirateRatio <= 1.0)
+    {
+      throw std::runtime_error("Error: multirate ratio must be larger than 1 (Use e.g.: 'MultirateRatio 10'");
+    }
+
+    // resolve the pressures and velocities of the cycle steps from their type
+    for (CycleStep &step : cycleSteps)
+    {
+      const bool highPressure =
+          step.type == CycleStep::Type::Pressurization || step.type == CycleStep::Type::Adsorption;
+      if (step.pressure < 0.0)
+      {
+        if (!highPressure && purgePressure < 0.0)
+        {
+          throw std::runtime_error("Error: purge pressure of the blowdown and purge steps not set "
+                                   "(Use e.g.: 'PurgePressure 1e5'");
+        }
+        step.pressure = highPressure ? totalPressure : purgePressure;
+      }
+      if (step.velocity < 0.0)
+      {
+        if (highPressure) step.velocity = columnEntranceVelocity;
+        else if (step.type == CycleStep::Type::Blowdown) step.velocity = 0.0;
+        else step.velocity = purgeVelocity >= 0.0 ? purgeVelocity : columnEntranceVelocity;
+      }
+      if (step.pressure <= 0.0)
+      {
+        throw std::runtime_error("Error: the pressure of a cycle step must be positive");
+      }
+    }
+    if (!cycleSteps.empty() && numberOfCycles == 0)
+    {
+      throw std::runtime_error("Error: number of cycles must be at least one (Use e.g.: 'NumberOfCycles 200'");
+    }
   }
 }
@@ -35,6 +35,30 @@ struct InputReader
     Test = 3                ///< Test simulation.
   };
 
+  /**
+   * \brief A step of a cyclic (pressure-swing) adsorption process, given in the input by 'CycleStep'.
+   *
+   * The flow direction and inlet gas follow from the type of step; the pressure and inlet velocity are resolved
+   * from the type after reading the input unless they were given on the 'CycleStep' line.
+   */
+  struct CycleStep
+  {
+    enum class Type
+    {
+      Pressurization = 0,  ///< Pressure raised to the feed pressure, co-current feed.
+      Adsorption = 1,      ///< Co-current feed at the feed pressure.
+      Blowdown = 2,        ///< Pressure lowered to the purge pressure, closed inlet, counter-current outflow.
+      Purge = 3            ///< Counter-current carrier gas at the purge pressure.
+    };
+
+    Type type{Type::Adsorption};  ///< The type of step.
+    double duration{0.0};         ///< The duration of the step in seconds.
+    double pressure{-1.0};        ///< The total pressure at the inlet in Pa.
+    double velocity{-1.0};        ///< The interstitial gas velocity at the inlet in m/s.
+    bool countercurrent{false};   ///< Whether the gas enters at the product end of the column.
+    bool carrierInlet{false};     ///< Whether the inlet gas is the carrier gas instead of the feed.
+  };
+
   std::vector<Component> components;  ///< The list of components involved in the simulation.
   size_t numberOfCarrierGases{0};     ///< The number of carrier gas components.
   size_t carrierGasComponent{0};      ///< The index of the carrier gas component.
@@ -60,13 +84,45 @@ struct InputReader
   size_t printEvery{10000};          ///< The interval at which to print output.
   size_t writeEvery{10000};          ///< The interval at which to write output.
   size_t numberOfGridPoints{100};    ///< The number of grid points in the column.
+  bool explicitIntegrator{false};    ///< Whether breakthroughs run with the explicit SSP-RK3 scheme.
+  size_t implicitIntegrator{0};      ///< The integrator of implicit runs (0 BDF, 1 IMEX, 2 Strang, 3 multirate).
+  double multirateRatio{10.0};       ///< Components with Kl above this ratio times the smallest Kl are fast.
+  size_t linearSolver{0};            ///< The linear solver of the BDF integrator (0 automatic, 1 dense, 2 GMRES).
+  double linearSolverMemoryLimit{1024.0};  ///< The memory the BDF linear solver may use in MiB.
+  size_t nonlinearSolver{0};         ///< The nonlinear solver of the BDF integrator (0 Newton, 1 fixed point).
+  size_t fixedPointAndersonDepth{3};  ///< The Anderson-acceleration depth of the fixed-point solver (0 for none).
+  double equilibriumReuseTolerance{0.0};  ///< Relative pressure change below which loadings are reused (0 for never).
+  bool equilibriumReuseCorrection{false};  ///< Whether reused loadings get a first-order correction.
+  size_t explicitTileSize{0};        ///< Grid points per tile of the cache-tiled explicit scheme (0 for untiled).
+  size_t explicitTileSteps{1};       ///< Time steps advanced per sweep of the cache-tiled explicit scheme.
+
+  bool outletOnly{false};                         ///< Whether to write only the outlet breakthrough curves.
+  std::vector<std::string> columnOutputFields{};  ///< The fields written to the column profiles (empty for all).
+  size_t columnOutputStride{1};                   ///< The grid stride of the column profiles (outlet always written).
+  size_t columnOutputFormat{0};                   ///< The column-profile format (0 text, 1 float32, 2 compressed).
+  size_t columnOutputMantissaBits{23};            ///< The float32 mantissa bits kept in compressed profiles.
+
+  std::vector<CycleStep> cycleSteps{};        ///< The steps of a cyclic process (empty for a single breakthrough).
+  size_t numberOfCycles{100};                 ///< The maximum number of cycles run towards cyclic steady state.
+  double purgePressure{-1.0};                 ///< The pressure of the blowdown and purge steps in Pa.
+  double purgeVelocity{-1.0};                 ///< The inlet velocity of the purge step in m/s.
+  double cyclicSteadyStateTolerance{1.0e-6};  ///< The largest scaled change of the state over a cycle at CSS.
+  size_t cyclicSteadyStateAcceleration{5};    ///< The Anderson-acceleration depth of the cycle map (0 for none).
 
   double pressureStart{-1.0};          ///< The starting pressure for isotherm calculations.
   double pressureEnd{-1.0};            ///< The ending pressure for isotherm calculations.
   size_t numberOfPressurePoints{100};  ///< The number of pressure points to calculate.
   size_t pressureScale{0};             ///< The scale for pressure calculations (0 for log, 1 for linear).
 
-  size_t columnPressure{0};  ///< The index of the column for pressure data.
-  size_t columnLoading{1};   ///< The index of the column for loading data.
-  size_t columnError{2};     ///< The index of the column for error data.
+  size_t columnPressure{0};    ///< The index of the column for pressure data.
+  size_t columnLoading{1};     ///< The index of the column for loading data.
+  size_t columnError{0};       ///< The index of the column for error data (0 when not given).
+  size_t fittingObjective{0};  ///< The fitting objective (0 least squares, 1 weighted, 2 Huber, 3 Cauchy).
+  bool quiet{false};           ///< Whether to suppress echoing the data points read for fitting.
+
+  size_t numberOfIslands{1};     ///< The number of genetic-algorithm islands (each evolved on its own thread).
+  size_t migrationInterval{10};  ///< The number of generations between migrations of elites between islands.
+  size_t numberOfMigrants{4};    ///< The number of elites sent to the neighbouring island at each migration.
+  size_t fitnessCacheSize{65536};  ///< The number of slots of the fitness cache (0 disables the cache).
+  size_t randomSeed{0};            ///< The seed of the random streams of the fitting (0 for a random seed).
 };
@@ -213,101 +213,250 @@ bool Isotherm::isUnphysical() const
   }
 }
 
+void Isotherm::addValues(const double *pressures, double *loadings, size_t n) const
+{
+  const double p0 = parameters[0];
+  const double p1 = numberOfParameters > 1 ? parameters[1] : 0.0;
+  const double p2 = numberOfParameters > 2 ? parameters[2] : 0.0;
+
+  switch (type)
+  {
+    case Isotherm::Type::Langmuir:
+    {
+      for (size_t i = 0; i < n; ++i)
+      {
+        double temp = p1 * pressures[i];
+        loadings[i] += p0 * temp / (1.0 + temp);
+      }
+      break;
+    }
+    case Isotherm::Type::Anti_Langmuir:
+    {
+      for (size_t i = 0; i < n; ++i)
+      {
+        loadings[i] += p0 * pressures[i] / (1.0 - p1 * pressures[i]);
+      }
+      break;
+    }
+    case Isotherm::Type::BET:
+    {
+      for (size_t i = 0; i < n; ++i)
+      {
+        loadings[i] += p0 * p1 * pressures[i] / ((1.0 - p2 * pressures[i]) * (1.0 - p2 + p1 * pressures[i]));
+      }
+      break;
+    }
+    case Isotherm::Type::Henry:
+    {
+      for (size_t i = 0; i < n; ++i)
+      {
+        loadings[i] += p0 * pressures[i];
+      }
+      break;
+    }
+    case Isotherm::Type::Freundlich:
+    {
+      const double exponent = 1.0 / p1;
+      for (size_t i = 0; i < n; ++i)
+      {
+        loadings[i] += p0 * std::pow(pressures[i], exponent);
+      }
+      break;
+    }
+    case Isotherm::Type::Sips:
+    {
+      const double exponent = 1.0 / p2;
+      for (size_t i = 0; i < n; ++i)
+      {
+        double temp = std::pow(p1 * pressures[i], exponent);
+        loadings[i] += p0 * temp / (1.0 + temp);
+      }
+      break;
+    }
+    case Isotherm::Type::Langmuir_Freundlich:
+    {
+      for (size_t i = 0; i < n; ++i)
+      {
+        double temp = p1 * std::pow(pressures[i], p2);
+        loadings[i] += p0 * temp / (1.0 + temp);
+      }
+      break;
+    }
+    case Isotherm::Type::Redlich_Peterson:
+    {
+      for (size_t i = 0; i < n; ++i)
+      {
+        loadings[i] += p0 * pressures[i] / (1.0 + p1 * std::pow(pressures[i], p2));
+      }
+      break;
+    }
+    case Isotherm::Type::Toth:
+    {
+      const double exponent = 1.0 / p2;
+      for (size_t i = 0; i < n; ++i)
+      {
+        double temp = p1 * pressures[i];
+        loadings[i] += p0 * temp / std::pow(1.0 + std::pow(temp, p2), exponent);
+      }
+      break;
+    }
+    case Isotherm::Type::Unilan:
+    {
+      const double factor1 = p1 * std::exp(p2);
+      const double factor2 = p1 * std::exp(-p2);
+      const double prefactor = p0 * (0.5 / p2);
+      for (size_t i = 0; i < n; ++i)
+      {
+        loadings[i] += prefactor * std::log((1.0 + factor1 * pressures[i]) / (1.0 + factor2 * pressures[i]));
+      }
+      break;
+    }
+    case Isotherm::Type::OBrien_Myers:
+    {
+      const double sigma2 = p2 * p2;
+      for (size_t i = 0; i < n; ++i)
+      {
+        double temp1 = p1 * pressures[i];
+        double temp2 = 1.0 + temp1;
+        loadings[i] += p0 * (temp1 / temp2 + sigma2 * temp1 * (1.0 - temp1) / (temp2 * temp2 * temp2));
+      }
+      break;
+    }
+    case Isotherm::Type::Quadratic:
+    {
+      for (size_t i = 0; i < n; ++i)
+      {
+        double temp1 = p1 * pressures[i];
+        double temp2 = p2 * pressures[i] * pressures[i];
+        loadings[i] += p0 * (temp1 + 2.0 * temp2) / (1.0 + temp1 + temp2);
+      }
+      break;
+    }
+    case Isotherm::Type::Temkin:
+    {
+      for (size_t i = 0; i < n; ++i)
+      {
+        double temp = p1 * pressures[i];
+        double temp1 = temp / (1.0 + temp);
+        loadings[i] += p0 * (temp1 + p2 * temp1 * temp1 * (temp1 - 1.0));
+      }
+      break;
+    }
+    case Isotherm::Type::BingelWalton:
+    {
+      const double rate = p1 + p2;
+      const double ratio = p2 / p1;
+      for (size_t i = 0; i < n; ++i)
+      {
+        double temp = std::exp(-rate * pressures[i]);
+        loadings[i] += p0 * (1.0 - temp) / (1.0 + ratio * temp);
+      }
+      break;
+    }
+    default:
+      throw std::runtime_error("Error: unknown isotherm type");
+  }
+}
+
 void Isotherm::randomize(double maximumLoading)
 {
+  // draw all deviates in one batch, so that the parameters do not depend on the evaluation order of the operands
+  std::array<double, 4> u;
+  RandomNumber::Uniform(u.data(), u.size());
+
   switch (type)
   {
     case Isotherm::Type::Langmuir:
     {
-      parameters[0] = 1.1 * maximumLoading * RandomNumber::Uniform();
-      parameters[1] = std::pow(RandomNumber::Uniform(), 10.0 * 2.0 * (RandomNumber::Uniform() - 1.0));
+      parameters[0] = 1.1 * maximumLoading * u[0];
+      parameters[1] = std::pow(u[1], 10.0 * 2.0 * (u[2] - 1.0));
       break;
     }
     case Isotherm::Type::Anti_Langmuir:
     {
-      parameters[0] = 1.1 * maximumLoading * RandomNumber::Uniform();
-      parameters[1] = std::pow(RandomNumber::Uniform(), 10.0 * 2.0 * (RandomNumber::Uniform() - 1.0));
+      parameters[0] = 1.1 * maximumLoading * u[0];
+      parameters[1] = std::pow(u[1], 10.0 * 2.0 * (u[2] - 1.0));
       break;
     }
     case Isotherm::Type::BET:
     {
-      parameters[0] = 10.0 * RandomNumber::Uniform();
-      parameters[1] = 10.0 * RandomNumber::Uniform();
-      parameters[2] = 10.0 * RandomNumber::Uniform();
+      parameters[0] = 10.0 * u[0];
+      parameters[1] = 10.0 * u[1];
+      parameters[2] = 10.0 * u[2];
       break;
     }
     case Isotherm::Type::Henry:
     {
-      parameters[0] = std::pow(RandomNumber::Uniform(), 10.0 * 2.0 * (RandomNumber::Uniform() - 1.0));
+      parameters[0] = std::pow(u[0], 10.0 * 2.0 * (u[1] - 1.0));
       break;
     }
     case Isotherm::Type::Freundlich:
     {
-      parameters[0] = std::pow(RandomNumber::Uniform(), 10.0 * 2.0 * (RandomNumber::Uniform() - 1.0));
-      parameters[1] = 0.1 + 2.0 * RandomNumber::Uniform();
+      parameters[0] = std::pow(u[0], 10.0 * 2.0 * (u[1] - 1.0));
+      parameters[1] = 0.1 + 2.0 * u[2];
       break;
     }
     case Isotherm::Type::Sips:
     {
-      parameters[0] = 1.1 * maximumLoading * RandomNumber::Uniform();
-      parameters[1] = std::pow(RandomNumber::Uniform(), 10.0 * 2.0 * (RandomNumber::Uniform() - 1.0));
-      parameters[2] = 0.1 + 2.0 * RandomNumber::Uniform();
+      parameters[0] = 1.1 * maximumLoading * u[0];
+      parameters[1] = std::pow(u[1], 10.0 * 2.0 * (u[2] - 1.0));
+      parameters[2] = 0.1 + 2.0 * u[3];
       break;
     }
     case Isotherm::Type::Langmuir_Freundlich:
     {
-      parameters[0] = 1.1 * maximumLoading * RandomNumber::Uniform();
-      parameters[1] = std::pow(RandomNumber::Uniform(), 10.0 * 2.0 * (RandomNumber::Uniform() - 1.0));
-      parameters[2] = 0.1 + 2.0 * RandomNumber::Uniform();
+      parameters[0] = 1.1 * maximumLoading * u[0];
+      parameters[1] = std::pow(u[1], 10.0 * 2.0 * (u[2] - 1.0));
+      parameters[2] = 0.1 + 2.0 * u[3];
       break;
     }
     case Isotherm::Type::Redlich_Peterson:
     {
-      parameters[0] = 1.1 * maximumLoading * RandomNumber::Uniform();
-      parameters[1] = std::pow(RandomNumber::Uniform(), 10.0 * 2.0 * (RandomNumber::Uniform() - 1.0));
-      parameters[2] = 0.1 + 2.0 * RandomNumber::Uniform();
+      parameters[0] = 1.1 * maximumLoading * u[0];
+      parameters[1] = std::pow(u[1], 10.0 * 2.0 * (u[2] - 1.0));
+      parameters[2] = 0.1 + 2.0 * u[3];
       break;
     }
     case Isotherm::Type::Toth:
     {
-      parameters[0] = 1.1 * maximumLoading * RandomNumber::Uniform();
-      parameters[1] = std::pow(RandomNumber::Uniform(), 10.0 * 2.0 * (RandomNumber::Uniform() - 1.0));
-      parameters[2] = 0.1 + 2.0 * RandomNumber::Uniform();
+      parameters[0] = 1.1 * maximumLoading * u[0];
+      parameters[1] = std::pow(u[1], 10.0 * 2.0 * (u[2] - 1.0));
+      parameters[2] = 0.1 + 2.0 * u[3];
       break;
     }
     case Isotherm::Type::Unilan:
     {
-      parameters[0] = 1.1 * maximumLoading * RandomNumber::Uniform();
-      parameters[1] = std::pow(RandomNumber::Uniform(), 10.0 * 2.0 * (RandomNumber::Uniform() - 1.0));
-      parameters[2] = 0.1 + 2.0 * RandomNumber::Uniform();
+      parameters[0] = 1.1 * maximumLoading * u[0];
+      parameters[1] = std::pow(u[1], 10.0 * 2.0 * (u[2] - 1.0));
+      parameters[2] = 0.1 + 2.0 * u[3];
       break;
     }
     case Isotherm::Type::OBrien_Myers:
     {
-      parameters[0] = 1.1 * maximumLoading * RandomNumber::Uniform();
-      parameters[1] = std::pow(RandomNumber::Uniform(), 10.0 * 2.0 * (RandomNumber::Uniform() - 1.0));
-      parameters[2] = 0.1 + 2.0 * RandomNumber::Uniform();
+      parameters[0] = 1.1 * maximumLoading * u[0];
+      parameters[1] = std::pow(u[1], 10.0 * 2.0 * (u[2] - 1.0));
+      parameters[2] = 0.1 + 2.0 * u[3];
       break;
     }
     case Isotherm::Type::Quadratic:
     {
-      parameters[0] = 2.1 * maximumLoading * RandomNumber::Uniform();
-      parameters[1] = 10.0 * RandomNumber::Uniform();
-      parameters[2] = 10.0 * RandomNumber::Uniform();
+      parameters[0] = 2.1 * maximumLoading * u[0];
+      parameters[1] = 10.0 * u[1];
+      parameters[2] = 10.0 * u[2];
       break;
     }
     case Isotherm::Type::Temkin:
     {
-      parameters[0] = 1.1 * maximumLoading * RandomNumber::Uniform();
-      parameters[1] = std::pow(RandomNumber::Uniform(), 10.0 * 2.0 * (RandomNumber::Uniform() - 1.0));
-      parameters[2] = 0.1 + 2.0 * RandomNumber::Uniform();
+      parameters[0] = 1.1 * maximumLoading * u[0];
+      parameters[1] = std::pow(u[1], 10.0 * 2.0 * (u[2] - 1.0));
+      parameters[2] = 0.1 + 2.0 * u[3];
       break;
     }
     case Isotherm::Type::BingelWalton:
     {
-      parameters[0] = 1.1 * maximumLoading * RandomNumber::Uniform();
-      parameters[1] = 0.1 + 2.0 * RandomNumber::Uniform();
-      parameters[2] = 0.1 + 2.0 * RandomNumber::Uniform();
+      parameters[0] = 1.1 * maximumLoading * u[0];
+      parameters[1] = 0.1 + 2.0 * u[1];
+      parameters[2] = 0.1 + 2.0 * u[2];
       break;
     }
     default:
@@ -185,6 +185,18 @@ struct Isotherm
     }
   }
 
+  /**
+   * \brief Adds the isotherm values at a batch of pressures.
+   *
+   * Computes loadings[i] += value(pressures[i]) for all i, with the switch on the isotherm type and the
+   * pressure-independent factors taken out of the loop over the pressures.
+   *
+   * \param pressures The pressures at which to evaluate the isotherm.
+   * \param loadings The loadings to which the isotherm values are added.
+   * \param n The number of pressures.
+   */
+  void addValues(const double *pressures, double *loadings, size_t n) const;
+
   /**
    * \brief Computes the reduced grand potential (spreading pressure) at a given pressure.
    *
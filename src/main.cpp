@@ -31,8 +31,13 @@ int main(void)
 				// Measure the time the simulation takes to run
 				const auto before = std::chrono::high_resolution_clock::now();
 
-				// run the simulation with the implicit solver
-				breakthrough.run( true );
+				// run the simulation with the implicit solver (or the explicit scheme with 'Integrator Explicit'), as a
+				// single breakthrough or as repeated cycles
+				const bool implicit = !reader.explicitIntegrator;
+				if (reader.cycleSteps.empty())
+					breakthrough.run( implicit );
+				else
+					breakthrough.runCycles( implicit );
 
 				const auto diff = std::chrono::high_resolution_clock::now() - before;
 				const auto millis = (int)std::chrono::duration_cast<std::chrono::milliseconds>(diff).count();
@@ -0,0 +1,100 @@
+#include "mapped_file.h"
+
+#include <stdexcept>
+
+#if defined(WIN32) || defined(_WIN32) || defined(__WIN32__) || defined(__NT__)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#if defined(WIN32) || defined(_WIN32) || defined(__WIN32__) || defined(__NT__)
+MappedFile::MappedFile(const std::string &fileName, bool sequential)
+{
+  // shared for writing, so that the output of a run that is still in progress can be read
+  HANDLE file = CreateFileA(fileName.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE, nullptr, OPEN_EXISTING,
+                            sequential ? FILE_FLAG_SEQUENTIAL_SCAN : FILE_FLAG_RANDOM_ACCESS, nullptr);
+  if (file == INVALID_HANDLE_VALUE) throw std::runtime_error("File '" + fileName + "' exists, but error opening file");
+
+  LARGE_INTEGER fileSize;
+  if (!GetFileSizeEx(file, &fileSize))
+  {
+    CloseHandle(file);
+    throw std::runtime_error("Error: could not determine the size of file '" + fileName + "'");
+  }
+  length = static_cast<size_t>(fileSize.QuadPart);
+
+  // mapping an empty file is not allowed, and not needed
+  if (length > 0)
+  {
+    HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    void *address = mapping != nullptr ? MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0) : nullptr;
+    if (mapping != nullptr) CloseHandle(mapping);
+    if (address == nullptr)
+    {
+      CloseHandle(file);
+      throw std::runtime_error("Error: could not memory-map file '" + fileName + "'");
+    }
+    begin = static_cast<const char *>(address);
+  }
+
+  // the view stays valid after closing the mapping and file handles
+  CloseHandle(file);
+}
+
+MappedFile::~MappedFile()
+{
+  if (begin != nullptr)
+  {
+    UnmapViewOfFile(begin);
+  }
+}
+#else
+MappedFile::MappedFile(const std::string &fileName, bool sequential)
+{
+  int fd = open(fileName.c_str(), O_RDONLY);
+  if (fd < 0) throw std::runtime_error("File '" + fileName + "' exists, but error opening file");
+
+  struct stat status;
+  if (fstat(fd, &status) != 0)
+  {
+    close(fd);
+    throw std::runtime_error("Error: could not determine the size of file '" + fileName + "'");
+  }
+  length = static_cast<size_t>(status.st_size);
+
+  // mapping an empty file is not allowed, and not needed
+  if (length > 0)
+  {
+    void *address = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (address == MAP_FAILED)
+    {
+      close(fd);
+      throw std::runtime_error("Error: could not memory-map file '" + fileName + "'");
+    }
+    // read-ahead pays off when the file is read front to back
+    madvise(address, length, sequential ? MADV_SEQUENTIAL : MADV_NORMAL);
+    begin = static_cast<const char *>(address);
+  }
+
+  // the mapping stays valid after closing the file descriptor
+  close(fd);
+}
+
+MappedFile::~MappedFile()
+{
+  if (begin != nullptr)
+  {
+    munmap(const_cast<char *>(begin), length);
+  }
+}
+#endif
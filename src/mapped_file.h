@@ -0,0 +1,33 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+/**
+ * \brief Read-only view of the complete contents of a file.
+ *
+ * The file is memory-mapped (mmap on POSIX systems, a file mapping on Windows), so large data files are not copied
+ * and pages are loaded on demand. The mapping covers the size of the file when it was opened.
+ */
+class MappedFile
+{
+ public:
+  /**
+   * \brief Maps the given file into memory.
+   *
+   * \param fileName The name of the file.
+   * \param sequential Whether the file is read front to back (otherwise it is accessed at random).
+   */
+  explicit MappedFile(const std::string &fileName, bool sequential = true);
+  ~MappedFile();
+
+  MappedFile(const MappedFile &) = delete;
+  MappedFile &operator=(const MappedFile &) = delete;
+
+  const char *data() const { return begin; }  ///< Pointer to the first byte of the file.
+  size_t size() const { return length; }      ///< Size of the file in bytes.
+
+ private:
+  const char *begin{nullptr};
+  size_t length{0};
+};
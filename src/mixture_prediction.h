@@ -1,5 +1,6 @@
 #pragma once
 
+#include <memory>
 #include <tuple>
 #include <vector>
 
@@ -12,6 +13,42 @@ namespace py = pybind11;
 #include "component.h"
 #include "inputreader.h"
 
+/**
+ * \brief Immutable isotherm data of the components of a mixture, shared by all copies of a MixturePrediction.
+ *
+ * The components are stored once and the solver orders refer to them by index. The Langmuir sites used by the
+ * explicit predictions (EI, SEI) are packed into one contiguous block in the order of the solver. A store is never
+ * modified: new parameters give a new store, so copies of a MixturePrediction (one per column, scenario or Python
+ * object) share it and own only their workspaces.
+ */
+struct IsothermStore
+{
+  /// Saturation loading and affinity of a Langmuir site, with the id of its component and its index in there.
+  struct LangmuirSite
+  {
+    double saturation;
+    double affinity;
+    size_t id;
+    size_t site;
+  };
+
+  std::vector<Component> components;        ///< The components, in input order.
+  std::vector<size_t> sorted;               ///< Indices of the components in the order of the IAST and EI solvers.
+  std::vector<LangmuirSite> langmuirSites;  ///< Explicit-isotherm sites, [level * Ncomp + i] in the solver order.
+};
+
+/**
+ * \brief Isotherm accessor of the mixture prediction kernels that evaluates the isotherms as given.
+ *
+ * The kernels take the isotherm of a component and the Langmuir sites of the explicit methods through an accessor, so
+ * a model that adjusts the isotherms (e.g. to the temperature at a grid point) reuses them with its own accessor.
+ */
+struct PlainIsotherms
+{
+  const MultiSiteIsotherm &isotherm(const Component &component) const { return component.isotherm; }
+  const IsothermStore::LangmuirSite &langmuirSite(const IsothermStore::LangmuirSite &site) const { return site; }
+};
+
 /**
  * \brief Class for predicting mixture adsorption isotherms.
  *
@@ -189,10 +226,28 @@ class MixturePrediction
   std::pair<size_t, size_t> predictMixture(const std::vector<double> &Yi, const double &P, std::vector<double> &Xi,
                                            std::vector<double> &Ni, double *cachedP0, double *cachedPsi);
 
+  /**
+   * \brief Predicts the mixture adsorption isotherm for isotherms provided by an accessor.
+   *
+   * Same as the function above, with the isotherms of the components and the Langmuir sites evaluated through
+   * 'isotherms' (see PlainIsotherms). Defined in mixture_prediction_kernels.h.
+   *
+   * \param isotherms The isotherm accessor.
+   * \param Yi The gas phase mole fractions.
+   * \param P The total pressure.
+   * \param Xi The adsorbed phase mole fractions (output).
+   * \param Ni The number of adsorbed molecules of each component (output).
+   * \param cachedP0 An array to cache intermediate pressure calculations.
+   * \param cachedPsi An array to cache intermediate psi calculations.
+   * \return A pair containing the number of IAST steps and a status code.
+   */
+  template <typename Isotherms>
+  std::pair<size_t, size_t> predictMixture(const Isotherms &isotherms, const std::vector<double> &Yi, const double &P,
+                                           std::vector<double> &Xi, std::vector<double> &Ni, double *cachedP0,
+                                           double *cachedPsi);
+
  private:
   std::string displayName;                  ///< The display name for the simulation.
-  std::vector<Component> components;        ///< The vector of components in the mixture.
-  std::vector<Component> sortedComponents;  ///< Components sorted according to specific criteria.
   const size_t Ncomp;                       ///< The total number of components.
   const size_t Nsorted;                     ///< The number of sorted components.
   size_t numberOfCarrierGases;              ///< The number of carrier gases in the mixture.
@@ -200,8 +255,13 @@ class MixturePrediction
   PredictionMethod predictionMethod;        ///< The method used for predicting mixture adsorption isotherms.
   IASTMethod iastMethod;                    ///< The method used for solving IAST equations.
   size_t maxIsothermTerms;                  ///< The maximum number of isotherm terms.
-  std::vector<std::vector<Component>>
-      segregatedSortedComponents;  ///< Segregated and sorted components for SIAST/SEI methods.
+  std::shared_ptr<const IsothermStore> store;  ///< The shared isotherm data of the components.
+
+  /// The components of the mixture, in input order.
+  const std::vector<Component> &components() const { return store->components; }
+
+  /// The i-th component in the order of the IAST and EI solvers.
+  const Component &sortedComponent(size_t i) const { return store->components[store->sorted[i]]; }
 
   std::vector<double> alpha1;      ///< Intermediate calculation vector for explicit isotherms.
   std::vector<double> alpha2;      ///< Intermediate calculation vector for explicit isotherms.
@@ -240,15 +300,20 @@ class MixturePrediction
   std::vector<double> initPressures();
 
   /**
-   * \brief Sorts the components based on specific criteria.
+   * \brief Creates the shared isotherm data of the components.
+   *
+   * Orders the components for the prediction method (carrier gas last, and by saturation loading for the explicit
+   * methods) and packs the Langmuir sites of the explicit methods.
    *
-   * Sorts the components to optimize calculations in prediction methods.
+   * \param components The components of the mixture, in input order.
+   * \return The new, immutable store.
    */
-  void sortComponents();
+  std::shared_ptr<const IsothermStore> createStore(std::vector<Component> components) const;
 
   /**
    * \brief Computes mixture prediction using Fast IAST method.
    *
+   * \param isotherms The isotherm accessor.
    * \param Yi The gas phase mole fractions.
    * \param P The total pressure.
    * \param Xi The adsorbed phase mole fractions (output).
@@ -257,12 +322,15 @@ class MixturePrediction
    * \param cachedPsi An array to cache intermediate psi calculations.
    * \return A pair containing the number of IAST steps and a status code.
    */
-  std::pair<size_t, size_t> computeFastIAST(const std::vector<double> &Yi, const double &P, std::vector<double> &Xi,
-                                            std::vector<double> &Ni, double *cachedP0, double *cachedPsi);
+  template <typename Isotherms>
+  std::pair<size_t, size_t> computeFastIAST(const Isotherms &isotherms, const std::vector<double> &Yi, const double &P,
+                                            std::vector<double> &Xi, std::vector<double> &Ni, double *cachedP0,
+                                            double *cachedPsi);
 
   /**
    * \brief Computes mixture prediction using Fast SIAST method.
    *
+   * \param isotherms The isotherm accessor.
    * \param Yi The gas phase mole fractions.
    * \param P The total pressure.
    * \param Xi The adsorbed phase mole fractions (output).
@@ -271,12 +339,15 @@ class MixturePrediction
    * \param cachedPsi An array to cache intermediate psi calculations.
    * \return A pair containing the number of IAST steps and a status code.
    */
-  std::pair<size_t, size_t> computeFastSIAST(const std::vector<double> &Yi, const double &P, std::vector<double> &Xi,
-                                             std::vector<double> &Ni, double *cachedP0, double *cachedPsi);
+  template <typename Isotherms>
+  std::pair<size_t, size_t> computeFastSIAST(const Isotherms &isotherms, const std::vector<double> &Yi, const double &P,
+                                             std::vector<double> &Xi, std::vector<double> &Ni, double *cachedP0,
+                                             double *cachedPsi);
 
   /**
    * \brief Computes mixture prediction for a specific term using Fast SIAST method.
    *
+   * \param isotherms The isotherm accessor.
    * \param term The index of the isotherm term.
    * \param Yi The gas phase mole fractions.
    * \param P The total pressure.
@@ -286,13 +357,15 @@ class MixturePrediction
    * \param cachedPsi An array to cache intermediate psi calculations.
    * \return A pair containing the number of IAST steps and a status code.
    */
-  std::pair<size_t, size_t> computeFastSIAST(size_t term, const std::vector<double> &Yi, const double &P,
-                                             std::vector<double> &Xi, std::vector<double> &Ni, double *cachedP0,
-                                             double *cachedPsi);
+  template <typename Isotherms>
+  std::pair<size_t, size_t> computeFastSIAST(const Isotherms &isotherms, size_t term, const std::vector<double> &Yi,
+                                             const double &P, std::vector<double> &Xi, std::vector<double> &Ni,
+                                             double *cachedP0, double *cachedPsi);
 
   /**
    * \brief Computes mixture prediction using IAST with nested loop bisection method.
    *
+   * \param isotherms The isotherm accessor.
    * \param Yi The gas phase mole fractions.
    * \param P The total pressure.
    * \param Xi The adsorbed phase mole fractions (output).
@@ -301,13 +374,16 @@ class MixturePrediction
    * \param cachedPsi An array to cache intermediate psi calculations.
    * \return A pair containing the number of IAST steps and a status code.
    */
-  std::pair<size_t, size_t> computeIASTNestedLoopBisection(const std::vector<double> &Yi, const double &P,
-                                                           std::vector<double> &Xi, std::vector<double> &Ni,
-                                                           double *cachedP0, double *cachedPsi);
+  template <typename Isotherms>
+  std::pair<size_t, size_t> computeIASTNestedLoopBisection(const Isotherms &isotherms, const std::vector<double> &Yi,
+                                                           const double &P, std::vector<double> &Xi,
+                                                           std::vector<double> &Ni, double *cachedP0,
+                                                           double *cachedPsi);
 
   /**
    * \brief Computes mixture prediction using SIAST with nested loop bisection method.
    *
+   * \param isotherms The isotherm accessor.
    * \param Yi The gas phase mole fractions.
    * \param P The total pressure.
    * \param Xi The adsorbed phase mole fractions (output).
@@ -316,13 +392,16 @@ class MixturePrediction
    * \param cachedPsi An array to cache intermediate psi calculations.
    * \return A pair containing the number of IAST steps and a status code.
    */
-  std::pair<size_t, size_t> computeSIASTNestedLoopBisection(const std::vector<double> &Yi, const double &P,
-                                                            std::vector<double> &Xi, std::vector<double> &Ni,
-                                                            double *cachedP0, double *cachedPsi);
+  template <typename Isotherms>
+  std::pair<size_t, size_t> computeSIASTNestedLoopBisection(const Isotherms &isotherms, const std::vector<double> &Yi,
+                                                            const double &P, std::vector<double> &Xi,
+                                                            std::vector<double> &Ni, double *cachedP0,
+                                                            double *cachedPsi);
 
   /**
    * \brief Computes mixture prediction for a specific term using SIAST with nested loop bisection method.
    *
+   * \param isotherms The isotherm accessor.
    * \param term The index of the isotherm term.
    * \param Yi The gas phase mole fractions.
    * \param P The total pressure.
@@ -332,37 +411,45 @@ class MixturePrediction
    * \param cachedPsi An array to cache intermediate psi calculations.
    * \return A pair containing the number of IAST steps and a status code.
    */
-  std::pair<size_t, size_t> computeSIASTNestedLoopBisection(size_t term, const std::vector<double> &Yi, const double &P,
+  template <typename Isotherms>
+  std::pair<size_t, size_t> computeSIASTNestedLoopBisection(const Isotherms &isotherms, size_t term,
+                                                            const std::vector<double> &Yi, const double &P,
                                                             std::vector<double> &Xi, std::vector<double> &Ni,
                                                             double *cachedP0, double *cachedPsi);
 
   /**
    * \brief Computes mixture prediction using explicit isotherm model.
    *
+   * \param isotherms The isotherm accessor.
    * \param Yi The gas phase mole fractions.
    * \param P The total pressure.
    * \param Xi The adsorbed phase mole fractions (output).
    * \param Ni The number of adsorbed molecules of each component (output).
    * \return A pair containing the number of steps and a status code.
    */
-  std::pair<size_t, size_t> computeExplicitIsotherm(const std::vector<double> &Yi, const double &P,
-                                                    std::vector<double> &Xi, std::vector<double> &Ni);
+  template <typename Isotherms>
+  std::pair<size_t, size_t> computeExplicitIsotherm(const Isotherms &isotherms, const std::vector<double> &Yi,
+                                                    const double &P, std::vector<double> &Xi, std::vector<double> &Ni);
 
   /**
    * \brief Computes mixture prediction using segregated explicit isotherm model.
    *
+   * \param isotherms The isotherm accessor.
    * \param Yi The gas phase mole fractions.
    * \param P The total pressure.
    * \param Xi The adsorbed phase mole fractions (output).
    * \param Ni The number of adsorbed molecules of each component (output).
    * \return A pair containing the number of steps and a status code.
    */
-  std::pair<size_t, size_t> computeSegratedExplicitIsotherm(const std::vector<double> &Yi, const double &P,
-                                                            std::vector<double> &Xi, std::vector<double> &Ni);
+  template <typename Isotherms>
+  std::pair<size_t, size_t> computeSegratedExplicitIsotherm(const Isotherms &isotherms, const std::vector<double> &Yi,
+                                                            const double &P, std::vector<double> &Xi,
+                                                            std::vector<double> &Ni);
 
   /**
    * \brief Computes mixture prediction for a specific term using segregated explicit isotherm model.
    *
+   * \param isotherms The isotherm accessor.
    * \param site The index of the isotherm site.
    * \param Yi The gas phase mole fractions.
    * \param P The total pressure.
@@ -370,7 +457,9 @@ class MixturePrediction
    * \param Ni The number of adsorbed molecules of each component (output).
    * \return A pair containing the number of steps and a status code.
    */
-  std::pair<size_t, size_t> computeSegratedExplicitIsotherm(size_t site, const std::vector<double> &Yi, const double &P,
+  template <typename Isotherms>
+  std::pair<size_t, size_t> computeSegratedExplicitIsotherm(const Isotherms &isotherms, size_t site,
+                                                            const std::vector<double> &Yi, const double &P,
                                                             std::vector<double> &Xi, std::vector<double> &Ni);
 
   /**
@@ -378,11 +467,14 @@ class MixturePrediction
    *
    * Outputs the current state of variables when an error occurs in IAST calculations.
    *
+   * \param isotherms The isotherm accessor.
    * \param psi The current psi value.
    * \param sum The current sum of mole fractions.
    * \param P The total pressure.
    * \param Yi The gas phase mole fractions.
    * \param cachedP0 An array of cached pressure values.
    */
-  void printErrorStatus(double psi, double sum, double P, const std::vector<double> Yi, double cachedP0[]);
+  template <typename Isotherms>
+  void printErrorStatus(const Isotherms &isotherms, double psi, double sum, double P, const std::vector<double> Yi,
+                        double cachedP0[]);
 };
@@ -0,0 +1,987 @@
+#pragma once
+
+// The mixture prediction kernels, templates over the isotherms they evaluate. 'PlainIsotherms' evaluates the
+// isotherms of the components as given; an accessor that adjusts them (for instance to the temperature at a grid
+// point) provides the same 'isotherm' and 'langmuirSite' functions. Included by the translation units that
+// instantiate 'MixturePrediction::predictMixture'.
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <limits>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "mixture_prediction.h"
+
+// allow std::pairs to be added
+template <typename T, typename U>
+std::pair<T, U> operator+(const std::pair<T, U> &l, const std::pair<T, U> &r)
+{
+  return {l.first + r.first, l.second + r.second};
+}
+template <typename T, typename U>
+std::pair<T, U> &operator+=(std::pair<T, U> &l, const std::pair<T, U> &r)
+{
+  l.first += r.first;
+  l.second += r.second;
+  return l;
+}
+
+template <typename Isotherms>
+std::pair<size_t, size_t> MixturePrediction::predictMixture(const Isotherms &isotherms, const std::vector<double> &Yi,
+                                                            const double &P, std::vector<double> &Xi,
+                                                            std::vector<double> &Ni, double *cachedP0,
+                                                            double *cachedPsi)
+{
+  const double tiny = 1.0e-10;
+
+  if (P < 0.0)
+  {
+    printErrorStatus(isotherms, 0.0, 0.0, P, Yi, cachedP0);
+    throw std::runtime_error("Error (IAST): negative total pressure\n");
+  }
+
+  double sumYi = 0.0;
+  for (size_t i = 0; i < Ncomp; ++i)
+  {
+    sumYi += Yi[i];
+  }
+  if (std::abs(sumYi - 1.0) > 1e-15)
+  {
+    printErrorStatus(isotherms, 0.0, sumYi, P, Yi, cachedP0);
+    throw std::runtime_error("Error (IAST): sum Yi at IAST start not unity\n");
+  }
+
+  // if only an inert component present
+  // this happens at the beginning of the simulation when the whole column is filled with the carrier gas
+  if (std::abs(Yi[carrierGasComponent] - 1.0) < tiny)
+  {
+    for (size_t i = 0; i < Ncomp; ++i)
+    {
+      Xi[i] = 0.0;
+      Ni[i] = 0.0;
+    }
+
+    // do not count it for the IAST statistics
+    return std::make_pair(0, 0);
+  }
+
+  switch (predictionMethod)
+  {
+    case PredictionMethod::IAST:
+    default:
+      switch (iastMethod)
+      {
+        case IASTMethod::FastIAST:
+        default:
+          return computeFastIAST(isotherms, Yi, P, Xi, Ni, cachedP0, cachedPsi);
+        case IASTMethod::NestedLoopBisection:
+          return computeIASTNestedLoopBisection(isotherms, Yi, P, Xi, Ni, cachedP0, cachedPsi);
+      }
+    case PredictionMethod::SIAST:
+      switch (iastMethod)
+      {
+        case IASTMethod::FastIAST:
+        default:
+          return computeFastSIAST(isotherms, Yi, P, Xi, Ni, cachedP0, cachedPsi);
+        case IASTMethod::NestedLoopBisection:
+          return computeSIASTNestedLoopBisection(isotherms, Yi, P, Xi, Ni, cachedP0, cachedPsi);
+      }
+    case PredictionMethod::EI:
+      return computeExplicitIsotherm(isotherms, Yi, P, Xi, Ni);
+    case PredictionMethod::SEI:
+      return computeSegratedExplicitIsotherm(isotherms, Yi, P, Xi, Ni);
+  }
+}
+
+// Yi  = gas phase molefraction
+// P   = total pressure
+// Xi  = adsorbed phase molefraction
+// Ni  = number of adsorbed molecules of component i
+template <typename Isotherms>
+std::pair<size_t, size_t> MixturePrediction::computeFastIAST(const Isotherms &isotherms, const std::vector<double> &Yi,
+                                                             const double &P, std::vector<double> &Xi,
+                                                             std::vector<double> &Ni, double *cachedP0,
+                                                             double *cachedPsi)
+{
+  const double tiny = 1.0e-13;
+
+  size_t numberOfIASTSteps = 0;
+
+  std::fill(pstar.begin(), pstar.end(), 0.0);
+  std::fill(G.begin(), G.end(), 0.0);
+  std::fill(delta.begin(), delta.end(), 0.0);
+  std::fill(Phi.begin(), Phi.end(), 0.0);
+
+  if (cachedPsi[0] > 0.0)
+  {
+    for (size_t i = 0; i < Nsorted; ++i)
+    {
+      pstar[i] = cachedP0[sortedComponent(i).id];
+    }
+  }
+  else
+  {
+    double initial_psi = 0.0;
+    for (size_t i = 0; i < Nsorted; ++i)
+    {
+      double temp_psi = Yi[sortedComponent(i).id] * isotherms.isotherm(sortedComponent(i)).psiForPressure(P);
+      initial_psi += temp_psi;
+    }
+    cachedPsi[0] = initial_psi;
+
+    double cachevalue = 0.0;
+    for (size_t i = 0; i < Nsorted; ++i)
+    {
+      pstar[i] = 1.0 / isotherms.isotherm(sortedComponent(i)).inversePressureForPsi(initial_psi, cachevalue);
+    }
+  }
+
+  double error = 1.0;
+  double sum_xi = 0.0;
+  do
+  {
+    // compute G
+    for (size_t i = 0; i < Nsorted - 1; ++i)
+    {
+      G[i] = isotherms.isotherm(sortedComponent(i)).psiForPressure(pstar[i]) -
+             isotherms.isotherm(sortedComponent(Nsorted - 1)).psiForPressure(pstar[Nsorted - 1]);
+    }
+
+    G[Nsorted - 1] = 0.0;
+    for (size_t i = 0; i < Nsorted; i++)
+    {
+      G[Nsorted - 1] += Yi[sortedComponent(i).id] * P / pstar[i];
+    }
+    G[Nsorted - 1] -= 1.0;
+
+    // compute Jacobian matrix Phi
+    for (size_t i = 0; i < Nsorted - 1; i++)
+    {
+      Phi[i + i * Nsorted] = isotherms.isotherm(sortedComponent(i)).value(pstar[i]) / pstar[i];
+    }
+    for (size_t i = 0; i < Nsorted - 1; i++)
+    {
+      Phi[i + (Nsorted - 1) * Nsorted] =
+          -isotherms.isotherm(sortedComponent(Nsorted - 1)).value(pstar[Nsorted - 1]) / pstar[Nsorted - 1];
+    }
+    for (size_t i = 0; i < Nsorted; i++)
+    {
+      Phi[(Nsorted - 1) + i * Nsorted] = -Yi[sortedComponent(i).id] * P / (pstar[i] * pstar[i]);
+    }
+
+    // corrections
+    for (size_t i = 0; i < Nsorted - 1; i++)
+    {
+      Phi[(Nsorted - 1) + (Nsorted - 1) * Nsorted] -=
+          Phi[(Nsorted - 1) + i * Nsorted] * Phi[i + (Nsorted - 1) * Nsorted] / Phi[i + i * Nsorted];
+      G[Nsorted - 1] -= Phi[(Nsorted - 1) + i * Nsorted] * G[i] / Phi[i + i * Nsorted];
+    }
+
+    // compute delta
+    delta[Nsorted - 1] = G[Nsorted - 1] / Phi[(Nsorted - 1) + (Nsorted - 1) * Nsorted];
+
+    // trick to loop downward from Nsorted - 2 to and including zero (still using size_t as index)
+    for (size_t i = Nsorted - 1; i-- != 0;)
+    {
+      delta[i] = (G[i] - delta[Nsorted - 1] * Phi[i + (Nsorted - 1) * Nsorted]) / Phi[i + i * Nsorted];
+    }
+
+    // update pstar
+    for (size_t i = 0; i < Nsorted; i++)
+    {
+      double newvalue = pstar[i] - delta[i];
+      if (newvalue > 0.0)
+        pstar[i] = newvalue;
+      else
+      {
+        pstar[i] = 0.5 * pstar[i];
+      }
+    }
+
+    // compute error in psi's
+    for (size_t i = 0; i < Nsorted; i++)
+    {
+      psi[i] = isotherms.isotherm(sortedComponent(i)).psiForPressure(pstar[i]);
+    }
+
+    sum_xi = 0.0;
+    for (size_t i = 0; i < Nsorted; ++i)
+    {
+      sum_xi += Yi[sortedComponent(i).id] * P / std::max(pstar[i], 1e-15);
+    }
+
+    double avg = std::accumulate(std::begin(psi), std::end(psi), 0.0) / static_cast<double>(psi.size());
+
+    double accum = 0.0;
+    std::for_each(std::begin(psi), std::end(psi), [&](const double d) { accum += (d - avg) * (d - avg); });
+
+    error = std::sqrt(accum / static_cast<double>(psi.size() - 1));
+
+    numberOfIASTSteps++;
+  } while (!(((error < tiny) && (std::fabs(sum_xi - 1.0) < 1e-10)) || (numberOfIASTSteps >= 50)));
+
+  for (size_t i = 0; i < Nsorted; ++i)
+  {
+    cachedP0[sortedComponent(i).id] = pstar[i];
+  }
+
+  for (size_t i = 0; i < Nsorted; ++i)
+  {
+    Xi[sortedComponent(i).id] = Yi[sortedComponent(i).id] * P / std::max(pstar[i], 1e-15);
+  }
+  if (numberOfCarrierGases > 0)
+  {
+    Xi[carrierGasComponent] = 0.0;
+  }
+
+  double sum = 0.0;
+  for (size_t i = 0; i < Ncomp; ++i)
+  {
+    sum += Xi[i];
+  }
+  for (size_t i = 0; i < Ncomp; ++i)
+  {
+    Xi[i] /= sum;
+  }
+
+  double inverse_q_total = 0.0;
+  for (size_t i = 0; i < Nsorted; ++i)
+  {
+    inverse_q_total += Xi[sortedComponent(i).id] / isotherms.isotherm(sortedComponent(i)).value(pstar[i]);
+  }
+  for (size_t i = 0; i < Ncomp; ++i)
+  {
+    Ni[i] = Xi[i] / inverse_q_total;
+  }
+  if (numberOfCarrierGases > 0)
+  {
+    Ni[carrierGasComponent] = 0.0;
+  }
+
+  return std::make_pair(numberOfIASTSteps, 1);
+}
+
+// Yi  = gas phase molefraction
+// P   = total pressure
+// Xi  = adsorbed phase molefraction
+// Ni  = number of adsorbed molecules of component i
+template <typename Isotherms>
+std::pair<size_t, size_t> MixturePrediction::computeFastSIAST(const Isotherms &isotherms, const std::vector<double> &Yi,
+                                                              const double &P, std::vector<double> &Xi,
+                                                              std::vector<double> &Ni, double *cachedP0,
+                                                              double *cachedPsi)
+{
+  std::fill(Xi.begin(), Xi.end(), 0.0);
+  std::fill(Ni.begin(), Ni.end(), 0.0);
+
+  std::pair<size_t, size_t> acc;
+  for (size_t i = 0; i < maxIsothermTerms; ++i)
+  {
+    acc += computeFastSIAST(isotherms, i, Yi, P, Xi, Ni, cachedP0, cachedPsi);
+  }
+
+  double N = 0.0;
+  for (size_t i = 0; i < Ncomp; ++i)
+  {
+    N += Ni[i];
+  }
+  for (size_t i = 0; i < Ncomp; ++i)
+  {
+    Xi[i] = Ni[i] / N;
+  }
+
+  return acc;
+}
+
+// computes IAST per term
+// Yi  = gas phase molefraction
+// P   = total pressure
+// Xi  = adsorbed phase molefraction
+// Ni  = number of adsorbed molecules of component i
+template <typename Isotherms>
+std::pair<size_t, size_t> MixturePrediction::computeFastSIAST(const Isotherms &isotherms, size_t site,
+                                                              const std::vector<double> &Yi, const double &P,
+                                                              std::vector<double> &Xi, std::vector<double> &Ni,
+                                                              double *cachedP0, double *cachedPsi)
+{
+  const double tiny = 1.0e-13;
+
+  size_t numberOfIASTSteps = 0;
+
+  std::fill(pstar.begin(), pstar.end(), 0.0);
+  std::fill(G.begin(), G.end(), 0.0);
+  std::fill(delta.begin(), delta.end(), 0.0);
+  std::fill(Phi.begin(), Phi.end(), 0.0);
+
+  if (cachedPsi[site] > tiny)
+  {
+    for (size_t i = 0; i < Nsorted; ++i)
+    {
+      pstar[i] = cachedP0[sortedComponent(i).id + site * Ncomp];
+    }
+  }
+  else
+  {
+    double initial_psi = 0.0;
+    for (size_t i = 0; i < Nsorted; ++i)
+    {
+      double temp_psi = Yi[sortedComponent(i).id] * isotherms.isotherm(sortedComponent(i)).psiForPressure(site, P);
+      initial_psi += temp_psi;
+    }
+    cachedPsi[site] = initial_psi;
+
+    double cachevalue = 0.0;
+    for (size_t i = 0; i < Nsorted; ++i)
+    {
+      pstar[i] = 1.0 / isotherms.isotherm(sortedComponent(i)).inversePressureForPsi(site, initial_psi, cachevalue);
+    }
+  }
+
+  double error = 1.0;
+  double sum_xi = 1.0;
+  do
+  {
+    // compute G
+    for (size_t i = 0; i < Nsorted - 1; ++i)
+    {
+      G[i] = isotherms.isotherm(sortedComponent(i)).psiForPressure(site, pstar[i]) -
+             isotherms.isotherm(sortedComponent(Nsorted - 1)).psiForPressure(site, pstar[Nsorted - 1]);
+    }
+
+    G[Nsorted - 1] = 0.0;
+    for (size_t i = 0; i < Nsorted; i++)
+    {
+      G[Nsorted - 1] += Yi[sortedComponent(i).id] * P / pstar[i];
+    }
+    G[Nsorted - 1] -= 1.0;
+
+    // compute Jacobian matrix Phi
+    for (size_t i = 0; i < Nsorted - 1; i++)
+    {
+      Phi[i + i * Nsorted] = isotherms.isotherm(sortedComponent(i)).value(site, pstar[i]) / pstar[i];
+    }
+    for (size_t i = 0; i < Nsorted - 1; i++)
+    {
+      Phi[i + (Nsorted - 1) * Nsorted] =
+          -isotherms.isotherm(sortedComponent(Nsorted - 1)).value(site, pstar[Nsorted - 1]) / pstar[Nsorted - 1];
+    }
+    for (size_t i = 0; i < Nsorted; i++)
+    {
+      Phi[(Nsorted - 1) + i * Nsorted] = -Yi[sortedComponent(i).id] * P / (pstar[i] * pstar[i]);
+    }
+
+    // corrections
+    for (size_t i = 0; i < Nsorted - 1; i++)
+    {
+      Phi[(Nsorted - 1) + (Nsorted - 1) * Nsorted] -=
+          Phi[(Nsorted - 1) + i * Nsorted] * Phi[i + (Nsorted - 1) * Nsorted] / Phi[i + i * Nsorted];
+      G[Nsorted - 1] -= Phi[(Nsorted - 1) + i * Nsorted] * G[i] / Phi[i + i * Nsorted];
+    }
+
+    // compute delta
+    delta[Nsorted - 1] = G[Nsorted - 1] / Phi[(Nsorted - 1) + (Nsorted - 1) * Nsorted];
+
+    // trick to loop downward from Nsorted - 2 to and including zero (still using size_t as index)
+    for (size_t i = Nsorted - 1; i-- != 0;)
+    {
+      delta[i] = (G[i] - delta[Nsorted - 1] * Phi[i + (Nsorted - 1) * Nsorted]) / Phi[i + i * Nsorted];
+    }
+
+    // update pstar
+    for (size_t i = 0; i < Nsorted; i++)
+    {
+      double newvalue = pstar[i] - delta[i];
+      if (newvalue > 0.0)
+        pstar[i] = newvalue;
+      else
+      {
+        pstar[i] = 0.5 * pstar[i];
+      }
+    }
+
+    // compute error in psi's
+    for (size_t i = 0; i < Nsorted; i++)
+    {
+      psi[i] = isotherms.isotherm(sortedComponent(i)).psiForPressure(site, pstar[i]);
+    }
+
+    sum_xi = 0.0;
+    for (size_t i = 0; i < Nsorted; ++i)
+    {
+      sum_xi += Yi[sortedComponent(i).id] * P / std::max(pstar[i], 1e-15);
+    }
+
+    double avg = std::accumulate(std::begin(psi), std::end(psi), 0.0) / static_cast<double>(psi.size());
+
+    double accum = 0.0;
+    std::for_each(std::begin(psi), std::end(psi), [&](const double d) { accum += (d - avg) * (d - avg); });
+
+    error = std::sqrt(accum / static_cast<double>(psi.size() - 1));
+
+    numberOfIASTSteps++;
+  } while (!(((error < tiny) && (std::fabs(sum_xi - 1.0) < 1e-10)) || (numberOfIASTSteps >= 50)));
+
+  for (size_t i = 0; i < Nsorted; ++i)
+  {
+    cachedP0[sortedComponent(i).id + site * Ncomp] = pstar[i];
+  }
+
+  for (size_t i = 0; i < Nsorted; ++i)
+  {
+    Xi[sortedComponent(i).id] = Yi[sortedComponent(i).id] * P / std::max(pstar[i], 1e-15);
+  }
+  if (numberOfCarrierGases > 0)
+  {
+    Xi[carrierGasComponent] = 0.0;
+  }
+
+  double sum = 0.0;
+  for (size_t i = 0; i < Ncomp; ++i)
+  {
+    sum += Xi[i];
+  }
+  for (size_t i = 0; i < Ncomp; ++i)
+  {
+    Xi[i] /= sum;
+  }
+
+  double inverse_q_total = 0.0;
+  for (size_t i = 0; i < Nsorted; ++i)
+  {
+    inverse_q_total += Xi[sortedComponent(i).id] / isotherms.isotherm(sortedComponent(i)).value(site, pstar[i]);
+  }
+  for (size_t i = 0; i < Ncomp; ++i)
+  {
+    Ni[i] += Xi[i] / inverse_q_total;
+  }
+  if (numberOfCarrierGases > 0)
+  {
+    Ni[carrierGasComponent] = 0.0;
+  }
+
+  return std::make_pair(numberOfIASTSteps, 1);
+}
+
+// Yi  = gas phase molefraction
+// P   = total pressure
+// Xi  = adsorbed phase molefraction
+// Ni  = number of adsorbed molecules of component i
+template <typename Isotherms>
+std::pair<size_t, size_t> MixturePrediction::computeIASTNestedLoopBisection(const Isotherms &isotherms,
+                                                                            const std::vector<double> &Yi,
+                                                                            const double &P, std::vector<double> &Xi,
+                                                                            std::vector<double> &Ni, double *cachedP0,
+                                                                            double *cachedPsi)
+{
+  const double tiny = 1.0e-15;
+
+  double initial_psi = 0.0;
+  for (size_t i = 0; i < Ncomp; ++i)
+  {
+    initial_psi += Yi[i] * isotherms.isotherm(components()[i]).psiForPressure(P);
+  }
+
+  if (initial_psi < tiny)
+  {
+    // nothing is adsorbing
+    for (size_t i = 0; i < Ncomp; ++i)
+    {
+      Xi[i] = 0.0;
+      Ni[i] = 0.0;
+    }
+
+    // do not count it for the IAST statistics
+    return std::make_pair(0, 0);
+  }
+
+  // condition 1: same reduced grand potential for all components (done by using a single variable)
+  // condition 2: mol-fractions add up to unity
+
+  double psi_value = 0.0;
+  size_t nr_steps = 0;
+  if (cachedPsi[0] > tiny)
+  {
+    initial_psi = cachedPsi[0];
+  }
+  // for this initial estimate 'initial_psi' compute the sum of mol-fractions
+  double sumXi = 0.0;
+  for (size_t i = 0; i < Ncomp; ++i)
+  {
+    sumXi += Yi[i] * P * isotherms.isotherm(components()[i]).inversePressureForPsi(initial_psi, cachedP0[i]);
+  }
+
+  // initialize the bisection algorithm
+  double left_bracket = initial_psi;
+  double right_bracket = initial_psi;
+  if (sumXi > 1.0)
+  {
+    do
+    {
+      right_bracket *= 2.0;
+
+      sumXi = 0.0;
+      for (size_t i = 0; i < Ncomp; ++i)
+      {
+        sumXi += Yi[i] * P * isotherms.isotherm(components()[i]).inversePressureForPsi(right_bracket, cachedP0[i]);
+      }
+      ++nr_steps;
+      if (nr_steps > 100000)
+      {
+        std::cout << "Left bracket: " << left_bracket << std::endl;
+        std::cout << "Right bracket: " << right_bracket << std::endl;
+        printErrorStatus(isotherms, 0.0, sumXi, P, Yi, cachedP0);
+        throw std::runtime_error("Error (IAST bisection): initial bracketing (for sum > 1) does NOT converge\n");
+      }
+    } while (sumXi > 1.0);
+  }
+  else
+  {
+    // Make an initial estimate for the reduced grandpotential when the
+    // sum of the molefractions is larger than 1
+    do
+    {
+      left_bracket *= 0.5;
+
+      sumXi = 0.0;
+      for (size_t i = 0; i < Ncomp; ++i)
+      {
+        sumXi += Yi[i] * P * isotherms.isotherm(components()[i]).inversePressureForPsi(left_bracket, cachedP0[i]);
+      }
+      ++nr_steps;
+      if (nr_steps > 100000)
+      {
+        std::cout << "Left bracket: " << left_bracket << std::endl;
+        std::cout << "Right bracket: " << right_bracket << std::endl;
+        printErrorStatus(isotherms, 0.0, sumXi, P, Yi, cachedP0);
+        throw std::runtime_error("Error (IAST bisection): initial bracketing (for sum < 1) does NOT converge\n");
+      }
+    } while (sumXi < 1.0);
+  }
+
+  // bisection algorithm
+  size_t numberOfIASTSteps = 0;
+  do
+  {
+    psi_value = 0.5 * (left_bracket + right_bracket);
+
+    sumXi = 0.0;
+    for (size_t i = 0; i < Ncomp; ++i)
+    {
+      sumXi += Yi[i] * P * isotherms.isotherm(components()[i]).inversePressureForPsi(psi_value, cachedP0[i]);
+    }
+
+    if (sumXi > 1.0)
+    {
+      left_bracket = psi_value;
+    }
+    else
+    {
+      right_bracket = psi_value;
+    }
+
+    ++numberOfIASTSteps;
+    if (numberOfIASTSteps > 100000)
+    {
+      throw std::runtime_error("Error (IAST bisection): NO convergence\n");
+    }
+  } while (std::abs(left_bracket - right_bracket) / std::abs(left_bracket + right_bracket) > tiny);  // convergence test
+
+  psi_value = 0.5 * (left_bracket + right_bracket);
+
+  sumXi = 0.0;
+  for (size_t i = 0; i < Ncomp; ++i)
+  {
+    sumXi += Yi[i] * P * isotherms.isotherm(components()[i]).inversePressureForPsi(psi_value, cachedP0[i]);
+  }
+
+  // cache the value of psi for subsequent use
+  cachedPsi[0] = psi_value;
+
+  // calculate mol-fractions in adsorbed phase and total loading
+  double inverse_q_total = 0.0;
+  for (size_t i = 0; i < Ncomp; ++i)
+  {
+    double ip = isotherms.isotherm(components()[i]).inversePressureForPsi(psi_value, cachedP0[i]);
+    Xi[i] = Yi[i] * P * ip / sumXi;
+
+    if (Xi[i] > tiny)
+    {
+      inverse_q_total += Xi[i] / isotherms.isotherm(components()[i]).value(1.0 / ip);
+    }
+    else
+    {
+      Xi[i] = 0.0;
+    }
+  }
+
+  // calculate loading for all of the components
+  if (inverse_q_total == 0.0)
+  {
+    for (size_t i = 0; i < Ncomp; ++i)
+    {
+      Ni[i] = 0.0;
+    }
+  }
+  else
+  {
+    for (size_t i = 0; i < Ncomp; ++i)
+    {
+      Ni[i] = Xi[i] / inverse_q_total;
+    }
+  }
+
+  return std::make_pair(numberOfIASTSteps, 1);
+}
+
+// Yi  = gas phase molefraction
+// P   = total pressure
+// Xi  = adsorbed phase molefraction
+// Ni  = number of adsorbed molecules of component i
+template <typename Isotherms>
+std::pair<size_t, size_t> MixturePrediction::computeSIASTNestedLoopBisection(const Isotherms &isotherms,
+                                                                             const std::vector<double> &Yi,
+                                                                             const double &P, std::vector<double> &Xi,
+                                                                             std::vector<double> &Ni, double *cachedP0,
+                                                                             double *cachedPsi)
+{
+  std::fill(Xi.begin(), Xi.end(), 0.0);
+  std::fill(Ni.begin(), Ni.end(), 0.0);
+
+  std::pair<size_t, size_t> acc;
+  for (size_t i = 0; i < maxIsothermTerms; ++i)
+  {
+    acc += computeSIASTNestedLoopBisection(isotherms, i, Yi, P, Xi, Ni, cachedP0, cachedPsi);
+  }
+
+  double N = 0.0;
+  for (size_t i = 0; i < Ncomp; ++i)
+  {
+    N += Ni[i];
+  }
+  for (size_t i = 0; i < Ncomp; ++i)
+  {
+    Xi[i] = Ni[i] / N;
+  }
+
+  return acc;
+}
+
+// computes IAST per term
+// Yi  = gas phase molefraction
+// P   = total pressure
+// Xi  = adsorbed phase molefraction
+// Ni  = number of adsorbed molecules of component i
+template <typename Isotherms>
+std::pair<size_t, size_t> MixturePrediction::computeSIASTNestedLoopBisection(const Isotherms &isotherms, size_t site,
+                                                                             const std::vector<double> &Yi,
+                                                                             const double &P, std::vector<double> &Xi,
+                                                                             std::vector<double> &Ni, double *cachedP0,
+                                                                             double *cachedPsi)
+{
+  const double tiny = 1.0e-15;
+
+  double initial_psi = 0.0;
+  for (size_t i = 0; i < Ncomp; ++i)
+  {
+    initial_psi += Yi[i] * isotherms.isotherm(components()[i]).psiForPressure(site, P);
+  }
+
+  if (initial_psi < tiny)
+  {
+    // nothing is adsorbing
+    // do not count it for the IAST statistics
+    return std::make_pair(0, 0);
+  }
+
+  // condition 1: same reduced grand potential for all components (done by using a single variable)
+  // condition 2: mol-fractions add up to unity
+
+  double psi_value = 0.0;
+  size_t nr_steps = 0;
+  if (cachedPsi[site] > tiny)
+  {
+    initial_psi = cachedPsi[site];
+  }
+  // for this initial estimate 'initial_psi' compute the sum of mol-fractions
+  double sumXi = 0.0;
+  for (size_t i = 0; i < Ncomp; ++i)
+  {
+    sumXi += Yi[i] * P *
+             isotherms.isotherm(components()[i]).inversePressureForPsi(site, initial_psi, cachedP0[i + Ncomp * site]);
+  }
+
+  // initialize the bisection algorithm
+  double left_bracket = initial_psi;
+  double right_bracket = initial_psi;
+  if (sumXi > 1.0)
+  {
+    do
+    {
+      right_bracket *= 2.0;
+
+      sumXi = 0.0;
+      for (size_t i = 0; i < Ncomp; ++i)
+      {
+        sumXi += Yi[i] * P * isotherms.isotherm(components()[i]).inversePressureForPsi(site, right_bracket,
+                                                                                     cachedP0[i + Ncomp * site]);
+      }
+      ++nr_steps;
+      if (nr_steps > 100000)
+      {
+        std::cout << "Left bracket: " << left_bracket << std::endl;
+        std::cout << "Right bracket: " << right_bracket << std::endl;
+        printErrorStatus(isotherms, 0.0, sumXi, P, Yi, cachedP0);
+        throw std::runtime_error("Error (IAST bisection): initial bracketing (for sum > 1) does NOT converge\n");
+      }
+    } while (sumXi > 1.0);
+  }
+  else
+  {
+    // Make an initial estimate for the reduced grandpotential when the
+    // sum of the molefractions is larger than 1
+    do
+    {
+      left_bracket *= 0.5;
+
+      sumXi = 0.0;
+      for (size_t i = 0; i < Ncomp; ++i)
+      {
+        sumXi += Yi[i] * P * isotherms.isotherm(components()[i]).inversePressureForPsi(site, left_bracket,
+                                                                                     cachedP0[i + Ncomp * site]);
+      }
+      ++nr_steps;
+      if (nr_steps > 100000)
+      {
+        std::cout << "Left bracket: " << left_bracket << std::endl;
+        std::cout << "Right bracket: " << right_bracket << std::endl;
+        printErrorStatus(isotherms, 0.0, sumXi, P, Yi, cachedP0);
+        throw std::runtime_error("Error (IAST bisection): initial bracketing (for sum < 1) does NOT converge\n");
+      }
+    } while (sumXi < 1.0);
+  }
+
+  // bisection algorithm
+  size_t numberOfIASTSteps = 0;
+  do
+  {
+    psi_value = 0.5 * (left_bracket + right_bracket);
+
+    sumXi = 0.0;
+    for (size_t i = 0; i < Ncomp; ++i)
+    {
+      sumXi += Yi[i] * P *
+               isotherms.isotherm(components()[i]).inversePressureForPsi(site, psi_value, cachedP0[i + Ncomp * site]);
+    }
+
+    if (sumXi > 1.0)
+    {
+      left_bracket = psi_value;
+    }
+    else
+    {
+      right_bracket = psi_value;
+    }
+
+    ++numberOfIASTSteps;
+    if (numberOfIASTSteps > 100000)
+    {
+      throw std::runtime_error("Error (IAST bisection): NO convergence\n");
+    }
+  } while (std::abs(left_bracket - right_bracket) / std::abs(left_bracket + right_bracket) > tiny);  // convergence test
+
+  psi_value = 0.5 * (left_bracket + right_bracket);
+
+  // cache the value of psi for subsequent use
+  cachedPsi[site] = psi_value;
+
+  // calculate mol-fractions in adsorbed phase and total loading
+  double inverse_q_total = 0.0;
+  for (size_t i = 0; i < Ncomp; ++i)
+  {
+    double ip = isotherms.isotherm(components()[i]).inversePressureForPsi(site, psi_value, cachedP0[i + Ncomp * site]);
+    Xi[i] = Yi[i] * P * ip;
+
+    if (Xi[i] > tiny)
+    {
+      inverse_q_total += Xi[i] / isotherms.isotherm(components()[i]).value(site, 1.0 / ip);
+    }
+  }
+
+  // calculate loading for all of the components
+  if (inverse_q_total > 0.0)
+  {
+    for (size_t i = 0; i < Ncomp; ++i)
+    {
+      Ni[i] += Xi[i] / inverse_q_total;
+    }
+  }
+
+  return std::make_pair(numberOfIASTSteps, 1);
+}
+
+// solve the mixed-langmuir equations derived by Assche et al.
+// T. R. Van Assche, G.V. Baron, and J. F. Denayer
+// An explicit multicomponent adsorption isotherm model:
+// Accounting for the size-effect for components with Langmuir adsorption behavior.
+// Adsorption, 24(6), 517-530 (2018)
+
+// An explicit multicomponent adsorption isotherm model: accounting for the
+// size-effect for components with Langmuir adsorption behavior
+
+// In the input file molecules must be added in the following order:
+// Largest molecule should be the first component or the component with
+// smallest saturation(Nimax) loading should be the first component
+// Last component is the carrier gas
+
+// At present, only single site isotherms are considered for pure components
+
+template <typename Isotherms>
+std::pair<size_t, size_t> MixturePrediction::computeExplicitIsotherm(const Isotherms &isotherms,
+                                                                     const std::vector<double> &Yi, const double &P,
+                                                                     std::vector<double> &Xi, std::vector<double> &Ni)
+{
+  const IsothermStore::LangmuirSite *sites = store->langmuirSites.data();
+  auto langmuir = [&](size_t i) { return isotherms.langmuirSite(sites[i]); };
+
+  x[0] = 1.0;
+  for (size_t i = 1; i < Ncomp; ++i)
+  {
+    x[i] = langmuir(i).saturation / langmuir(i - 1).saturation;
+  }
+
+  alpha1[Ncomp - 1] = std::pow((1.0 + langmuir(Ncomp - 1).affinity * Yi[langmuir(Ncomp - 1).id] * P), x[Ncomp - 1]);
+  alpha2[Ncomp - 1] = 1.0 + langmuir(Ncomp - 1).affinity * Yi[langmuir(Ncomp - 1).id] * P;
+  for (size_t i = Ncomp - 2; i > 0; i--)
+  {
+    alpha1[i] = std::pow((alpha1[i + 1] + langmuir(i).affinity * Yi[langmuir(i).id] * P), x[i]);
+    alpha2[i] = alpha1[i + 1] + langmuir(i).affinity * Yi[langmuir(i).id] * P;
+  }
+  alpha1[0] = alpha1[1] + langmuir(0).affinity * Yi[langmuir(0).id] * P;
+  alpha2[0] = alpha1[1] + langmuir(0).affinity * Yi[langmuir(0).id] * P;
+
+  double beta = alpha2[0];
+
+  alpha_prod[0] = 1.0;
+  for (size_t i = 1; i < Ncomp; ++i)
+  {
+    alpha_prod[i] = (alpha1[i] / alpha2[i]) * alpha_prod[i - 1];
+  }
+
+  for (size_t i = 0; i < Ncomp; ++i)
+  {
+    size_t index = langmuir(i).id;
+    Ni[index] = langmuir(i).saturation * langmuir(i).affinity * Yi[index] * P * alpha_prod[i] / beta;
+  }
+  double N = 0.0;
+  for (size_t i = 0; i < Ncomp; ++i)
+  {
+    N += Ni[i];
+  }
+  for (size_t i = 0; i < Ncomp; ++i)
+  {
+    Xi[i] = Ni[i] / N;
+  }
+
+  return std::make_pair(1, 1);
+}
+
+template <typename Isotherms>
+std::pair<size_t, size_t> MixturePrediction::computeSegratedExplicitIsotherm(const Isotherms &isotherms,
+                                                                             const std::vector<double> &Yi,
+                                                                             const double &P, std::vector<double> &Xi,
+                                                                             std::vector<double> &Ni)
+{
+  std::fill(Xi.begin(), Xi.end(), 0.0);
+  std::fill(Ni.begin(), Ni.end(), 0.0);
+
+  std::pair<size_t, size_t> acc;
+  for (size_t i = 0; i < maxIsothermTerms; ++i)
+  {
+    acc += computeSegratedExplicitIsotherm(isotherms, i, Yi, P, Xi, Ni);
+  }
+
+  double N = 0.0;
+  for (size_t i = 0; i < Ncomp; ++i)
+  {
+    N += Ni[i];
+  }
+  for (size_t i = 0; i < Ncomp; ++i)
+  {
+    Xi[i] = Ni[i] / N;
+  }
+
+  return acc;
+}
+
+template <typename Isotherms>
+std::pair<size_t, size_t> MixturePrediction::computeSegratedExplicitIsotherm(const Isotherms &isotherms, size_t site,
+                                                                             const std::vector<double> &Yi,
+                                                                             const double &P, std::vector<double> &Xi,
+                                                                             std::vector<double> &Ni)
+{
+  const IsothermStore::LangmuirSite *sites = &store->langmuirSites[site * Ncomp];
+  auto langmuir = [&](size_t i) { return isotherms.langmuirSite(sites[i]); };
+
+  x[0] = 1.0;
+  for (size_t i = 1; i < Ncomp; ++i)
+  {
+    x[i] = langmuir(i).saturation / langmuir(i - 1).saturation;
+  }
+
+  alpha1[Ncomp - 1] = std::pow((1.0 + langmuir(Ncomp - 1).affinity * Yi[langmuir(Ncomp - 1).id] * P), x[Ncomp - 1]);
+  alpha2[Ncomp - 1] = 1.0 + langmuir(Ncomp - 1).affinity * Yi[langmuir(Ncomp - 1).id] * P;
+  for (size_t i = Ncomp - 2; i > 0; i--)
+  {
+    alpha1[i] = std::pow((alpha1[i + 1] + langmuir(i).affinity * Yi[langmuir(i).id] * P), x[i]);
+    alpha2[i] = alpha1[i + 1] + langmuir(i).affinity * Yi[langmuir(i).id] * P;
+  }
+  alpha1[0] = alpha1[1] + langmuir(0).affinity * Yi[langmuir(0).id] * P;
+  alpha2[0] = alpha1[1] + langmuir(0).affinity * Yi[langmuir(0).id] * P;
+
+  double beta = alpha2[0];
+
+  alpha_prod[0] = 1.0;
+  for (size_t i = 1; i < Ncomp; ++i)
+  {
+    alpha_prod[i] = (alpha1[i] / alpha2[i]) * alpha_prod[i - 1];
+  }
+
+  for (size_t i = 0; i < Ncomp; ++i)
+  {
+    size_t index = langmuir(i).id;
+    Ni[index] += langmuir(i).saturation * langmuir(i).affinity * Yi[index] * P * alpha_prod[i] / beta;
+  }
+  double N = 0.0;
+  for (size_t i = 0; i < Ncomp; ++i)
+  {
+    N += Ni[i];
+  }
+  for (size_t i = 0; i < Ncomp; ++i)
+  {
+    Xi[i] = Ni[i] / N;
+  }
+
+  return std::make_pair(1, 1);
+}
+
+template <typename Isotherms>
+void MixturePrediction::printErrorStatus(const Isotherms &isotherms, double psi_value, double sum, double P,
+                                         const std::vector<double> Yi, double cachedP0[])
+{
+  std::cout << "psi: " << psi_value << std::endl;
+  std::cout << "sum: " << sum << std::endl;
+  for (size_t i = 0; i < Ncomp; ++i) std::cout << "cachedP0: " << cachedP0[i] << std::endl;
+  for (size_t i = 0; i < Ncomp; ++i)
+  {
+    double value = isotherms.isotherm(components()[i]).inversePressureForPsi(psi_value, cachedP0[i]);
+    std::cout << "inversePressure: " << value << std::endl;
+  }
+  std::cout << "P: " << P << std::endl;
+  for (size_t i = 0; i < Ncomp; ++i)
+  {
+    std::cout << "Yi[i] " << i << " " << Yi[i] << std::endl;
+  }
+}
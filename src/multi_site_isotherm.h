@@ -1,8 +1,11 @@
 #pragma once
 
+#include <algorithm>
 #include <array>
+#include <cmath>
 #include <cstddef>
 #include <iostream>
+#include <stdexcept>
 #include <string>
 #include <tuple>
 #include <vector>
@@ -119,7 +122,7 @@ struct MultiSiteIsotherm
    *
    * \return A vector containing all parameter values.
    */
-  std::vector<double> getParameters();
+  std::vector<double> getParameters() const;
 
   /**
    * \brief Computes the total adsorption value at a given pressure.
@@ -139,6 +142,24 @@ struct MultiSiteIsotherm
     return sum;
   }
 
+  /**
+   * \brief Computes the total adsorption values at a batch of pressures.
+   *
+   * Batched counterpart of value(double): each site is evaluated over all pressures in turn.
+   *
+   * \param pressures The pressures at which to evaluate the adsorption.
+   * \param loadings Receives the total adsorption values (at least n entries).
+   * \param n The number of pressures.
+   */
+  inline void values(const double *pressures, double *loadings, size_t n) const
+  {
+    std::fill(loadings, loadings + n, 0.0);
+    for (size_t i = 0; i < numberOfSites; ++i)
+    {
+      sites[i].addValues(pressures, loadings, n);
+    }
+  }
+
   /**
    * \brief Computes the adsorption value for a specific site at a given pressure.
    *
@@ -245,6 +266,114 @@ struct MultiSiteIsotherm
   std::string gnuplotFunctionString(char s) const;
 };
 
+/**
+ * \brief Computes the inverse pressure corresponding to a given reduced grand potential by bisection.
+ *
+ * Brackets the pressure from the cached starting point and bisects it to a relative precision of 1e-15. Shared by
+ * MultiSiteIsotherm::inversePressureForPsi and by isotherms adjusted outside of it, which pass their own reduced grand
+ * potential.
+ *
+ * \param psiForPressure Callable returning the reduced grand potential at a given pressure.
+ * \param reduced_grand_potential The target reduced grand potential.
+ * \param cachedP0 A reference to a cached pressure value for starting point optimization; receives the pressure found.
+ * \return The inverse of the pressure corresponding to the reduced grand potential.
+ */
+template <typename PsiForPressure>
+double inversePressureForPsiBisection(const PsiForPressure &psiForPressure, double reduced_grand_potential,
+                                      double &cachedP0)
+{
+  const double tiny = 1.0e-15;
+
+  double left_bracket;
+  double right_bracket;
+
+  // from here on, work with pressure, and return 1.0 / pressure at the end of the routine
+  double p_start;
+  if (cachedP0 <= 0.0)
+  {
+    p_start = 5.0;
+  }
+  else
+  {
+    // use the last value of Pi0
+    p_start = cachedP0;
+  }
+
+  // use bisection algorithm
+  double s = psiForPressure(p_start);
+
+  size_t nr_steps = 0;
+  left_bracket = p_start;
+  right_bracket = p_start;
+
+  if (s < reduced_grand_potential)
+  {
+    // find the bracket on the right
+    do
+    {
+      right_bracket *= 2.0;
+      s = psiForPressure(right_bracket);
+
+      ++nr_steps;
+      if (nr_steps > 100000)
+      {
+        std::cout << "reduced_grand_potential: " << reduced_grand_potential << std::endl;
+        std::cout << "psi: " << s << std::endl;
+        std::cout << "p_start: " << p_start << std::endl;
+        std::cout << "Left bracket: " << left_bracket << std::endl;
+        std::cout << "Right bracket: " << right_bracket << std::endl;
+        throw std::runtime_error("Error (Inverse bisection): initial bracketing (for sum < 1) does NOT converge\n");
+      }
+    } while (s < reduced_grand_potential);
+  }
+  else
+  {
+    // find the bracket on the left
+    do
+    {
+      left_bracket *= 0.5;
+      s = psiForPressure(left_bracket);
+
+      ++nr_steps;
+      if (nr_steps > 100000)
+      {
+        std::cout << "reduced_grand_potential: " << reduced_grand_potential << std::endl;
+        std::cout << "psi: " << s << std::endl;
+        std::cout << "p_start: " << p_start << std::endl;
+        std::cout << "Left bracket: " << left_bracket << std::endl;
+        std::cout << "Right bracket: " << right_bracket << std::endl;
+        throw std::runtime_error("Error (Inverse bisection): initial bracketing (for sum > 1) does NOT converge\n");
+      }
+    } while (s > reduced_grand_potential);
+  }
+
+  do
+  {
+    double middle = 0.5 * (left_bracket + right_bracket);
+    s = psiForPressure(middle);
+
+    if (s > reduced_grand_potential)
+      right_bracket = middle;
+    else
+      left_bracket = middle;
+
+    ++nr_steps;
+    if (nr_steps > 100000)
+    {
+      std::cout << "Left bracket: " << left_bracket << std::endl;
+      std::cout << "Right bracket: " << right_bracket << std::endl;
+      throw std::runtime_error("Error (Inverse bisection): initial bracketing (for sum < 1) does NOT converge\n");
+    }
+  } while (std::abs(left_bracket - right_bracket) / std::abs(left_bracket + right_bracket) > tiny);
+
+  double middle = 0.5 * (left_bracket + right_bracket);
+
+  //  Store the last value of Pi0
+  cachedP0 = middle;
+
+  return 1.0 / middle;
+}
+
 namespace std
 {
 template <>
@@ -1,41 +1,145 @@
 #pragma once
 
+#include <array>
+#include <atomic>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
 #include <random>
 
+/**
+ * \brief Counter-based random-number generator Philox4x32-10.
+ *
+ * Philox (Salmon et al., "Parallel random numbers: as easy as 1, 2, 3", SC'11) maps a 128-bit counter and a
+ * 64-bit key to 128 random bits through ten rounds of a multiply-and-xor bijection. There is no state other
+ * than the counter: any counter value can be generated directly, so independent streams follow from simply
+ * reserving parts of the counter for a stream identifier.
+ */
+struct Philox4x32
+{
+  using Counter = std::array<uint32_t, 4>;
+  using Key = std::array<uint32_t, 2>;
+
+  static Counter generate(Counter counter, Key key)
+  {
+    for (size_t round = 0; round < 10; ++round)
+    {
+      const uint64_t product0 = uint64_t{0xD2511F53} * counter[0];
+      const uint64_t product1 = uint64_t{0xCD9E8D57} * counter[2];
+      counter = {static_cast<uint32_t>(product1 >> 32) ^ counter[1] ^ key[0], static_cast<uint32_t>(product1),
+                 static_cast<uint32_t>(product0 >> 32) ^ counter[3] ^ key[1], static_cast<uint32_t>(product0)};
+      key[0] += 0x9E3779B9;
+      key[1] += 0xBB67AE85;
+    }
+    return counter;
+  }
+};
+
+/**
+ * \brief Random numbers drawn from per-thread Philox streams.
+ *
+ * A stream is identified by the seed and the tuple (citizen, generation, tag) set with selectStream; the
+ * numbers drawn after selecting a stream depend on nothing else, so a run with a fixed seed is reproducible
+ * irrespective of the order in which threads or citizens are processed. Threads that never select a stream
+ * draw from a stream of their own.
+ */
 class RandomNumber
 {
  public:
-  static double Uniform() { return getInstance().uniformDistribution_(getInstance().mt); }
-  static double Gaussian() { return getInstance().normalDistribution_(getInstance().mt); }
+  /// Sets the seed of all streams selected afterwards (0 draws a seed from std::random_device).
+  static void setSeed(uint64_t seed) { globalSeed().store(seed != 0 ? seed : std::random_device{}() | 1); }
+  static uint64_t seed() { return globalSeed().load(); }
+
+  /// Positions the generator of the calling thread at the start of the stream (seed, citizen, generation, tag).
+  static void selectStream(size_t citizen, size_t generation, size_t tag = 0)
+  {
+    getInstance().select(static_cast<uint32_t>(citizen), static_cast<uint32_t>(generation),
+                         static_cast<uint32_t>(tag));
+  }
+
+  static double Uniform() { return toUniform(UInt64()); }
+  static void Uniform(double *values, size_t n)
+  {
+    for (size_t i = 0; i < n; ++i)
+    {
+      values[i] = toUniform(UInt64());
+    }
+  }
+  static double Gaussian()
+  {
+    double value;
+    Gaussian(&value, 1);
+    return value;
+  }
+  // Box-Muller transform, two normal deviates per pair of uniform deviates
+  static void Gaussian(double *values, size_t n)
+  {
+    constexpr double twoPi = 6.283185307179586476925;
+    for (size_t i = 0; i < n; i += 2)
+    {
+      const double radius = std::sqrt(-2.0 * std::log(1.0 - toUniform(UInt64())));
+      const double angle = twoPi * toUniform(UInt64());
+      values[i] = radius * std::cos(angle);
+      if (i + 1 < n) values[i + 1] = radius * std::sin(angle);
+    }
+  }
   static size_t Integer(size_t i, size_t j)
   {
     return i + static_cast<size_t>(static_cast<double>(j + 1 - i) * Uniform());
   }
-  static uint64_t UInt64() { return getInstance().uniformUInt64Distribution_(getInstance().mt); }
+  static uint64_t UInt64() { return getInstance().next(); }
 
  private:
   RandomNumber()
   {
-    std::random_device rd;
-    mt = std::mt19937_64(rd());
-    // mt = std::mt19937_64(10);
-    uniformDistribution_ = std::uniform_real_distribution<double>(0.0, 1.0);
-    uniformUInt64Distribution_ = std::uniform_int_distribution<uint64_t>();
-    normalDistribution_ = std::normal_distribution<double>();
+    // default stream of a thread: a tag that is never used by selectStream callers
+    static std::atomic<uint32_t> threadCount{0};
+    select(threadCount.fetch_add(1), 0, 0xFFFFFFFF);
   }
   ~RandomNumber() {}
 
+  // one generator per thread, so that concurrently evolving islands do not share (and race on) the stream state
   static RandomNumber& getInstance()
   {
-    static RandomNumber s;
+    static thread_local RandomNumber s;
     return s;
   }
 
+  static std::atomic<uint64_t> &globalSeed()
+  {
+    static std::atomic<uint64_t> seed{std::random_device{}() | 1};
+    return seed;
+  }
+
+  // 53 random bits mapped to [0, 1)
+  static double toUniform(uint64_t bits) { return static_cast<double>(bits >> 11) * 0x1.0p-53; }
+
+  void select(uint32_t citizen, uint32_t generation, uint32_t tag)
+  {
+    const uint64_t s = seed();
+    key = {static_cast<uint32_t>(s), static_cast<uint32_t>(s >> 32)};
+    counter = {0, generation, citizen, tag};
+    position = 2;
+  }
+
+  uint64_t next()
+  {
+    if (position == 2)
+    {
+      const Philox4x32::Counter block = Philox4x32::generate(counter, key);
+      buffer[0] = (uint64_t{block[0]} << 32) | block[1];
+      buffer[1] = (uint64_t{block[2]} << 32) | block[3];
+      ++counter[0];
+      position = 0;
+    }
+    return buffer[position++];
+  }
+
   RandomNumber(RandomNumber const&) = delete;
   RandomNumber& operator=(RandomNumber const&) = delete;
 
-  std::mt19937_64 mt;
-  std::uniform_real_distribution<double> uniformDistribution_;
-  std::normal_distribution<double> normalDistribution_;
-  std::uniform_int_distribution<uint64_t> uniformUInt64Distribution_;
+  Philox4x32::Key key;
+  Philox4x32::Counter counter;
+  std::array<uint64_t, 2> buffer;
+  size_t position;
 };
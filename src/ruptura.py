@@ -174,6 +174,23 @@ class Fitting:
         evaluatedPoints = self._Fitting.evaluate(p)
         return evaluatedPoints
 
+    def evaluateParameterSets(self, component: int, parameters: np.ndarray, p: np.ndarray) -> np.ndarray:
+        """
+        Evaluates the isotherm model of a component for many parameter sets at once.
+
+        The evaluation runs in parallel in C++ without holding the GIL, which makes it suited
+        for outer-loop optimisation or sampling (e.g. Bayesian optimisation, MCMC).
+
+        Parameters:
+            component (int): Index of the component whose isotherm model is evaluated.
+            parameters (np.ndarray): Parameter sets, shape (M, number of isotherm parameters).
+            p (np.ndarray): Pressures, shape (N,).
+
+        Returns:
+            np.ndarray: Loadings, shape (M, N).
+        """
+        return self._Fitting.evaluateParameterSets(component, np.atleast_2d(parameters), np.asarray(p))
+
     def plot(self, ax, data, p, ixlabel, iylabel):
         """
         Plots the fitted data.
@@ -372,6 +389,8 @@ class Breakthrough:
         TimeStep: float = 5e-4,
         PulseTime: float = None,
         MixturePredictionMethod: Literal["IAST", "SIAST", "EI", "SEI"] = "IAST",
+        ExplicitTileSize: int = 0,
+        ExplicitTileSteps: int = 1,
     ):
         """
         Initializes the Breakthrough object.
@@ -393,11 +412,14 @@ class Breakthrough:
             TimeStep (float, optional): Time step for the prediction model. Defaults to 5e-4.
             PulseTime (float, optional): Pulse time for the prediction model. If it's None, there is no pulse. Defaults to None.
             MixturePredictionMethod (str): Method of prediction: 'IAST', 'SIAST', 'EI', 'SEI' (default is 'IAST').
+            ExplicitTileSize (int, optional): Grid points per tile of the cache-tiled explicit scheme, 0 for untiled. Defaults to 0.
+            ExplicitTileSteps (int, optional): Time steps advanced per sweep of the cache-tiled explicit scheme. Defaults to 1.
         """
 
         # set attributes
         self.components = components
         self.DisplayName = DisplayName
+        self.WriteEvery = WriteEvery
         self.data = None
         
         # determine number of timesteps and set autosteps flag
@@ -434,6 +456,8 @@ class Breakthrough:
             PulseTime,
             mix._MixturePrediction,
         )
+        if ExplicitTileSize > 0:
+            self._Breakthrough.setExplicitTiling(ExplicitTileSize, ExplicitTileSteps)
 
     def compute(self):
         """
@@ -445,6 +469,71 @@ class Breakthrough:
         self.data = self._Breakthrough.compute()
         return self.data
 
+    def snapshots(self, fields: list[str] = ["P", "Q", "V"], every: int = None):
+        """
+        Runs the breakthrough and yields a snapshot every `every` time steps, without storing the history.
+
+        Each snapshot is a dict with the time step 'step', the time 't' [s] and read-only views of the
+        requested fields: per-component fields ("P", "Q", "Qeq", "Dpdt", "Dqdt") have shape
+        (NumberOfGridPoints + 1, ncomp), "V" and "Pt" have shape (NumberOfGridPoints + 1,).
+        The views share memory with the solver and are overwritten when the next snapshot is computed;
+        copy them to keep them. Stopping the iteration stops the run.
+
+        Parameters:
+            fields (list[str], optional): The fields to include. Defaults to ["P", "Q", "V"].
+            every (int, optional): Number of time steps between snapshots. Defaults to WriteEvery.
+
+        Yields:
+            dict: The snapshot.
+        """
+        every = self.WriteEvery if every is None else every
+        while (snapshot := self._Breakthrough.advance(every, list(fields))) is not None:
+            yield snapshot
+
+    def stream(self, callback, fields: list[str] = ["P", "Q", "V"], every: int = None) -> int:
+        """
+        Runs the breakthrough and passes a snapshot to `callback` every `every` time steps (see `snapshots`).
+        The run stops early when the callback returns False.
+
+        Parameters:
+            callback (callable): Function called with each snapshot dict.
+            fields (list[str], optional): The fields to include. Defaults to ["P", "Q", "V"].
+            every (int, optional): Number of time steps between snapshots. Defaults to WriteEvery.
+
+        Returns:
+            int: The number of snapshots passed to the callback.
+        """
+        count = 0
+        for snapshot in self.snapshots(fields, every):
+            count += 1
+            if callback(snapshot) is False:
+                break
+        return count
+
+    def sweep(self, GasPhaseMolFractions: np.ndarray = None, MassTransferCoefficients: np.ndarray = None) -> np.ndarray:
+        """
+        Runs scenarios of this column that differ in the feed composition and/or the mass-transfer coefficients
+        together, with the explicit integrator and one shared time loop (the number of time steps and the
+        output interval are those of the column).
+
+        Parameters:
+            GasPhaseMolFractions (np.ndarray, optional): The feed mol-fractions with shape (scenarios, ncomp).
+                Defaults to those of the components.
+            MassTransferCoefficients (np.ndarray, optional): The mass-transfer coefficients [1/s] with shape
+                (scenarios, ncomp). Defaults to those of the components.
+
+        Returns:
+            np.ndarray: The outlet breakthrough curves with shape (scenarios, times, 2 + ncomp): the dimensionless
+            time, the time [min] and the normalized partial pressure of every component.
+        """
+        empty = np.empty((0, 0))
+        batch = _ruptura.BreakthroughBatch(
+            self._Breakthrough,
+            empty if GasPhaseMolFractions is None else np.asarray(GasPhaseMolFractions, dtype=float),
+            empty if MassTransferCoefficients is None else np.asarray(MassTransferCoefficients, dtype=float),
+        )
+        return batch.compute()
+
     def plot(self, ax, plot_type: Literal["breakthrough", "Dpdt", "Dqdt", "P", "Pnorm", "Pt", "Q", "Qeq", "V"]):
         """
         Plots the data for the breakthrough model. If data has not yet been computed, raises a ValueError.
@@ -483,3 +572,58 @@ class Breakthrough:
 
         ax.legend()
         ax.set_title(f"{self.DisplayName} ({plot_type})")
+
+
+class Snapshots:
+    """
+    Random access to the column profiles written by a breakthrough run with 'ColumnOutputFormat Float32'
+    ('column.f32') or 'ColumnOutputFormat Compressed' ('column.f32z'). The file is memory-mapped and only the
+    accessed snapshots are read, so runs that do not fit in memory can be post-processed.
+
+    Attributes:
+        columns (list[str]): The column names, e.g. "z", "V", "component 1 Q" (from the '<file>.txt' layout).
+        shape (tuple): The number of snapshots, rows (grid points) and columns.
+    """
+
+    def __init__(self, file_path: str = "column.f32"):
+        """
+        Opens the snapshot file.
+
+        Parameters:
+            file_path (str, optional): The 'column.f32' or 'column.f32z' file. Defaults to "column.f32".
+        """
+        self._SnapshotReader = _ruptura.SnapshotReader(file_path)
+        self.columns = list(self._SnapshotReader.columnNames())
+        self.shape = (self._SnapshotReader.frames(), self._SnapshotReader.rows(), self._SnapshotReader.columns())
+
+    def __len__(self) -> int:
+        return self.shape[0]
+
+    def __getitem__(self, k: int) -> np.ndarray:
+        """
+        Snapshot k with shape (rows, columns); a read-only view into the file for 'column.f32'.
+        """
+        if k < 0:
+            k += len(self)
+        if not 0 <= k < len(self):
+            raise IndexError(f"snapshot {k} out of range")
+        return self._SnapshotReader.snapshot(k)
+
+    def column(self, k: int, column: Union[str, int]) -> np.ndarray:
+        """
+        The values of a column (name or index) of snapshot k along the column, with shape (rows,).
+        """
+        return self._SnapshotReader.column(k, str(column))
+
+    def timeSeries(self, row: int, column: Union[str, int]) -> np.ndarray:
+        """
+        The values of a column (name or index) at grid point `row` for all snapshots, with shape (snapshots,).
+        """
+        return self._SnapshotReader.timeSeries(row, str(column))
+
+    def array(self) -> np.ndarray:
+        """
+        All snapshots as a read-only (snapshots, rows, columns) view into 'column.f32' (not available for
+        compressed files).
+        """
+        return self._SnapshotReader.array()
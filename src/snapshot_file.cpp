@@ -0,0 +1,535 @@
+#include "snapshot_file.h"
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <stdexcept>
+
+namespace
+{
+// probabilities of a zero bit, in units of 2^-11
+constexpr size_t probabilityBits = 11;
+constexpr size_t adaptationShift = 5;
+
+void reset(SnapshotCodec::Model &model)
+{
+  for (auto &probabilities : model.probabilities) probabilities.fill(uint16_t{1} << (probabilityBits - 1));
+}
+
+// binary range coder of the LZMA family: 32-bit range, carries propagated through a cached byte
+class RangeEncoder
+{
+ public:
+  explicit RangeEncoder(std::vector<uint8_t> &out_) : out(out_) {}
+
+  void encode(uint16_t &probability, uint32_t bit)
+  {
+    const uint32_t bound = (range >> probabilityBits) * probability;
+    if (bit == 0)
+    {
+      range = bound;
+      probability = static_cast<uint16_t>(probability + (((1u << probabilityBits) - probability) >> adaptationShift));
+    }
+    else
+    {
+      low += bound;
+      range -= bound;
+      probability = static_cast<uint16_t>(probability - (probability >> adaptationShift));
+    }
+    while (range < (1u << 24))
+    {
+      range <<= 8;
+      shiftLow();
+    }
+  }
+
+  void flush()
+  {
+    for (size_t i = 0; i < 5; ++i) shiftLow();
+  }
+
+ private:
+  void shiftLow()
+  {
+    if (static_cast<uint32_t>(low) < 0xFF000000u || (low >> 32) != 0)
+    {
+      const uint8_t carry = static_cast<uint8_t>(low >> 32);
+      uint8_t byte = cache;
+      for (; pending != 0; --pending)
+      {
+        out.push_back(static_cast<uint8_t>(byte + carry));
+        byte = 0xFF;
+      }
+      cache = static_cast<uint8_t>(low >> 24);
+    }
+    ++pending;
+    low = (low & 0x00FFFFFFu) << 8;
+  }
+
+  std::vector<uint8_t> &out;
+  uint64_t low{0};
+  uint32_t range{0xFFFFFFFFu};
+  uint8_t cache{0};
+  size_t pending{1};
+};
+
+class RangeDecoder
+{
+ public:
+  RangeDecoder(const uint8_t *data_, size_t size_) : data(data_), size(size_)
+  {
+    for (size_t i = 0; i < 5; ++i) code = (code << 8) | nextByte();
+  }
+
+  uint32_t decode(uint16_t &probability)
+  {
+    const uint32_t bound = (range >> probabilityBits) * probability;
+    uint32_t bit;
+    if (code < bound)
+    {
+      range = bound;
+      probability = static_cast<uint16_t>(probability + (((1u << probabilityBits) - probability) >> adaptationShift));
+      bit = 0;
+    }
+    else
+    {
+      code -= bound;
+      range -= bound;
+      probability = static_cast<uint16_t>(probability - (probability >> adaptationShift));
+      bit = 1;
+    }
+    while (range < (1u << 24))
+    {
+      range <<= 8;
+      code = (code << 8) | nextByte();
+    }
+    return bit;
+  }
+
+ private:
+  uint32_t nextByte()
+  {
+    if (position >= size) throw std::runtime_error("Error: corrupt snapshot frame (truncated)\n");
+    return data[position++];
+  }
+
+  const uint8_t *data;
+  size_t size;
+  size_t position{0};
+  uint32_t code{0};
+  uint32_t range{0xFFFFFFFFu};
+};
+
+uint32_t prediction(SnapshotCodec::FrameType type, const uint32_t *words, const uint32_t *previous,
+                    const uint32_t *beforePrevious, size_t k, size_t columns)
+{
+  switch (type)
+  {
+    case SnapshotCodec::FrameType::Delta:
+      return previous[k];
+    case SnapshotCodec::FrameType::Linear:
+      return 2u * previous[k] - beforePrevious[k];
+    default:
+      return k >= columns ? words[k - columns] : 0u;
+  }
+}
+
+void putLittleEndian(std::vector<uint8_t> &out, uint64_t value, size_t bytes)
+{
+  for (size_t b = 0; b < bytes; ++b)
+  {
+    out.push_back(static_cast<uint8_t>(value >> (8 * b)));
+  }
+}
+}  // namespace
+
+void SnapshotCodec::encode(const uint32_t *words, const uint32_t *previous, const uint32_t *beforePrevious,
+                           size_t rows, size_t columns, Model &model, std::vector<uint8_t> &out)
+{
+  const FrameType type = previous == nullptr         ? FrameType::Keyframe
+                         : beforePrevious == nullptr ? FrameType::Delta
+                                                     : FrameType::Linear;
+  out.push_back(static_cast<uint8_t>(type));
+
+  if (type == FrameType::Keyframe) reset(model);
+  RangeEncoder encoder(out);
+  for (size_t k = 0; k < rows * columns; ++k)
+  {
+    const uint32_t residual = words[k] ^ prediction(type, words, previous, beforePrevious, k, columns);
+    size_t nonzero = 0;
+    for (size_t b = 4; b-- > 0;)
+    {
+      // entry 0 codes whether the byte is zero, entries 1-255 are the nodes of the bit tree of a nonzero byte
+      const uint32_t byte = (residual >> (8 * b)) & 0xFF;
+      auto &probabilities = model.probabilities[2 * b + nonzero];
+      encoder.encode(probabilities[0], byte != 0 ? 1u : 0u);
+      if (byte == 0) continue;
+      for (uint32_t node = 1, bit = 8; bit-- > 0;)
+      {
+        const uint32_t value = (byte >> bit) & 1;
+        encoder.encode(probabilities[node], value);
+        node = (node << 1) | value;
+      }
+      nonzero = 1;
+    }
+  }
+  encoder.flush();
+}
+
+void SnapshotCodec::decode(const uint8_t *data, size_t size, const uint32_t *previous,
+                           const uint32_t *beforePrevious, size_t rows, size_t columns, Model &model,
+                           uint32_t *words)
+{
+  if (size == 0 || data[0] > static_cast<uint8_t>(FrameType::Linear))
+    throw std::runtime_error("Error: corrupt snapshot frame (unknown frame type)\n");
+  const FrameType type = static_cast<FrameType>(data[0]);
+  if ((type != FrameType::Keyframe && previous == nullptr) || (type == FrameType::Linear && beforePrevious == nullptr))
+    throw std::runtime_error("Error: snapshot frame decoded without its previous frames\n");
+
+  if (type == FrameType::Keyframe) reset(model);
+  RangeDecoder decoder(data + 1, size - 1);
+  for (size_t k = 0; k < rows * columns; ++k)
+  {
+    uint32_t residual = 0;
+    size_t nonzero = 0;
+    for (size_t b = 4; b-- > 0;)
+    {
+      auto &probabilities = model.probabilities[2 * b + nonzero];
+      if (decoder.decode(probabilities[0]) == 0) continue;
+      uint32_t node = 1;
+      for (size_t bit = 0; bit < 8; ++bit)
+      {
+        node = (node << 1) | decoder.decode(probabilities[node]);
+      }
+      residual |= (node & 0xFF) << (8 * b);
+      nonzero = 1;
+    }
+    words[k] = residual ^ prediction(type, words, previous, beforePrevious, k, columns);
+  }
+}
+
+SnapshotWriter::SnapshotWriter(const std::string &fileName, size_t rows_, size_t columns_, size_t mantissaBits,
+                               size_t keyframeInterval_)
+    : stream(fileName, std::ios::out | std::ios::binary),
+      rows(rows_),
+      columns(columns_),
+      roundingMask(~((uint32_t{1} << (23 - std::min(mantissaBits, size_t{23}))) - 1)),
+      roundingHalf(((uint32_t{1} << (23 - std::min(mantissaBits, size_t{23}))) - 1) / 2 + 1),
+      keyframeInterval(std::max(keyframeInterval_, size_t{1})),
+      current(rows_ * columns_),
+      previous(rows_ * columns_),
+      beforePrevious(rows_ * columns_)
+{
+  if (!stream) throw std::runtime_error("Error: could not create snapshot file '" + fileName + "'\n");
+
+  buffer.assign(std::begin(SnapshotCodec::magic), std::end(SnapshotCodec::magic));
+  putLittleEndian(buffer, SnapshotCodec::version, sizeof(uint32_t));
+  putLittleEndian(buffer, rows, sizeof(uint32_t));
+  putLittleEndian(buffer, columns, sizeof(uint32_t));
+  putLittleEndian(buffer, keyframeInterval, sizeof(uint32_t));
+  putLittleEndian(buffer, std::min(mantissaBits, size_t{23}), sizeof(uint32_t));
+  stream.write(reinterpret_cast<const char *>(buffer.data()), static_cast<std::streamsize>(buffer.size()));
+  position = buffer.size();
+}
+
+SnapshotWriter::~SnapshotWriter() { close(); }
+
+void SnapshotWriter::append(const float *frame)
+{
+  std::memcpy(current.data(), frame, current.size() * sizeof(float));
+  if (roundingMask != 0xFFFFFFFFu)
+  {
+    // round the mantissas to nearest; infinities and NaNs, and values that would round to infinity, are kept
+    for (uint32_t &word : current)
+    {
+      const uint32_t rounded = (word + roundingHalf) & roundingMask;
+      if ((rounded & 0x7F800000u) != 0x7F800000u) word = rounded;
+    }
+  }
+
+  const size_t index = offsets.size() % keyframeInterval;
+  buffer.clear();
+  SnapshotCodec::encode(current.data(), index >= 1 ? previous.data() : nullptr,
+                        index >= 2 ? beforePrevious.data() : nullptr, rows, columns, model, buffer);
+  stream.write(reinterpret_cast<const char *>(buffer.data()), static_cast<std::streamsize>(buffer.size()));
+
+  offsets.push_back(position);
+  position += buffer.size();
+  std::swap(beforePrevious, previous);
+  std::swap(previous, current);
+}
+
+void SnapshotWriter::close()
+{
+  if (!stream.is_open()) return;
+
+  buffer.clear();
+  for (uint64_t offset : offsets)
+  {
+    putLittleEndian(buffer, offset, sizeof(uint64_t));
+  }
+  putLittleEndian(buffer, offsets.size(), sizeof(uint64_t));
+  putLittleEndian(buffer, position, sizeof(uint64_t));
+  buffer.insert(buffer.end(), std::begin(SnapshotCodec::magic), std::end(SnapshotCodec::magic));
+  stream.write(reinterpret_cast<const char *>(buffer.data()), static_cast<std::streamsize>(buffer.size()));
+  stream.close();
+}
+
+bool littleEndianHost()
+{
+  const uint32_t probe = 1;
+  uint8_t first;
+  std::memcpy(&first, &probe, 1);
+  return first == 1;
+}
+
+void writeLittleEndian(std::ostream &stream, const uint32_t *words, size_t n)
+{
+  if (littleEndianHost())
+  {
+    stream.write(reinterpret_cast<const char *>(words), static_cast<std::streamsize>(n * sizeof(uint32_t)));
+    return;
+  }
+  std::vector<uint8_t> bytes;
+  bytes.reserve(n * sizeof(uint32_t));
+  for (size_t k = 0; k < n; ++k)
+  {
+    putLittleEndian(bytes, words[k], sizeof(uint32_t));
+  }
+  stream.write(reinterpret_cast<const char *>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+}
+
+void writeLittleEndian(std::ostream &stream, const float *values, size_t n)
+{
+  static_assert(sizeof(float) == sizeof(uint32_t), "float32 snapshots need 32-bit floats");
+  if (littleEndianHost())
+  {
+    stream.write(reinterpret_cast<const char *>(values), static_cast<std::streamsize>(n * sizeof(float)));
+    return;
+  }
+  std::vector<uint32_t> words(n);
+  std::memcpy(words.data(), values, n * sizeof(float));
+  writeLittleEndian(stream, words.data(), n);
+}
+
+namespace
+{
+uint64_t getLittleEndian(const char *data, size_t bytes)
+{
+  uint64_t value = 0;
+  for (size_t b = 0; b < bytes; ++b)
+  {
+    value |= static_cast<uint64_t>(static_cast<uint8_t>(data[b])) << (8 * b);
+  }
+  return value;
+}
+
+// the labels of the '# column N: label (description)' lines of a layout file, e.g. "component 1 Q"
+std::vector<std::string> readColumnNames(const std::string &fileName)
+{
+  std::vector<std::string> names;
+  std::ifstream stream(fileName);
+  std::string line;
+  while (std::getline(stream, line))
+  {
+    if (line.rfind("# column ", 0) != 0) continue;
+    const size_t start = line.find(": ");
+    if (start == std::string::npos) continue;
+    const size_t end = line.find('(', start);
+    std::string label = line.substr(start + 2, end == std::string::npos ? std::string::npos : end - start - 2);
+    label.erase(label.find_last_not_of(' ') + 1);
+    names.push_back(label);
+  }
+  return names;
+}
+}  // namespace
+
+SnapshotReader::SnapshotReader(const std::string &fileName) : file(fileName, false)
+{
+  const char *begin = file.data();
+  const size_t size = file.size();
+
+  if (size >= SnapshotCodec::headerSize + SnapshotCodec::footerSize &&
+      std::equal(std::begin(SnapshotCodec::magic), std::end(SnapshotCodec::magic), begin))
+  {
+    if (getLittleEndian(begin + 4, sizeof(uint32_t)) != SnapshotCodec::version)
+      throw std::runtime_error("Error: unsupported version of snapshot file '" + fileName + "'\n");
+    rowCount = getLittleEndian(begin + 8, sizeof(uint32_t));
+    columnCount = getLittleEndian(begin + 12, sizeof(uint32_t));
+    keyframeInterval = std::max(getLittleEndian(begin + 16, sizeof(uint32_t)), uint64_t{1});
+
+    const char *footer = begin + size - SnapshotCodec::footerSize;
+    if (!std::equal(std::begin(SnapshotCodec::magic), std::end(SnapshotCodec::magic), footer + 16))
+      throw std::runtime_error("Error: snapshot file '" + fileName + "' has no index (incomplete run?)\n");
+    frameCount = getLittleEndian(footer, sizeof(uint64_t));
+    const uint64_t indexOffset = getLittleEndian(footer + 8, sizeof(uint64_t));
+    // compared without multiplying, so that a corrupt frame count cannot wrap around
+    const uint64_t indexEnd = size - SnapshotCodec::footerSize;
+    if (indexOffset > indexEnd || (indexEnd - indexOffset) % sizeof(uint64_t) != 0 ||
+        (indexEnd - indexOffset) / sizeof(uint64_t) != frameCount)
+      throw std::runtime_error("Error: corrupt index of snapshot file '" + fileName + "'\n");
+
+    offsets.reserve(frameCount + 1);
+    for (size_t k = 0; k < frameCount; ++k)
+    {
+      offsets.push_back(getLittleEndian(begin + indexOffset + k * sizeof(uint64_t), sizeof(uint64_t)));
+      if (offsets.back() < (k == 0 ? SnapshotCodec::headerSize : offsets[k - 1] + 1) || offsets.back() >= indexOffset)
+        throw std::runtime_error("Error: corrupt index of snapshot file '" + fileName + "'\n");
+    }
+    offsets.push_back(indexOffset);
+
+    current.resize(rowCount * columnCount);
+    previous.resize(rowCount * columnCount);
+    beforePrevious.resize(rowCount * columnCount);
+    frame.resize(rowCount * columnCount);
+  }
+  else
+  {
+    // 'column.f32': two uint32 (rows and columns) followed by the snapshots
+    if (size < 2 * sizeof(uint32_t)) throw std::runtime_error("Error: snapshot file '" + fileName + "' is empty\n");
+    rowCount = getLittleEndian(begin, sizeof(uint32_t));
+    columnCount = getLittleEndian(begin + 4, sizeof(uint32_t));
+    if (rowCount * columnCount == 0)
+      throw std::runtime_error("Error: snapshot file '" + fileName + "' is not a column.f32 or column.f32z file\n");
+    frameCount = (size - 2 * sizeof(uint32_t)) / (rowCount * columnCount * sizeof(float));
+    if (!littleEndianHost()) frame.resize(rowCount * columnCount);
+  }
+
+  names = readColumnNames(fileName + ".txt");
+}
+
+size_t SnapshotReader::columnIndex(const std::string &name) const
+{
+  auto it = std::find(names.begin(), names.end(), name);
+  if (it != names.end()) return static_cast<size_t>(it - names.begin());
+  if (!name.empty() && name.find_first_not_of("0123456789") == std::string::npos)
+  {
+    const size_t index = std::stoul(name);
+    if (index < columnCount) return index;
+  }
+  throw std::runtime_error("Error: unknown snapshot column '" + name + "'\n");
+}
+
+const float *SnapshotReader::data() const
+{
+  return compressed() || !littleEndianHost() ? nullptr
+                                             : reinterpret_cast<const float *>(file.data() + 2 * sizeof(uint32_t));
+}
+
+const float *SnapshotReader::snapshot(size_t k)
+{
+  if (k >= frameCount) throw std::out_of_range("Error: snapshot " + std::to_string(k) + " out of range\n");
+  if (!compressed())
+  {
+    if (littleEndianHost()) return data() + k * rowCount * columnCount;
+
+    // the values are stored little-endian
+    const char *values = file.data() + 2 * sizeof(uint32_t) + k * rowCount * columnCount * sizeof(float);
+    for (size_t n = 0; n < frame.size(); ++n)
+    {
+      const uint32_t word = static_cast<uint32_t>(getLittleEndian(values + n * sizeof(float), sizeof(float)));
+      std::memcpy(&frame[n], &word, sizeof(float));
+    }
+    return frame.data();
+  }
+
+  // decode forward from the keyframe, or from the last decoded frame when it precedes k in the same group
+  const size_t start =
+      (decoded == none || k < decoded || k / keyframeInterval != decoded / keyframeInterval) ? k - k % keyframeInterval
+                                                                                           : decoded + 1;
+  for (size_t f = start; f <= k; ++f)
+  {
+    const uint8_t *frameData = reinterpret_cast<const uint8_t *>(file.data()) + offsets[f];
+    SnapshotCodec::decode(frameData, offsets[f + 1] - offsets[f], previous.data(), beforePrevious.data(), rowCount,
+                          columnCount, model, current.data());
+    std::swap(beforePrevious, previous);
+    std::swap(previous, current);
+    decoded = f;
+  }
+  std::memcpy(frame.data(), previous.data(), frame.size() * sizeof(float));
+  return frame.data();
+}
+
+void SnapshotReader::column(size_t k, size_t column, float *values)
+{
+  if (column >= columnCount) throw std::out_of_range("Error: column " + std::to_string(column) + " out of range\n");
+  const float *frameValues = snapshot(k);
+  for (size_t row = 0; row < rowCount; ++row)
+  {
+    values[row] = frameValues[row * columnCount + column];
+  }
+}
+
+void SnapshotReader::timeSeries(size_t row, size_t column, float *values)
+{
+  if (row >= rowCount || column >= columnCount)
+    throw std::out_of_range("Error: row " + std::to_string(row) + " or column " + std::to_string(column) +
+                            " out of range\n");
+  for (size_t k = 0; k < frameCount; ++k)
+  {
+    values[k] = snapshot(k)[row * columnCount + column];
+  }
+}
+
+#ifdef PYBUILD
+void SnapshotWriter::appendArray(py::array_t<float, py::array::c_style | py::array::forcecast> frame)
+{
+  if (static_cast<size_t>(frame.size()) != rows * columns)
+  {
+    throw std::runtime_error("Error: snapshot of " + std::to_string(frame.size()) + " values, expected " +
+                             std::to_string(rows * columns) + "\n");
+  }
+  append(frame.data());
+}
+
+py::array_t<float> SnapshotReader::snapshotView(size_t k)
+{
+  const std::vector<size_t> shape{rowCount, columnCount};
+  if (compressed() || !littleEndianHost())
+  {
+    const float *values = snapshot(k);
+    return py::array_t<float>(shape, values);
+  }
+
+  // the view keeps this reader, and with it the mapping, alive through its base
+  py::array_t<float> array(shape, snapshot(k), py::cast(this, py::return_value_policy::reference));
+  array.attr("setflags")(py::arg("write") = false);
+  return array;
+}
+
+py::array_t<float> SnapshotReader::columnValues(size_t k, const std::string &name)
+{
+  const size_t index = columnIndex(name);
+  py::array_t<float> values(static_cast<py::ssize_t>(rowCount));
+  column(k, index, values.mutable_data());
+  return values;
+}
+
+py::array_t<float> SnapshotReader::timeSeriesValues(size_t row, const std::string &name)
+{
+  const size_t index = columnIndex(name);
+  py::array_t<float> values(static_cast<py::ssize_t>(frameCount));
+  float *output = values.mutable_data();
+  {
+    py::gil_scoped_release release;
+    timeSeries(row, index, output);
+  }
+  return values;
+}
+
+py::array_t<float> SnapshotReader::view()
+{
+  if (compressed())
+  {
+    throw std::runtime_error("Error: a compressed snapshot file has no view of all snapshots, use snapshot(k)\n");
+  }
+  if (!littleEndianHost())
+  {
+    throw std::runtime_error("Error: no view of all snapshots on a big-endian host, use snapshot(k)\n");
+  }
+  py::array_t<float> array(std::vector<size_t>{frameCount, rowCount, columnCount}, data(),
+                           py::cast(this, py::return_value_policy::reference));
+  array.attr("setflags")(py::arg("write") = false);
+  return array;
+}
+#endif  // PYBUILD
@@ -0,0 +1,226 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <limits>
+#include <string>
+#include <vector>
+
+#include "mapped_file.h"
+
+#ifdef PYBUILD
+#include <pybind11/numpy.h>
+#include <pybind11/pybind11.h>
+namespace py = pybind11;
+#endif  // PYBUILD
+
+/**
+ * \brief Codec for consecutive float32 snapshots of the column profiles.
+ *
+ * Most of the column changes slowly between two snapshots, so a value is predicted from the same value in the
+ * previous snapshots (linear extrapolation of the bit patterns, which are monotonic in the value for a fixed
+ * sign) and only the XOR of the value with its prediction is stored. Every keyframe-interval-th frame is a
+ * keyframe, predicted from the previous grid point of the frame itself. The XOR residuals are mostly zero in
+ * their high bytes and are coded byte by byte with an adaptive binary range coder, in which the probabilities
+ * are conditioned on the byte position and on whether a higher byte of the same residual was nonzero. The
+ * probabilities adapt across the frames following a keyframe and are reset at every keyframe.
+ *
+ * The codec is lossless; optionally the mantissas are rounded to fewer bits before coding (see SnapshotWriter),
+ * which leaves the low bytes of the residuals zero and compresses long runs by an order of magnitude.
+ *
+ * File layout ('column.f32z'), all integers little-endian:
+ *  - header: the magic "RPTZ", uint32 version, rows, columns, keyframe interval and mantissa bits;
+ *  - the frames, each a frame-type byte (see FrameType) followed by the range-coded residuals;
+ *  - index footer: uint64 file offset of every frame, then uint64 number of frames, uint64 offset of the index
+ *    and the magic "RPTZ" again.
+ * A single frame is recovered by decoding forward from the preceding keyframe.
+ */
+namespace SnapshotCodec
+{
+constexpr char magic[4] = {'R', 'P', 'T', 'Z'};
+constexpr uint32_t version = 1;
+constexpr size_t headerSize = 4 + 5 * sizeof(uint32_t);
+constexpr size_t footerSize = 2 * sizeof(uint64_t) + 4;
+
+enum class FrameType : uint8_t
+{
+  Keyframe = 0,  ///< predicted from the previous grid point
+  Delta = 1,     ///< predicted from the previous frame
+  Linear = 2     ///< predicted by linear extrapolation of the two previous frames
+};
+
+/// Adaptive probabilities of the range coder, carried from one frame to the next and reset at keyframes.
+struct Model
+{
+  // per byte position and 'higher byte nonzero': the probability of a zero byte and the bit tree of the byte
+  std::array<std::array<uint16_t, 256>, 8> probabilities;
+};
+
+/**
+ * \brief Appends a coded frame to 'out'.
+ *
+ * \param words The frame as rows x columns float32 bit patterns.
+ * \param previous The previous frame, or nullptr for a keyframe.
+ * \param beforePrevious The frame before the previous frame, or nullptr for a delta frame.
+ * \param rows The number of rows (grid points) of the frame.
+ * \param columns The number of columns per row.
+ * \param model The probabilities left by the previous frame (reset for a keyframe).
+ * \param out The buffer the frame-type byte and the coded residuals are appended to.
+ */
+void encode(const uint32_t *words, const uint32_t *previous, const uint32_t *beforePrevious, size_t rows,
+            size_t columns, Model &model, std::vector<uint8_t> &out);
+
+/**
+ * \brief Decodes a frame written by encode.
+ *
+ * \param data The frame, starting at the frame-type byte.
+ * \param size The size of the frame in bytes.
+ * \param previous The previous frame (required for delta and linear frames).
+ * \param beforePrevious The frame before the previous frame (required for linear frames).
+ * \param rows The number of rows (grid points) of the frame.
+ * \param columns The number of columns per row.
+ * \param model The probabilities left by the previous frame (reset for a keyframe).
+ * \param words The decoded rows x columns float32 bit patterns.
+ */
+void decode(const uint8_t *data, size_t size, const uint32_t *previous, const uint32_t *beforePrevious,
+            size_t rows, size_t columns, Model &model, uint32_t *words);
+}  // namespace SnapshotCodec
+
+/// Whether the host stores numbers little-endian, the byte order of the snapshot files.
+bool littleEndianHost();
+
+/**
+ * \brief Writes 32-bit words to a 'column.f32' file in little-endian byte order, whatever the byte order of the host.
+ *
+ * \param stream The binary output stream.
+ * \param words The words (uint32 or float32 values).
+ * \param n The number of words.
+ */
+void writeLittleEndian(std::ostream &stream, const uint32_t *words, size_t n);
+void writeLittleEndian(std::ostream &stream, const float *values, size_t n);
+
+/**
+ * \brief Writes float32 snapshots of a fixed shape as a compressed, randomly accessible 'column.f32z' file.
+ */
+class SnapshotWriter
+{
+ public:
+  /**
+   * \brief Creates the file and writes its header.
+   *
+   * \param fileName The name of the file.
+   * \param rows The number of rows (grid points) per snapshot.
+   * \param columns The number of columns per row.
+   * \param mantissaBits The number of mantissa bits kept (23 is lossless, 12 a relative precision of 1.2e-4).
+   * \param keyframeInterval The number of frames between keyframes, bounding the cost of random access.
+   */
+  SnapshotWriter(const std::string &fileName, size_t rows, size_t columns, size_t mantissaBits = 23,
+                 size_t keyframeInterval = 64);
+  ~SnapshotWriter();
+
+  SnapshotWriter(const SnapshotWriter &) = delete;
+  SnapshotWriter &operator=(const SnapshotWriter &) = delete;
+
+  /// Appends a snapshot of rows x columns values.
+  void append(const float *frame);
+
+  /// Writes the index footer and closes the file; called by the destructor if needed.
+  void close();
+
+  size_t frames() const { return offsets.size(); }  ///< Number of snapshots written so far.
+
+#ifdef PYBUILD
+  // appends a snapshot given as an array of rows x columns values
+  void appendArray(py::array_t<float, py::array::c_style | py::array::forcecast> frame);
+#endif  // PYBUILD
+
+ private:
+  std::ofstream stream;
+  size_t rows;
+  size_t columns;
+  uint32_t roundingMask;
+  uint32_t roundingHalf;
+  size_t keyframeInterval;
+  std::vector<uint64_t> offsets;  // file offset of every frame
+  uint64_t position{0};           // current file offset
+  std::vector<uint32_t> current;
+  std::vector<uint32_t> previous;
+  std::vector<uint32_t> beforePrevious;
+  SnapshotCodec::Model model;
+  std::vector<uint8_t> buffer;
+};
+
+/**
+ * \brief Random access to the column profiles written as 'column.f32' or 'column.f32z'.
+ *
+ * The file is memory-mapped and only the accessed snapshots are read: a snapshot of 'column.f32' is a view into
+ * the mapping, a snapshot of 'column.f32z' is decoded from the preceding keyframe (consecutive snapshots are
+ * decoded incrementally). The column names are taken from the layout file '<file>.txt' when present. A
+ * 'column.f32' file of a run that is still in progress can be read up to its last complete snapshot. On a
+ * big-endian host the snapshots of a 'column.f32' file are byte-swapped copies instead of views. Not
+ * thread-safe: the decoded snapshot is shared by all calls.
+ */
+class SnapshotReader
+{
+ public:
+  /**
+   * \brief Maps the file and reads its header (and the index footer for compressed files).
+   *
+   * \param fileName The name of the 'column.f32' or 'column.f32z' file.
+   */
+  explicit SnapshotReader(const std::string &fileName);
+
+  size_t frames() const { return frameCount; }            ///< Number of snapshots.
+  size_t rows() const { return rowCount; }                ///< Number of rows (grid points) per snapshot.
+  size_t columns() const { return columnCount; }          ///< Number of columns per row.
+  bool compressed() const { return !offsets.empty(); }    ///< Whether the file is a compressed 'column.f32z'.
+  const std::vector<std::string> &columnNames() const { return names; }  ///< E.g. "z", "V", "component 1 Q".
+
+  /// Index of the column with the given name, or the column number itself (0-based) when given as digits.
+  size_t columnIndex(const std::string &name) const;
+
+  /// Snapshot k as rows x columns values, valid until the next call.
+  const float *snapshot(size_t k);
+
+  /// The values of a column of snapshot k (one per row).
+  void column(size_t k, size_t column, float *values);
+
+  /// The values at a row (grid point) and column for all snapshots.
+  void timeSeries(size_t row, size_t column, float *values);
+
+  /// All snapshots as frames x rows x columns values, or nullptr for a compressed file or on a big-endian host.
+  const float *data() const;
+
+#ifdef PYBUILD
+  // snapshot k as a (rows, columns) array: a read-only view into the mapping for 'column.f32' (on a little-endian
+  // host), a copy otherwise
+  py::array_t<float> snapshotView(size_t k);
+  // a column (by name or index) of snapshot k, with shape (rows,)
+  py::array_t<float> columnValues(size_t k, const std::string &column);
+  // a column (by name or index) at a grid point for all snapshots, with shape (frames,)
+  py::array_t<float> timeSeriesValues(size_t row, const std::string &column);
+  // all snapshots as a read-only (frames, rows, columns) view into the mapping ('column.f32' on a little-endian
+  // host only)
+  py::array_t<float> view();
+#endif  // PYBUILD
+
+ private:
+  MappedFile file;
+  size_t rowCount{0};
+  size_t columnCount{0};
+  size_t frameCount{0};
+  size_t keyframeInterval{1};
+  std::vector<uint64_t> offsets;  // frame offsets of a compressed file, followed by the offset of the index
+  std::vector<std::string> names;
+
+  // the decoded frames of a compressed file
+  static constexpr size_t none = std::numeric_limits<size_t>::max();
+  size_t decoded{none};
+  std::vector<uint32_t> current;
+  std::vector<uint32_t> previous;
+  std::vector<uint32_t> beforePrevious;
+  SnapshotCodec::Model model;
+  std::vector<float> frame;
+};
@@ -0,0 +1,91 @@
+// Command-line access to the column profiles written with 'ColumnOutputFormat Float32' or 'Compressed'.
+//
+//   ruptura-snapshots <file> info                   rows, columns, snapshots and column names
+//   ruptura-snapshots <file> snapshot <k>           all columns of snapshot k (in the format of 'column.data')
+//   ruptura-snapshots <file> column <k> <column>    position and value of a column of snapshot k
+//   ruptura-snapshots <file> series <row> <column>  snapshot index and value at a grid point for all snapshots
+//
+// Columns are given by name (e.g. "component 1 Q", as listed by 'info') or by 0-based index.
+
+#include <exception>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "snapshot_file.h"
+
+static int usage()
+{
+  std::cerr << "usage: ruptura-snapshots <file> info\n"
+               "       ruptura-snapshots <file> snapshot <k>\n"
+               "       ruptura-snapshots <file> column <k> <column>\n"
+               "       ruptura-snapshots <file> series <row> <column>\n";
+  return 1;
+}
+
+int main(int argc, char *argv[])
+{
+  if (argc < 3) return usage();
+  const std::vector<std::string> arguments(argv + 1, argv + argc);
+
+  try
+  {
+    SnapshotReader reader(arguments[0]);
+    const std::string &command = arguments[1];
+
+    if (command == "info" && arguments.size() == 2)
+    {
+      std::cout << "file:      " << arguments[0] << (reader.compressed() ? " (compressed)" : "") << "\n";
+      std::cout << "snapshots: " << reader.frames() << "\n";
+      std::cout << "rows:      " << reader.rows() << "\n";
+      std::cout << "columns:   " << reader.columns() << "\n";
+      for (size_t i = 0; i < reader.columnNames().size(); ++i)
+      {
+        std::cout << "  " << i << ": " << reader.columnNames()[i] << "\n";
+      }
+      return 0;
+    }
+    if (command == "snapshot" && arguments.size() == 3)
+    {
+      const float *values = reader.snapshot(std::stoul(arguments[2]));
+      for (size_t row = 0; row < reader.rows(); ++row)
+      {
+        for (size_t column = 0; column < reader.columns(); ++column)
+        {
+          std::cout << values[row * reader.columns() + column] << " ";
+        }
+        std::cout << "\n";
+      }
+      return 0;
+    }
+    if (command == "column" && arguments.size() == 4)
+    {
+      const size_t k = std::stoul(arguments[2]);
+      std::vector<float> position(reader.rows());
+      std::vector<float> values(reader.rows());
+      reader.column(k, 0, position.data());
+      reader.column(k, reader.columnIndex(arguments[3]), values.data());
+      for (size_t row = 0; row < reader.rows(); ++row)
+      {
+        std::cout << position[row] << " " << values[row] << "\n";
+      }
+      return 0;
+    }
+    if (command == "series" && arguments.size() == 4)
+    {
+      std::vector<float> values(reader.frames());
+      reader.timeSeries(std::stoul(arguments[2]), reader.columnIndex(arguments[3]), values.data());
+      for (size_t k = 0; k < values.size(); ++k)
+      {
+        std::cout << k << " " << values[k] << "\n";
+      }
+      return 0;
+    }
+    return usage();
+  }
+  catch (std::exception const &e)
+  {
+    std::cerr << e.what();
+    return 1;
+  }
+}
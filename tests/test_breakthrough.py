@@ -1,4 +1,5 @@
 import pytest
+import _ruptura
 from unittest.mock import patch
 from ruptura import Components, Breakthrough
 import numpy as np
@@ -34,4 +35,99 @@ def test_compute(breakthrough_instance):
     with patch('_ruptura.Breakthrough.compute', return_value=expected_output) as mock_compute:
         result = breakthrough_instance.compute()
         np.testing.assert_array_equal(result, expected_output)
-        mock_compute.assert_called_once()
\ No newline at end of file
+        mock_compute.assert_called_once()
+
+def test_snapshots(breakthrough_instance):
+    snapshots = [{"step": 10, "t": 0.005, "P": np.random.rand(101, 3)},
+                 {"step": 20, "t": 0.010, "P": np.random.rand(101, 3)}, None]
+
+    with patch('_ruptura.Breakthrough.advance', side_effect=snapshots) as mock_advance:
+        result = list(breakthrough_instance.snapshots(fields=["P"], every=10))
+        assert [s["step"] for s in result] == [10, 20]
+        assert mock_advance.call_count == 3
+        mock_advance.assert_called_with(10, ["P"])
+
+def test_stream_stops_early(breakthrough_instance):
+    snapshots = [{"step": 10}, {"step": 20}, {"step": 30}, None]
+
+    with patch('_ruptura.Breakthrough.advance', side_effect=snapshots) as mock_advance:
+        count = breakthrough_instance.stream(lambda s: s["step"] < 20, fields=["Q"], every=10)
+        assert count == 2
+        assert mock_advance.call_count == 2
+
+def test_sweep(breakthrough_instance):
+    expected_output = np.random.rand(4, 10, 5)
+    kl = np.full((4, 3), 0.06)
+
+    with patch('_ruptura.BreakthroughBatch') as mock_batch:
+        mock_batch.return_value.compute.return_value = expected_output
+        result = breakthrough_instance.sweep(MassTransferCoefficients=kl)
+        np.testing.assert_array_equal(result, expected_output)
+        args = mock_batch.call_args[0]
+        assert args[1].size == 0
+        np.testing.assert_array_equal(args[2], kl)
+
+def make_column(NumberOfTimeSteps=20, WriteEvery=5, TimeStep=0.0005, MolFractions=(0.9, 0.05, 0.05),
+                MassTransferCoefficients=(0.0, 0.06, 0.06)):
+    # a small column built through the compiled module itself
+    y, kl = MolFractions, MassTransferCoefficients
+    components = [
+        _ruptura.Component(0, "Helium", [_ruptura.Isotherm(0, [1.0, 0.0], 2)], y[0], kl[0], 0.0, True),
+        _ruptura.Component(1, "nC7", [_ruptura.Isotherm(0, [1.09984, 6.55857e-5], 2),
+                                      _ruptura.Isotherm(0, [0.19466, 8.90731e-07], 2)], y[1], kl[1], 0.0, False),
+        _ruptura.Component(2, "C6m2", [_ruptura.Isotherm(0, [1.22228, 3.90895e-05], 2),
+                                       _ruptura.Isotherm(0, [0.481726, 9.64046e-08], 2)], y[2], kl[2], 0.0, False),
+    ]
+    mixture = _ruptura.MixturePrediction("Column", components, 1, 0, 433.0, 1.0e3, 1.0e6, 100, 0, 0, 0)
+    return _ruptura.Breakthrough("Column", components, 0, 20, 1000, WriteEvery, 433.0, 1.0e6, 0.4, 0.0, 1000.0, 0.1,
+                                 0.3, TimeStep, NumberOfTimeSteps, False, False, 0.0, mixture)
+
+def test_advance_matches_compute():
+    rows = make_column().compute()
+
+    # a snapshot after the first step is the first row of 'compute', with the same time label
+    column = make_column()
+    snapshot = column.advance(1, ["P", "V"])
+    assert snapshot["step"] == 0
+    assert snapshot["t"] == pytest.approx(rows[0, 0, 1] * 60.0)
+    np.testing.assert_allclose(snapshot["P"], rows[0, :, 7::6])
+    np.testing.assert_allclose(snapshot["V"], rows[0, :, 3])
+
+    # five steps later the column is at the second row (WriteEvery 5)
+    snapshot = column.advance(5, ["P"])
+    assert snapshot["step"] == 5
+    assert snapshot["t"] == pytest.approx(rows[1, 0, 1] * 60.0)
+    np.testing.assert_allclose(snapshot["P"], rows[1, :, 7::6])
+
+def test_tiled_compute_matches_untiled():
+    # the cache-tiled scheme only reorders the work; the velocity differs by round-off
+    run = dict(NumberOfTimeSteps=1000, WriteEvery=50, TimeStep=0.05)
+    rows = make_column(**run).compute()
+    column = make_column(**run)
+    column.setExplicitTiling(7, 4)
+    np.testing.assert_allclose(column.compute(), rows, rtol=1e-10, atol=1e-6)
+
+    # 'advance' never sweeps past the requested step
+    column = make_column(**run)
+    column.setExplicitTiling(7, 4)
+    column.advance(1, ["P"])
+    snapshot = column.advance(50, ["P"])
+    assert snapshot["step"] == 50
+    np.testing.assert_allclose(snapshot["P"], rows[1, :, 7::6], rtol=1e-10, atol=1e-6)
+
+def test_batch_matches_single_columns():
+    # every scenario of a batch is the column with its own feed and mass-transfer coefficients
+    molFractions = np.array([[0.9, 0.05, 0.05], [0.8, 0.1, 0.1]])
+    kl = np.array([[0.0, 0.06, 0.06], [0.0, 0.03, 0.12]])
+    run = dict(NumberOfTimeSteps=6000, WriteEvery=200, TimeStep=0.05)
+    curves = _ruptura.BreakthroughBatch(make_column(**run), molFractions, kl).compute()
+    assert curves.shape == (2, 30, 5)
+
+    for s in range(2):
+        rows = make_column(MolFractions=molFractions[s], MassTransferCoefficients=kl[s], **run).compute()
+        # the time [min] and P / (Pt Yi0) of every component at the outlet
+        np.testing.assert_allclose(curves[s, :, 1], rows[:, -1, 1])
+        np.testing.assert_allclose(curves[s, :, 2:], rows[:, -1, 8::6], rtol=1e-10, atol=1e-12)
+    # the scenarios differ and both break through
+    assert not np.allclose(curves[0, :, 2:], curves[1, :, 2:])
+    assert np.all(curves[:, -1, 3:] > 0.5)
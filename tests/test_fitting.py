@@ -1,4 +1,5 @@
 import pytest
+import _ruptura
 from unittest.mock import patch
 from ruptura import Components, Fitting
 import numpy as np
@@ -26,4 +27,33 @@ def test_compute(fitting_instance):
     with patch('_ruptura.Fitting.compute', return_value=expected_output) as mock_compute:
         result = fitting_instance.compute(mock_data)
         np.testing.assert_array_equal(result, expected_output)
-        mock_compute.assert_called_once_with(mock_data)
\ No newline at end of file
+        mock_compute.assert_called_once_with(mock_data)
+
+def test_evaluateParameterSets(fitting_instance):
+    parameters = np.random.rand(3, 4)
+    p = np.logspace(0, 6, 5)
+    expected_output = np.random.rand(3, 5)
+
+    with patch('_ruptura.Fitting.evaluateParameterSets', return_value=expected_output) as mock_evaluate:
+        result = fitting_instance.evaluateParameterSets(1, parameters, p)
+        np.testing.assert_array_equal(result, expected_output)
+        mock_evaluate.assert_called_once()
+        component, passed_parameters, passed_p = mock_evaluate.call_args[0]
+        assert component == 1
+        np.testing.assert_array_equal(passed_parameters, parameters)
+        np.testing.assert_array_equal(passed_p, p)
+
+def test_evaluateParameterSets_binding():
+    # calls the compiled binding itself: a dual-site Langmuir model evaluated for two parameter sets
+    isotherms = [_ruptura.Isotherm(0, [1.09984, 6.55857e-5], 2), _ruptura.Isotherm(0, [0.19466, 8.90731e-07], 2)]
+    component = _ruptura.Component(0, "nC7", isotherms, 1.0, 0.0, 0.0, False)
+    fitting = _ruptura.Fitting("Column", [component], [], 0)
+
+    parameters = np.array([[1.09984, 6.55857e-5, 0.19466, 8.90731e-07], [2.0, 1.0e-4, 0.5, 1.0e-6]])
+    p = np.logspace(0, 6, 5)
+    result = fitting.evaluateParameterSets(0, parameters, p)
+
+    expected = np.array([q1 * b1 * p / (1.0 + b1 * p) + q2 * b2 * p / (1.0 + b2 * p)
+                         for q1, b1, q2, b2 in parameters])
+    assert result.shape == (2, 5)
+    np.testing.assert_allclose(result, expected, rtol=1e-10)
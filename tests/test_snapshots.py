@@ -0,0 +1,99 @@
+import pytest
+import _ruptura
+from unittest.mock import patch
+from ruptura import Snapshots
+import numpy as np
+
+@pytest.fixture
+def snapshots_instance():
+    with patch('_ruptura.SnapshotReader') as mock_reader:
+        reader = mock_reader.return_value
+        reader.columnNames.return_value = ["z", "V", "Pt", "component 0 Q", "component 0 P"]
+        reader.frames.return_value = 10
+        reader.rows.return_value = 101
+        reader.columns.return_value = 5
+        yield Snapshots("column.f32z")
+
+def test_shape(snapshots_instance):
+    assert snapshots_instance.shape == (10, 101, 5)
+    assert len(snapshots_instance) == 10
+    assert snapshots_instance.columns[3] == "component 0 Q"
+
+def test_getitem(snapshots_instance):
+    expected_output = np.random.rand(101, 5)
+    snapshots_instance._SnapshotReader.snapshot.return_value = expected_output
+
+    np.testing.assert_array_equal(snapshots_instance[-1], expected_output)
+    snapshots_instance._SnapshotReader.snapshot.assert_called_once_with(9)
+    with pytest.raises(IndexError):
+        snapshots_instance[10]
+
+def test_column_and_timeseries(snapshots_instance):
+    snapshots_instance.column(3, "component 0 Q")
+    snapshots_instance._SnapshotReader.column.assert_called_once_with(3, "component 0 Q")
+    snapshots_instance.timeSeries(100, 4)
+    snapshots_instance._SnapshotReader.timeSeries.assert_called_once_with(100, "4")
+
+def write_snapshots(path, frames, mantissaBits, keyframeInterval):
+    writer = _ruptura.SnapshotWriter(str(path), frames.shape[1], frames.shape[2], mantissaBits, keyframeInterval)
+    for frame in frames:
+        writer.append(frame)
+    assert writer.frames() == len(frames)
+    writer.close()
+
+@pytest.fixture
+def profiles():
+    # slowly moving fronts, with a constant zero column, negative values and a repeated frame
+    z = np.linspace(0.0, 1.0, 50)
+    frames = np.stack([np.stack([z, np.zeros_like(z), -np.exp(-z * (k + 1)), np.tanh(20.0 * (z - 0.05 * k))], axis=1)
+                       for k in range(11)]).astype(np.float32)
+    frames[6] = frames[5]
+    return frames
+
+def test_round_trip_lossless(tmp_path, profiles):
+    path = tmp_path / "column.f32z"
+    write_snapshots(path, profiles, 23, 4)
+
+    reader = _ruptura.SnapshotReader(str(path))
+    assert reader.compressed()
+    assert (reader.frames(), reader.rows(), reader.columns()) == profiles.shape
+    for k in np.random.default_rng(42).permutation(len(profiles)):
+        np.testing.assert_array_equal(reader.snapshot(int(k)).view(np.uint32), profiles[k].view(np.uint32))
+    for k in range(len(profiles)):
+        np.testing.assert_array_equal(reader.snapshot(k).view(np.uint32), profiles[k].view(np.uint32))
+    np.testing.assert_array_equal(reader.column(7, "3"), profiles[7, :, 3])
+    np.testing.assert_array_equal(reader.timeSeries(10, "2"), profiles[:, 10, 2])
+
+def test_round_trip_lossy(tmp_path, profiles):
+    path = tmp_path / "column.f32z"
+    write_snapshots(path, profiles, 12, 4)
+
+    reader = _ruptura.SnapshotReader(str(path))
+    for k in np.random.default_rng(7).permutation(len(profiles)):
+        np.testing.assert_allclose(reader.snapshot(int(k)), profiles[k], rtol=2.0 ** -12, atol=0.0)
+
+def test_truncated_and_corrupt_footer(tmp_path, profiles):
+    path = tmp_path / "column.f32z"
+    write_snapshots(path, profiles, 23, 4)
+    data = path.read_bytes()
+
+    truncated = tmp_path / "truncated.f32z"
+    truncated.write_bytes(data[:-5])
+    with pytest.raises(RuntimeError, match="has no index"):
+        _ruptura.SnapshotReader(str(truncated))
+
+    # footer: uint64 number of frames, uint64 offset of the index, magic
+    for field, value in [(-20, 12), (-12, len(data)), (-20, 2 ** 61 + len(profiles))]:
+        corrupt = bytearray(data)
+        corrupt[field:field + 8] = value.to_bytes(8, "little")
+        path.write_bytes(bytes(corrupt))
+        with pytest.raises(RuntimeError, match="corrupt index"):
+            _ruptura.SnapshotReader(str(path))
+
+def test_snapshot_out_of_range(tmp_path, profiles):
+    path = tmp_path / "column.f32z"
+    write_snapshots(path, profiles, 23, 4)
+
+    reader = _ruptura.SnapshotReader(str(path))
+    with pytest.raises(IndexError):
+        reader.snapshot(len(profiles))